@@ -0,0 +1,90 @@
+/**
+ * @file    AsyncPrinter_Demo.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/hmi/output/asyncprinter.h>
+#include <PropWare/serial/uart/shareduarttx.h>
+
+static const unsigned int WORKERS    = 6;
+static const size_t       STACK_SIZE = 128;
+static const uint32_t     WAIT_TIME  = 500 * MILLISECOND;
+
+static char     rings[PropWare::AsyncPrinter::COGS][128];
+static uint32_t printerStack[STACK_SIZE];
+static uint32_t workerStacks[WORKERS][STACK_SIZE];
+
+class Worker : public PropWare::Runnable {
+    public:
+        template<size_t N>
+        Worker (const uint32_t (&stack)[N], PropWare::AsyncPrinter &out)
+                : Runnable(stack),
+                  m_out(&out) {
+        }
+
+        void run () {
+            uint32_t elapsed = 0;
+            uint32_t nextCnt = WAIT_TIME + CNT;
+            while (1) {
+                const uint32_t start = CNT;
+                this->m_out->printf("Hello from cog %d (last printf took %u cycles)\n", cogid(), elapsed);
+                elapsed = CNT - start;
+                nextCnt = waitcnt2(nextCnt, WAIT_TIME);
+            }
+        }
+
+    private:
+        PropWare::AsyncPrinter *m_out;
+};
+
+/**
+ * @example     AsyncPrinter_Demo.cpp
+ *
+ * Six cogs print to the same serial terminal through a PropWare::AsyncPrinter. Each reports how long its previous
+ * `printf` call took: only the time to format into its own ring, no matter how busy the serial port is. Compare with
+ * SynchronousPrinter_Demo.cpp, where every cog waits for the others' transmissions.
+ *
+ * @include Examples/PropWare_AsyncPrinter/CMakeLists.txt
+ */
+int main () {
+    PropWare::SharedUARTTX  uart;
+    const PropWare::Printer printer(uart);
+    PropWare::AsyncPrinter  asyncOut(printer, rings, printerStack);
+    PropWare::Runnable::invoke(asyncOut);
+
+    Worker workers[WORKERS] = {
+        Worker(workerStacks[0], asyncOut),
+        Worker(workerStacks[1], asyncOut),
+        Worker(workerStacks[2], asyncOut),
+        Worker(workerStacks[3], asyncOut),
+        Worker(workerStacks[4], asyncOut),
+        Worker(workerStacks[5], asyncOut)
+    };
+    for (unsigned int i = 0; i < WORKERS; ++i)
+        PropWare::Runnable::invoke(workers[i]);
+
+    while (1) {
+        waitcnt(5 * SECOND + CNT);
+        asyncOut << "Dropped so far: " << asyncOut.get_dropped_count() << '\n';
+    }
+}
@@ -0,0 +1,63 @@
+/**
+ * @file    BinaryLogger_Demo.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/hmi/output/binarylogger.h>
+#include <PropWare/serial/uart/uarttx.h>
+
+static char logBuffer[256];
+
+/**
+ * @example     BinaryLogger_Demo.cpp
+ *
+ * Log a few values every 10 ms without formatting any text on the Propeller. Each PW_LOG call copies a 2-byte format ID
+ * and the raw argument bytes into a ring buffer; the loop then sends the buffered records over the serial port as
+ * frames. Capture the serial output on a PC and decode it with the `pwlogdecode` tool from `tools/pwlogdecode`:
+ *
+ *     pwlogdecode BinaryLogger_Demo.elf capture.bin
+ *
+ * The time spent in PW_LOG is logged as well, for comparison with PropWare::Printer::printf.
+ *
+ * @include Examples/PropWare_BinaryLogger/CMakeLists.txt
+ */
+int main () {
+    PropWare::UARTTX       uart;
+    PropWare::BinaryLogger logger(logBuffer);
+
+    uint32_t sequence      = 0;
+    uint32_t elapsedCycles = 0;
+    while (1) {
+        const int32_t millivolts = (int32_t) (CNT >> 20) - 2048;
+
+        const uint32_t start = CNT;
+        PW_LOG(logger, "Sample %u: %d mV, flags=%08b\n", sequence, millivolts, sequence & 0xFF);
+        elapsedCycles = CNT - start;
+
+        PW_LOG(logger, "PW_LOG took %u cycles (%u dropped)\n", elapsedCycles, logger.get_dropped_count());
+
+        logger.drain(uart);
+        ++sequence;
+        waitcnt(10 * MILLISECOND + CNT);
+    }
+}
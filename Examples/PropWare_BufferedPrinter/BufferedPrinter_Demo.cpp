@@ -0,0 +1,64 @@
+/**
+ * @file    BufferedPrinter_Demo.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/hmi/output/bufferedprinter.h>
+#include <PropWare/serial/uart/uarttx.h>
+
+static const unsigned int LINES = 20;
+
+static char buffer[64];
+
+template<typename P>
+uint32_t print_lines (P &printer) {
+    const uint32_t start = CNT;
+    for (unsigned int i = 0; i < LINES; ++i)
+        printer.printf("Line %2d: CNT = 0x%08X\n", i, CNT);
+    return CNT - start;
+}
+
+/**
+ * @example     BufferedPrinter_Demo.cpp
+ *
+ * Print the same log lines twice: first through a plain PropWare::Printer, which hands the UART one character at a
+ * time, then through a PropWare::BufferedPrinter, which sends each line with a single PropWare::UARTTX::send_array call.
+ * The time taken by each is printed at the end.
+ *
+ * @include Examples/PropWare_BufferedPrinter/CMakeLists.txt
+ */
+int main () {
+    PropWare::UARTTX uart;
+    uart.set_baud_rate(1000000);
+
+    const PropWare::Printer   unbuffered(uart);
+    PropWare::BufferedPrinter buffered(uart, buffer);
+
+    const uint32_t unbufferedCycles = print_lines(unbuffered);
+    const uint32_t bufferedCycles   = print_lines(buffered);
+
+    buffered << "Printer:         " << unbufferedCycles / LINES << " cycles/line\n";
+    buffered << "BufferedPrinter: " << bufferedCycles / LINES << " cycles/line\n";
+
+    return 0;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file    BufferedUARTRX_Demo.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/hmi/output/printer.h>
+#include <PropWare/serial/uart/buffereduartrx.h>
+
+static char                            rxBuffer[256];
+static PropWare::BufferedUARTRX::Frame frames[8];
+
+/**
+ * @example BufferedUARTRX_Demo.cpp
+ *
+ * Keep the main cog busy while a PropWare::BufferedUARTRX collects lines typed into the terminal. Each complete line
+ * is echoed back along with how much work was done while it was being received.
+ *
+ * @include Examples/PropWare_BufferedUARTRX/CMakeLists.txt
+ */
+int main () {
+    PropWare::BufferedUARTRX receiver(rxBuffer, frames);
+    receiver.set_delimiter_framing('\r');
+    receiver.start();
+
+    pwOut << "Type a line and press enter\n";
+
+    char                            line[64];
+    PropWare::BufferedUARTRX::Frame frame;
+    uint32_t                        iterations = 0;
+    uint32_t                        lastFrame  = CNT;
+    while (1) {
+        // Stand-in for polling a sensor
+        ++iterations;
+
+        if (receiver.frame_ready()) {
+            const size_t length = receiver.receive_frame(line, sizeof(line) - 1, &frame);
+            line[length] = '\0';
+
+            pwOut.printf("\"%s\" (%u ms after the previous line, %u loop iterations)\n", line,
+                         (frame.timestamp - lastFrame) / MILLISECOND, iterations);
+            if (frame.flags & PropWare::BufferedUARTRX::Frame::PARITY_ERROR)
+                pwOut << "    parity error\n";
+            if (frame.flags & PropWare::BufferedUARTRX::Frame::DATA_OVERFLOW)
+                pwOut << "    buffer overflow\n";
+            if (frame.flags & PropWare::BufferedUARTRX::Frame::TRUNCATED)
+                pwOut << "    truncated\n";
+
+            lastFrame  = frame.timestamp;
+            iterations = 0;
+        }
+    }
+}
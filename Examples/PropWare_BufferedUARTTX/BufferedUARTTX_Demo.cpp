@@ -0,0 +1,61 @@
+/**
+ * @file    BufferedUARTTX_Demo.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/hmi/output/printer.h>
+#include <PropWare/serial/uart/buffereduarttx.h>
+#include <PropWare/utility/utility.h>
+
+static char     txBuffer[1024];
+static uint32_t txStack[64];
+
+/**
+ * @example BufferedUARTTX_Demo.cpp
+ *
+ * Redirect `pwOut` to a PropWare::BufferedUARTTX and compare how long the calling cog spends printing the same line
+ * with and without the helper cog.
+ *
+ * @include Examples/PropWare_BufferedUARTTX/CMakeLists.txt
+ */
+int main () {
+    static const char line[] = "The quick brown fox jumps over the lazy dog\n";
+
+    volatile uint32_t start = CNT;
+    pwOut << line;
+    const uint32_t unbufferedTime = PropWare::Utility::measure_time_interval(start);
+
+    static PropWare::BufferedUARTTX bufferedTx(txBuffer, txStack);
+    bufferedTx.start();
+    pwOut.set_print_capable(bufferedTx);
+
+    start = CNT;
+    pwOut << line;
+    const uint32_t bufferedTime = PropWare::Utility::measure_time_interval(start);
+
+    pwOut << "Unbuffered: " << unbufferedTime << " us\n";
+    pwOut << "Buffered:   " << bufferedTime << " us\n";
+
+    bufferedTx.flush();
+    while (1);
+}
@@ -0,0 +1,171 @@
+/**
+ * @file    CogPool_Demo.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/hmi/output/printer.h>
+#include <PropWare/concurrent/cogpool.h>
+
+static const unsigned int WORKERS     = 6;
+static const size_t       STACK_SIZE  = 128;
+static const uint32_t     NUMBERS     = 2048;
+/** The numbers are checked in this many separate bursts of parallel work */
+static const uint32_t     BURSTS      = 32;
+static const unsigned int ROUND_TRIPS = 64;
+
+static uint32_t       stacks[WORKERS][STACK_SIZE];
+static PropWare::Task tasks[16];
+static uint8_t        isPrime[NUMBERS];
+
+/**
+ * @brief   The kernel: a deliberately slow primality test, by trial division, of every number in a range
+ */
+void find_primes (const uint32_t begin, const uint32_t end, void *context) {
+    for (uint32_t n = begin; n < end; ++n) {
+        bool prime = 2 <= n;
+        for (uint32_t divisor = 2; prime && divisor * divisor <= n; ++divisor)
+            prime = n % divisor;
+        isPrime[n] = prime;
+    }
+}
+
+uint32_t count_primes () {
+    uint32_t count = 0;
+    for (uint32_t n = 0; n < NUMBERS; ++n)
+        count += isPrime[n];
+    return count;
+}
+
+void do_nothing (void *context) {
+}
+
+/**
+ * @brief   The way to do it without a pool: start a fresh cog for every chunk of every burst
+ */
+class ChunkRunner : public PropWare::Runnable {
+    public:
+        ChunkRunner (const uint32_t (&stack)[STACK_SIZE], const uint32_t begin, const uint32_t end)
+                : Runnable(stack),
+                  m_begin(begin),
+                  m_end(end),
+                  m_done(false) {
+        }
+
+        void run () {
+            find_primes(this->m_begin, this->m_end, NULL);
+            this->m_done = true;
+            cogstop(cogid());
+        }
+
+    public:
+        const uint32_t m_begin;
+        const uint32_t m_end;
+        volatile bool  m_done;
+};
+
+uint32_t time_single_cog () {
+    const uint32_t start = CNT;
+    find_primes(0, NUMBERS, NULL);
+    return CNT - start;
+}
+
+uint32_t time_pool (PropWare::CogPool &pool) {
+    const uint32_t burst = NUMBERS / BURSTS;
+    const uint32_t start = CNT;
+    for (uint32_t n = 0; n < NUMBERS; n += burst)
+        pool.parallel_for(n, n + burst, find_primes, NULL);
+    return CNT - start;
+}
+
+uint32_t time_cog_per_chunk () {
+    const uint32_t burst = NUMBERS / BURSTS;
+    const uint32_t chunk = burst / (WORKERS + 1);
+    const uint32_t start = CNT;
+    for (uint32_t n = 0; n < NUMBERS; n += burst) {
+        ChunkRunner runner0(stacks[0], n, n + chunk);
+        ChunkRunner runner1(stacks[1], n + chunk, n + 2 * chunk);
+        ChunkRunner runner2(stacks[2], n + 2 * chunk, n + 3 * chunk);
+        ChunkRunner runner3(stacks[3], n + 3 * chunk, n + 4 * chunk);
+        ChunkRunner runner4(stacks[4], n + 4 * chunk, n + 5 * chunk);
+        ChunkRunner runner5(stacks[5], n + 5 * chunk, n + 6 * chunk);
+        ChunkRunner *runners[WORKERS] = {&runner0, &runner1, &runner2, &runner3, &runner4, &runner5};
+
+        for (unsigned int i = 0; i < WORKERS; ++i)
+            PropWare::Runnable::invoke(*runners[i]);
+        find_primes(n + WORKERS * chunk, n + burst, NULL);
+        for (unsigned int i = 0; i < WORKERS; ++i)
+            while (!runners[i]->m_done);
+    }
+    return CNT - start;
+}
+
+/**
+ * @return  Average clock cycles from submitting an empty task until a worker has finished it
+ */
+uint32_t time_round_trip (PropWare::CogPool &pool) {
+    const uint32_t start = CNT;
+    for (unsigned int i = 0; i < ROUND_TRIPS; ++i) {
+        PropWare::Latch done(1);
+        pool.submit(do_nothing, NULL, &done);
+        // Wait without helping, so that the task really goes through a worker
+        done.wait();
+    }
+    return (CNT - start) / ROUND_TRIPS;
+}
+
+/**
+ * @example     CogPool_Demo.cpp
+ *
+ * Find the primes below 2048 by trial division, in 32 separate bursts of parallel work: once on a single cog, once
+ * with a PropWare::CogPool of six workers plus the main cog, and once by starting six new cogs for every burst.
+ *
+ * @include Examples/PropWare_CogPool/CMakeLists.txt
+ */
+int main () {
+    // The pool's task queue and every Latch are software locks, built on the one hardware lock of LockService
+    if (!PropWare::LockService::is_available()) {
+        pwOut << "No free hardware lock\n";
+        return 1;
+    }
+
+    PropWare::CogPool pool(stacks, tasks);
+
+    pwOut << "Primes below " << NUMBERS << ", in " << BURSTS << " bursts\n";
+
+    const uint32_t single = time_single_cog();
+    pwOut << "Single cog       : " << single / MICROSECOND << " us (" << count_primes() << " primes)\n";
+
+    pwOut << "Workers started  : " << pool.start() << '\n';
+    pwOut << "Task round trip  : " << time_round_trip(pool) << " cycles\n";
+    const uint32_t pooled = time_pool(pool);
+    pwOut << "CogPool          : " << pooled / MICROSECOND << " us (" << count_primes() << " primes)\n";
+    pool.stop();
+
+    const uint32_t cogPerChunk = time_cog_per_chunk();
+    pwOut << "New cog per chunk: " << cogPerChunk / MICROSECOND << " us (" << count_primes() << " primes)\n";
+
+    pwOut.printf("Speedup over a single cog: %.2f with the pool, %.2f starting cogs\n", (float) single / pooled,
+                 (float) single / cogPerChunk);
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file    Fibers_Demo.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/gpio/pin.h>
+#include <PropWare/hmi/output/printer.h>
+#include <PropWare/concurrent/fiber.h>
+
+/**
+ * @brief   Toggle an LED at a fixed rate, forever
+ */
+class Blinker : public PropWare::Fiber {
+    public:
+        Blinker (const PropWare::Pin::Mask mask, const uint32_t period)
+                : m_pin(mask, PropWare::Pin::Dir::OUT),
+                  m_period(period) {
+        }
+
+        void run () {
+            PW_FIBER_BEGIN();
+            this->m_deadline = CNT;
+            while (1) {
+                this->m_pin.toggle();
+                this->m_deadline += this->m_period;
+                PW_SLEEP_UNTIL(this->m_deadline);
+            }
+            PW_FIBER_END();
+        }
+
+    private:
+        const PropWare::Pin m_pin;
+        const uint32_t      m_period;
+        uint32_t            m_deadline;
+};
+
+/**
+ * @brief   Count presses of an active-low button
+ */
+class ButtonCounter : public PropWare::Fiber {
+    public:
+        ButtonCounter (const PropWare::Pin::Mask mask)
+                : m_mask(mask),
+                  m_presses(0) {
+        }
+
+        void run () {
+            PW_FIBER_BEGIN();
+            while (1) {
+                PW_WAIT_PIN(this->m_mask, 0);
+                ++this->m_presses;
+                // Ignore contact bounce, then wait for the release
+                PW_SLEEP_UNTIL(CNT + 20 * MILLISECOND);
+                PW_WAIT_PIN(this->m_mask, this->m_mask);
+            }
+            PW_FIBER_END();
+        }
+
+        unsigned int get_presses () const {
+            return this->m_presses;
+        }
+
+    private:
+        const PropWare::Pin::Mask m_mask;
+        unsigned int              m_presses;
+};
+
+/**
+ * @brief   Print the button count once per second
+ */
+class Reporter : public PropWare::Fiber {
+    public:
+        Reporter (const ButtonCounter &counter)
+                : m_counter(&counter) {
+        }
+
+        void run () {
+            PW_FIBER_BEGIN();
+            this->m_deadline = CNT;
+            while (1) {
+                this->m_deadline += SECOND;
+                PW_SLEEP_UNTIL(this->m_deadline);
+                pwOut << "Button presses: " << this->m_counter->get_presses() << '\n';
+            }
+            PW_FIBER_END();
+        }
+
+    private:
+        const ButtonCounter *m_counter;
+        uint32_t            m_deadline;
+};
+
+/**
+ * @example     Fibers_Demo.cpp
+ *
+ * Run ten independent jobs in a single cog with PropWare::FiberScheduler: eight LEDs blinking at different rates, a
+ * button counter and a once-per-second report. Written with PropWare::Runnable instead, the same jobs would need all
+ * eight cogs and then some. Whenever no job has anything to do, the cog sleeps in `waitcnt` until the next deadline -
+ * except while the button counter is waiting for the pin, which is checked on every pass.
+ *
+ * @include PropWare_Fibers/CMakeLists.txt
+ */
+int main () {
+    static Blinker blinkers[] = {
+            Blinker(PropWare::Pin::Mask::P16, 50 * MILLISECOND),
+            Blinker(PropWare::Pin::Mask::P17, 70 * MILLISECOND),
+            Blinker(PropWare::Pin::Mask::P18, 110 * MILLISECOND),
+            Blinker(PropWare::Pin::Mask::P19, 130 * MILLISECOND),
+            Blinker(PropWare::Pin::Mask::P20, 170 * MILLISECOND),
+            Blinker(PropWare::Pin::Mask::P21, 190 * MILLISECOND),
+            Blinker(PropWare::Pin::Mask::P22, 230 * MILLISECOND),
+            Blinker(PropWare::Pin::Mask::P23, 290 * MILLISECOND)
+    };
+    ButtonCounter button(PropWare::Pin::Mask::P0);
+    Reporter      reporter(button);
+
+    PropWare::FiberScheduler<> scheduler;
+    for (size_t i = 0; i < sizeof(blinkers) / sizeof(blinkers[0]); ++i)
+        scheduler.add(blinkers[i]);
+    scheduler.add(button);
+    scheduler.add(reporter);
+
+    pwOut << "Running " << scheduler.get_fiber_count() << " fibers in one cog\n";
+    scheduler.run();
+    return 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file    FramedSerial_Demo.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/serial/framing/framedserial.h>
+#include <PropWare/serial/uart/fullduplexserial.h>
+
+struct Sample {
+    uint32_t timestamp;
+    uint32_t sequence;
+    int16_t  values[4];
+};
+
+static char rxBuffer[sizeof(Sample) + PropWare::COBSDecoder::CRC_SIZE];
+
+/**
+ * @example FramedSerial_Demo.cpp
+ *
+ * Stream binary records to a PC over a PropWare::FullDuplexSerial link. Each 16-byte Sample goes out as a 20-byte frame
+ * (one COBS code byte, two CRC bytes and the zero byte that ends the frame), where printing the same values as text
+ * would take three to five times as many bytes. Decode them on the PC with PropWare::COBSDecoder from
+ * PropWare/serial/framing/cobs.h, which needs nothing but the standard library.
+ *
+ * @include Examples/PropWare_FramedSerial/CMakeLists.txt
+ */
+int main () {
+    PropWare::FullDuplexSerial serial;
+    serial.start();
+    PropWare::FramedSerial framed(serial, serial, rxBuffer);
+
+    Sample sample;
+    sample.sequence = 0;
+    while (1) {
+        sample.timestamp = CNT;
+        for (unsigned int i = 0; i < sizeof(sample.values) / sizeof(sample.values[0]); ++i)
+            sample.values[i] = (int16_t) ((sample.sequence << i) - 1000);
+
+        framed.send(sample);
+        ++sample.sequence;
+
+        waitcnt(10 * MILLISECOND + CNT);
+    }
+}
@@ -0,0 +1,210 @@
+/**
+ * @file    LockBenchmark_Demo.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/hmi/output/printer.h>
+#include <PropWare/concurrent/runnable.h>
+#include <PropWare/concurrent/lockservice.h>
+
+static const unsigned int CONTENDERS   = 4;
+static const unsigned int ITERATIONS   = 1024;
+/** Clock cycles each contender holds the lock for */
+static const uint32_t     HOLD         = 400;
+/** Clock cycles each contender spends outside the lock between acquisitions */
+static const uint32_t     THINK        = 1000;
+static const uint32_t     RUN_DURATION = 100 * MILLISECOND;
+static const size_t       STACK_SIZE   = 128;
+
+static uint32_t      stacks[CONTENDERS][STACK_SIZE];
+static volatile bool go;
+static volatile bool stop;
+
+/**
+ * @brief   Exclusive access through `lock()` and `unlock()`
+ */
+template<typename Lock>
+struct Exclusive {
+    static void acquire (Lock &lock) {
+        lock.lock();
+    }
+
+    static void release (Lock &lock) {
+        lock.unlock();
+    }
+};
+
+/**
+ * @brief   Shared access to a PropWare::ReadWriteLock
+ */
+struct Shared {
+    static void acquire (PropWare::ReadWriteLock &lock) {
+        lock.lock_shared();
+    }
+
+    static void release (PropWare::ReadWriteLock &lock) {
+        lock.unlock_shared();
+    }
+};
+
+void busy_wait (const uint32_t cycles) {
+    const uint32_t start = CNT;
+    while (CNT - start < cycles);
+}
+
+/**
+ * @brief   Takes the lock over and over again, recording how long each acquisition had to wait
+ */
+template<typename Lock, typename Access>
+class Contender : public PropWare::Runnable {
+    public:
+        Contender (const uint32_t (&stack)[STACK_SIZE], Lock &lock)
+                : Runnable(stack),
+                  m_lock(&lock),
+                  m_acquisitions(0),
+                  m_totalWait(0),
+                  m_maxWait(0),
+                  m_done(false) {
+        }
+
+        void run () {
+            while (!go);
+
+            while (!stop) {
+                const uint32_t start = CNT;
+                Access::acquire(*this->m_lock);
+                const uint32_t wait = CNT - start;
+                busy_wait(HOLD);
+                Access::release(*this->m_lock);
+
+                ++this->m_acquisitions;
+                this->m_totalWait += wait;
+                if (wait > this->m_maxWait)
+                    this->m_maxWait = wait;
+                busy_wait(THINK);
+            }
+
+            this->m_done = true;
+            cogstop(cogid());
+        }
+
+    public:
+        Lock              *m_lock;
+        volatile uint32_t m_acquisitions;
+        volatile uint32_t m_totalWait;
+        volatile uint32_t m_maxWait;
+        volatile bool     m_done;
+};
+
+/**
+ * @return  Average clock cycles for one acquire and release with no other cog competing
+ */
+template<typename Lock, typename Access>
+uint32_t time_uncontended (Lock &lock) {
+    uint32_t start = CNT;
+    for (unsigned int i = 0; i < ITERATIONS; ++i);
+    const uint32_t loopOverhead = CNT - start;
+
+    start = CNT;
+    for (unsigned int i = 0; i < ITERATIONS; ++i) {
+        Access::acquire(lock);
+        Access::release(lock);
+    }
+    return (CNT - start - loopOverhead) / ITERATIONS;
+}
+
+/**
+ * @param[in]   name[]  Row label, padded to 16 characters
+ */
+template<typename Lock, typename Access>
+void run_benchmark (const char name[], Lock &lock) {
+    typedef Contender<Lock, Access> LockContender;
+
+    const uint32_t uncontended = time_uncontended<Lock, Access>(lock);
+
+    LockContender contender0(stacks[0], lock);
+    LockContender contender1(stacks[1], lock);
+    LockContender contender2(stacks[2], lock);
+    LockContender contender3(stacks[3], lock);
+    LockContender *contenders[CONTENDERS] = {&contender0, &contender1, &contender2, &contender3};
+
+    go   = false;
+    stop = false;
+    for (unsigned int i = 0; i < CONTENDERS; ++i)
+        PropWare::Runnable::invoke(*contenders[i]);
+    // Let the new cogs finish loading before the clock starts
+    waitcnt(10 * MILLISECOND + CNT);
+
+    go = true;
+    waitcnt(RUN_DURATION + CNT);
+    stop = true;
+
+    uint32_t acquisitions = 0;
+    uint32_t totalWait    = 0;
+    uint32_t maxWait      = 0;
+    uint32_t fewest       = UINT32_MAX;
+    for (unsigned int i = 0; i < CONTENDERS; ++i) {
+        while (!contenders[i]->m_done);
+        acquisitions += contenders[i]->m_acquisitions;
+        totalWait += contenders[i]->m_totalWait;
+        if (contenders[i]->m_maxWait > maxWait)
+            maxWait = contenders[i]->m_maxWait;
+        if (contenders[i]->m_acquisitions < fewest)
+            fewest = contenders[i]->m_acquisitions;
+    }
+
+    pwOut.printf("%s %11u %9u %9u %12u %9u\n", name, uncontended, totalWait / acquisitions, maxWait, acquisitions,
+                 fewest);
+}
+
+/**
+ * @example     LockBenchmark_Demo.cpp
+ *
+ * Compare a raw hardware lock with the software locks from PropWare/concurrent/lockservice.h. Each lock is first timed
+ * with no competition, then four cogs fight over it: each holds the lock for a short time, releases it, works for a
+ * while and comes back for more. The table shows how long an acquisition waits on average and at worst, the total
+ * number of acquisitions in the run and the number made by the least lucky cog - a measure of fairness.
+ *
+ * @include Examples/PropWare_LockBenchmark/CMakeLists.txt
+ */
+int main () {
+    PropWare::HardwareLock  hardwareLock;
+    PropWare::TicketLock    ticketLock;
+    PropWare::ReadWriteLock readWriteLock;
+
+    if (!hardwareLock.is_valid() || !ticketLock.is_valid() || !readWriteLock.is_valid()) {
+        pwOut << "Not enough free hardware locks\n";
+        return 1;
+    }
+
+    pwOut << "Lock benchmark (" << CONTENDERS << " cogs, hold " << HOLD << " cycles, think " << THINK
+          << " cycles)\n";
+    pwOut << "                 uncontended  avg wait  max wait acquisitions  min/cog\n";
+
+    run_benchmark<PropWare::HardwareLock, Exclusive<PropWare::HardwareLock> >("HardwareLock    ", hardwareLock);
+    run_benchmark<PropWare::TicketLock, Exclusive<PropWare::TicketLock> >("TicketLock      ", ticketLock);
+    run_benchmark<PropWare::ReadWriteLock, Exclusive<PropWare::ReadWriteLock> >("RWLock (write)  ", readWriteLock);
+    run_benchmark<PropWare::ReadWriteLock, Shared>("RWLock (read)   ", readWriteLock);
+
+    return 0;
+}
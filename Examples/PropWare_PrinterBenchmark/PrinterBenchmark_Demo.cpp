@@ -0,0 +1,139 @@
+/**
+ * @file    PrinterBenchmark_Demo.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/hmi/output/printer.h>
+#include <stdio.h>
+
+using PropWare::Printer;
+
+static const unsigned int ITERATIONS = 64;
+
+/**
+ * @brief   Throws away everything printed to it, so that only the cost of formatting is measured
+ */
+class NullPrintCapable : public PropWare::PrintCapable {
+    public:
+        virtual void put_char (const char c) {
+        }
+
+        virtual void puts (const char string[]) {
+        }
+};
+
+/**
+ * @brief   The modulo-and-divide loop that PropWare::Printer::put_uint used before it had dedicated kernels
+ */
+template<typename T>
+char *format_with_division (T x, const uint8_t radix, char *end) {
+    do {
+        const unsigned int digit = static_cast<unsigned int>(x % radix);
+        *--end = static_cast<char>(digit > 9 ? digit + 'A' - 10 : digit + '0');
+        x /= radix;
+    } while (x);
+    return end;
+}
+
+const char *memory_model () {
+#if defined(__PROPELLER_CMM__)
+    return "CMM";
+#elif defined(__PROPELLER_XMMC__)
+    return "XMMC";
+#elif defined(__PROPELLER_XMM__)
+    return "XMM";
+#else
+    return "LMM";
+#endif
+}
+
+template<typename T, char *(*FORMAT) (T, uint8_t, char *)>
+uint32_t time_conversion (const T value, const uint8_t radix) {
+    char           buffer[sizeof(T) * 8];
+    volatile char  sink;
+    const uint32_t start = CNT;
+    for (unsigned int i = 0; i < ITERATIONS; ++i)
+        sink = *FORMAT(value, radix, &buffer[sizeof(buffer)]);
+    (void) sink;
+    return (CNT - start) / ITERATIONS;
+}
+
+template<typename T, char *(*KERNEL) (T, uint8_t, char *)>
+void report (const char name[], const T value, const uint8_t radix) {
+    const uint32_t divisionCycles = time_conversion<T, format_with_division<T> >(value, radix);
+    const uint32_t kernelCycles   = time_conversion<T, KERNEL>(value, radix);
+    pwOut << name << " - division: " << divisionCycles << ", kernel: " << kernelCycles << " cycles/conversion ("
+          << 100 * kernelCycles / divisionCycles << "%)\n";
+}
+
+/**
+ * @brief   Print a value to three decimal places and report the average time taken
+ */
+template<typename T>
+void report_print (const Printer &printer, const char name[], const T value) {
+    const Printer::Format format(0, Printer::DEFAULT_FILL_CHAR, Printer::DEFAULT_RADIX, 3);
+    const uint32_t        start = CNT;
+    for (unsigned int i = 0; i < ITERATIONS; ++i)
+        printer.print(value, format);
+    pwOut << name << ": " << (CNT - start) / ITERATIONS << " cycles/call\n";
+}
+
+/**
+ * @example     PrinterBenchmark_Demo.cpp
+ *
+ * Measure how many clock cycles it takes to turn an integer into text, comparing the modulo-and-divide loop that
+ * PropWare::Printer used to run against its division-free kernels. The Propeller has no hardware divider, so the
+ * difference depends heavily on the memory model: build this example once with each `MODEL` (such as `cmm` and `lmm`)
+ * and compare the results. The remaining lines include the cost of handing the digits to a PropWare::PrintCapable,
+ * and compare the integer-only `float` and fixed-point paths with the C library's `sprintf`.
+ *
+ * @include Examples/PropWare_PrinterBenchmark/CMakeLists.txt
+ */
+int main () {
+    pwOut << "Printer benchmark (" << memory_model() << ", " << ITERATIONS << " iterations each)\n";
+
+    report<uint32_t, Printer::format_uint>("32-bit decimal    ", 4294967295U, 10);
+    report<uint32_t, Printer::format_uint>("32-bit hexadecimal", 0xDEADBEEF, 16);
+    report<uint32_t, Printer::format_uint>("32-bit binary     ", 0xDEADBEEF, 2);
+    report<uint64_t, Printer::format_ull>("64-bit decimal    ", 18446744073709551615ULL, 10);
+    report<uint64_t, Printer::format_ull>("64-bit hexadecimal", 0xFEDCBA9876543210ULL, 16);
+
+    NullPrintCapable nullPrintCapable;
+    const Printer    nullPrinter(nullPrintCapable, false);
+    const uint32_t   start = CNT;
+    for (unsigned int i = 0; i < ITERATIONS; ++i)
+        nullPrinter.put_uint(4294967295U, 10, 12, '0');
+    pwOut << "put_uint(4294967295, 10, 12, '0'): " << (CNT - start) / ITERATIONS << " cycles/call\n";
+
+    report_print(nullPrinter, "print(float)     ", 3.14159265f);
+    report_print(nullPrinter, "print(Q16)       ", PropWare::Q16(3.14159265));
+
+    char           buffer[32];
+    volatile float value        = 3.14159265f;
+    const uint32_t sprintfStart = CNT;
+    for (unsigned int i = 0; i < ITERATIONS; ++i)
+        sprintf(buffer, "%.3f", value);
+    pwOut << "sprintf(\"%.3f\")   : " << (CNT - sprintfStart) / ITERATIONS << " cycles/call\n";
+
+    return 0;
+}
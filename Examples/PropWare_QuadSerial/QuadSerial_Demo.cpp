@@ -0,0 +1,73 @@
+/**
+ * @file    QuadSerial_Demo.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/hmi/output/printer.h>
+#include <PropWare/serial/uart/quadserial.h>
+
+static const int PEER_RX_PIN = 12;
+static const int PEER_TX_PIN = 13;
+static const int PEER_BAUD   = 57600;
+
+/**
+ * @example QuadSerial_Demo.cpp
+ *
+ * Run two of QuadSerial's four ports from a single cog: the first port talks to the terminal and the second to a peer
+ * device. Every line received from the peer is forwarded to the terminal.
+ *
+ * @include Examples/PropWare_QuadSerial/CMakeLists.txt
+ */
+int main () {
+    static char terminalRx[16];
+    static char terminalTx[256];
+    static char peerRx[512];
+    static char peerTx[64];
+
+    PropWare::QuadSerial       serial;
+    PropWare::QuadSerial::Port &terminal = serial.set_port(0, terminalRx, terminalTx, _cfg_rxpin, _cfg_txpin);
+    PropWare::QuadSerial::Port &peer     = serial.set_port(1, peerRx, peerTx, PEER_RX_PIN, PEER_TX_PIN, 0, PEER_BAUD);
+
+    // pwOut uses the same pin as the terminal port, so it must not be used after the driver starts
+    serial.start();
+
+    PropWare::Printer terminalPrinter(terminal);
+    PropWare::Printer peerPrinter(peer);
+
+    terminalPrinter << "Hello from QuadSerial! Forwarding everything from the peer...\n";
+    peerPrinter << "Hello, peer!\n";
+
+    char     buffer[64];
+    uint32_t bytesLost = 0;
+    while (1) {
+        const size_t length = peer.read(buffer, sizeof(buffer) - 1);
+        if (length) {
+            buffer[length] = '\0';
+            terminalPrinter << buffer;
+        }
+        if (bytesLost != peer.get_overflow_count()) {
+            bytesLost = peer.get_overflow_count();
+            terminalPrinter << "Lost " << bytesLost << " bytes from the peer so far\n";
+        }
+    }
+}
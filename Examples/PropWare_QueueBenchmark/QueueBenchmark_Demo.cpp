@@ -0,0 +1,153 @@
+/**
+ * @file    QueueBenchmark_Demo.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/hmi/output/printer.h>
+#include <PropWare/concurrent/runnable.h>
+#include <PropWare/utility/collection/queue.h>
+
+static const unsigned int PRODUCERS  = 2;
+static const unsigned int CONSUMERS  = 2;
+static const unsigned int ITEMS      = 2048;
+static const size_t       BATCH      = 16;
+static const size_t       STACK_SIZE = 128;
+
+static uint8_t       queueArray[64];
+static uint32_t      stacks[PRODUCERS + CONSUMERS][STACK_SIZE];
+static volatile bool go;
+static volatile bool stop;
+
+/**
+ * @brief   Moves bytes through a shared queue, either one per lock hold or a batch per lock hold
+ */
+class Worker : public PropWare::Runnable {
+    public:
+        Worker (const uint32_t (&stack)[STACK_SIZE], PropWare::Queue<uint8_t> &queue, const bool producer,
+                const bool batched)
+                : Runnable(stack),
+                  m_queue(&queue),
+                  m_producer(producer),
+                  m_batched(batched),
+                  m_consumed(0) {
+        }
+
+        void run () {
+            uint8_t batch[BATCH];
+            while (!go);
+
+            if (this->m_producer) {
+                for (size_t i = 0; i < BATCH; ++i)
+                    batch[i] = (uint8_t) i;
+                if (this->m_batched)
+                    for (unsigned int i = 0; i < ITEMS; i += BATCH)
+                        this->m_queue->wait_enqueue_n(batch, BATCH);
+                else
+                    for (unsigned int i = 0; i < ITEMS; ++i)
+                        this->m_queue->wait_enqueue_n(&batch[i % BATCH], 1);
+            } else {
+                while (!stop) {
+                    if (this->m_batched)
+                        this->m_consumed += this->m_queue->dequeue_n(batch, BATCH);
+                    else if (this->m_queue->try_dequeue(batch[0]))
+                        ++this->m_consumed;
+                }
+            }
+
+            cogstop(cogid());
+        }
+
+        uint32_t get_consumed () const {
+            return this->m_consumed;
+        }
+
+    private:
+        PropWare::Queue<uint8_t> *m_queue;
+        const bool               m_producer;
+        const bool               m_batched;
+        volatile uint32_t        m_consumed;
+};
+
+const char *memory_model () {
+#if defined(__PROPELLER_CMM__)
+    return "CMM";
+#elif defined(__PROPELLER_XMMC__)
+    return "XMMC";
+#elif defined(__PROPELLER_XMM__)
+    return "XMM";
+#else
+    return "LMM";
+#endif
+}
+
+/**
+ * @return  Average cycles per byte, from the moment the workers are released until every byte has been consumed
+ */
+uint32_t time_workers (PropWare::Queue<uint8_t> &queue, const bool batched) {
+    Worker producer0(stacks[0], queue, true, batched);
+    Worker producer1(stacks[1], queue, true, batched);
+    Worker consumer0(stacks[2], queue, false, batched);
+    Worker consumer1(stacks[3], queue, false, batched);
+
+    go   = false;
+    stop = false;
+    PropWare::Runnable::invoke(producer0);
+    PropWare::Runnable::invoke(producer1);
+    PropWare::Runnable::invoke(consumer0);
+    PropWare::Runnable::invoke(consumer1);
+    // Let the new cogs finish loading before the clock starts
+    waitcnt(10 * MILLISECOND + CNT);
+
+    const uint32_t start = CNT;
+    go = true;
+    while (PRODUCERS * ITEMS != consumer0.get_consumed() + consumer1.get_consumed());
+    const uint32_t elapsed = CNT - start;
+
+    stop = true;
+    waitcnt(MILLISECOND + CNT);
+    return elapsed / (PRODUCERS * ITEMS);
+}
+
+/**
+ * @example     QueueBenchmark_Demo.cpp
+ *
+ * Two producer cogs and two consumer cogs share one PropWare::Queue of bytes. The first run takes the queue's lock
+ * once per byte; the second moves up to 16 bytes per lock hold with PropWare::Queue::enqueue_n and
+ * PropWare::Queue::dequeue_n.
+ *
+ * @include Examples/PropWare_QueueBenchmark/CMakeLists.txt
+ */
+int main () {
+    PropWare::Queue<uint8_t> queue(queueArray);
+
+    pwOut << "Queue benchmark (" << memory_model() << ", " << PRODUCERS << " producers, " << CONSUMERS
+          << " consumers, " << PRODUCERS * ITEMS << " bytes)\n";
+
+    const uint32_t single  = time_workers(queue, false);
+    pwOut << "One byte per lock hold      : " << single << " cycles/byte\n";
+    const uint32_t batched = time_workers(queue, true);
+    pwOut << "Up to " << BATCH << " bytes per lock hold: " << batched << " cycles/byte\n";
+    pwOut << "Speedup: " << single / batched << "x\n";
+
+    return 0;
+}
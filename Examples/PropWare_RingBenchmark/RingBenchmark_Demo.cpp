@@ -0,0 +1,187 @@
+/**
+ * @file    RingBenchmark_Demo.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/hmi/output/printer.h>
+#include <PropWare/concurrent/runnable.h>
+#include <PropWare/utility/collection/queue.h>
+#include <PropWare/utility/collection/spscring.h>
+
+static const unsigned int ITERATIONS = 256;
+static const unsigned int STREAM     = 4096;
+static const size_t       CAPACITY   = 32;
+
+static uint32_t                          queueArray[CAPACITY];
+static PropWare::SPSCRing<uint32_t, 32> ring;
+static uint32_t                          producerStack[128];
+static volatile bool                     go;
+
+/**
+ * @brief   Streams the numbers 0 through STREAM - 1 to the main cog, one of three ways
+ */
+class Producer : public PropWare::Runnable {
+    public:
+        typedef enum {
+            QUEUE,
+            RING,
+            RING_SPANS
+        } Method;
+
+    public:
+        Producer (PropWare::Queue<uint32_t> &queue, const Method method)
+                : Runnable(producerStack),
+                  m_queue(&queue),
+                  m_method(method) {
+        }
+
+        void run () {
+            while (!go);
+
+            uint32_t next = 0;
+            switch (this->m_method) {
+                case QUEUE:
+                    // Queue overwrites old data when full, so the producer must wait for room
+                    while (STREAM > next)
+                        if (!this->m_queue->is_full())
+                            this->m_queue->enqueue(next++);
+                    break;
+                case RING:
+                    while (STREAM > next)
+                        if (ring.try_push(next))
+                            ++next;
+                    break;
+                case RING_SPANS:
+                    while (STREAM > next) {
+                        const PropWare::SPSCRing<uint32_t, 32>::Span span = ring.push_n(STREAM - next);
+                        for (size_t i = 0; i < span.length; ++i)
+                            span.data[i] = next++;
+                        ring.commit_push(span.length);
+                    }
+                    break;
+            }
+
+            cogstop(cogid());
+        }
+
+    private:
+        PropWare::Queue<uint32_t> *m_queue;
+        const Method              m_method;
+};
+
+const char *memory_model () {
+#if defined(__PROPELLER_CMM__)
+    return "CMM";
+#elif defined(__PROPELLER_XMMC__)
+    return "XMMC";
+#elif defined(__PROPELLER_XMM__)
+    return "XMM";
+#else
+    return "LMM";
+#endif
+}
+
+/**
+ * @brief   Start the producer, then consume the whole stream in this cog
+ *
+ * @return  Average cycles per element, from the moment the producer is released until the last element is consumed
+ */
+uint32_t time_stream (PropWare::Queue<uint32_t> &queue, const Producer::Method method) {
+    Producer producer(queue, method);
+    go = false;
+    PropWare::Runnable::invoke(producer);
+    // Let the new cog finish loading before the clock starts
+    waitcnt(10 * MILLISECOND + CNT);
+
+    uint32_t       checksum = 0;
+    unsigned int   received = 0;
+    const uint32_t start    = CNT;
+    go = true;
+    if (Producer::QUEUE == method) {
+        while (STREAM > received)
+            // Queue returns garbage when empty, so it has to be checked first
+            if (!queue.is_empty()) {
+                checksum += queue.dequeue();
+                ++received;
+            }
+    } else if (Producer::RING == method) {
+        uint32_t value;
+        while (STREAM > received)
+            if (ring.try_pop(value)) {
+                checksum += value;
+                ++received;
+            }
+    } else {
+        while (STREAM > received) {
+            const PropWare::SPSCRing<uint32_t, 32>::Span span = ring.pop_n();
+            for (size_t i = 0; i < span.length; ++i)
+                checksum += span.data[i];
+            ring.commit_pop(span.length);
+            received += span.length;
+        }
+    }
+    const uint32_t elapsed = CNT - start;
+
+    if (STREAM * (STREAM - 1) / 2 != checksum)
+        pwOut << "    (checksum mismatch: " << checksum << ")\n";
+    return elapsed / STREAM;
+}
+
+/**
+ * @example     RingBenchmark_Demo.cpp
+ *
+ * Compare PropWare::Queue, which takes a hardware lock for every element, with the lock-free PropWare::SPSCRing:
+ * first with both ends in the same cog, then streaming from one cog to another.
+ *
+ * @include Examples/PropWare_RingBenchmark/CMakeLists.txt
+ */
+int main () {
+    PropWare::Queue<uint32_t> queue(queueArray);
+    volatile uint32_t         sink;
+    uint32_t                  value;
+
+    pwOut << "Ring benchmark (" << memory_model() << ", " << ITERATIONS << " iterations each)\n";
+
+    uint32_t start = CNT;
+    for (unsigned int i = 0; i < ITERATIONS; ++i) {
+        queue.enqueue(i);
+        sink = queue.dequeue();
+    }
+    pwOut << "Queue::enqueue + dequeue         : " << (CNT - start) / ITERATIONS << " cycles\n";
+
+    start = CNT;
+    for (unsigned int i = 0; i < ITERATIONS; ++i) {
+        ring.try_push(i);
+        ring.try_pop(value);
+        sink = value;
+    }
+    pwOut << "SPSCRing::try_push + try_pop     : " << (CNT - start) / ITERATIONS << " cycles\n";
+    (void) sink;
+
+    pwOut << "Streaming " << STREAM << " elements between two cogs:\n";
+    pwOut << "    Queue                        : " << time_stream(queue, Producer::QUEUE) << " cycles/element\n";
+    pwOut << "    SPSCRing, one at a time      : " << time_stream(queue, Producer::RING) << " cycles/element\n";
+    pwOut << "    SPSCRing, push_n and pop_n   : " << time_stream(queue, Producer::RING_SPANS) << " cycles/element\n";
+
+    return 0;
+}
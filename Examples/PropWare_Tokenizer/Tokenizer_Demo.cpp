@@ -0,0 +1,79 @@
+/**
+ * @file    Tokenizer_Demo.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/PropWare.h>
+#include <PropWare/hmi/output/printer.h>
+#include <PropWare/hmi/input/tokenizer.h>
+#include <PropWare/memory/sd.h>
+#include <PropWare/filesystem/fat/fatfs.h>
+#include <PropWare/filesystem/fat/fatfilereader.h>
+
+using namespace PropWare;
+
+// Whole sectors are copied out of the file a piece at a time through this buffer
+static char lookahead[64];
+
+/**
+ * @example     Tokenizer_Demo.cpp
+ *
+ * Read a CSV configuration file from an SD card, with one "name,address,gain" record per line, such as
+ *
+ *     # name, address, gain
+ *     heater, 0x48, 1.25
+ *     fan,    0x49, -0.5
+ *
+ * Lines which start with '#' are skipped and bad values are reported along with their line and column.
+ *
+ * @include PropWare_Tokenizer/CMakeLists.txt
+ */
+int main () {
+    const SD driver;
+    FatFS    filesystem(driver);
+    filesystem.mount();
+
+    FatFileReader reader(filesystem, "config.csv");
+    reader.open();
+    Tokenizer tokens(reader, lookahead);
+
+    char     name[16];
+    uint32_t address;
+    Q16      gain;
+    char     c;
+    while (!tokens.at_end()) {
+        if (tokens.peek(c) && '#' == c)
+            ;
+        else if (tokens.get_token(name, sizeof(name)) || tokens.expect(',') || tokens.get(address)
+                || tokens.expect(',') || tokens.get(gain))
+            pwOut.printf("Bad value on line %u, column %u\n", tokens.get_token_position().line,
+                         tokens.get_token_position().column);
+        else {
+            pwOut.printf("%s: address = 0x%02X, gain = ", name, address);
+            pwOut << gain << '\n';
+        }
+        tokens.skip_line();
+    }
+
+    return 0;
+}
@@ -29,10 +29,19 @@ unsigned char _sd_firstByteResponse;
 
 extern "C" {
 
+#ifdef __PROPELLER__
 int _cfg_rxpin    = -1;
 int _cfg_txpin    = -1;
 int _cfg_baudrate = -1;
+#else
+// Nothing patches these on a PC, so the host model uses the standard Propeller serial pins
+int _cfg_rxpin    = 31;
+int _cfg_txpin    = 30;
+int _cfg_baudrate = 115200;
+#endif
 
+// Support for the C++ runtime; a PC has its own
+#ifdef __PROPELLER__
 void __cxa_pure_virtual () {
     // TODO: Provide some cool way for the user to enter their own error code
     while (1) {
@@ -51,5 +60,6 @@ void *__dso_handle = 0;
 int __cxa_atexit (void (*destructor) (void *), void *arg, void *dso) {
     return 0;
 }
+#endif
 
 }
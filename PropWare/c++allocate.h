@@ -3,6 +3,9 @@
 #include <stdlib.h>
 #include <new>
 
+// A PC's C++ runtime provides all of this, and sanitizers rely on its allocator
+#ifdef __PROPELLER__
+
 std::new_handler __new_handler;
 
 void *
@@ -49,3 +52,5 @@ std::new_handler std::set_new_handler (std::new_handler handler) {
     __new_handler = handler;
     return prev_handler;
 }
+
+#endif
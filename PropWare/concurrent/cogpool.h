@@ -0,0 +1,369 @@
+/**
+ * @file        PropWare/concurrent/cogpool.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <type_traits>
+#include <PropWare/concurrent/runnable.h>
+#include <PropWare/concurrent/latch.h>
+#include <PropWare/concurrent/lockservice.h>
+#include <PropWare/utility/collection/queue.h>
+
+namespace PropWare {
+
+/**
+ * @brief   A function and its argument, queued for execution by a PropWare::CogPool
+ */
+struct Task {
+    /** Function to be run by a worker cog */
+    void (*function) (void *context);
+    /** Argument for `function` */
+    void  *context;
+    /** Counted down after `function` returns; may be NULL */
+    Latch *latch;
+};
+
+/**
+ * @brief   Worker cogs which are started once and then run any number of short tasks
+ *
+ * Starting a cog costs a few thousand clock cycles and a stack that is only in use while the cog runs. For bursty
+ * parallel work - processing chunks of a buffer, filtering several channels, and so on - a pool keeps its worker cogs
+ * running and hands them PropWare::Task objects through a shared queue instead.
+ *
+ * @code
+ * static uint32_t       stacks[4][128];
+ * static PropWare::Task tasks[16];
+ *
+ * void square (const uint32_t begin, const uint32_t end, void *context) {
+ *     int32_t *samples = static_cast<int32_t *>(context);
+ *     for (uint32_t i = begin; i < end; ++i)
+ *         samples[i] *= samples[i];
+ * }
+ *
+ * int main () {
+ *     PropWare::CogPool pool(stacks, tasks);
+ *     pool.start();
+ *
+ *     // Split the indices among the four workers and this cog, and return once all are done
+ *     pool.parallel_for(0, SAMPLE_COUNT, square, samples);
+ * }
+ * @endcode
+ *
+ * A cog which waits through PropWare::CogPool::wait or PropWare::CogPool::parallel_for runs queued tasks itself while
+ * it waits, so tasks may submit and wait for tasks of their own without deadlocking the pool, and a pool works (on
+ * one cog) even before it is started.
+ *
+ * Idle workers check the queue less and less often, backing off as PropWare::Queue::back_off does, so that a pool
+ * which sits idle does not slow down every other software lock. After a quiet spell, a new task may therefore wait up
+ * to PropWare::Queue::MAX_BACKOFF clock cycles before a worker picks it up, unless the submitting cog runs it first.
+ */
+class CogPool {
+    public:
+        /** Most workers a pool can have: every cog but the one which starts them */
+        static const unsigned int MAX_WORKERS = 7;
+
+        /**
+         * @brief   Function run by PropWare::CogPool::parallel_for on a range of indices
+         *
+         * @param[in]   begin   First index of the range
+         * @param[in]   end     One past the last index of the range
+         * @param[in]   context Pointer passed to PropWare::CogPool::parallel_for
+         */
+        typedef void (*RangeFunction) (const uint32_t begin, const uint32_t end, void *context);
+
+    public:
+        /**
+         * @brief       Construct a pool; no cog is started until PropWare::CogPool::start is called
+         *
+         * @param[in]   stacks  Statically allocated array, NOT a pointer, with one stack for each worker. Its first
+         *                      dimension sets the number of workers
+         * @param[in]   tasks   Statically allocated array, NOT a pointer, used for the queue of tasks waiting for a
+         *                      worker
+         */
+        template<size_t WORKERS, size_t STACK_LENGTH, size_t QUEUE_LENGTH>
+        CogPool (uint32_t (&stacks)[WORKERS][STACK_LENGTH], Task (&tasks)[QUEUE_LENGTH])
+                : m_tasks(tasks),
+                  m_workerCount(WORKERS),
+                  m_stopping(false) {
+            static_assert(0 < WORKERS && MAX_WORKERS >= WORKERS, "A pool must have between 1 and 7 workers");
+            for (unsigned int i = 0; i < WORKERS; ++i)
+                this->m_workers[i].configure(*this, stacks[i], STACK_LENGTH);
+        }
+
+        /**
+         * @brief   Stop the workers, if they are running
+         */
+        ~CogPool () {
+            this->stop();
+        }
+
+        /**
+         * @brief   Start every worker cog
+         *
+         * @return  Number of workers that were started, which is less than requested if the chip ran out of cogs
+         */
+        unsigned int start () {
+            unsigned int started = 0;
+
+            this->m_stopping = false;
+            for (unsigned int i = 0; i < this->m_workerCount; ++i)
+                if (!this->m_workers[i].m_running) {
+                    this->m_workers[i].m_running = true;
+                    if (0 <= Runnable::invoke(this->m_workers[i]))
+                        ++started;
+                    else
+                        this->m_workers[i].m_running = false;
+                }
+            return started;
+        }
+
+        /**
+         * @brief   Let each worker finish the task it is running, then stop all of them
+         *
+         * Tasks which are still queued stay queued and run once the pool is started again (or by any cog waiting on
+         * the pool).
+         */
+        void stop () {
+            this->m_stopping = true;
+            for (unsigned int i = 0; i < this->m_workerCount; ++i)
+                while (this->m_workers[i].m_running);
+        }
+
+        /**
+         * @brief   Number of workers the pool was constructed with
+         */
+        unsigned int get_worker_count () const {
+            return this->m_workerCount;
+        }
+
+        /**
+         * @brief   One of the worker cogs, such as for watching its stack with PropWare::StackMonitor
+         */
+        const Runnable &get_worker (const unsigned int index) const {
+            return this->m_workers[index];
+        }
+
+        /**
+         * @brief   Number of tasks waiting for a worker
+         */
+        size_t get_pending_count () const {
+            return this->m_tasks.size();
+        }
+
+        /**
+         * @brief       Queue a task
+         *
+         * While the queue is full, the calling cog runs queued tasks itself to make room.
+         *
+         * @param[in]   task    Task to run. If its latch is not NULL, it is counted down once the task has finished
+         */
+        void submit (const Task &task) {
+            while (!this->try_submit(task))
+                this->run_pending_task();
+        }
+
+        /**
+         * @brief       Queue `function(context)`
+         *
+         * @param[in]   function    Function to run
+         * @param[in]   context     Argument for `function`
+         * @param[in]   latch       Counted down once `function` has returned; may be NULL
+         */
+        void submit (void (*function) (void *context), void *context, Latch *latch = NULL) {
+            const Task task = {function, context, latch};
+            this->submit(task);
+        }
+
+        /**
+         * @brief       Queue a task only if there is room for it
+         *
+         * @return      True if the task was queued
+         */
+        bool try_submit (const Task &task) {
+            return this->m_tasks.enqueue_n(&task, 1);
+        }
+
+        /**
+         * @brief   Run one queued task on the calling cog, if there is one
+         *
+         * @return  True if a task was run
+         */
+        bool run_pending_task () {
+            Task task;
+            if (this->m_tasks.try_dequeue(task)) {
+                execute(task);
+                return true;
+            } else
+                return false;
+        }
+
+        /**
+         * @brief       Wait for a latch to be released, running queued tasks on the calling cog in the meantime
+         */
+        void wait (const Latch &latch) {
+            while (!latch.is_released())
+                this->run_pending_task();
+            memory_barrier();
+        }
+
+        /**
+         * @brief       Run `function` over the indices `[begin, end)`, split into one contiguous range per worker plus
+         *              one for the calling cog, and return once every range is done
+         *
+         * @param[in]   begin       First index
+         * @param[in]   end         One past the last index
+         * @param[in]   function    Run once for each range
+         * @param[in]   context     Passed to every call of `function`
+         */
+        void parallel_for (const uint32_t begin, const uint32_t end, const RangeFunction function, void *context) {
+            this->split(begin, end, function, context);
+        }
+
+        /**
+         * @brief       Run any callable object over the indices `[begin, end)`, as `callable(rangeBegin, rangeEnd)`
+         *
+         * The object, such as a lambda expression with captures, stays where it is: every range refers to it, which
+         * is safe because this call does not return before all ranges are done.
+         *
+         * @see PropWare::CogPool::parallel_for(const uint32_t, const uint32_t, const RangeFunction, void *)
+         */
+        template<typename Callable>
+        void parallel_for (const uint32_t begin, const uint32_t end, Callable &&callable) {
+            typedef typename std::remove_reference<Callable>::type CallableType;
+            this->split(begin, end, call_callable<CallableType>, (void *) &callable);
+        }
+
+    protected:
+        typedef Queue<Task, TicketLock> TaskQueue;
+
+        /**
+         * @brief   Loop run by each worker cog
+         */
+        class Worker : public Runnable {
+            public:
+                Worker ()
+                        : Runnable(NULL, 0),
+                          m_pool(NULL),
+                          m_running(false) {
+                }
+
+                void configure (CogPool &pool, const uint32_t *stack, const size_t stackLength) {
+                    this->m_pool             = &pool;
+                    this->m_stackPointer     = stack;
+                    this->m_stackSizeInBytes = stackLength * sizeof(uint32_t);
+                }
+
+                void run () {
+                    unsigned int attempts = 0;
+                    uint32_t     delay    = TaskQueue::MIN_BACKOFF;
+
+                    while (!this->m_pool->m_stopping) {
+                        // An idle worker only reads the queue's size, and less and less often, so that it stays off
+                        // the hardware lock shared by every software lock in the application
+                        if (this->m_pool->m_tasks.is_empty())
+                            TaskQueue::back_off(attempts, delay);
+                        else if (this->m_pool->run_pending_task()) {
+                            attempts = 0;
+                            delay    = TaskQueue::MIN_BACKOFF;
+                        }
+                    }
+
+                    this->m_running = false;
+                    cogstop(cogid());
+                }
+
+            public:
+                CogPool       *m_pool;
+                volatile bool m_running;
+        };
+
+        struct Chunk {
+            RangeFunction function;
+            void          *context;
+            uint32_t      begin;
+            uint32_t      end;
+        };
+
+    protected:
+        void split (const uint32_t begin, const uint32_t end, const RangeFunction function, void *context) {
+            if (begin >= end)
+                return;
+
+            const uint32_t length = end - begin;
+            const uint32_t parts  = length < this->m_workerCount + 1 ? length : this->m_workerCount + 1;
+            const uint32_t size   = length / parts;
+            uint32_t       extra  = length - size * parts;
+
+            // The chunks live on this cog's stack, which is safe because nothing returns before the latch is released
+            Chunk    chunks[MAX_WORKERS + 1];
+            Latch    done(parts - 1);
+            uint32_t next = begin;
+            for (uint32_t i = 0; i < parts; ++i) {
+                chunks[i].function = function;
+                chunks[i].context  = context;
+                chunks[i].begin    = next;
+                next += size;
+                if (extra) {
+                    ++next;
+                    --extra;
+                }
+                chunks[i].end = next;
+            }
+
+            for (uint32_t i = 1; i < parts; ++i)
+                this->submit(run_chunk, &chunks[i], &done);
+            run_chunk(&chunks[0]);
+            this->wait(done);
+        }
+
+        static void execute (const Task &task) {
+            task.function(task.context);
+            if (task.latch)
+                task.latch->count_down();
+        }
+
+        static void run_chunk (void *context) {
+            const Chunk *chunk = static_cast<const Chunk *>(context);
+            chunk->function(chunk->begin, chunk->end, chunk->context);
+        }
+
+        template<typename Callable>
+        static void call_callable (const uint32_t begin, const uint32_t end, void *target) {
+            (*static_cast<Callable *>(target))(begin, end);
+        }
+
+    private:
+        // Copies would share the workers' stacks
+        CogPool (const CogPool &other);
+        CogPool &operator= (const CogPool &other);
+
+    protected:
+        TaskQueue          m_tasks;
+        const unsigned int m_workerCount;
+        volatile bool      m_stopping;
+        Worker             m_workers[MAX_WORKERS];
+};
+
+}
@@ -0,0 +1,382 @@
+/**
+ * @file        PropWare/concurrent/fiber.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <PropWare/concurrent/propellerclock.h>
+
+/**
+ * @brief   Start the body of PropWare::Fiber::run; must be its first statement
+ */
+#define PW_FIBER_BEGIN() \
+    switch (this->m_resumePoint) { \
+        case 0:
+
+/**
+ * @brief   End the body of PropWare::Fiber::run; the fiber is finished once it gets here
+ */
+#define PW_FIBER_END() \
+    } \
+    this->finish()
+
+/** @cond DOXYGEN_IGNORE */
+#define PW_FIBER_SUSPEND() \
+    this->m_resumePoint = __LINE__; \
+    return; \
+    case __LINE__:
+/** @endcond */
+
+/**
+ * @brief   Let every other ready fiber run, then continue
+ */
+#define PW_YIELD() \
+    do { \
+        this->yield(); \
+        PW_FIBER_SUSPEND(); \
+    } while (0)
+
+/**
+ * @brief   Continue once the system counter reaches `deadline` (a value of `CNT`)
+ *
+ * Adding a fixed period to the previous deadline, rather than to the current time, gives a loop that does not drift.
+ */
+#define PW_SLEEP_UNTIL(deadline) \
+    do { \
+        this->sleep_until(deadline); \
+        PW_FIBER_SUSPEND(); \
+    } while (0)
+
+/**
+ * @brief   Continue once `(INA & mask) == state`
+ */
+#define PW_WAIT_PIN(mask, state) \
+    do { \
+        this->wait_pin(mask, state); \
+        PW_FIBER_SUSPEND(); \
+    } while (0)
+
+/**
+ * @brief   Continue once `condition` is true; it is checked each time the fiber's turn comes around
+ */
+#define PW_WAIT_UNTIL(condition) \
+    do { \
+        this->m_resumePoint = __LINE__; \
+        case __LINE__: \
+        if (!(condition)) { \
+            this->yield(); \
+            return; \
+        } \
+    } while (0)
+
+namespace PropWare {
+
+template<typename Clock>
+class FiberScheduler;
+
+/**
+ * @brief   A lightweight task which shares a cog with other fibers, for the many jobs that spend most of their time
+ *          waiting
+ *
+ * Fibers are stackless: PropWare::Fiber::run returns to the scheduler every time the fiber waits, and picks up where
+ * it left off on its next turn. A fiber costs a few longs rather than a cog and a stack, so a single cog can run dozens
+ * of them. Because the stack is unwound at every wait, anything which must survive a wait belongs in a member
+ * variable rather than a local one.
+ *
+ * @code
+ * class Blinker : public PropWare::Fiber {
+ *     public:
+ *         Blinker (const PropWare::Pin::Mask mask, const uint32_t period)
+ *                 : m_pin(mask, PropWare::Pin::Dir::OUT),
+ *                   m_period(period) {
+ *         }
+ *
+ *         void run () {
+ *             PW_FIBER_BEGIN();
+ *             this->m_deadline = CNT;
+ *             while (1) {
+ *                 this->m_pin.toggle();
+ *                 this->m_deadline += this->m_period;
+ *                 PW_SLEEP_UNTIL(this->m_deadline);
+ *             }
+ *             PW_FIBER_END();
+ *         }
+ *
+ *     private:
+ *         const PropWare::Pin m_pin;
+ *         const uint32_t      m_period;
+ *         uint32_t            m_deadline;
+ * };
+ * @endcode
+ *
+ * The body of `run()` must begin with PW_FIBER_BEGIN and end with PW_FIBER_END, and it may wait with PW_YIELD,
+ * PW_SLEEP_UNTIL, PW_WAIT_PIN and PW_WAIT_UNTIL anywhere between them, including inside loops. The macros are built on
+ * a `switch` statement, so the body may not contain a `switch` of its own around a wait, and no two waits may share a
+ * line.
+ */
+class Fiber {
+    public:
+        typedef enum {
+            /** Waiting for its turn to run */
+            READY,
+            /** Waiting for the system counter to reach a deadline */
+            SLEEPING,
+            /** Waiting for a pin state */
+            WAITING_FOR_PIN,
+            /** Ran to the end of its body; it will never run again */
+            FINISHED
+        } State;
+
+    public:
+        /**
+         * @brief   Body of the fiber, resumed by the scheduler each time it is the fiber's turn
+         */
+        virtual void run () = 0;
+
+        State get_state () const {
+            return this->m_state;
+        }
+
+        /**
+         * @brief   Value of `CNT` at which a sleeping fiber becomes ready
+         */
+        uint32_t get_deadline () const {
+            return this->m_deadline;
+        }
+
+    protected:
+        Fiber ()
+                : m_resumePoint(0),
+                  m_state(READY),
+                  m_deadline(0),
+                  m_pinMask(0),
+                  m_pinState(0),
+                  m_next(NULL) {
+        }
+
+        /**
+         * @brief   Prefer PW_YIELD, which also suspends the fiber
+         */
+        void yield () {
+            this->m_state = READY;
+        }
+
+        /**
+         * @brief   Prefer PW_SLEEP_UNTIL, which also suspends the fiber
+         */
+        void sleep_until (const uint32_t deadline) {
+            this->m_state    = SLEEPING;
+            this->m_deadline = deadline;
+        }
+
+        /**
+         * @brief   Prefer PW_WAIT_PIN, which also suspends the fiber
+         */
+        void wait_pin (const uint32_t mask, const uint32_t state) {
+            this->m_state    = WAITING_FOR_PIN;
+            this->m_pinMask  = mask;
+            this->m_pinState = state & mask;
+        }
+
+        void finish () {
+            this->m_state = FINISHED;
+        }
+
+    protected:
+        int      m_resumePoint;
+        State    m_state;
+        uint32_t m_deadline;
+        uint32_t m_pinMask;
+        uint32_t m_pinState;
+        Fiber    *m_next;
+
+        template<typename Clock>
+        friend class FiberScheduler;
+};
+
+/**
+ * @brief   Cooperative scheduler which runs any number of PropWare::Fiber instances inside the cog that calls
+ *          PropWare::FiberScheduler::run
+ *
+ * Ready fibers take turns in the order they became ready. Sleeping fibers are kept sorted by deadline, so only the
+ * earliest one is compared against the clock on each pass, and fibers waiting for pins are checked against a single
+ * read of `INA`. When nothing is ready and no fiber waits for a pin, the cog sleeps with `waitcnt` until the earliest
+ * deadline.
+ *
+ * @code
+ * Blinker fast(PropWare::Pin::Mask::P16, 100 * MILLISECOND);
+ * Blinker slow(PropWare::Pin::Mask::P17, 500 * MILLISECOND);
+ *
+ * PropWare::FiberScheduler<> scheduler;
+ * scheduler.add(fast);
+ * scheduler.add(slow);
+ * scheduler.run();
+ * @endcode
+ *
+ * @tparam  Clock   Source of the time and the pin states, with static `uint32_t now()`, `uint32_t read_pins()` and
+ *                  `void wait_until(uint32_t deadline)`. The default is the real hardware; unit tests on a PC supply a
+ *                  simulated clock instead
+ */
+template<typename Clock = PropellerClock>
+class FiberScheduler {
+    public:
+        FiberScheduler ()
+                : m_ready(NULL),
+                  m_readyTail(NULL),
+                  m_sleeping(NULL),
+                  m_waiting(NULL),
+                  m_count(0) {
+        }
+
+        /**
+         * @brief       Add a fiber; it runs for the first time on its next turn
+         *
+         * @pre         The fiber must not already belong to a scheduler
+         */
+        void add (Fiber &fiber) {
+            fiber.m_resumePoint = 0;
+            fiber.m_state       = Fiber::READY;
+            ++this->m_count;
+            this->push_ready(&fiber);
+        }
+
+        /**
+         * @brief   Number of fibers which have not finished
+         */
+        size_t get_fiber_count () const {
+            return this->m_count;
+        }
+
+        /**
+         * @brief   Run fibers until every one of them has finished
+         */
+        void run () {
+            while (this->m_count)
+                if (!this->run_once())
+                    this->idle();
+        }
+
+        /**
+         * @brief   Wake any fibers whose wait is over, then give one ready fiber its turn
+         *
+         * @return  True if a fiber ran, false if none was ready
+         */
+        bool run_once () {
+            this->wake_sleepers();
+            this->wake_pin_waiters();
+
+            Fiber *fiber = this->m_ready;
+            if (NULL == fiber)
+                return false;
+
+            this->m_ready = fiber->m_next;
+            if (NULL == this->m_ready)
+                this->m_readyTail = NULL;
+
+            fiber->run();
+
+            switch (fiber->m_state) {
+                case Fiber::READY:
+                    this->push_ready(fiber);
+                    break;
+                case Fiber::SLEEPING:
+                    this->insert_sleeper(fiber);
+                    break;
+                case Fiber::WAITING_FOR_PIN:
+                    fiber->m_next   = this->m_waiting;
+                    this->m_waiting = fiber;
+                    break;
+                default:
+                    --this->m_count;
+            }
+            return true;
+        }
+
+    protected:
+        /**
+         * @brief   Nothing is ready: sleep until the earliest deadline, unless a fiber is polling a pin
+         */
+        void idle () {
+            if (NULL == this->m_waiting && NULL != this->m_sleeping)
+                Clock::wait_until(this->m_sleeping->m_deadline);
+        }
+
+        void push_ready (Fiber *fiber) {
+            fiber->m_next = NULL;
+            if (NULL == this->m_readyTail)
+                this->m_ready = fiber;
+            else
+                this->m_readyTail->m_next = fiber;
+            this->m_readyTail = fiber;
+        }
+
+        /**
+         * @brief   Keep sleepers sorted by deadline; fibers with equal deadlines wake in the order they went to sleep
+         */
+        void insert_sleeper (Fiber *fiber) {
+            Fiber **link = &this->m_sleeping;
+            while (NULL != *link && 0 <= (int32_t) (fiber->m_deadline - (*link)->m_deadline))
+                link = &(*link)->m_next;
+            fiber->m_next = *link;
+            *link = fiber;
+        }
+
+        void wake_sleepers () {
+            const uint32_t now = Clock::now();
+            while (NULL != this->m_sleeping && 0 <= (int32_t) (now - this->m_sleeping->m_deadline)) {
+                Fiber *fiber = this->m_sleeping;
+                this->m_sleeping = fiber->m_next;
+                fiber->m_state   = Fiber::READY;
+                this->push_ready(fiber);
+            }
+        }
+
+        void wake_pin_waiters () {
+            if (NULL == this->m_waiting)
+                return;
+
+            const uint32_t pins = Clock::read_pins();
+            Fiber          **link = &this->m_waiting;
+            while (NULL != *link) {
+                Fiber *fiber = *link;
+                if ((pins & fiber->m_pinMask) == fiber->m_pinState) {
+                    *link = fiber->m_next;
+                    fiber->m_state = Fiber::READY;
+                    this->push_ready(fiber);
+                } else
+                    link = &fiber->m_next;
+            }
+        }
+
+    protected:
+        Fiber  *m_ready;
+        Fiber  *m_readyTail;
+        Fiber  *m_sleeping;
+        Fiber  *m_waiting;
+        size_t m_count;
+};
+
+}
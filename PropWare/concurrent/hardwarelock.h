@@ -0,0 +1,154 @@
+/**
+ * @file        PropWare/concurrent/hardwarelock.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <propeller.h>
+
+// Need to include this since PropWare.h is not imported
+#ifdef __PROPELLER_COG__
+#define PropWare PropWare_cog
+#endif
+
+namespace PropWare {
+
+/**
+ * @brief   One of the Propeller's eight hardware locks
+ *
+ * This is the fastest lock available: PropWare::HardwareLock::lock is a single `lockset` per attempt. There are only
+ * eight of them though, and `locknew` returns -1 once they are gone - after which every cog "acquires" lock -1 and
+ * nothing is protected. When an application needs more than a handful of locks, use the software locks in
+ * PropWare/concurrent/lockservice.h, which all share a single hardware lock.
+ *
+ * Along with PropWare::TicketLock and PropWare::ReadWriteLock, this class provides `lock()`, `try_lock()` and
+ * `unlock()` and can be used as the lock policy of PropWare::Queue or wherever a PropWare::LockReference is accepted.
+ * None of them use virtual functions, so an instance may be shared with code compiled for the cog memory model.
+ */
+class HardwareLock {
+    public:
+        /** Lock number used to mark an instance that does not own a hardware lock */
+        static const int NONE = -1;
+
+    public:
+        /**
+         * @brief   Allocate a new hardware lock
+         *
+         * Check PropWare::HardwareLock::is_valid to know if all eight were already in use.
+         */
+        HardwareLock ()
+                : m_lockNumber(locknew()) {
+            if (this->is_valid())
+                lockclr(this->m_lockNumber);
+        }
+
+        /**
+         * @brief       Take ownership of a hardware lock which was allocated elsewhere
+         *
+         * @param[in]   lockNumber  Lock returned by `locknew()`; it will be returned with `lockret()` when this
+         *                          instance is destroyed. PropWare::HardwareLock::NONE creates an empty instance
+         */
+        explicit HardwareLock (const int lockNumber)
+                : m_lockNumber(lockNumber) {
+            if (this->is_valid())
+                lockclr(this->m_lockNumber);
+        }
+
+        /**
+         * @brief   Return the hardware lock to the pool
+         */
+        ~HardwareLock () {
+            this->release();
+        }
+
+        /**
+         * @brief   Determine if this instance owns a hardware lock
+         */
+        bool is_valid () const {
+            return NONE != this->m_lockNumber;
+        }
+
+        /**
+         * @brief   Lock number, as passed to `lockset()` and `lockclr()`
+         */
+        int get_lock_number () const {
+            return this->m_lockNumber;
+        }
+
+        /**
+         * @brief   Wait for any other cog to unlock, then return the hardware lock and allocate a new one
+         *
+         * @return  True if a new lock was allocated
+         */
+        bool reallocate () {
+            if (this->is_valid()) {
+                this->lock();
+                this->release();
+            }
+
+            this->m_lockNumber = locknew();
+            if (this->is_valid())
+                lockclr(this->m_lockNumber);
+            return this->is_valid();
+        }
+
+        /**
+         * @brief   Spin until the lock is acquired
+         */
+        void lock () {
+            while (lockset(this->m_lockNumber));
+        }
+
+        /**
+         * @brief   Acquire the lock only if no other cog holds it
+         *
+         * @return  True if the lock was acquired
+         */
+        bool try_lock () {
+            return !lockset(this->m_lockNumber);
+        }
+
+        void unlock () {
+            lockclr(this->m_lockNumber);
+        }
+
+    protected:
+        void release () {
+            if (this->is_valid()) {
+                lockclr(this->m_lockNumber);
+                lockret(this->m_lockNumber);
+                this->m_lockNumber = NONE;
+            }
+        }
+
+    private:
+        // Two instances must never return the same hardware lock
+        HardwareLock (const HardwareLock &other);
+        HardwareLock &operator= (const HardwareLock &other);
+
+    protected:
+        int m_lockNumber;
+};
+
+}
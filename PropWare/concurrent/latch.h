@@ -0,0 +1,116 @@
+/**
+ * @file        PropWare/concurrent/latch.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <PropWare/concurrent/lockservice.h>
+
+namespace PropWare {
+
+/**
+ * @brief   One-shot countdown: any number of cogs wait until a count of events has occurred
+ *
+ * Typically, a cog which hands out N pieces of work creates a latch with a count of N, every piece ends with
+ * PropWare::Latch::count_down and the cog then calls PropWare::Latch::wait to know that all of them are finished.
+ *
+ * @code
+ * PropWare::Latch done(2);
+ * pool.submit(filter_left, &leftChannel, &done);
+ * pool.submit(filter_right, &rightChannel, &done);
+ * pool.wait(done);
+ * @endcode
+ *
+ * The count is decremented under the hardware lock of PropWare::LockService, so a latch is as cheap to create as any
+ * other software lock and may live on the stack of the cog which waits for it.
+ */
+class Latch {
+    public:
+        /**
+         * Check PropWare::Latch::is_valid to know if the shared hardware lock could be allocated.
+         *
+         * @param[in]   count   Number of calls to PropWare::Latch::count_down before waiting cogs are released
+         */
+        explicit Latch (const uint32_t count)
+                : m_serviceLock(LockService::get_lock()),
+                  m_count(count) {
+        }
+
+        /**
+         * @brief   Determine if this latch has a hardware lock to build on; one which does not must not be used
+         */
+        bool is_valid () const {
+            return HardwareLock::NONE != this->m_serviceLock;
+        }
+
+        /**
+         * @brief   Record one event, releasing the waiting cogs if it was the last one
+         *
+         * Any memory written before this call is visible to cogs released by it.
+         */
+        void count_down () {
+            memory_barrier();
+            while (lockset(this->m_serviceLock));
+            this->m_count = this->m_count - 1;
+            lockclr(this->m_serviceLock);
+        }
+
+        /**
+         * @brief   Determine if every event has occurred
+         */
+        bool is_released () const {
+            return !this->m_count;
+        }
+
+        /**
+         * @brief   Spin until every event has occurred
+         */
+        void wait () const {
+            while (this->m_count);
+            memory_barrier();
+        }
+
+        /**
+         * @brief   Number of events still expected
+         */
+        uint32_t get_count () const {
+            return this->m_count;
+        }
+
+        /**
+         * @brief       Reuse the latch for another round of events
+         *
+         * @pre         No cog may be counting down or waiting
+         */
+        void reset (const uint32_t count) {
+            this->m_count = count;
+        }
+
+    protected:
+        const int         m_serviceLock;
+        volatile uint32_t m_count;
+};
+
+}
@@ -0,0 +1,105 @@
+/**
+ * @file        PropWare/concurrent/lockreference.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Non-owning reference to any lock with `lock()` and `unlock()` methods
+ *
+ * Classes which are not templates, such as PropWare::SynchronousPrinter and PropWare::FullDuplexSerial, accept a
+ * LockReference so that the application chooses the kind of lock they use: a PropWare::HardwareLock, a
+ * PropWare::TicketLock, a PropWare::ReadWriteLock, or any class of its own. Every lock converts implicitly:
+ *
+ * @code
+ * PropWare::TicketLock         printerLock;
+ * PropWare::SynchronousPrinter syncOut(pwOut, printerLock);
+ * @endcode
+ *
+ * The referenced lock must outlive the LockReference. Calls go through a function pointer rather than a virtual
+ * function so that the locks themselves stay free of a vtable.
+ */
+class LockReference {
+    public:
+        /**
+         * @brief   A reference to no lock at all; see PropWare::LockReference::is_bound
+         */
+        LockReference ()
+                : m_lock(NULL),
+                  m_acquire(NULL),
+                  m_release(NULL) {
+        }
+
+        template<typename Lock>
+        LockReference (Lock &lock)
+                : m_lock(&lock),
+                  m_acquire(&acquire<Lock>),
+                  m_release(&release<Lock>) {
+        }
+
+        /**
+         * @brief   Determine if this instance refers to a lock
+         */
+        bool is_bound () const {
+            return NULL != this->m_lock;
+        }
+
+        /**
+         * @brief   Determine if this instance refers to a particular lock
+         */
+        template<typename Lock>
+        bool refers_to (const Lock &lock) const {
+            return &lock == this->m_lock;
+        }
+
+        void lock () const {
+            this->m_acquire(this->m_lock);
+        }
+
+        void unlock () const {
+            this->m_release(this->m_lock);
+        }
+
+    protected:
+        template<typename Lock>
+        static void acquire (void *lock) {
+            static_cast<Lock *>(lock)->lock();
+        }
+
+        template<typename Lock>
+        static void release (void *lock) {
+            static_cast<Lock *>(lock)->unlock();
+        }
+
+    protected:
+        void *m_lock;
+        void (*m_acquire) (void *lock);
+        void (*m_release) (void *lock);
+};
+
+}
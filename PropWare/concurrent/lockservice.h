@@ -0,0 +1,345 @@
+/**
+ * @file        PropWare/concurrent/lockservice.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <PropWare/concurrent/hardwarelock.h>
+#include <PropWare/concurrent/memorybarrier.h>
+
+// Need to include this since PropWare.h is not imported
+#ifdef __PROPELLER_COG__
+#define PropWare PropWare_cog
+#endif
+
+namespace PropWare {
+
+/**
+ * @brief   Owner of the single hardware lock on which every software lock in PropWare is built
+ *
+ * The hub has no atomic read-modify-write instruction, so a software lock still needs a hardware lock for the few
+ * instructions that update its state. Those updates are so short that one hardware lock can serve any number of
+ * software locks: a cog holds it for a handful of hub accesses and never while waiting for the software lock itself.
+ * An application which uses only software locks consumes exactly one of the eight hardware locks.
+ *
+ * The hardware lock is allocated by the first software lock constructed. Software locks remember the lock number
+ * themselves, so construct them from the main program (not from code compiled for the cog memory model) before any
+ * other cog is started. If all eight hardware locks are already taken at that point, the software lock can not work:
+ * check `is_valid()` on the software lock, or PropWare::LockService::is_available before constructing any.
+ */
+class LockService {
+    public:
+        /**
+         * @brief   Number of the shared hardware lock, allocating it on the first call
+         *
+         * Only a successful allocation is remembered: after a failure, the next call tries `locknew` again.
+         *
+         * @return  Lock number, or PropWare::HardwareLock::NONE if all eight hardware locks are in use
+         */
+        static int get_lock () {
+            static int sharedLock = HardwareLock::NONE;
+
+            if (HardwareLock::NONE == sharedLock) {
+                const int lock = locknew();
+                if (HardwareLock::NONE != lock) {
+                    lockclr(lock);
+                    sharedLock = lock;
+                }
+            }
+            return sharedLock;
+        }
+
+        /**
+         * @brief   Determine if the shared hardware lock exists, allocating it if it does not yet
+         *
+         * @return  False if all eight hardware locks are in use, in which case no software lock can be constructed
+         */
+        static bool is_available () {
+            return HardwareLock::NONE != get_lock();
+        }
+};
+
+/**
+ * @brief   First-come, first-served software mutex
+ *
+ * Acquiring the lock takes a ticket - the shared hardware lock is held just long enough to increment a counter - and
+ * then waits, reading only this lock's own hub longs, until that ticket is served. Waiting cogs therefore do not
+ * compete for the shared hardware lock, and they are granted the lock in the order they asked for it, so no cog can
+ * starve. The cost is twelve bytes per lock and a few extra hub accesses per acquisition compared with a
+ * PropWare::HardwareLock.
+ *
+ * @code
+ * PropWare::TicketLock                       printerLock;
+ * PropWare::SynchronousPrinter               syncOut(pwOut, printerLock);
+ * PropWare::Queue<int, PropWare::TicketLock> samples(sampleBuffer);
+ * @endcode
+ *
+ * @see PropWare::LockService
+ */
+class TicketLock {
+    public:
+        /**
+         * Check PropWare::TicketLock::is_valid to know if the shared hardware lock could be allocated.
+         */
+        TicketLock ()
+                : m_serviceLock(LockService::get_lock()),
+                  m_next(0),
+                  m_serving(0) {
+        }
+
+        /**
+         * @brief   Determine if this lock has a hardware lock to build on; one which does not must not be used
+         */
+        bool is_valid () const {
+            return HardwareLock::NONE != this->m_serviceLock;
+        }
+
+        /**
+         * @brief   Wait until every cog which asked before this one has unlocked, then take the lock
+         */
+        void lock () {
+            while (lockset(this->m_serviceLock));
+            const uint32_t ticket = this->m_next;
+            this->m_next = ticket + 1;
+            lockclr(this->m_serviceLock);
+
+            while (ticket != this->m_serving);
+            memory_barrier();
+        }
+
+        /**
+         * @brief   Take the lock only if it is free and no other cog is waiting for it
+         *
+         * @return  True if the lock was acquired
+         */
+        bool try_lock () {
+            bool acquired = false;
+
+            while (lockset(this->m_serviceLock));
+            const uint32_t ticket = this->m_next;
+            if (ticket == this->m_serving) {
+                this->m_next = ticket + 1;
+                acquired = true;
+            }
+            lockclr(this->m_serviceLock);
+
+            memory_barrier();
+            return acquired;
+        }
+
+        /**
+         * @brief   Pass the lock to the next waiting cog, if any
+         *
+         * @pre     Must only be called by the cog which holds the lock
+         */
+        void unlock () {
+            // Only the holder ever writes this long, so the shared hardware lock is not needed
+            memory_barrier();
+            this->m_serving = this->m_serving + 1;
+        }
+
+        /**
+         * @brief   Determine if any cog holds the lock (or is about to)
+         */
+        bool is_locked () const {
+            return this->m_next != this->m_serving;
+        }
+
+    private:
+        // The counters are the lock: a copy would be a different lock
+        TicketLock (const TicketLock &other);
+        TicketLock &operator= (const TicketLock &other);
+
+    protected:
+        const int         m_serviceLock;
+        volatile uint32_t m_next;
+        volatile uint32_t m_serving;
+};
+
+/**
+ * @brief   Software lock which lets any number of readers in at once, or a single writer
+ *
+ * Use it for data which is read far more often than it is written, such as configuration or calibration tables:
+ * readers on different cogs do not wait for each other. A writer which is waiting keeps new readers out, so writers
+ * are never starved by a steady stream of readers (though readers can be starved by a steady stream of writers).
+ *
+ * `lock()`, `try_lock()` and `unlock()` take the lock for writing, so a PropWare::ReadWriteLock can also be used
+ * anywhere a plain mutex is expected.
+ *
+ * @code
+ * PropWare::ReadWriteLock calibrationLock;
+ *
+ * // Any number of cogs
+ * calibrationLock.lock_shared();
+ * const int offset = calibration.offset;
+ * calibrationLock.unlock_shared();
+ *
+ * // One cog at a time, with no readers
+ * calibrationLock.lock();
+ * calibration.offset = newOffset;
+ * calibrationLock.unlock();
+ * @endcode
+ *
+ * @see PropWare::LockService
+ */
+class ReadWriteLock {
+    public:
+        /**
+         * Check PropWare::ReadWriteLock::is_valid to know if the shared hardware lock could be allocated.
+         */
+        ReadWriteLock ()
+                : m_serviceLock(LockService::get_lock()),
+                  m_readers(0),
+                  m_writersWaiting(0) {
+        }
+
+        /**
+         * @brief   Determine if this lock has a hardware lock to build on; one which does not must not be used
+         */
+        bool is_valid () const {
+            return HardwareLock::NONE != this->m_serviceLock;
+        }
+
+        /**
+         * @brief   Wait for any writer to finish, then take the lock for reading
+         */
+        void lock_shared () {
+            while (!this->try_lock_shared()) {
+                // Wait without the shared hardware lock so that readers do not slow down every other software lock
+                while (this->m_writersWaiting || WRITER == this->m_readers);
+            }
+        }
+
+        /**
+         * @brief   Take the lock for reading only if no writer holds it or is waiting for it
+         *
+         * @return  True if the lock was acquired
+         */
+        bool try_lock_shared () {
+            bool acquired = false;
+
+            while (lockset(this->m_serviceLock));
+            if (!this->m_writersWaiting && WRITER != this->m_readers) {
+                this->m_readers = this->m_readers + 1;
+                acquired = true;
+            }
+            lockclr(this->m_serviceLock);
+
+            memory_barrier();
+            return acquired;
+        }
+
+        /**
+         * @pre     Must only be called by a cog which holds the lock for reading
+         */
+        void unlock_shared () {
+            memory_barrier();
+            while (lockset(this->m_serviceLock));
+            this->m_readers = this->m_readers - 1;
+            lockclr(this->m_serviceLock);
+        }
+
+        /**
+         * @brief   Wait for all readers and any other writer to finish, then take the lock for writing
+         */
+        void lock () {
+            while (lockset(this->m_serviceLock));
+            this->m_writersWaiting = this->m_writersWaiting + 1;
+            lockclr(this->m_serviceLock);
+
+            bool acquired;
+            do {
+                while (this->m_readers);
+
+                while (lockset(this->m_serviceLock));
+                acquired = !this->m_readers;
+                if (acquired) {
+                    this->m_readers        = WRITER;
+                    this->m_writersWaiting = this->m_writersWaiting - 1;
+                }
+                lockclr(this->m_serviceLock);
+            } while (!acquired);
+
+            memory_barrier();
+        }
+
+        /**
+         * @brief   Take the lock for writing only if no reader or writer holds it
+         *
+         * @return  True if the lock was acquired
+         */
+        bool try_lock () {
+            bool acquired = false;
+
+            while (lockset(this->m_serviceLock));
+            if (!this->m_readers) {
+                this->m_readers = WRITER;
+                acquired = true;
+            }
+            lockclr(this->m_serviceLock);
+
+            memory_barrier();
+            return acquired;
+        }
+
+        /**
+         * @pre     Must only be called by the cog which holds the lock for writing
+         */
+        void unlock () {
+            // No other cog writes the reader count while a writer holds the lock
+            memory_barrier();
+            this->m_readers = 0;
+        }
+
+        /**
+         * @brief   Number of cogs holding the lock for reading
+         */
+        int32_t get_reader_count () const {
+            const int32_t readers = this->m_readers;
+            return WRITER == readers ? 0 : readers;
+        }
+
+        /**
+         * @brief   Determine if a cog holds the lock for writing
+         */
+        bool is_write_locked () const {
+            return WRITER == this->m_readers;
+        }
+
+    protected:
+        /** Value of the reader count while a writer holds the lock */
+        static const int32_t WRITER = -1;
+
+    private:
+        ReadWriteLock (const ReadWriteLock &other);
+        ReadWriteLock &operator= (const ReadWriteLock &other);
+
+    protected:
+        const int        m_serviceLock;
+        volatile int32_t m_readers;
+        volatile uint8_t m_writersWaiting;
+};
+
+}
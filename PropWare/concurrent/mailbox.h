@@ -0,0 +1,283 @@
+/**
+ * @file        PropWare/concurrent/mailbox.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <PropWare/concurrent/memorybarrier.h>
+#include <PropWare/concurrent/propellerclock.h>
+
+namespace PropWare {
+
+template<typename Req, typename Resp, typename Clock>
+class Mailbox;
+
+/**
+ * @brief   Result of a request posted to a PropWare::Mailbox, which will be filled in by another cog
+ *
+ * A Future is a small handle - two pointers and a sequence number - and may be copied freely. The result it refers to
+ * lives in the mailbox slot, and stays there until the next request is posted to the same slot.
+ *
+ * @tparam  T       Type of the result
+ * @tparam  Clock   Source of the time for PropWare::Future::get with a timeout; see PropWare::PropellerClock
+ */
+template<typename T, typename Clock = PropellerClock>
+class Future {
+    public:
+        /**
+         * @brief   Construct a Future which refers to nothing and will never be ready
+         */
+        Future ()
+                : m_sequence(NULL),
+                  m_value(NULL),
+                  m_expected(0) {
+        }
+
+        /**
+         * @brief   Determine whether the Future refers to a request; PropWare::Mailbox::post returns an invalid Future
+         *          when the slot is busy
+         */
+        bool is_valid () const {
+            return NULL != this->m_sequence;
+        }
+
+        /**
+         * @brief   Determine, without waiting, whether the result has arrived
+         */
+        bool ready () const {
+            return NULL != this->m_sequence && this->m_expected == *this->m_sequence;
+        }
+
+        /**
+         * @brief   Wait for the result
+         *
+         * @pre     The Future must be valid
+         */
+        const T &get () const {
+            while (!this->ready());
+            memory_barrier();
+            return *this->m_value;
+        }
+
+        /**
+         * @brief       Wait for the result, giving up after a timeout
+         *
+         * @param[out]  result  Destination for the result; unmodified if it does not arrive in time
+         * @param[in]   timeout Clock ticks to wait before giving up
+         *
+         * @return      True if the result arrived in time
+         */
+        bool get (T &result, const uint32_t timeout) const {
+            const uint32_t start = Clock::now();
+            while (!this->ready())
+                if (!this->m_sequence || timeout <= Clock::now() - start)
+                    return false;
+            memory_barrier();
+            result = *this->m_value;
+            return true;
+        }
+
+    protected:
+        Future (const volatile uint32_t *sequence, const T *value, const uint32_t expected)
+                : m_sequence(sequence),
+                  m_value(value),
+                  m_expected(expected) {
+        }
+
+    protected:
+        const volatile uint32_t *m_sequence;
+        const T                 *m_value;
+        uint32_t                m_expected;
+
+        template<typename Req, typename Resp, typename C>
+        friend class Mailbox;
+};
+
+/**
+ * @brief   Hand requests to a server cog and collect its responses through hub RAM, without locks
+ *
+ * Each slot carries one request and one response at a time, plus a pair of sequence numbers: the client bumps the
+ * request number once the request is written, and the server copies it to the response number once the response is
+ * written. Neither side ever writes the other's number, so no hardware lock is needed - but each slot must only be
+ * used by one client cog at a time. Give every client its own slot (or guard a shared slot with a lock), and the
+ * server can work through all of them in turn.
+ *
+ * @code
+ * typedef PropWare::Mailbox<ReadRequest, int> SDMailbox;
+ *
+ * static SDMailbox::Slot slots[2];
+ * static SDMailbox       mailbox(slots);
+ *
+ * // In the client cog
+ * PropWare::Future<int> done = mailbox.post(request);
+ * ...                                                      // Do something useful in the meantime
+ * int err;
+ * if (!done.get(err, 100 * MILLISECOND))
+ *     handle_timeout();
+ *
+ * // In the server cog
+ * while (1)
+ *     mailbox.serve(read_sector);
+ * @endcode
+ *
+ * @tparam  Req     Request type; copied into the slot, so keep it small
+ * @tparam  Resp    Response type; copied into the slot
+ * @tparam  Clock   Source of the time for PropWare::Future::get with a timeout; see PropWare::PropellerClock
+ */
+template<typename Req, typename Resp, typename Clock = PropellerClock>
+class Mailbox {
+    public:
+        struct Slot {
+            /** Number of the most recent request; written by the client only */
+            volatile uint32_t requestSequence;
+            /** Number of the request most recently answered; written by the server only */
+            volatile uint32_t responseSequence;
+            Req               request;
+            Resp              response;
+        };
+
+    public:
+        /**
+         * @brief       Construct a mailbox
+         *
+         * @param[in]   slots[]     Statically allocated array, NOT a pointer, of slots shared by the client and server
+         */
+        template<size_t N>
+        Mailbox (Slot (&slots)[N])
+                : m_slots(slots),
+                  m_slotCount(N),
+                  m_nextSlot(0) {
+            for (size_t i = 0; i < N; ++i) {
+                slots[i].requestSequence  = 0;
+                slots[i].responseSequence = 0;
+            }
+        }
+
+        /**
+         * @brief   Number of slots in the mailbox
+         */
+        size_t get_slot_count () const {
+            return this->m_slotCount;
+        }
+
+        /**
+         * @brief   Determine if a slot's request is still waiting for a response
+         */
+        bool is_busy (const size_t slot = 0) const {
+            return this->m_slots[slot].requestSequence != this->m_slots[slot].responseSequence;
+        }
+
+        /**
+         * @brief       Post a request, without waiting for the server
+         *
+         * @param[in]   request     Request to be copied into the slot
+         * @param[in]   slot        Slot which belongs to the calling client
+         *
+         * @return      Future for the response, or an invalid Future if the slot's previous request is still pending
+         */
+        Future<Resp, Clock> post (const Req &request, const size_t slot = 0) {
+            Slot &s = this->m_slots[slot];
+            if (this->is_busy(slot))
+                return Future<Resp, Clock>();
+
+            const uint32_t sequence = s.requestSequence + 1;
+            s.request = request;
+            memory_barrier();
+            s.requestSequence = sequence;
+            return Future<Resp, Clock>(&s.responseSequence, &s.response, sequence);
+        }
+
+        /**
+         * @brief       Find the next pending request, visiting the slots in turn so that no client is starved
+         *
+         * Server side. Follow with PropWare::Mailbox::get_request and PropWare::Mailbox::respond.
+         *
+         * @param[out]  slot    Slot of the pending request
+         *
+         * @return      True if a request was pending
+         */
+        bool receive (size_t &slot) {
+            for (size_t i = 0; i < this->m_slotCount; ++i) {
+                const size_t candidate = this->m_nextSlot;
+                if (++this->m_nextSlot == this->m_slotCount)
+                    this->m_nextSlot = 0;
+                if (this->is_busy(candidate)) {
+                    memory_barrier();
+                    slot = candidate;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * @brief   Request waiting in a slot; server side, valid from PropWare::Mailbox::receive until
+         *          PropWare::Mailbox::respond
+         */
+        const Req &get_request (const size_t slot) const {
+            return this->m_slots[slot].request;
+        }
+
+        /**
+         * @brief       Answer the request in a slot; server side
+         */
+        void respond (const size_t slot, const Resp &response) {
+            Slot &s = this->m_slots[slot];
+            s.response = response;
+            memory_barrier();
+            s.responseSequence = s.requestSequence;
+        }
+
+        /**
+         * @brief       Answer one pending request, if there is one; server side
+         *
+         * @param[in]   handler     Function or function object which takes a `const Req &` and returns a `Resp`
+         *
+         * @return      True if a request was answered
+         */
+        template<typename Handler>
+        bool serve (Handler handler) {
+            size_t slot;
+            if (this->receive(slot)) {
+                this->respond(slot, handler(this->get_request(slot)));
+                return true;
+            } else
+                return false;
+        }
+
+    private:
+        // Copying a mailbox would leave two servers for the same slots
+        Mailbox (const Mailbox &);
+
+        Mailbox &operator= (const Mailbox &);
+
+    protected:
+        Slot         *m_slots;
+        const size_t m_slotCount;
+        size_t       m_nextSlot;
+};
+
+}
@@ -0,0 +1,54 @@
+/**
+ * @file        PropWare/concurrent/memorybarrier.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Need to include this since PropWare.h is not imported
+#ifdef __PROPELLER_COG__
+#define PropWare PropWare_cog
+#endif
+
+namespace PropWare {
+
+/**
+ * @brief   Keep memory accesses from being moved across the barrier, as seen by another cog
+ *
+ * Use it between writing shared data and publishing it (such as advancing an index or a sequence number, or releasing a
+ * lock), and between observing the publication and reading the data.
+ *
+ * Each cog's hub accesses take effect in program order, so on the Propeller only the compiler must be stopped from
+ * reordering them and the barrier costs no instructions. The host model runs cogs as threads, and a PC's processor may
+ * reorder memory accesses (ARM does; x86 only reorders a store with a later load), so there it is an acquire-release
+ * fence.
+ */
+inline void memory_barrier () {
+#ifdef __PROPELLER__
+    __asm__ __volatile__ ("" : : : "memory");
+#else
+    __atomic_thread_fence(__ATOMIC_ACQ_REL);
+#endif
+}
+
+}
@@ -0,0 +1,64 @@
+/**
+ * @file        PropWare/concurrent/propellerclock.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// Classes which take their time from a Clock parameter only touch the hardware through it, so they also build on a PC
+#ifdef __PROPELLER__
+#include <propeller.h>
+#endif
+
+namespace PropWare {
+
+#ifdef __PROPELLER__
+/**
+ * @brief   Time and pins of the real hardware, for classes such as PropWare::FiberScheduler and PropWare::Future
+ *
+ * Those classes take the clock as a template parameter so that unit tests on a PC can substitute a simulated one.
+ */
+struct PropellerClock {
+    /** Shortest delay that `waitcnt` can not miss in any memory model; shorter waits just spin */
+    static const uint32_t MIN_WAIT = 512;
+
+    static uint32_t now () {
+        return CNT;
+    }
+
+    static uint32_t read_pins () {
+        return INA;
+    }
+
+    static void wait_until (const uint32_t deadline) {
+        if ((int32_t) (deadline - CNT) > (int32_t) MIN_WAIT)
+            waitcnt(deadline);
+    }
+};
+#else
+struct PropellerClock;
+#endif
+
+}
@@ -71,8 +71,19 @@ namespace PropWare {
  *     while(1);
  * }
  * @endcode
+ *
+ * Stack sizes are hard to guess, so PropWare::Runnable::invoke fills the stack with PropWare::Runnable::STACK_CANARY
+ * before starting the cog. Any word still holding the pattern has never been touched, which lets
+ * PropWare::Runnable::get_stack_high_water_mark and PropWare::Runnable::get_stack_margin report how much of the stack
+ * the cog has needed so far. Run the application through its heaviest paths, then shrink the stack to the high-water
+ * mark plus a little headroom. PropWare::StackMonitor checks a set of Runnables periodically and reports any that run
+ * low.
  */
 class Runnable {
+    public:
+        /** Pattern written over the stack by PropWare::Runnable::invoke */
+        static const uint32_t STACK_CANARY = 0xDEADBEEF;
+
     public:
         /**
          * @brief       Start a new cog running the given object
@@ -85,6 +96,7 @@ class Runnable {
         static int8_t invoke(T &runnable) {
             static_assert(std::is_base_of<Runnable, T>::value,
                           "Only PropWare::Runnable and its children can be invoked");
+            runnable.paint_stack();
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpmf-conversions"
             return (int8_t) cogstart((void (*)(void *)) &T::run, (void *) &runnable,
@@ -98,6 +110,60 @@ class Runnable {
          */
         virtual void run() = 0;
 
+        /**
+         * @brief   Size of the stack, in bytes
+         */
+        size_t get_stack_size () const {
+            return this->m_stackSizeInBytes;
+        }
+
+        /**
+         * @brief   Determine whether the stack has been painted, which PropWare::Runnable::invoke does before starting
+         *          the cog; until then, nothing is known about the stack's use
+         */
+        bool is_stack_painted () const {
+            return this->m_stackPainted;
+        }
+
+        /**
+         * @brief   Number of bytes at the end of the stack which the cog has never touched
+         *
+         * Only meaningful once the Runnable has been started with PropWare::Runnable::invoke; before that, the whole
+         * stack is reported as spare. The scan starts at the lowest address, where the stack would overflow, and skips
+         * the words which PropGCC reserves there for the cog's thread state.
+         *
+         * @returns     Bytes to spare; zero means the stack has (very likely) overflowed
+         */
+        size_t get_stack_margin () const {
+            if (!this->m_stackPainted)
+                return this->m_stackSizeInBytes;
+
+            const uint32_t *word = this->m_stackPointer;
+            const uint32_t *end  = this->m_stackPointer + this->m_stackSizeInBytes / sizeof(uint32_t);
+
+            while (word < end && STACK_CANARY != *word)
+                ++word;
+            const uint32_t *untouched = word;
+            while (word < end && STACK_CANARY == *word)
+                ++word;
+            return (word - untouched) * sizeof(uint32_t);
+        }
+
+        /**
+         * @brief   Largest number of bytes of stack that the cog has used so far, including PropGCC's thread state
+         */
+        size_t get_stack_high_water_mark () const {
+            return this->m_stackSizeInBytes - this->get_stack_margin();
+        }
+
+        /**
+         * @brief   Determine whether the cog has used every word of its stack; always false for a stack which has not
+         *          been painted
+         */
+        bool has_stack_overflowed () const {
+            return this->m_stackPainted && 0 == this->get_stack_margin();
+        }
+
     protected:
         /**
          * @brief       Construct a new instance that runs on the given stack
@@ -107,7 +173,8 @@ class Runnable {
         template<size_t N>
         Runnable(const uint32_t (&stack)[N])
             : m_stackPointer(stack),
-              m_stackSizeInBytes(N * sizeof(uint32_t)) {
+              m_stackSizeInBytes(N * sizeof(uint32_t)),
+              m_stackPainted(false) {
         }
 
         /**
@@ -128,12 +195,25 @@ class Runnable {
          */
         Runnable(const uint32_t *stack, const size_t stackLength)
             : m_stackPointer(stack),
-              m_stackSizeInBytes(stackLength * sizeof(uint32_t)) {
+              m_stackSizeInBytes(stackLength * sizeof(uint32_t)),
+              m_stackPainted(false) {
+        }
+
+        /**
+         * @brief   Fill the stack with PropWare::Runnable::STACK_CANARY; must not be called while the cog is running
+         */
+        void paint_stack () {
+            uint32_t       *word = const_cast<uint32_t *>(this->m_stackPointer);
+            const uint32_t *end  = word + this->m_stackSizeInBytes / sizeof(uint32_t);
+            while (word < end)
+                *word++ = STACK_CANARY;
+            this->m_stackPainted = true;
         }
 
     protected:
         const uint32_t *m_stackPointer;
         size_t         m_stackSizeInBytes;
+        bool           m_stackPainted;
 };
 
 }
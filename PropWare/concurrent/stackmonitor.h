@@ -0,0 +1,154 @@
+/**
+ * @file        PropWare/concurrent/stackmonitor.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/concurrent/runnable.h>
+#include <PropWare/hmi/output/synchronousprinter.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Watch the stacks of other PropWare::Runnable instances from a cog of its own, and report any which run low
+ *
+ * Each stack is reported once, the first time its margin (see PropWare::Runnable::get_stack_margin) falls to the
+ * threshold or below. A stack which has already been overflowed will usually have corrupted whatever lies beneath it,
+ * so the report is a diagnosis rather than a rescue: set a threshold of a few longs to hear about trouble before it
+ * happens.
+ *
+ * @code
+ * static uint32_t                 monitorStack[48];
+ * static const PropWare::Runnable *watched[] = {&blinker, &logger};
+ * PropWare::StackMonitor           monitor(monitorStack, watched, 16);
+ *
+ * PropWare::Runnable::invoke(blinker);
+ * PropWare::Runnable::invoke(logger);
+ * PropWare::Runnable::invoke(monitor);
+ * ...
+ * monitor.print_report();
+ * @endcode
+ */
+class StackMonitor : public Runnable {
+    public:
+        /** Largest number of Runnables that a single monitor can watch */
+        static const size_t MAX_WATCHED = 32;
+
+    public:
+        /**
+         * @brief       Constructor
+         *
+         * @param[in]   stack[]         Stack for the monitor's own cog
+         * @param[in]   watched[]       Runnables to be watched; the array must outlive the monitor. A Runnable is
+         *                              only checked once it has been started with PropWare::Runnable::invoke
+         * @param[in]   minimumMargin   A stack is reported once its margin, in bytes, is this small or smaller
+         * @param[in]   printer         Destination for reports
+         * @param[in]   period          Clock ticks to sleep between each check of every stack
+         */
+        template<size_t N, size_t M>
+        StackMonitor (const uint32_t (&stack)[N], const Runnable *(&watched)[M], const size_t minimumMargin = 0,
+                      const SynchronousPrinter &printer = pwSyncOut, const uint32_t period = 10 * MILLISECOND)
+                : Runnable(stack),
+                  m_watched(watched),
+                  m_watchedCount(M),
+                  m_minimumMargin(minimumMargin),
+                  m_printer(&printer),
+                  m_period(period),
+                  m_reported(0) {
+            static_assert(MAX_WATCHED >= M, "A StackMonitor can watch no more than 32 Runnables");
+        }
+
+        void run () {
+            uint32_t timer = CNT;
+            while (1) {
+                this->check();
+                timer += this->m_period;
+                waitcnt(timer);
+            }
+        }
+
+        /**
+         * @brief   Check every stack once and report any which have newly run low; usable without starting a cog
+         *
+         * @return  Number of stacks reported by this call
+         */
+        unsigned int check () {
+            unsigned int reported = 0;
+            for (size_t i = 0; i < this->m_watchedCount; ++i) {
+                const uint32_t bit = 1U << i;
+                // A Runnable which has not been started yet is checked again next time
+                if (!(this->m_reported & bit) && this->m_watched[i]->is_stack_painted()) {
+                    const size_t margin = this->m_watched[i]->get_stack_margin();
+                    if (this->m_minimumMargin >= margin) {
+                        this->m_reported |= bit;
+                        ++reported;
+                        this->m_printer->printf("%s: stack of Runnable %u (0x%X) has %u of %u bytes left\n",
+                                                margin ? "WARNING" : "OVERFLOW", (unsigned int) i,
+                                                (unsigned int) (uintptr_t) this->m_watched[i], (unsigned int) margin,
+                                                (unsigned int) this->m_watched[i]->get_stack_size());
+                    }
+                }
+            }
+            return reported;
+        }
+
+        /**
+         * @brief   Determine whether a stack has been reported
+         *
+         * @param[in]   index   Index of the Runnable in the array given to the constructor
+         */
+        bool is_reported (const size_t index) const {
+            return this->m_reported & (1U << index);
+        }
+
+        /**
+         * @brief   Print the size, high-water mark and margin of every stack, for choosing stack sizes
+         *
+         * Runnables which have not been started yet show a dash instead of their use.
+         */
+        void print_report () const {
+            this->m_printer->printf("Runnable    Size    Used    Free\n");
+            for (size_t i = 0; i < this->m_watchedCount; ++i) {
+                const Runnable *runnable = this->m_watched[i];
+                if (runnable->is_stack_painted())
+                    this->m_printer->printf("%8u%8u%8u%8u\n", (unsigned int) i,
+                                            (unsigned int) runnable->get_stack_size(),
+                                            (unsigned int) runnable->get_stack_high_water_mark(),
+                                            (unsigned int) runnable->get_stack_margin());
+                else
+                    this->m_printer->printf("%8u%8u       -       -\n", (unsigned int) i,
+                                            (unsigned int) runnable->get_stack_size());
+            }
+        }
+
+    private:
+        const Runnable           **m_watched;
+        const size_t             m_watchedCount;
+        const size_t             m_minimumMargin;
+        const SynchronousPrinter *m_printer;
+        const uint32_t           m_period;
+        volatile uint32_t        m_reported;
+};
+
+}
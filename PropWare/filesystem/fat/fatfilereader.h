@@ -27,6 +27,7 @@
 
 #include <PropWare/filesystem/filereader.h>
 #include <PropWare/filesystem/fat/fatfile.h>
+#include <string.h>
 
 namespace PropWare {
 
@@ -109,6 +110,39 @@ class FatFileReader : virtual public FatFile, virtual public FileReader {
             return NO_ERROR;
         }
 
+        /**
+         * @brief       Copy up to `maxLength` characters straight out of the sector buffer, without going through
+         *              `safe_get_char` for each one
+         *
+         * At most the remainder of the current sector is copied, so a single call never loads more than one sector.
+         *
+         * @see PropWare::FileReader::get_chars
+         */
+        size_t get_chars (char buffer[], const size_t maxLength) {
+            PropWare::ErrorCode err;
+
+            if (!this->m_open)
+                err = FILE_NOT_OPEN;
+            else if (this->eof())
+                return 0;
+            else if (!(err = this->load_sector_under_ptr())) {
+                const uint16_t sectorSize   = this->m_driver->get_sector_size();
+                const uint16_t bufferOffset = (uint16_t) (this->m_ptr % sectorSize);
+                size_t         length       = sectorSize - bufferOffset;
+                if ((size_t) (this->m_length - this->m_ptr) < length)
+                    length = (size_t) (this->m_length - this->m_ptr);
+                if (maxLength < length)
+                    length = maxLength;
+
+                memcpy(buffer, &this->m_buf->buf[bufferOffset], length);
+                this->m_ptr += length;
+                return length;
+            }
+
+            this->m_error = err;
+            return 0;
+        }
+
         PropWare::ErrorCode safe_get_char (char &c) {
             PropWare::ErrorCode err;
 
@@ -28,6 +28,7 @@
 #include <PropWare/PropWare.h>
 #include <PropWare/c++allocate.h>
 #include <PropWare/utility/utility.h>
+#include <PropWare/utility/allocator/allocator.h>
 #include <PropWare/hmi/output/printer.h>
 #include <PropWare/memory/blockstorage.h>
 #include <PropWare/filesystem/filesystem.h>
@@ -55,7 +56,8 @@ class FatFS : public Filesystem {
             /** FatFS Error 4 */   READING_PAST_EOC,
             /** FatFS Error 5 */   PARTITION_DOES_NOT_EXIST,
             /** FatFS Error 6 */   UNSUPPORTED_FILESYSTEM,
-            /** Last FatFS error */END_ERROR       = UNSUPPORTED_FILESYSTEM
+            /** FatFS Error 7 */   OUT_OF_MEMORY,
+            /** Last FatFS error */END_ERROR       = OUT_OF_MEMORY
         }    ErrorCode;
 
     public:
@@ -68,9 +70,16 @@ class FatFS : public Filesystem {
          * @param[in]   *logger     Useful for debugging, a logger can be given to help determine when something goes
          *                          wrong. All code using the logger will be optimized out by GCC so long as you only
          *                          call public method
+         * @param[in]   allocator   Source of the two sector-sized buffers which are taken when the filesystem is mounted
+         *                          and given back when it is unmounted. A PropWare::ObjectPool of sector-sized blocks
+         *                          keeps repeated mounting from fragmenting the heap. An allocator which can not reuse
+         *                          freed blocks, such as PropWare::Arena, keeps them until the FatFS is destroyed
+         *                          instead, so that remounting takes nothing more from it
          */
-        FatFS (const BlockStorage &driver, const Printer &logger = pwOut)
+        FatFS (const BlockStorage &driver, const Printer &logger = pwOut,
+               Allocator &allocator = HeapAllocator::get_instance())
                 : Filesystem(driver, logger),
+                  m_allocator(&allocator),
                   m_fat(NULL),
                   m_fatMod(false) {
         }
@@ -81,11 +90,8 @@ class FatFS : public Filesystem {
         ~FatFS () {
             this->unmount();
 
-            if (NULL != this->m_buf.buf)
-                free(this->m_buf.buf);
-
-            if (NULL != this->m_fat)
-                free(this->m_fat);
+            this->m_allocator->deallocate(this->m_buf.buf);
+            this->m_allocator->deallocate(this->m_fat);
         }
 
         /**
@@ -104,11 +110,15 @@ class FatFS : public Filesystem {
             this->m_fatMod     = false;
             this->m_nextFileId = 0;
 
-            // Allocate the buffers
+            // Allocate the buffers, unless they were kept from an earlier mount
             if (NULL == this->m_buf.buf)
-                this->m_buf.buf        = (uint8_t *) malloc(this->m_sectorSize);
+                this->m_buf.buf        = (uint8_t *) this->m_allocator->allocate(this->m_sectorSize);
             if (NULL == this->m_fat)
-                this->m_fat            = (uint8_t *) malloc(this->m_sectorSize);
+                this->m_fat            = (uint8_t *) this->m_allocator->allocate(this->m_sectorSize);
+            if (NULL == this->m_buf.buf || NULL == this->m_fat) {
+                this->release_buffers();
+                return OUT_OF_MEMORY;
+            }
             if (Utility::empty(this->m_buf.meta->name))
                 this->m_buf.meta->name = "FAT shared buffer";
 
@@ -134,17 +144,13 @@ class FatFS : public Filesystem {
             if (this->m_mounted) {
                 PropWare::ErrorCode err;
 
-                if (NULL != this->m_buf.buf) {
+                if (NULL != this->m_buf.buf)
                     check_errors(this->m_driver->flush(&this->m_buf));
-                    free(this->m_buf.buf);
-                    this->m_buf.buf = NULL;
-                }
-
-                if (NULL != this->m_fat) {
+                if (NULL != this->m_fat)
                     check_errors(this->flush_fat());
-                    free(this->m_fat);
-                    this->m_fat = NULL;
-                }
+
+                this->release_buffers();
+                this->m_mounted = false;
             }
 
             return NO_ERROR;
@@ -207,6 +213,19 @@ class FatFS : public Filesystem {
 
     private:
 
+        /**
+         * @brief   Give both sector buffers back to the allocator, unless it could never reuse them; an arena's buffers
+         *          are kept for the next mount instead
+         */
+        void release_buffers () {
+            if (this->m_allocator->reclaims_memory()) {
+                this->m_allocator->deallocate(this->m_buf.buf);
+                this->m_buf.buf = NULL;
+                this->m_allocator->deallocate(this->m_fat);
+                this->m_fat = NULL;
+            }
+        }
+
         /**
          * @brief       Read the master boot record and load in the boot sector for the requested partition
          *
@@ -721,6 +740,7 @@ class FatFS : public Filesystem {
         }
 
     private:
+        Allocator   *m_allocator;
         InitFATInfo m_initFatInfo;
         uint8_t     m_filesystem;  // File system type - one of FAT_16 or FAT_32
         char        m_label[9]; // Filesystem label
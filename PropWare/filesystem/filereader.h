@@ -67,6 +67,26 @@ class FileReader : virtual public File, virtual public ScanCapable {
                 return c;
         }
 
+        /**
+         * @brief       Read up to `maxLength` characters, stopping early only at the end of the file or on an error
+         *
+         * @post        If an error occurs, you can retrieve the error code via `FileReader::get_error()`
+         *
+         * @see PropWare::ScanCapable::get_chars
+         */
+        virtual size_t get_chars (char buffer[], const size_t maxLength) {
+            size_t length = 0;
+            while (length < maxLength && !this->eof()) {
+                const PropWare::ErrorCode err = this->safe_get_char(buffer[length]);
+                if (err) {
+                    this->m_error = err;
+                    break;
+                } else
+                    ++length;
+            }
+            return length;
+        }
+
         /**
          * @brief       Determine whether the read pointer has reached the end of the file
          *
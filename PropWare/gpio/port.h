@@ -215,7 +215,11 @@ class Port {
          * @brief   Set the port for input
          */
         inline void set_dir_in () const {
+#ifdef __PROPELLER__
             __asm__ volatile ("andn dira, %0" : : "r" (this->m_mask));
+#else
+            DIRA &= ~this->m_mask;
+#endif
         }
 
         /**
@@ -247,7 +251,11 @@ class Port {
          * @pre     If port is not set as output, statement will have no affect
          */
         void clear () const {
+#ifdef __PROPELLER__
             __asm__ volatile ("andn outa, %0" : : "r" (this->m_mask));
+#else
+            OUTA &= ~this->m_mask;
+#endif
         }
 
         /**
@@ -30,6 +30,8 @@
 #define PropWare PropWare_cog
 #endif
 
+#include <stddef.h>
+
 namespace PropWare {
 
 /**
@@ -42,6 +44,23 @@ class ScanCapable {
          *          the implementation
          */
         virtual char get_char () = 0;
+
+        /**
+         * @brief       Read whatever characters are readily available, waiting only for the first one
+         *
+         * The default implementation reads a single character with `get_char`. Sources which receive or load data in
+         * blocks, such as PropWare::FullDuplexSerial and PropWare::FatFileReader, hand over a whole block at once.
+         *
+         * @param[out]  buffer[]    Characters are stored here
+         * @param[in]   maxLength   Maximum number of characters to store in `buffer[]`; must be at least 1
+         *
+         * @return      Number of characters stored in `buffer[]`. Zero only if the source has nothing more to give,
+         *              such as at the end of a file
+         */
+        virtual size_t get_chars (char buffer[], const size_t maxLength) {
+            buffer[0] = this->get_char();
+            return 1;
+        }
 };
 
 }
@@ -24,9 +24,18 @@
  */
 
 #include <PropWare/hmi/input/scanner.h>
+
+#ifdef __PROPELLER__
 #include <PropWare/serial/uart/uartrx.h>
 
 #ifndef __PROPELLER_COG__
 PropWare::UARTRX  _g_uartrx;
 PropWare::Scanner pwIn(_g_uartrx, &pwOut);
 #endif
+#else
+#include <PropWare/models/host/console.h>
+
+// The terminal echoes what is typed, so the Scanner must not
+PropWare::Console _g_inputConsole;
+PropWare::Scanner pwIn(_g_inputConsole);
+#endif
@@ -27,18 +27,17 @@
 
 #include <PropWare/PropWare.h>
 #include <PropWare/hmi/input/scancapable.h>
+#include <PropWare/hmi/input/tokenizer.h>
 #include <PropWare/hmi/output/printer.h>
 #include <PropWare/utility/comparator.h>
 
-extern "C" {
-extern const char *_scanf_getl (const char *str, int *dst, int base, unsigned width, int isSigned);
-extern const char *_scanf_getf (const char *str, float *dst);
-}
-
 namespace PropWare {
 
 /**
 * @brief    Interface for all classes capable of scanning
+*
+* Numbers are read a line at a time, so that the user may correct typing mistakes with backspace, and then converted by
+* PropWare::Tokenizer. To parse a file or other machine-generated input, use a PropWare::Tokenizer directly instead.
 */
 class Scanner {
     public:
@@ -155,7 +154,7 @@ class Scanner {
             ErrorCode err;
             char      userInput[32];
             check_errors(this->gets(userInput, sizeof(userInput)));
-            if (0 == _scanf_getl(userInput, (int *) &x, 10, 11, false))
+            if (Tokenizer(userInput).get(x))
                 return BAD_INPUT;
             else
                 return NO_ERROR;
@@ -168,7 +167,7 @@ class Scanner {
             ErrorCode err;
             char      userInput[32];
             check_errors(this->gets(userInput, sizeof(userInput)));
-            if (0 == _scanf_getl(userInput, &x, 10, 11, false))
+            if (Tokenizer(userInput).get(x))
                 return BAD_INPUT;
             else
                 return NO_ERROR;
@@ -181,7 +180,7 @@ class Scanner {
             ErrorCode err;
             char      userInput[32];
             check_errors(this->gets(userInput, sizeof(userInput)));
-            if (0 == _scanf_getf(userInput, &f))
+            if (Tokenizer(userInput).get(f))
                 return BAD_INPUT;
             else
                 return NO_ERROR;
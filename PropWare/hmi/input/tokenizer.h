@@ -0,0 +1,624 @@
+/**
+ * @file    PropWare/hmi/input/tokenizer.h
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/PropWare.h>
+#include <PropWare/hmi/input/scancapable.h>
+#include <PropWare/hmi/output/printer.h>
+#include <PropWare/utility/fixed.h>
+#include <float.h>
+#include <string.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Parse numbers and delimited fields straight out of a PropWare::ScanCapable, without reading whole lines
+ *          first
+ *
+ * Characters are pulled from the source into a small lookahead buffer - a whole block at a time from sources which
+ * implement PropWare::ScanCapable::get_chars - and each number is converted as its digits go by. Nothing is allocated
+ * and none of newlib's scanf is linked in. Integers may be decimal or hexadecimal (with a leading "0x"). `float`s and
+ * PropWare::Fixed numbers may have a fraction, and `float`s may also have an exponent.
+ *
+ * Blanks (spaces, tabs and carriage returns) before a value are skipped. Parsing stops at the first character which
+ * can not be part of the value and leaves it unread. When an error is returned, that character is the offending one,
+ * and PropWare::Tokenizer::get_token_position gives the line and column where the rejected value began.
+ *
+ * @code
+ * // One "name,setpoint,gain" record per line
+ * static char lookahead[64];
+ *
+ * int main () {
+ *     ...
+ *     PropWare::FatFileReader reader(filesystem, "config.csv");
+ *     reader.open();
+ *     PropWare::Tokenizer tokens(reader, lookahead);
+ *
+ *     char          name[16];
+ *     int32_t       setpoint;
+ *     PropWare::Q16 gain;
+ *     while (!tokens.at_end()) {
+ *         if (tokens.get_token(name, sizeof(name)) || tokens.expect(',') || tokens.get(setpoint)
+ *                 || tokens.expect(',') || tokens.get(gain))
+ *             pwOut.printf("Bad value on line %u, column %u\n", tokens.get_token_position().line,
+ *                          tokens.get_token_position().column);
+ *         tokens.skip_line();
+ *     }
+ * }
+ * @endcode
+ */
+class Tokenizer {
+    public:
+        /** Number of allocated error codes for PropWare::Tokenizer */
+#define TOKENIZER_ERRORS_LIMIT 16
+        /** First PropWare::Tokenizer error code */
+#define TOKENIZER_ERRORS_BASE  96
+
+        /**
+         * Error codes
+         */
+        typedef enum {
+            /** No errors; Successful completion of the function */ NO_ERROR             = 0,
+            /** First error code for PropWare::Tokenizer */         BEG_ERROR            = TOKENIZER_ERRORS_BASE,
+            /** No digits where a number was expected */            NOT_A_NUMBER         = BEG_ERROR,
+            /** The value does not fit in its destination */        OUT_OF_RANGE,
+            /** A different character was expected */               UNEXPECTED_CHARACTER,
+            /** The source has nothing more to give */              END_OF_INPUT,
+            /** Last error code used by PropWare::Tokenizer */      END_ERROR            = END_OF_INPUT
+        } ErrorCode;
+
+        /**
+         * @brief   Location of a character in the input, counting both lines and columns from 1
+         */
+        struct Position {
+            uint32_t line;
+            uint32_t column;
+        };
+
+        /** Most characters the tokenizer looks ahead of the current one: "0x" followed by a digit */
+        static const size_t MAX_LOOKAHEAD = 3;
+
+    public:
+        /**
+         * @brief       Tokenize the characters from any ScanCapable
+         *
+         * @param[in]   source      Characters are read from here
+         * @param[in]   lookahead   Statically allocated array, NOT a pointer, which holds characters between reads
+         *                          from `source`. A larger buffer lets block sources hand over more at once
+         */
+        template<size_t N>
+        Tokenizer (ScanCapable &source, char (&lookahead)[N])
+                : m_source(&source),
+                  m_buffer(lookahead),
+                  m_capacity(N),
+                  m_next(lookahead),
+                  m_end(lookahead) {
+            static_assert(MAX_LOOKAHEAD <= N, "Lookahead buffer must hold at least MAX_LOOKAHEAD characters");
+            this->m_position.line   = 1;
+            this->m_position.column = 1;
+            this->m_tokenPosition   = this->m_position;
+        }
+
+        /**
+         * @brief       Tokenize a null-terminated string which is already in memory
+         *
+         * @param[in]   string[]    Characters to be tokenized. The string must outlive the tokenizer
+         */
+        Tokenizer (const char string[])
+                : m_source(NULL),
+                  m_buffer(NULL),
+                  m_capacity(0),
+                  m_next(string),
+                  m_end(string + strlen(string)) {
+            this->m_position.line   = 1;
+            this->m_position.column = 1;
+            this->m_tokenPosition   = this->m_position;
+        }
+
+        /**
+         * @brief       Parse an unsigned integer, either decimal or hexadecimal with a leading "0x"
+         *
+         * @param[out]  x   Parsed value; unmodified if an error is returned
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        ErrorCode get (uint32_t &x) {
+            char c;
+            this->begin_token();
+            if (this->peek(c) && '+' == c)
+                this->advance();
+            return this->parse_integer(x, 0xFFFFFFFF);
+        }
+
+        /**
+         * @overload
+         */
+        ErrorCode get (int32_t &x) {
+            ErrorCode err;
+            uint32_t  magnitude;
+            this->begin_token();
+            const bool negative = this->parse_sign();
+            check_errors(this->parse_integer(magnitude, negative ? 0x80000000 : 0x7FFFFFFF));
+            x = (int32_t) (negative ? 0 - magnitude : magnitude);
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Parse a number such as "-12", "3.25" or "6.02e23"
+         *
+         * Only the first nine significant digits are used, and the result may be off by a unit or two in the last
+         * place: not quite as good as `strtof` on a PC, but it costs no more than a handful of `float` operations.
+         *
+         * @param[out]  f   Parsed value; unmodified if an error other than PropWare::Tokenizer::OUT_OF_RANGE is
+         *                  returned
+         *
+         * @return      0 upon success, error code otherwise. If the magnitude is too large for a `float`,
+         *              PropWare::Tokenizer::OUT_OF_RANGE is returned and `f` is set to infinity
+         */
+        ErrorCode get (float &f) {
+            ErrorCode err;
+            char      c;
+            uint32_t  mantissa;
+            int32_t   exponent;
+
+            this->begin_token();
+            const bool negative = this->parse_sign();
+            check_errors(this->parse_significand(mantissa, exponent));
+
+            if (this->peek(c) && ('e' == c || 'E' == c) && this->exponent_follows()) {
+                uint32_t magnitude;
+                this->advance();
+                const bool negativeExponent = this->parse_sign();
+                check_errors(this->parse_digits(magnitude, 0xFFFFFFFF, 10));
+                // Anything beyond this is infinite or zero anyway
+                if (1000 < magnitude)
+                    magnitude = 1000;
+                exponent += negativeExponent ? -(int32_t) magnitude : (int32_t) magnitude;
+            }
+
+            const float value = scale(mantissa, exponent);
+            f = negative ? -value : value;
+            return FLT_MAX < value ? OUT_OF_RANGE : NO_ERROR;
+        }
+
+        /**
+         * @brief       Parse a number such as "-12" or "3.25" directly into fixed point, without using `float`s
+         *
+         * The result is correctly rounded to the nearest multiple of 2^-`FRACTION_BITS`, considering the first nine
+         * digits after the decimal point.
+         *
+         * @param[out]  x   Parsed value; unmodified if an error is returned
+         *
+         * @return      0 upon success, error code otherwise
+         */
+        template<uint8_t FRACTION_BITS>
+        ErrorCode get (Fixed<FRACTION_BITS> &x) {
+            ErrorCode err;
+            char      c;
+            uint32_t  integer  = 0;
+            uint32_t  fraction = 0;
+
+            this->begin_token();
+            const bool     negative = this->parse_sign();
+            const uint32_t rawLimit = negative ? 0x80000000 : 0x7FFFFFFF;
+
+            if (!this->peek(c))
+                return END_OF_INPUT;
+            const bool hasInteger = '.' != c;
+            if (hasInteger)
+                check_errors(this->parse_digits(integer, rawLimit >> FRACTION_BITS, 10));
+
+            if (this->peek(c) && '.' == c) {
+                bool hasFraction;
+                this->advance();
+                fraction = this->parse_fraction(FRACTION_BITS, hasFraction);
+                if (!hasInteger && !hasFraction)
+                    return NOT_A_NUMBER;
+            }
+
+            // Rounding the fraction can carry into the integer, so the limit is checked once more
+            const uint64_t raw = ((uint64_t) integer << FRACTION_BITS) + fraction;
+            if (rawLimit < raw)
+                return OUT_OF_RANGE;
+            x = Fixed<FRACTION_BITS>::from_raw((int32_t) (negative ? 0 - (uint32_t) raw : (uint32_t) raw));
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief       Read a field up to, but not including, the next delimiter or the end of the input
+         *
+         * Blanks before the field are skipped, but blanks within or after it are kept. An empty field is not an error.
+         *
+         * @param[out]  buffer[]        The field is stored here, null-terminated
+         * @param[in]   size            Size of `buffer[]`. Characters which do not fit are consumed and discarded
+         * @param[in]   delimiters[]    Characters which end the field
+         *
+         * @return      0 upon success, PropWare::Tokenizer::OUT_OF_RANGE if the field was cut short or
+         *              PropWare::Tokenizer::END_OF_INPUT if the input had already ended
+         */
+        ErrorCode get_token (char buffer[], const size_t size, const char delimiters[] = ",\r\n") {
+            char   c;
+            size_t length    = 0;
+            bool   truncated = false;
+
+            this->begin_token();
+            if (!this->peek(c)) {
+                buffer[0] = '\0';
+                return END_OF_INPUT;
+            }
+
+            while (this->peek(c) && NULL == strchr(delimiters, c)) {
+                if (length + 1 < size)
+                    buffer[length++] = c;
+                else
+                    truncated = true;
+                this->advance();
+            }
+            buffer[length] = '\0';
+            return truncated ? OUT_OF_RANGE : NO_ERROR;
+        }
+
+        /**
+         * @brief       Consume a specific character, which may be preceded by blanks
+         *
+         * @param[in]   expected    Character which must come next, such as a field separator
+         *
+         * @return      0 upon success, error code otherwise. The unexpected character is left unread
+         */
+        ErrorCode expect (const char expected) {
+            char c;
+            this->begin_token();
+            if (!this->peek(c))
+                return END_OF_INPUT;
+            else if (expected == c) {
+                this->advance();
+                return NO_ERROR;
+            } else
+                return UNEXPECTED_CHARACTER;
+        }
+
+        /**
+         * @brief   Consume everything up to and including the next line feed
+         *
+         * @return  True if a line feed was found, false if the input ran out first
+         */
+        bool skip_line () {
+            char c;
+            while (this->next(c))
+                if ('\n' == c)
+                    return true;
+            return false;
+        }
+
+        /**
+         * @brief   Consume blanks (spaces, tabs and carriage returns)
+         */
+        void skip_blanks () {
+            char c;
+            while (this->peek(c) && is_blank(c))
+                this->advance();
+        }
+
+        /**
+         * @brief   Determine whether anything other than blanks remains in the input
+         *
+         * For a source which never ends, such as a UART, this waits for the next character which is not a blank.
+         */
+        bool at_end () {
+            char c;
+            this->skip_blanks();
+            return !this->peek(c);
+        }
+
+        /**
+         * @brief       Look at the next character without consuming it
+         *
+         * @param[out]  c   Next character
+         *
+         * @return      False if the input has ended
+         */
+        bool peek (char &c) {
+            return this->peek(c, 0);
+        }
+
+        /**
+         * @brief       Consume the next character
+         *
+         * @param[out]  c   Next character
+         *
+         * @return      False if the input has ended
+         */
+        bool next (char &c) {
+            if (this->peek(c)) {
+                this->advance();
+                return true;
+            } else
+                return false;
+        }
+
+        /**
+         * @brief   Position of the next unread character
+         */
+        const Position &get_position () const {
+            return this->m_position;
+        }
+
+        /**
+         * @brief   Position where the most recently parsed (or rejected) value began, after any blanks
+         */
+        const Position &get_token_position () const {
+            return this->m_tokenPosition;
+        }
+
+    protected:
+        /** Returned by PropWare::Tokenizer::digit_value for anything other than a hexadecimal digit */
+        static const uint8_t NOT_A_DIGIT         = 0xFF;
+        /** Digits kept for `float`s and the fraction of fixed point numbers; more would overflow 32 bits */
+        static const uint8_t SIGNIFICANT_DIGITS  = 9;
+        /** Extra bits of precision used while converting a decimal fraction to binary */
+        static const uint8_t GUARD_BITS          = 8;
+
+    protected:
+        static bool is_blank (const char c) {
+            return ' ' == c || '\t' == c || '\r' == c;
+        }
+
+        static uint8_t digit_value (const char c) {
+            if ('0' <= c && c <= '9')
+                return (uint8_t) (c - '0');
+            else if ('a' <= c && c <= 'f')
+                return (uint8_t) (c - 'a' + 10);
+            else if ('A' <= c && c <= 'F')
+                return (uint8_t) (c - 'A' + 10);
+            else
+                return NOT_A_DIGIT;
+        }
+
+        /**
+         * @brief   Multiply `mantissa` by 10^`exponent`, dividing by exact powers of ten for negative exponents
+         */
+        static float scale (const uint32_t mantissa, const int32_t exponent) {
+            static const float POWERS_OF_TEN[] = {1e1f, 1e2f, 1e4f, 1e8f, 1e16f, 1e32f};
+
+            const bool negative  = 0 > exponent;
+            uint32_t   magnitude = (uint32_t) (negative ? -exponent : exponent);
+            float      value     = (float) mantissa;
+
+            // Every non-zero mantissa is infinite or zero beyond 10^+-63
+            if (0 == mantissa)
+                return 0;
+            else if (63 < magnitude)
+                magnitude = 63;
+
+            for (const float *power = POWERS_OF_TEN; magnitude; ++power, magnitude >>= 1)
+                if (magnitude & 1)
+                    value = negative ? value / *power : value * *power;
+            return value;
+        }
+
+        /**
+         * @brief   Ensure at least `count` characters are buffered, reading from the source as needed
+         *
+         * @return  False if the source ran out first
+         */
+        bool fill (const size_t count) {
+            if (NULL == this->m_source)
+                return false;
+
+            // Only ever a couple of characters are left to move
+            const size_t buffered = (size_t) (this->m_end - this->m_next);
+            memmove(this->m_buffer, this->m_next, buffered);
+            this->m_next = this->m_buffer;
+            this->m_end  = this->m_buffer + buffered;
+
+            while ((size_t) (this->m_end - this->m_next) < count) {
+                const size_t used     = (size_t) (this->m_end - this->m_buffer);
+                const size_t received = this->m_source->get_chars(this->m_buffer + used, this->m_capacity - used);
+                if (0 == received)
+                    return false;
+                this->m_end += received;
+            }
+            return true;
+        }
+
+        bool peek (char &c, const size_t offset) {
+            if ((size_t) (this->m_end - this->m_next) <= offset && !this->fill(offset + 1))
+                return false;
+            c = this->m_next[offset];
+            return true;
+        }
+
+        /**
+         * @brief   Consume the next character, which must already have been peeked at
+         */
+        void advance () {
+            if ('\n' == *this->m_next++) {
+                ++this->m_position.line;
+                this->m_position.column = 1;
+            } else
+                ++this->m_position.column;
+        }
+
+        void begin_token () {
+            this->skip_blanks();
+            this->m_tokenPosition = this->m_position;
+        }
+
+        /**
+         * @brief   Consume an optional '+' or '-'
+         *
+         * @return  True if a '-' was consumed
+         */
+        bool parse_sign () {
+            char c;
+            if (this->peek(c) && ('-' == c || '+' == c)) {
+                this->advance();
+                return '-' == c;
+            } else
+                return false;
+        }
+
+        ErrorCode parse_integer (uint32_t &x, const uint32_t limit) {
+            char c;
+            // Only look past a leading zero when there is one, so that interactive input is not kept waiting
+            if (this->peek(c) && '0' == c && this->peek(c, 1) && ('x' == c || 'X' == c) && this->peek(c, 2)
+                    && NOT_A_DIGIT != digit_value(c)) {
+                this->advance();
+                this->advance();
+                return this->parse_digits(x, limit, 16);
+            } else
+                return this->parse_digits(x, limit, 10);
+        }
+
+        /**
+         * @brief   Consume digits in base 10 or 16 for as long as they come, without ever dividing
+         *
+         * If the value would exceed `limit`, the digit which pushed it over is left unread.
+         */
+        ErrorCode parse_digits (uint32_t &x, const uint32_t limit, const uint8_t radix) {
+            char     c;
+            uint8_t  digit;
+            uint32_t value = 0;
+
+            if (!this->peek(c))
+                return END_OF_INPUT;
+            else if (radix <= (digit = digit_value(c)))
+                return NOT_A_NUMBER;
+
+            do {
+                const uint64_t shifted = 16 == radix
+                                         ? (uint64_t) value << 4
+                                         : ((uint64_t) value << 3) + ((uint64_t) value << 1);
+                if (limit < shifted + digit)
+                    return OUT_OF_RANGE;
+                value = (uint32_t) (shifted + digit);
+                this->advance();
+            } while (this->peek(c) && (digit = digit_value(c)) < radix);
+
+            x = value;
+            return NO_ERROR;
+        }
+
+        /**
+         * @brief   Consume decimal digits with an optional decimal point, keeping the first
+         *          PropWare::Tokenizer::SIGNIFICANT_DIGITS significant ones such that the value is
+         *          `mantissa` * 10^`exponent`
+         */
+        ErrorCode parse_significand (uint32_t &mantissa, int32_t &exponent) {
+            char    c;
+            uint8_t significant = 0;
+            bool    hasDigits   = false;
+            bool    hasPoint    = false;
+
+            mantissa = 0;
+            exponent = 0;
+            while (this->peek(c)) {
+                if ('.' == c && !hasPoint)
+                    hasPoint = true;
+                else if ('0' <= c && c <= '9') {
+                    hasDigits = true;
+                    if (SIGNIFICANT_DIGITS > significant) {
+                        mantissa = (mantissa << 3) + (mantissa << 1) + (c - '0');
+                        // Leading zeros are not significant
+                        if (mantissa)
+                            ++significant;
+                        if (hasPoint)
+                            --exponent;
+                    } else if (!hasPoint)
+                        ++exponent;
+                } else
+                    break;
+                this->advance();
+            }
+
+            if (hasDigits)
+                return NO_ERROR;
+            else
+                return hasPoint || this->peek(c) ? NOT_A_NUMBER : END_OF_INPUT;
+        }
+
+        /**
+         * @brief   Determine whether the 'e' or 'E' under the cursor starts an exponent, rather than being the next
+         *          token
+         */
+        bool exponent_follows () {
+            char c;
+            if (!this->peek(c, 1))
+                return false;
+            else if ('-' == c || '+' == c)
+                return this->peek(c, 2) && '0' <= c && c <= '9';
+            else
+                return '0' <= c && c <= '9';
+        }
+
+        /**
+         * @brief       Consume the digits after a decimal point and convert them to a binary fraction
+         *
+         * The digits are converted from last to first - add the digit, then divide by ten - so that only shifts and
+         * adds are needed (see PropWare::Printer::divide_by_10). Extra guard bits keep the truncation in each division
+         * from affecting the rounded result.
+         *
+         * @param[in]   fractionBits    Bits after the binary point in the result
+         * @param[out]  hasDigits       Set to true if at least one digit was found
+         *
+         * @return      Fraction multiplied by 2^`fractionBits` and rounded; may be equal to 2^`fractionBits`
+         */
+        uint32_t parse_fraction (const uint8_t fractionBits, bool &hasDigits) {
+            char         c;
+            uint32_t     digits = 0;
+            uint8_t      count  = 0;
+            uint64_t     scaled = 0;
+            uint_fast8_t digit;
+            uint_fast8_t unused;
+
+            hasDigits = false;
+            while (this->peek(c) && '0' <= c && c <= '9') {
+                hasDigits = true;
+                if (SIGNIFICANT_DIGITS > count) {
+                    digits = (digits << 3) + (digits << 1) + (c - '0');
+                    ++count;
+                }
+                this->advance();
+            }
+
+            while (count--) {
+                digits = Printer::divide_by_10(digits, digit);
+                scaled = Printer::divide_by_10(scaled + ((uint64_t) digit << (fractionBits + GUARD_BITS)), unused);
+            }
+            return (uint32_t) ((scaled + (1 << (GUARD_BITS - 1))) >> GUARD_BITS);
+        }
+
+    protected:
+        ScanCapable *m_source;
+        char        *m_buffer;
+        size_t      m_capacity;
+        const char  *m_next;
+        const char  *m_end;
+        Position    m_position;
+        Position    m_tokenPosition;
+};
+
+}
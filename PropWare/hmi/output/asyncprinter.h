@@ -0,0 +1,264 @@
+/**
+ * @file    PropWare/hmi/output/asyncprinter.h
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/concurrent/runnable.h>
+#include <PropWare/hmi/output/printer.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Print from any cog without waiting for other cogs: each cog formats into its own ring buffer and a dedicated
+ *          printer cog sends the rings on to a PropWare::Printer
+ *
+ * PropWare::SynchronousPrinter holds a hardware lock while it formats and transmits, so one cog's slow output stalls
+ * every other cog that wants to print. An AsyncPrinter needs no lock at all: every cog has a single-producer ring of
+ * its own, written only by that cog and read only by the printer cog. A call such as PropWare::AsyncPrinter::printf
+ * formats into the caller's ring and returns as soon as the text has been copied there.
+ *
+ * Each call's output is published as a unit and the printer cog empties one ring before moving on to the next, so
+ * output from different cogs is never interleaved within a single call. If a call's output does not fit in the space
+ * left in its ring, the whole call's output is dropped and counted rather than blocking.
+ *
+ * The printer cog must be able to drive the output pin, so use a device which configures the pin on every call, such
+ * as PropWare::SharedUARTTX:
+ *
+ * @code
+ * static char     rings[PropWare::AsyncPrinter::COGS][128];
+ * static uint32_t stack[128];
+ *
+ * int main () {
+ *     PropWare::SharedUARTTX   uart;
+ *     const PropWare::Printer  printer(uart);
+ *     PropWare::AsyncPrinter   asyncOut(printer, rings, stack);
+ *     PropWare::Runnable::invoke(asyncOut);
+ *
+ *     asyncOut.printf("Hello from cog %d\n", cogid());
+ * }
+ * @endcode
+ */
+class AsyncPrinter : public Runnable {
+    public:
+        /** Number of cogs, and therefore rings */
+        static const unsigned int COGS = 8;
+
+    public:
+        /**
+         * @brief       Construct an AsyncPrinter; start its printer cog with PropWare::Runnable::invoke
+         *
+         * @param[in]   printer     Destination for all output
+         * @param[in]   rings       Statically allocated array, NOT a pointer, with one ring for each cog. The size of
+         *                          each ring must be a power of two
+         * @param[in]   stack       Stack for the printer cog
+         */
+        template<size_t RING_SIZE, size_t STACK_SIZE>
+        AsyncPrinter (const Printer &printer, char (&rings)[COGS][RING_SIZE], const uint32_t (&stack)[STACK_SIZE])
+                : Runnable(stack),
+                  m_printer(&printer),
+                  m_rings(&rings[0][0]),
+                  m_ringSize(RING_SIZE) {
+            static_assert(0 == (RING_SIZE & (RING_SIZE - 1)), "Ring size must be a power of two");
+            for (unsigned int i = 0; i < COGS; ++i) {
+                this->m_head[i]    = 0;
+                this->m_tail[i]    = 0;
+                this->m_dropped[i] = 0;
+            }
+        }
+
+        /**
+         * @brief   Printer cog's main loop: empty every cog's ring, round-robin, forever
+         */
+        void run () {
+            while (1)
+                this->drain();
+        }
+
+        /**
+         * @brief   Send everything that is waiting in each cog's ring to the printer, one ring at a time
+         *
+         * PropWare::AsyncPrinter::run calls this in a loop; applications without a spare cog may call it themselves.
+         *
+         * @return  Number of characters sent
+         */
+        size_t drain () {
+            size_t sent = 0;
+            for (unsigned int cog = 0; cog < COGS; ++cog)
+                sent += this->drain_ring(cog);
+            return sent;
+        }
+
+        /**
+         * @see PropWare::Printer::print
+         */
+        template<typename T>
+        void print (const T var) {
+            RingWriter writer(*this);
+            writer.get_printer().print(var);
+            writer.commit();
+        }
+
+        /**
+         * @see PropWare::Printer::println
+         */
+        void println (const char string[]) {
+            RingWriter writer(*this);
+            writer.get_printer().println(string);
+            writer.commit();
+        }
+
+        /**
+         * @see PropWare::Printer::puts
+         */
+        void puts (const char string[]) {
+            RingWriter writer(*this);
+            writer.get_printer().puts(string);
+            writer.commit();
+        }
+
+        /**
+         * @see PropWare::Printer::printf(const char fmt[], const T first, Targs... remaining)
+         */
+        template<typename... Targs>
+        void printf (const char fmt[], const Targs... args) {
+            RingWriter writer(*this);
+            writer.get_printer().printf(fmt, args...);
+            writer.commit();
+        }
+
+        /**
+         * @see PropWare::Printer::printf(const CompiledFormat<S> format, const Targs &... args)
+         */
+        template<typename S, typename... Targs>
+        void printf (const CompiledFormat<S> format, const Targs &... args) {
+            RingWriter writer(*this);
+            writer.get_printer().printf(format, args...);
+            writer.commit();
+        }
+
+        template<typename T>
+        AsyncPrinter &operator<< (const T arg) {
+            this->print(arg);
+            return *this;
+        }
+
+        /**
+         * @brief   Wait until the printer cog has sent everything the calling cog printed
+         */
+        void flush () const {
+            const unsigned int cog = cogid();
+            while (this->m_head[cog] != this->m_tail[cog]);
+        }
+
+        /**
+         * @brief   Number of calls, from any cog, whose output was dropped because it did not fit in the ring
+         */
+        uint32_t get_dropped_count () const {
+            uint32_t dropped = 0;
+            for (unsigned int cog = 0; cog < COGS; ++cog)
+                dropped += this->m_dropped[cog];
+            return dropped;
+        }
+
+    protected:
+        /**
+         * Formats one call's output into the calling cog's ring, publishing it only if all of it fit
+         */
+        class RingWriter : public PrintCapable {
+            public:
+                RingWriter (AsyncPrinter &parent)
+                        : m_parent(&parent),
+                          m_cog(cogid()),
+                          m_ring(parent.m_rings + this->m_cog * parent.m_ringSize),
+                          m_mask(parent.m_ringSize - 1),
+                          m_position(parent.m_head[this->m_cog]),
+                          m_overflow(false) {
+                }
+
+                virtual void put_char (const char c) {
+                    if (this->m_parent->m_ringSize == this->m_position - this->m_parent->m_tail[this->m_cog])
+                        this->m_overflow = true;
+                    else if (!this->m_overflow)
+                        this->m_ring[this->m_position++ & this->m_mask] = c;
+                }
+
+                virtual void puts (const char string[]) {
+                    while (*string)
+                        this->put_char(*string++);
+                }
+
+                Printer get_printer () {
+                    // Cooked mode, if any, is applied once by the destination printer
+                    return Printer(*this, false);
+                }
+
+                void commit () {
+                    if (this->m_overflow)
+                        ++this->m_parent->m_dropped[this->m_cog];
+                    else
+                        this->m_parent->m_head[this->m_cog] = this->m_position;
+                }
+
+            protected:
+                AsyncPrinter       *m_parent;
+                const unsigned int m_cog;
+                volatile char      *m_ring;
+                const size_t       m_mask;
+                size_t             m_position;
+                bool               m_overflow;
+        };
+
+        size_t drain_ring (const unsigned int cog) {
+            const volatile char *ring  = this->m_rings + cog * this->m_ringSize;
+            const size_t        mask   = this->m_ringSize - 1;
+            size_t              tail   = this->m_tail[cog];
+            const size_t        head   = this->m_head[cog];
+            const size_t        length = head - tail;
+
+            // Copy in small chunks so the text can be handed to the printer with puts
+            char chunk[32];
+            while (head != tail) {
+                size_t i = 0;
+                while (head != tail && sizeof(chunk) - 1 > i)
+                    chunk[i++] = ring[tail++ & mask];
+                chunk[i] = '\0';
+                this->m_printer->puts(chunk);
+
+                // Free the space only once it has been printed
+                this->m_tail[cog] = tail;
+            }
+            return length;
+        }
+
+    protected:
+        const Printer     *m_printer;
+        volatile char     *m_rings;
+        const size_t      m_ringSize;
+        volatile size_t   m_head[COGS];
+        volatile size_t   m_tail[COGS];
+        volatile uint32_t m_dropped[COGS];
+};
+
+}
@@ -0,0 +1,352 @@
+/**
+ * @file    PropWare/hmi/output/binarylogger.h
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/hmi/output/compiledformat.h>
+#include <PropWare/serial/framing/framedserial.h>
+#include <string.h>
+
+/**
+ * Start of the section holding every PW_LOG format string; defined by the linker because the section's name is a valid
+ * C identifier
+ */
+extern "C" const char __start_pwlog_formats[];
+
+/**
+ * @brief       Log a message through a PropWare::BinaryLogger without formatting it on the Propeller
+ *
+ * The format string is stored once, in the `pwlog_formats` section, and only its 16-bit ID and the raw arguments are
+ * logged. The number and types of the arguments are checked against the format string at compile time.
+ *
+ * @code
+ * PW_LOG(logger, "Sample %u: x=%d y=%d\n", sequence, x, y);
+ * @endcode
+ *
+ * @param[in]   logger          Instance of PropWare::BinaryLogger
+ * @param[in]   formatString    String literal using the same conversions as PropWare::Printer::printf
+ */
+#define PW_LOG(logger, formatString, ...) \
+    do { \
+        static const char pwLogFormat[] __attribute__((section("pwlog_formats"))) = formatString; \
+        (logger).log(PW_FMT(formatString), pwLogFormat, ##__VA_ARGS__); \
+    } while (0)
+
+namespace PropWare {
+
+/** @cond DOXYGEN_IGNORE */
+namespace binary_log {
+
+/**
+ * Writes consecutive bytes into a ring buffer, starting at a free-running position
+ */
+struct RingWriter {
+    volatile char *buffer;
+    size_t        mask;
+    size_t        position;
+
+    void put (const char c) {
+        this->buffer[this->position++ & this->mask] = c;
+    }
+
+    void put_word (const uint32_t word) {
+        this->put((char) word);
+        this->put((char) (word >> 8));
+        this->put((char) (word >> 16));
+        this->put((char) (word >> 24));
+    }
+};
+
+/**
+ * How the argument for one conversion is stored: four bytes (least significant first) for integers and floats, one byte
+ * for characters and the null-terminated text of strings
+ */
+template<char CONVERSION>
+struct Encoding {
+    template<typename T>
+    static size_t size (const T &value) {
+        static_assert(CONVERSION != CONVERSION, "Unsupported conversion in log format string");
+        return 0;
+    }
+
+    template<typename T>
+    static void write (RingWriter &writer, const T &value) {
+    }
+};
+
+template<>
+struct Encoding<'d'> {
+    template<typename T>
+    static size_t size (const T &value) {
+        static_assert(std::is_integral<T>::value, "%d, %i, %u, %X and %b require an integer argument");
+        static_assert(sizeof(T) <= sizeof(uint32_t), "64-bit integers can not be logged");
+        return sizeof(uint32_t);
+    }
+
+    template<typename T>
+    static void write (RingWriter &writer, const T &value) {
+        writer.put_word((uint32_t) value);
+    }
+};
+
+template<>
+struct Encoding<'i'> : Encoding<'d'> {
+};
+
+template<>
+struct Encoding<'u'> : Encoding<'d'> {
+};
+
+template<>
+struct Encoding<'X'> : Encoding<'d'> {
+};
+
+template<>
+struct Encoding<'b'> : Encoding<'d'> {
+};
+
+template<>
+struct Encoding<'c'> {
+    template<typename T>
+    static size_t size (const T &value) {
+        static_assert(std::is_same<T, char>::value, "%c requires a char argument");
+        return 1;
+    }
+
+    template<typename T>
+    static void write (RingWriter &writer, const T &value) {
+        writer.put(value);
+    }
+};
+
+template<>
+struct Encoding<'f'> {
+    template<typename T>
+    static size_t size (const T &value) {
+        static_assert(std::is_arithmetic<T>::value, "%f requires a numeric argument");
+        return sizeof(float);
+    }
+
+    template<typename T>
+    static void write (RingWriter &writer, const T &value) {
+        union {
+            float    value;
+            uint32_t word;
+        } convert;
+        convert.value = (float) value;
+        writer.put_word(convert.word);
+    }
+};
+
+template<>
+struct Encoding<'s'> {
+    template<typename T>
+    static size_t size (const T &value) {
+        static_assert(std::is_convertible<T, const char *>::value, "%s requires a string argument");
+        return strlen(value) + 1;
+    }
+
+    template<typename T>
+    static void write (RingWriter &writer, const T &value) {
+        const char *s = value;
+        do {
+            writer.put(*s);
+        } while (*s++);
+    }
+};
+
+/**
+ * Arguments from number `INDEX` onward, each encoded according to its conversion in the format string
+ */
+template<typename S, size_t INDEX>
+struct Arguments {
+    static size_t size () {
+        return 0;
+    }
+
+    template<typename T, typename... Targs>
+    static size_t size (const T &first, const Targs &... remaining) {
+        return Encoding<FormatParser::nth_conversion(S::string(), INDEX)>::size(first)
+               + Arguments<S, INDEX + 1>::size(remaining...);
+    }
+
+    static void write (RingWriter &writer) {
+    }
+
+    template<typename T, typename... Targs>
+    static void write (RingWriter &writer, const T &first, const Targs &... remaining) {
+        Encoding<FormatParser::nth_conversion(S::string(), INDEX)>::write(writer, first);
+        Arguments<S, INDEX + 1>::write(writer, remaining...);
+    }
+};
+
+}
+/** @endcond */
+
+/**
+ * @brief   Deferred logging: record a format string ID and raw argument bytes instead of formatted text
+ *
+ * Formatting text costs far more on the Propeller than copying a few bytes, and text is much larger than the values it
+ * describes. A BinaryLogger stores each PW_LOG call as a record in a ring buffer: the format string's 16-bit ID
+ * followed by the arguments, four bytes for each number. Records are sent on to any PropWare::PrintCapable (such as a
+ * PropWare::UARTTX, PropWare::FullDuplexSerial or PropWare::FatFileWriter) by PropWare::BinaryLogger::drain, each as a
+ * PropWare::FramedSerial frame, and turned back into text on a PC by the `pwlogdecode` tool in `tools/pwlogdecode`,
+ * which reads the format strings out of the application's ELF file.
+ *
+ * @code
+ * static char logBuffer[512];
+ *
+ * int main () {
+ *     PropWare::FullDuplexSerial serial;
+ *     serial.start();
+ *     PropWare::BinaryLogger logger(logBuffer);
+ *
+ *     while (1) {
+ *         PW_LOG(logger, "Reading %u: %d mV\n", i, millivolts);
+ *         ...
+ *         logger.drain(serial);
+ *     }
+ * }
+ * @endcode
+ *
+ * One cog may log while another drains, but two cogs must not log to the same instance at the same time. Records
+ * which do not fit in the buffer are dropped whole and counted.
+ */
+class BinaryLogger {
+    public:
+        /** Number of bytes used for a format string's ID */
+        static const size_t ID_SIZE         = 2;
+        /** Largest record, including its ID, that can be logged */
+        static const size_t MAX_RECORD_SIZE = 255;
+
+    public:
+        /**
+         * @brief       Construct a logger
+         *
+         * @param[in]   buffer  Statically allocated array, NOT a pointer, holding records until they are drained. Its
+         *                      size must be a power of two
+         */
+        template<size_t N>
+        BinaryLogger (char (&buffer)[N])
+                : m_buffer(buffer),
+                  m_size(N),
+                  m_head(0),
+                  m_tail(0),
+                  m_droppedRecords(0) {
+            static_assert(0 == (N & (N - 1)), "Buffer size must be a power of two");
+        }
+
+        /**
+         * @brief       Log one record; call through the PW_LOG macro rather than directly
+         *
+         * @param[in]   format          Compile-time copy of the format string, used to check and encode the arguments
+         * @param[in]   storedFormat    The copy of the format string in the `pwlog_formats` section
+         * @param[in]   args            Arguments matching the format string's conversions
+         *
+         * @return      False if the record did not fit in the buffer and was dropped
+         */
+        template<typename S, typename... Targs>
+        bool log (const CompiledFormat<S> format, const char storedFormat[], const Targs &... args) {
+            static_assert(CompiledFormat<S>::ARGUMENTS == sizeof...(Targs),
+                          "Number of arguments does not match the format string");
+
+            const size_t length = ID_SIZE + binary_log::Arguments<S, 0>::size(args...);
+            if (MAX_RECORD_SIZE < length || this->m_size - (this->m_head - this->m_tail) <= length) {
+                ++this->m_droppedRecords;
+                return false;
+            }
+
+            const uint16_t          id     = (uint16_t) (storedFormat - __start_pwlog_formats);
+            binary_log::RingWriter writer = {this->m_buffer, this->m_size - 1, this->m_head};
+            writer.put((char) length);
+            writer.put((char) id);
+            writer.put((char) (id >> 8));
+            binary_log::Arguments<S, 0>::write(writer, args...);
+
+            // Only publish the record once all of it is in the buffer
+            this->m_head = writer.position;
+            return true;
+        }
+
+        /**
+         * @brief       Send the oldest record as a frame
+         *
+         * The record is removed from the buffer before it is sent, so logging can continue while it goes out.
+         *
+         * @param[in]   printCapable    Destination for the frame
+         *
+         * @return      False if there were no records to send
+         */
+        bool drain_one (PrintCapable &printCapable) {
+            if (this->is_empty())
+                return false;
+
+            const size_t mask     = this->m_size - 1;
+            size_t       position = this->m_tail;
+            const size_t length   = (uint8_t) this->m_buffer[position++ & mask];
+
+            char record[MAX_RECORD_SIZE];
+            for (size_t i = 0; i < length; ++i)
+                record[i] = this->m_buffer[position++ & mask];
+            this->m_tail = position;
+
+            FramedSerial::send_frame(printCapable, record, length);
+            return true;
+        }
+
+        /**
+         * @brief       Send every record in the buffer
+         *
+         * @param[in]   printCapable    Destination for the frames
+         *
+         * @return      Number of records sent
+         */
+        size_t drain (PrintCapable &printCapable) {
+            size_t records = 0;
+            while (this->drain_one(printCapable))
+                ++records;
+            return records;
+        }
+
+        bool is_empty () const {
+            return this->m_head == this->m_tail;
+        }
+
+        /**
+         * @brief   Number of records which were dropped because the buffer was full
+         */
+        uint32_t get_dropped_count () const {
+            return this->m_droppedRecords;
+        }
+
+    protected:
+        volatile char   *m_buffer;
+        const size_t    m_size;
+        volatile size_t m_head;
+        volatile size_t m_tail;
+        uint32_t        m_droppedRecords;
+};
+
+}
@@ -0,0 +1,183 @@
+/**
+ * @file    PropWare/hmi/output/bufferedprinter.h
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/hmi/output/printer.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Collect characters in a buffer and pass them on to another PropWare::PrintCapable with as few `puts` calls as
+ *          possible
+ *
+ * Objects such as PropWare::UARTTX pay a setup cost for every `put_char` call but send a whole string from `puts` in
+ * one tight loop. A PrintBuffer sits in front of such an object and only calls its `puts` when a line is finished
+ * (optional), when the buffer is full or when PropWare::PrintBuffer::flush is called. See PropWare::BufferedPrinter for
+ * the most common use.
+ *
+ * Not safe to use from multiple cogs at once.
+ */
+class PrintBuffer : public PrintCapable {
+    public:
+        /**
+         * @brief       Construct a buffer in front of another PrintCapable
+         *
+         * @param[in]   destination     Object which receives the buffered characters
+         * @param[in]   buffer          Statically allocated array, NOT a pointer. One byte is reserved for the
+         *                              null-terminator
+         * @param[in]   flushOnNewline  When true, the buffer is flushed after every newline character
+         */
+        template<size_t N>
+        PrintBuffer (PrintCapable &destination, char (&buffer)[N], const bool flushOnNewline = true)
+                : m_destination(&destination),
+                  m_buffer(buffer),
+                  m_capacity(N - 1),
+                  m_length(0),
+                  m_flushOnNewline(flushOnNewline) {
+            static_assert(1 < N, "Buffer must have room for at least one character and the null-terminator");
+        }
+
+        virtual void put_char (const char c) {
+            // A null character can not be stored without cutting the string short
+            if ('\0' == c) {
+                this->flush();
+                this->m_destination->put_char(c);
+            } else {
+                this->m_buffer[this->m_length++] = c;
+                if (this->m_capacity == this->m_length || (this->m_flushOnNewline && '\n' == c))
+                    this->flush();
+            }
+        }
+
+        virtual void puts (const char string[]) {
+            while (*string)
+                this->put_char(*string++);
+        }
+
+        /**
+         * @brief   Send everything in the buffer to the destination
+         */
+        void flush () {
+            if (this->m_length) {
+                this->m_buffer[this->m_length] = '\0';
+                this->m_destination->puts(this->m_buffer);
+                this->m_length = 0;
+            }
+        }
+
+        /**
+         * @brief   Number of characters waiting to be flushed
+         */
+        size_t get_length () const {
+            return this->m_length;
+        }
+
+        /**
+         * @brief       Choose whether or not a newline character flushes the buffer
+         */
+        void set_flush_on_newline (const bool flushOnNewline) {
+            this->m_flushOnNewline = flushOnNewline;
+        }
+
+        bool get_flush_on_newline () const {
+            return this->m_flushOnNewline;
+        }
+
+    protected:
+        PrintCapable *m_destination;
+        char         *m_buffer;
+        const size_t m_capacity;
+        size_t       m_length;
+        bool         m_flushOnNewline;
+};
+
+/**
+ * @brief   A PropWare::Printer which batches its output, so that each line reaches the device with a single `puts`
+ *
+ * Formatting, including the `\r` inserted by cooked mode, happens in hub RAM and only complete lines (or full buffers)
+ * are sent on to the device. With PropWare::UARTTX, that turns one `send` per character into one `send_array` per line.
+ *
+ * @code
+ * static char buffer[64];
+ *
+ * int main () {
+ *     PropWare::UARTTX          uart;
+ *     PropWare::BufferedPrinter printer(uart, buffer);
+ *
+ *     printer.printf("Reading %d: %d\n", i, value); // One send_array call
+ *     printer << "Partial line";
+ *     printer.flush();
+ * }
+ * @endcode
+ *
+ * Output without a trailing newline stays in the buffer until PropWare::BufferedPrinter::flush is called (or the
+ * printer is destroyed). Like PropWare::Printer, a BufferedPrinter is not safe to use from multiple cogs at once.
+ */
+class BufferedPrinter : public Printer {
+    public:
+        /**
+         * @brief       Construct a buffered printer
+         *
+         * @param[in]   printCapable    Device which receives the output, such as a PropWare::UARTTX
+         * @param[in]   buffer          Statically allocated array, NOT a pointer. A line longer than the buffer is
+         *                              sent in pieces
+         * @param[in]   cooked          True to turn cooked mode on, false to turn it off. See
+         *                              PropWare::Printer::set_cooked for more information
+         * @param[in]   flushOnNewline  When true, output is sent after every newline character
+         */
+        template<size_t N>
+        BufferedPrinter (PrintCapable &printCapable, char (&buffer)[N], const bool cooked = true,
+                         const bool flushOnNewline = true)
+                : Printer(m_printBuffer, cooked),
+                  m_printBuffer(printCapable, buffer, flushOnNewline) {
+        }
+
+        /**
+         * @brief   Send any output still in the buffer
+         */
+        ~BufferedPrinter () {
+            this->flush();
+        }
+
+        /**
+         * @brief   Send everything in the buffer to the device
+         */
+        void flush () {
+            this->m_printBuffer.flush();
+        }
+
+        /**
+         * @brief   Buffer in front of the device, for changing when it is flushed
+         */
+        PrintBuffer &get_print_buffer () {
+            return this->m_printBuffer;
+        }
+
+    protected:
+        PrintBuffer m_printBuffer;
+};
+
+}
@@ -0,0 +1,365 @@
+/**
+ * @file    PropWare/hmi/output/compiledformat.h
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+/**
+ * @brief       Parse a printf-style format string at compile time, for use with PropWare::Printer::printf
+ *
+ * @code
+ * pwOut.printf(PW_FMT("x=%5d y=%X\n"), x, y);
+ * @endcode
+ *
+ * @param[in]   formatString    String literal using the same conversions as PropWare::Printer::printf
+ */
+#define PW_FMT(formatString) \
+    ([] () { \
+        struct PropWareFormatString { \
+            static constexpr const char *string () { \
+                return formatString; \
+            } \
+        }; \
+        return PropWare::CompiledFormat<PropWareFormatString>(); \
+    }())
+
+namespace PropWare {
+
+/**
+ * @brief   Compile-time helpers for walking a printf-style format string
+ *
+ * Every function is `constexpr` and is only ever evaluated by the compiler; none of them end up in the binary.
+ */
+class FormatParser {
+    public:
+        static constexpr bool is_digit (const char c) {
+            return '0' <= c && c <= '9';
+        }
+
+        /**
+         * @brief   Index of the first '%' at or after `i`, or of the null-terminator if there is none
+         */
+        static constexpr size_t find_percent (const char *s, const size_t i) {
+            return ('\0' == s[i] || '%' == s[i]) ? i : find_percent(s, i + 1);
+        }
+
+        /**
+         * @brief   Number of '\n' characters from index `i` up to, but not including, `end`
+         */
+        static constexpr size_t count_newlines (const char *s, const size_t i, const size_t end) {
+            return i == end ? 0 : ('\n' == s[i]) + count_newlines(s, i + 1, end);
+        }
+
+        /**
+         * @brief   Character number `n` of the text starting at `i`, as cooked mode sends it: every "\n" as "\r\n"
+         */
+        static constexpr char cooked_char (const char *s, const size_t i, const size_t n) {
+            return '\n' == s[i]
+                   ? (0 == n ? '\r' : (1 == n ? '\n' : cooked_char(s, i + 1, n - 2)))
+                   : (0 == n ? s[i] : cooked_char(s, i + 1, n - 1));
+        }
+
+        static constexpr size_t skip_digits (const char *s, const size_t i) {
+            return is_digit(s[i]) ? skip_digits(s, i + 1) : i;
+        }
+
+        static constexpr uint16_t parse_number (const char *s, const size_t i, const uint16_t value = 0) {
+            return is_digit(s[i]) ? parse_number(s, i + 1, (uint16_t) (10 * value + s[i] - '0')) : value;
+        }
+
+        /**
+         * @brief   Index of the conversion character (such as 'd') for the specification starting at `percent`
+         */
+        static constexpr size_t conversion_index (const char *s, const size_t percent) {
+            return '.' == s[skip_digits(s, percent + 1)]
+                   ? skip_digits(s, skip_digits(s, percent + 1) + 1)
+                   : skip_digits(s, percent + 1);
+        }
+
+        /**
+         * @brief   Number of arguments consumed by the format string from index `i` onward
+         */
+        static constexpr size_t count_conversions (const char *s, const size_t i) {
+            return '\0' == s[find_percent(s, i)]
+                   ? 0
+                   : '%' == s[find_percent(s, i) + 1]
+                     ? count_conversions(s, find_percent(s, i) + 2)
+                     : '\0' == s[conversion_index(s, find_percent(s, i))]
+                       ? 1
+                       : 1 + count_conversions(s, conversion_index(s, find_percent(s, i)) + 1);
+        }
+
+        /**
+         * @brief   Conversion character (such as 'd') which consumes argument number `n`, or '\0' if there is none
+         */
+        static constexpr char nth_conversion (const char *s, const size_t n, const size_t i = 0) {
+            return '\0' == s[find_percent(s, i)]
+                   ? '\0'
+                   : '%' == s[find_percent(s, i) + 1]
+                     ? nth_conversion(s, n, find_percent(s, i) + 2)
+                     : 0 == n
+                       ? s[conversion_index(s, find_percent(s, i))]
+                       : nth_conversion(s, n - 1, conversion_index(s, find_percent(s, i)) + 1);
+        }
+};
+
+/** @cond DOXYGEN_IGNORE */
+namespace compiled_format {
+
+template<size_t... I>
+struct IndexList {
+};
+
+template<size_t N, size_t... I>
+struct MakeIndexList : MakeIndexList<N - 1, N - 1, I...> {
+};
+
+template<size_t... I>
+struct MakeIndexList<0, I...> {
+    typedef IndexList<I...> type;
+};
+
+/**
+ * Null-terminated copy of literal text with every "\n" already expanded to "\r\n", so that a printer in cooked mode
+ * can also send it with a single `puts`
+ */
+template<typename S, size_t BEGIN, typename Indices>
+struct CookedLiteral;
+
+template<typename S, size_t BEGIN, size_t... I>
+struct CookedLiteral<S, BEGIN, IndexList<I...>> {
+    static const char text[sizeof...(I) + 1];
+};
+
+template<typename S, size_t BEGIN, size_t... I>
+const char CookedLiteral<S, BEGIN, IndexList<I...>>::text[sizeof...(I) + 1] = {
+        FormatParser::cooked_char(S::string(), BEGIN, I)..., '\0'};
+
+/**
+ * Null-terminated copy of the literal text between two conversions, so that it can be sent with a single `puts`
+ */
+template<typename S, size_t BEGIN, typename Indices>
+struct Literal;
+
+template<typename S, size_t BEGIN>
+struct Literal<S, BEGIN, IndexList<>> {
+    template<typename P>
+    static void print (const P &printer) {
+    }
+};
+
+template<typename S, size_t BEGIN, size_t... I>
+struct Literal<S, BEGIN, IndexList<I...>> {
+    static const size_t NEWLINES = FormatParser::count_newlines(S::string(), BEGIN, BEGIN + sizeof...(I));
+    static const char   text[sizeof...(I) + 1];
+
+    template<typename P>
+    static void print (const P &printer) {
+        // Printer::puts would translate a cooked string one character at a time
+        if (printer.get_cooked())
+            printer.get_print_capable()->puts(cooked_text(std::integral_constant<bool, 0 != NEWLINES>()));
+        else
+            printer.puts(text);
+    }
+
+    static const char *cooked_text (std::false_type) {
+        return text;
+    }
+
+    static const char *cooked_text (std::true_type) {
+        return CookedLiteral<S, BEGIN, typename MakeIndexList<sizeof...(I) + NEWLINES>::type>::text;
+    }
+};
+
+template<typename S, size_t BEGIN, size_t... I>
+const char Literal<S, BEGIN, IndexList<I...>>::text[sizeof...(I) + 1] = {S::string()[BEGIN + I]..., '\0'};
+
+template<typename T>
+struct Fits32Bits {
+    static const bool value = sizeof(T) <= sizeof(uint32_t);
+};
+
+/**
+ * One conversion: checks the argument's type and prints it exactly as the run-time PropWare::Printer::printf would
+ */
+template<char CONVERSION>
+struct Conversion {
+    template<typename P, typename T>
+    static void print (const P &printer, const T &value, const typename P::Format &format) {
+        static_assert(CONVERSION != CONVERSION, "Unsupported conversion in format string");
+    }
+};
+
+template<>
+struct Conversion<'d'> {
+    template<typename P, typename T>
+    static void print (const P &printer, const T &value, const typename P::Format &format) {
+        static_assert(std::is_integral<T>::value, "%d and %i require an integer argument");
+        if (Fits32Bits<T>::value)
+            printer.put_int((int) value, format.radix, format.width, format.fillChar);
+        else
+            printer.put_ll((long long) value, format.radix, format.width, format.fillChar);
+    }
+};
+
+template<>
+struct Conversion<'i'> : Conversion<'d'> {
+};
+
+template<>
+struct Conversion<'u'> {
+    template<typename P, typename T>
+    static void print (const P &printer, const T &value, const typename P::Format &format) {
+        static_assert(std::is_integral<T>::value, "%u, %X and %b require an integer argument");
+        if (Fits32Bits<T>::value)
+            printer.put_uint((unsigned int) value, format.radix, format.width, format.fillChar);
+        else
+            printer.put_ull((unsigned long long) value, format.radix, format.width, format.fillChar);
+    }
+};
+
+template<>
+struct Conversion<'X'> : Conversion<'u'> {
+};
+
+template<>
+struct Conversion<'b'> : Conversion<'u'> {
+};
+
+template<>
+struct Conversion<'c'> {
+    template<typename P, typename T>
+    static void print (const P &printer, const T &value, const typename P::Format &format) {
+        static_assert(std::is_same<T, char>::value, "%c requires a char argument");
+        printer.put_char(value);
+    }
+};
+
+template<>
+struct Conversion<'s'> {
+    template<typename P, typename T>
+    static void print (const P &printer, const T &value, const typename P::Format &format) {
+        static_assert(std::is_convertible<T, const char *>::value, "%s requires a string argument");
+        printer.puts(value);
+    }
+};
+
+template<>
+struct Conversion<'f'> {
+    template<typename P, typename T>
+    static void print (const P &printer, const T &value, const typename P::Format &format) {
+        static_assert(std::is_arithmetic<T>::value, "%f requires a numeric argument");
+        printer.put_float((double) value, format.width, format.precision, format.fillChar);
+    }
+};
+
+template<typename S, size_t POSITION>
+struct Segment;
+
+/**
+ * What follows a run of literal text: the end of the string, an escaped "%%" or a conversion
+ */
+template<typename S, size_t PERCENT, char NEXT = S::string()[PERCENT] ? S::string()[PERCENT + 1] : '\0'>
+struct Specification {
+    static const size_t CONVERSION_INDEX = FormatParser::conversion_index(S::string(), PERCENT);
+    static const char   CONVERSION       = S::string()[CONVERSION_INDEX];
+    static const size_t WIDTH_END        = FormatParser::skip_digits(S::string(), PERCENT + 1);
+    static const bool   HAS_PRECISION    = '.' == S::string()[WIDTH_END];
+
+    static_assert('\0' != CONVERSION, "Format string ends in the middle of a conversion");
+
+    template<typename P, typename T, typename... Targs>
+    static void print (const P &printer, const T &first, const Targs &... remaining) {
+        const typename P::Format format(
+                FormatParser::parse_number(S::string(), PERCENT + 1),
+                '0' == NEXT ? '0' : P::DEFAULT_FILL_CHAR,
+                'X' == CONVERSION ? 16 : ('b' == CONVERSION ? 2 : P::DEFAULT_RADIX),
+                HAS_PRECISION ? FormatParser::parse_number(S::string(), WIDTH_END + 1) : P::DEFAULT_PRECISION);
+        Conversion<CONVERSION>::print(printer, first, format);
+        Segment<S, CONVERSION_INDEX + 1>::print(printer, remaining...);
+    }
+};
+
+template<typename S, size_t PERCENT>
+struct Specification<S, PERCENT, '%'> {
+    template<typename P, typename... Targs>
+    static void print (const P &printer, const Targs &... args) {
+        printer.put_char('%');
+        Segment<S, PERCENT + 2>::print(printer, args...);
+    }
+};
+
+template<typename S, size_t PERCENT>
+struct Specification<S, PERCENT, '\0'> {
+    static_assert('\0' == S::string()[PERCENT], "Format string ends in the middle of a conversion");
+
+    template<typename P, typename... Targs>
+    static void print (const P &printer, const Targs &... args) {
+    }
+};
+
+/**
+ * Literal text starting at `POSITION`, followed by whatever comes after it
+ */
+template<typename S, size_t POSITION>
+struct Segment {
+    static const size_t PERCENT = FormatParser::find_percent(S::string(), POSITION);
+
+    template<typename P, typename... Targs>
+    static void print (const P &printer, const Targs &... args) {
+        Literal<S, POSITION, typename MakeIndexList<PERCENT - POSITION>::type>::print(printer);
+        Specification<S, PERCENT>::print(printer, args...);
+    }
+};
+
+}
+/** @endcond */
+
+/**
+ * @brief   A format string which was parsed at compile time; create one with the PW_FMT macro
+ *
+ * Literal text between conversions is sent with a single `puts` call, also in cooked mode: its "\n" characters are
+ * expanded to "\r\n" by the compiler. Each conversion calls the matching PropWare::Printer method directly and the
+ * argument types are checked against the conversions by the compiler. Nothing is parsed at run time.
+ */
+template<typename S>
+struct CompiledFormat {
+    /** Number of arguments which must accompany the format string */
+    static const size_t ARGUMENTS = FormatParser::count_conversions(S::string(), 0);
+
+    template<typename P, typename... Targs>
+    static void print (const P &printer, const Targs &... args) {
+        static_assert(ARGUMENTS == sizeof...(Targs), "Number of arguments does not match the format string");
+        compiled_format::Segment<S, 0>::print(printer, args...);
+    }
+};
+
+template<typename S>
+const size_t CompiledFormat<S>::ARGUMENTS;
+
+}
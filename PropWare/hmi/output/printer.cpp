@@ -24,11 +24,19 @@
  */
 
 #include <PropWare/hmi/output/printer.h>
-#include <PropWare/serial/uart/uarttx.h>
 
 const PropWare::Printer::Format PropWare::Printer::DEFAULT_FORMAT;
 
+#ifdef __PROPELLER__
+#include <PropWare/serial/uart/uarttx.h>
+
 #ifndef __PROPELLER_COG__
 PropWare::UARTTX  _g_uarttx;
 PropWare::Printer pwOut(_g_uarttx);
 #endif
+#else
+#include <PropWare/models/host/console.h>
+
+PropWare::Console _g_console;
+PropWare::Printer pwOut(_g_console);
+#endif
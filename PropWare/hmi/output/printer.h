@@ -27,18 +27,13 @@
 
 #include <PropWare/PropWare.h>
 #include <PropWare/hmi/output/printcapable.h>
+#include <PropWare/hmi/output/compiledformat.h>
 #include <PropWare/utility/utility.h>
+#include <PropWare/utility/fixed.h>
+#include <string.h>
 
 namespace PropWare {
 
-#ifndef S_ISNAN
-#define S_ISNAN(x) (x != x)
-#endif  /* !defined(S_ISNAN) */
-
-#ifndef S_ISINF
-#define S_ISINF(x) (x != 0.0 && x + x == x)
-#endif  /* !defined(S_ISINF) */
-
 #ifndef isdigit
 #define isdigit(x) ('0' <= x && x <= '9')
 #endif
@@ -79,6 +74,8 @@ class Printer {
         static const uint16_t DEFAULT_PRECISION = 6;
         static const uint8_t  DEFAULT_RADIX     = 10;
         static const char     DEFAULT_FILL_CHAR = ' ';
+        /** Largest precision accepted by PropWare::Printer::put_float and PropWare::Printer::put_fixed */
+        static const uint16_t MAX_PRECISION     = 9;
 
         /**
          * @brief   Passed into any of the `Printer::print` methods, this struct controls how aspects of numerical
@@ -167,6 +164,26 @@ class Printer {
             return this->m_cooked;
         }
 
+        /**
+         * @brief       Send all future output to a different device
+         *
+         * Useful for redirecting a shared instance, such as `pwOut`, to a faster or buffered device after startup.
+         *
+         * @param[in]   printCapable    The address of any initialized communication object such as a PropWare::UART
+         */
+        void set_print_capable (PrintCapable &printCapable) {
+            this->m_printCapable = &printCapable;
+        }
+
+        /**
+         * @brief       Retrieve the device that this printer is sending characters to
+         *
+         * @returns     The device passed to the constructor or to PropWare::Printer::set_print_capable
+         */
+        PrintCapable *get_print_capable () const {
+            return this->m_printCapable;
+        }
+
         /**
          * @brief       Print a single character
          *
@@ -207,7 +224,8 @@ class Printer {
             if (0 > x)
                 this->put_char('-');
 
-            this->put_uint((uint32_t) abs(x), radix, width, fillChar);
+            // Negate as unsigned: the magnitude of INT_MIN does not fit in an int
+            this->put_uint(0 > x ? 0U - (unsigned int) x : (unsigned int) x, radix, width, fillChar);
         }
 
         /**
@@ -221,27 +239,11 @@ class Printer {
          */
         void put_uint (unsigned int x, const uint8_t radix = 10, uint16_t width = 0,
                        const char fillChar = DEFAULT_FILL_CHAR) const {
-            char    buf[sizeof(x) * 8]; // Max size would be a single character for each bit - aka, bytes * 8
-            uint_fast8_t i = 0;
-
-            // Create a character array in reverse order, starting with the
-            // tens digit and working toward the largest digit
-            do {
-                const unsigned int digit = x % radix;
-                buf[i] = static_cast<char>(digit > 9 ? digit + 'A' - 10 : digit + '0');
-                x /= radix;
-                ++i;
-            } while (x);
-
-            if (width && width > i) {
-                width -= i;
-                while (width--)
-                    this->put_char(fillChar);
-            }
-
-            // Reverse the character array
-            for (unsigned int j = 0; j < i; ++j)
-                this->put_char(buf[i - j - 1]);
+            // Max size would be a single character for each bit - aka, bytes * 8 - plus the null-terminator
+            char buffer[sizeof(x) * 8 + 1];
+            char *end = &buffer[sizeof(x) * 8];
+            *end = '\0';
+            this->put_digits(buffer, format_uint(x, radix, end), end, width, fillChar);
         }
 
         /**
@@ -258,7 +260,7 @@ class Printer {
             if (0 > x)
                 this->put_char('-');
 
-            this->put_ull((unsigned long long) llabs(x), radix, width, fillChar);
+            this->put_ull(0 > x ? 0ULL - (unsigned long long) x : (unsigned long long) x, radix, width, fillChar);
         }
 
         /**
@@ -272,177 +274,221 @@ class Printer {
          */
         void put_ull (unsigned long long x, const uint8_t radix = 10, uint16_t width = 0,
                       const char fillChar = DEFAULT_FILL_CHAR) const {
-            char         buf[sizeof(x) * 8]; // Max size would be a single character for each bit - aka, bytes * 8
-            uint_fast8_t i = 0;
+            // Max size would be a single character for each bit - aka, bytes * 8 - plus the null-terminator
+            char buffer[sizeof(x) * 8 + 1];
+            char *end = &buffer[sizeof(x) * 8];
+            *end = '\0';
+            this->put_digits(buffer, format_ull(x, radix, end), end, width, fillChar);
+        }
 
-            // Create a character array in reverse order, starting with the
-            // tens digit and working toward the largest digit
-            do {
-                const uint_fast8_t digit = static_cast<uint_fast8_t>(x % radix);
-                buf[i] = static_cast<char>(digit > 9 ? digit + 'A' - 10 : digit + '0');
-                x /= radix;
-                ++i;
-            } while (x);
-
-            if (width && width > i) {
-                width -= i;
-                while (width--)
-                    this->put_char(fillChar);
+        /**
+         * @brief       Write the digits of an unsigned integer backwards, starting just before `end`
+         *
+         * The Propeller has neither a hardware divider nor a hardware multiplier, so the common radices avoid both:
+         * powers of two are split with shifts and masks and base 10 uses PropWare::Printer::divide_by_10. Any other
+         * radix falls back to `%` and `/`.
+         *
+         * @param[in]   x       Integer to be converted
+         * @param[in]   radix   Radix to print the integer (aka, the base of the number)
+         * @param[out]  end     One past the last digit; the caller is responsible for the null-terminator
+         *
+         * @return      Address of the most significant digit. No more than `sizeof(x) * 8` characters are written
+         */
+        static char *format_uint (uint32_t x, const uint8_t radix, char *end) {
+            if (10 == radix) {
+                do {
+                    uint_fast8_t digit;
+                    x = divide_by_10(x, digit);
+                    *--end = static_cast<char>(digit + '0');
+                } while (x);
+            } else if (0 == (radix & (radix - 1))) {
+                const uint_fast8_t shift = static_cast<uint_fast8_t>(__builtin_ctz(radix));
+                const uint32_t     mask  = radix - 1U;
+                do {
+                    *--end = to_digit(x & mask);
+                    x >>= shift;
+                } while (x);
+            } else {
+                do {
+                    *--end = to_digit(x % radix);
+                    x /= radix;
+                } while (x);
+            }
+            return end;
+        }
+
+        /**
+         * @brief       Write the digits of an unsigned 64-bit integer backwards, starting just before `end`
+         *
+         * Base 10 only pays for 64-bit arithmetic until the remaining value fits in 32 bits.
+         *
+         * @see         PropWare::Printer::format_uint
+         */
+        static char *format_ull (uint64_t x, const uint8_t radix, char *end) {
+            if (10 == radix) {
+                while (x >> 32) {
+                    uint_fast8_t digit;
+                    x = divide_by_10(x, digit);
+                    *--end = static_cast<char>(digit + '0');
+                }
+                return format_uint(static_cast<uint32_t>(x), radix, end);
+            } else if (0 == (radix & (radix - 1))) {
+                const uint_fast8_t shift = static_cast<uint_fast8_t>(__builtin_ctz(radix));
+                const uint32_t     mask  = radix - 1U;
+                do {
+                    *--end = to_digit(static_cast<uint32_t>(x) & mask);
+                    x >>= shift;
+                } while (x);
+            } else {
+                do {
+                    *--end = to_digit(static_cast<uint32_t>(x % radix));
+                    x /= radix;
+                } while (x);
             }
+            return end;
+        }
+
+        /**
+         * @brief       Divide by ten using only shifts and adds
+         *
+         * The quotient is approximated as `x * 0.8 / 8`, with 0.8 built up from its repeating binary fraction
+         * (0.1100 1100...), and then corrected by at most one using the remainder. See "Hacker's Delight", section
+         * 10-18.
+         *
+         * @param[in]   x           Dividend
+         * @param[out]  remainder   `x % 10`
+         *
+         * @return      `x / 10`
+         */
+        static uint32_t divide_by_10 (const uint32_t x, uint_fast8_t &remainder) {
+            uint32_t q = (x >> 1) + (x >> 2);
+            q += q >> 4;
+            q += q >> 8;
+            q += q >> 16;
+            q >>= 3;
+            return correct_quotient(x, q, remainder);
+        }
 
-            // Reverse the character array
-            for (unsigned int j = 0; j < i; ++j)
-                this->put_char(buf[i - j - 1]);
+        /**
+         * @overload
+         */
+        static uint64_t divide_by_10 (const uint64_t x, uint_fast8_t &remainder) {
+            uint64_t q = (x >> 1) + (x >> 2);
+            q += q >> 4;
+            q += q >> 8;
+            q += q >> 16;
+            q += q >> 32;
+            q >>= 3;
+            return correct_quotient(x, q, remainder);
         }
 
         /**
          * @brief       Print a floating point number with a given width and
          *              precision
          *
-         * @param[in]   f           Number to print
-         * @param[in]   width       Number of integer digits to print (includes
-         *                          decimal point)
-         * @param[in]   precision   Number of digits to print to the right of
-         *                          the decimal point
+         * Only integer arithmetic is used. Numbers are rounded correctly (half to even, like the C-standard printf)
+         * from the exact value of the `float`.
+         *
+         * @param[in]   f           Number to print; it is converted to a single-precision `float`
+         * @param[in]   width       Minimum number of characters to print, including the sign and decimal point
+         * @param[in]   precision   Number of digits to print to the right of the decimal point, no more than
+         *                          PropWare::Printer::MAX_PRECISION
          * @param[in]   fillChar    Character to print to the left of the number
-         *                          if the number's width is less than `width`
+         *                          if the number's width is less than `width`. Zeros go between the sign and the digits
          */
         void put_float (double f, uint16_t width = 0, uint16_t precision = 6,
                         const char fillChar = DEFAULT_FILL_CHAR) const {
-            ////////////////////////////////////////////////////////////////////
-            // Code taken straight from Parallax's floatToString! Thank you!!!
-            ////////////////////////////////////////////////////////////////////
-
-            char buffer[32];
-            char *s = buffer;
-            union convert {
-                float v;
-                int   w;
-            }    fval;
-
-            int m = 0;
-            int k = 0;
-
-            int j    = 0;
-            int sign = 0;
-            int g    = 0;
-
-            int   reps = 0;
-            float scale;
-            int   ctr  = 0;
-
-            int offset;
-            int p;
-            int q;
-            int n;
-
-            if (S_ISNAN(f)) {
-                this->puts("nan");
-            }
-            if (S_ISINF(f)) {
-                if (((int) f) & 0x80000000)
-                    this->puts("-inf");
-                else
-                    this->puts("inf");
+            union {
+                float    value;
+                uint32_t bits;
+            } convert;
+            convert.value = (float) f;
+
+            const bool negative = convert.bits >> 31;
+            int        exponent = (convert.bits >> 23) & 0xFF;
+            uint32_t   mantissa = convert.bits & 0x7FFFFF;
+
+            if (0xFF == exponent) {
+                char text[] = "-inf";
+                char *digits = mantissa ? strcpy(text, "nan") : (negative ? text : text + 1);
+                this->put_digits(text, digits, digits + strlen(digits), width, ' ');
+                return;
             }
 
-            /* clamp the digits. */
-            int clamp = 6; /* a buffer must be at least clamp + 4 digits */
-            precision = (precision > clamp) ? clamp : precision;
-
-            if (f < 0.0) {
-                sign = 1;
-                f    = -f;
-            }
-
-            if (sign) {
-                s[j++] = '-';
-            }
-
-            /* Find reasonable starting value for scale.
-            // Using 2^10x has similar values to 10^3x. */
-            fval.v = f;
-            g = fval.w;
-
-            g >>= 23;
-            g &= 0xFF;
-            g -= 127;
-
-            reps     = (g / 10);
-            scale    = 1.0;
-            for (ctr = 0; ctr <= reps; ctr++) {
-                scale *= 1000.0;
-            }
-
-            /* If integer is zero, 0 */
-            if (f < 1.0) {
-                s[j++] = '0';
-            }
-            else {
-                char c;
-                for (; scale >= 1.0; scale /= 10.0) {
-                    if (f >= scale) {
-                        break;
-                    }
-                }
-                for (; scale >= 1.0; scale /= 10.0) {
-                    c = (char) (f / scale);
-                    f -= ((float) c * scale);
-                    c += 48;
-                    s[j++] = c;
-                }
-            }
-
-            /* If width > current size, move right, then pad with spaces */
-            offset = width - j - precision - 1;
-            if (precision == 0)
-                offset++;
-
-            p = j + offset;
-            q = j;
-            n = p;
-
-            if (offset > 0) {
-                for (; j >= 0;) {
-                    s[n--] = s[j--];
-                }
-                for (; n >= 0;) {
-                    s[n--] = fillChar;
-                }
-                j = p;
-            }
+            // Subnormals have no implied leading one
+            if (exponent)
+                mantissa |= 1UL << 23;
             else
-                j = q;
-
-            /* Append with fractional */
-            if (precision > 0)
-                s[j++] = '.';
-
-            k = j;
-            k += precision;
-            for (; j <= k;) {
-                f *= 10.0;
-                s[j++] = (char) f + '0';
-                f -= ((int) f);
-            }
-
-            m = j - 1;
-            j--;
-            if (s[j] >= '5') {
-                j--;
-                for (; (j >= 0); j--)
-                    if (!(s[j] < '0' || s[j] > '9')) {
-                        if (s[j] < '9') {
-                            s[j]++;
-                            break;
-                        } else
-                            s[j] = '0';
-                    }
-            }
+                exponent = 1;
+
+            // The number is exactly mantissa * 2^shift
+            const int shift = exponent - 127 - 23;
+            if (64 - 24 < shift)
+                this->put_large_float(negative, mantissa, shift, width, precision, fillChar);
+            else if (0 <= shift)
+                this->put_fixed_point(negative, (uint64_t) mantissa << shift, 0, width, precision, fillChar);
+            else if (-shift <= FRACTION_BITS) {
+                const uint64_t integer  = -shift < 24 ? mantissa >> -shift : 0;
+                const uint64_t fraction = ((uint64_t) mantissa << (FRACTION_BITS + shift)) & FRACTION_MASK;
+                this->put_fixed_point(negative, integer, fraction, width, precision, fillChar);
+            } else
+                // Less than 2^-36, so even MAX_PRECISION digits round to zero
+                this->put_fixed_point(negative, 0, 0, width, precision, fillChar);
+        }
 
-            s[m] = 0;
+        /**
+         * @brief       Print a fixed-point number with a given width and precision
+         *
+         * @param[in]   x           Number to print
+         * @param[in]   width       Minimum number of characters to print, including the sign and decimal point
+         * @param[in]   precision   Number of digits to print to the right of the decimal point, no more than
+         *                          PropWare::Printer::MAX_PRECISION
+         * @param[in]   fillChar    Character to print to the left of the number
+         *                          if the number's width is less than `width`. Zeros go between the sign and the digits
+         */
+        template<uint8_t FRACTION>
+        void put_fixed (const Fixed<FRACTION> x, uint16_t width = 0, uint16_t precision = 6,
+                        const char fillChar = DEFAULT_FILL_CHAR) const {
+            const bool     negative  = 0 > x.get_raw();
+            const uint32_t magnitude = negative ? -(uint32_t) x.get_raw() : (uint32_t) x.get_raw();
+            this->put_fixed_point(negative, magnitude >> FRACTION,
+                                  (uint64_t) (magnitude & ((1UL << FRACTION) - 1)) << (FRACTION_BITS - FRACTION),
+                                  width, precision, fillChar);
+        }
 
-            this->puts(s);
+        /**
+         * @brief       Print an integer which has been scaled by a power of ten, such as millivolts as volts
+         *
+         * @code
+         * pwOut.put_decimal(-1205, 3); // "-1.205"
+         * @endcode
+         *
+         * @param[in]   x           Scaled integer to be printed
+         * @param[in]   decimals    Number of the integer's digits which belong after the decimal point, no more than
+         *                          10
+         * @param[in]   width       Minimum number of characters to print, including the sign and decimal point
+         * @param[in]   fillChar    Character to print to the left of the number
+         *                          if the number's width is less than `width`. Zeros go between the sign and the digits
+         */
+        void put_decimal (const int32_t x, const uint8_t decimals, const uint16_t width = 0,
+                          const char fillChar = DEFAULT_FILL_CHAR) const {
+            // Sign, one digit per bit, leading zeros, decimal point and null-terminator
+            char       buffer[1 + 32 + 10 + 1 + 1];
+            char       *end     = &buffer[sizeof(buffer) - 1];
+            const bool negative = 0 > x;
+            *end = '\0';
+
+            char *digits = format_uint(negative ? -(uint32_t) x : (uint32_t) x, 10, end);
+            if (decimals) {
+                const uint8_t places = decimals < 10 ? decimals : 10;
+                while (end - digits <= places)
+                    *--digits = '0';
+                char *point = end - places;
+                memmove(digits - 1, digits, point - digits);
+                *--point = '.';
+                --digits;
+            }
+            this->put_signed_digits(buffer, digits, end, negative, width, fillChar);
         }
 
         /**
@@ -532,14 +578,14 @@ class Printer {
                         switch (c) {
                             case 'i':
                             case 'd':
-                                this->print((int) first, format);
+                                this->print((int) (intptr_t) first, format);
                                 break;
                             case 'X':
                             case 'b':
                                 format.radix = static_cast<uint8_t>('b' == c ? 2 : 16);
                                 // No "break;" after 'X' - let it flow into 'u'
                             case 'u':
-                                this->print((unsigned int) first, format);
+                                this->print((unsigned int) (uintptr_t) first, format);
                                 break;
                             case 'f':
                             case 's':
@@ -571,6 +617,27 @@ class Printer {
             this->puts(fmt);
         }
 
+        /**
+         * @brief       Print with a format string that was parsed at compile time
+         *
+         * Output is identical to the run-time version of PropWare::Printer::printf, but nothing is parsed at run time:
+         * each run of literal text is sent with a single call to PropWare::Printer::puts and each conversion calls the
+         * matching `put_*` method directly. The number and types of the arguments are checked by the compiler, so
+         * `%c` requires a `char`, `%s` a string, `%f` a number and every other conversion an integer. 64-bit integers
+         * are printed in full.
+         *
+         * @code
+         * pwOut.printf(PW_FMT("x=%5d y=%X\n"), x, y);
+         * @endcode
+         *
+         * @param[in]   format  Compiled format string, created with the PW_FMT macro
+         * @param[in]   ...     One argument for each conversion in the format string
+         */
+        template<typename S, typename... Targs>
+        void printf (const CompiledFormat<S> format, const Targs &... args) const {
+            CompiledFormat<S>::print(*this, args...);
+        }
+
         /**
          * @brief       Print a single character
          *
@@ -638,6 +705,33 @@ class Printer {
             this->put_int(x, format.radix, format.width, format.fillChar);
         }
 
+        /**
+         * @brief       Print an unsigned long with the given format; 32 bits on the Propeller, but `size_t` is an
+         *              unsigned long on 64-bit hosts
+         *
+         * @param[in]   x           Unsigned value to be printed
+         * @param[in]   format      Format of the integer
+         */
+        void print (const unsigned long x, const Format &format = DEFAULT_FORMAT) const {
+            if (sizeof(x) > sizeof(unsigned int))
+                this->put_ull(x, format.radix, format.width, format.fillChar);
+            else
+                this->put_uint((unsigned int) x, format.radix, format.width, format.fillChar);
+        }
+
+        /**
+         * @brief       Print a signed long with the given format
+         *
+         * @param[in]   x           Signed value to be printed
+         * @param[in]   format      Format of the integer
+         */
+        void print (const long x, const Format &format = DEFAULT_FORMAT) const {
+            if (sizeof(x) > sizeof(int))
+                this->put_ll(x, format.radix, format.width, format.fillChar);
+            else
+                this->put_int((int) x, format.radix, format.width, format.fillChar);
+        }
+
         /**
          * @brief       Print an unsigned integer with the given format
          *
@@ -645,7 +739,7 @@ class Printer {
          * @param[in]   format      Format of the integer
          */
         void print (const unsigned long long x, const Format &format = DEFAULT_FORMAT) const {
-            this->put_uint(x, format.radix, format.width, format.fillChar);
+            this->put_ull(x, format.radix, format.width, format.fillChar);
         }
 
         /**
@@ -655,7 +749,7 @@ class Printer {
          * @param[in]   format      Format of the integer
          */
         void print (const long long x, const Format &format = DEFAULT_FORMAT) const {
-            this->put_int(x, format.radix, format.width, format.fillChar);
+            this->put_ll(x, format.radix, format.width, format.fillChar);
         }
 
         /**
@@ -668,6 +762,17 @@ class Printer {
             this->put_float(f, format.width, format.precision, format.fillChar);
         }
 
+        /**
+         * @see PropWare::Printer::put_fixed
+         *
+         * @param[in]   x           Fixed-point value to be printed
+         * @param[in]   format      Format of the number
+         */
+        template<uint8_t FRACTION>
+        void print (const Fixed<FRACTION> x, const Format &format = DEFAULT_FORMAT) const {
+            this->put_fixed(x, format.width, format.precision, format.fillChar);
+        }
+
         /**
          * @brief   The `<<` operator allows for highly optimized use of the Printer.
          *
@@ -729,6 +834,154 @@ class Printer {
             return *this;
         }
 
+    protected:
+        /** Binary places used for the fraction of PropWare::Printer::put_float and PropWare::Printer::put_fixed */
+        static const uint_fast8_t FRACTION_BITS = 60;
+        /** All FRACTION_BITS bits of the fraction set */
+        static const uint64_t     FRACTION_MASK = (1ULL << FRACTION_BITS) - 1;
+
+    protected:
+        static char to_digit (const uint32_t digit) {
+            return static_cast<char>(digit > 9 ? digit + 'A' - 10 : digit + '0');
+        }
+
+        template<typename T>
+        static T correct_quotient (const T x, T q, uint_fast8_t &remainder) {
+            // q is never more than one too small: fix it up by checking the remainder
+            uint_fast8_t r = static_cast<uint_fast8_t>(x - (((q << 2) + q) << 1));
+            if (9 < r) {
+                ++q;
+                r -= 10;
+            }
+            remainder = r;
+            return q;
+        }
+
+        /**
+         * Print `integer` plus `fraction` / 2^FRACTION_BITS. Every fraction digit costs one multiply by ten with shifts
+         * and adds
+         */
+        void put_fixed_point (const bool negative, uint64_t integer, uint64_t fraction, const uint16_t width,
+                              uint16_t precision, const char fillChar) const {
+            if (MAX_PRECISION < precision)
+                precision = MAX_PRECISION;
+
+            // Sign, 20 integer digits, decimal point, fraction and null-terminator
+            char buffer[1 + 20 + 1 + MAX_PRECISION + 1];
+            char *end   = &buffer[sizeof(buffer) - 1];
+            char *point = end - precision;
+            *end = '\0';
+
+            for (char *digit = point; digit < end; ++digit) {
+                fraction = (fraction << 3) + (fraction << 1);
+                *digit   = static_cast<char>('0' + (fraction >> FRACTION_BITS));
+                fraction &= FRACTION_MASK;
+            }
+
+            // Round half to even. '0' is even, so a digit's character has the same parity as the digit itself
+            const uint64_t half = FRACTION_MASK / 2 + 1;
+            const bool     odd  = precision ? end[-1] & 1 : integer & 1;
+            if (half < fraction || (half == fraction && odd)) {
+                bool carry = true;
+                for (char *digit = end; carry && point < digit;) {
+                    --digit;
+                    if ('9' == *digit)
+                        *digit = '0';
+                    else {
+                        ++*digit;
+                        carry = false;
+                    }
+                }
+                if (carry)
+                    ++integer;
+            }
+
+            char *digits = point;
+            if (precision)
+                *--digits = '.';
+            digits = format_ull(integer, 10, digits);
+            this->put_signed_digits(buffer, digits, end, negative, width, fillChar);
+        }
+
+        /**
+         * Numbers of 2^64 and above have no fraction, but need more than 64 bits for their integer digits
+         */
+        void put_large_float (const bool negative, const uint32_t mantissa, const int shift, const uint16_t width,
+                              uint16_t precision, const char fillChar) const {
+            if (MAX_PRECISION < precision)
+                precision = MAX_PRECISION;
+
+            // The largest float, 2^128 - 2^104, has 39 digits
+            char buffer[1 + 39 + 1 + MAX_PRECISION + 1];
+            char *end = &buffer[sizeof(buffer) - 1];
+            *end = '\0';
+
+            char *digits = end - precision;
+            memset(digits, '0', precision);
+            if (precision)
+                *--digits = '.';
+
+            // Spread mantissa * 2^shift over four 32-bit words, most significant last, and divide the whole thing by
+            // ten for each digit
+            uint32_t words[4] = {0, 0, 0, 0};
+            words[shift / 32] = mantissa << (shift % 32);
+            // Nothing spills out of the top word: the largest shift, 104, leaves a 24-bit mantissa just fitting
+            if (shift % 32 && 3 > shift / 32)
+                words[shift / 32 + 1] = mantissa >> (32 - shift % 32);
+
+            bool remaining;
+            do {
+                uint32_t remainder = 0;
+                remaining = false;
+                for (int i = 3; 0 <= i; --i) {
+                    uint_fast8_t digit;
+                    words[i] = (uint32_t) divide_by_10(((uint64_t) remainder << 32) | words[i], digit);
+                    remainder = digit;
+                    remaining |= 0 != words[i];
+                }
+                *--digits = static_cast<char>('0' + remainder);
+            } while (remaining);
+
+            this->put_signed_digits(buffer, digits, end, negative, width, fillChar);
+        }
+
+        /**
+         * Print digits which have room for a sign in front of them. Zero padding goes between the sign and the digits
+         */
+        void put_signed_digits (char buffer[], char *digits, const char *end, const bool negative, uint16_t width,
+                                const char fillChar) const {
+            if (negative) {
+                if ('0' == fillChar) {
+                    this->put_char('-');
+                    if (width)
+                        --width;
+                } else
+                    *--digits = '-';
+            }
+            this->put_digits(buffer, digits, end, width, fillChar);
+        }
+
+        /**
+         * Send the digits and their padding with a single `puts`, as long as the padding fits in the digits' buffer
+         */
+        void put_digits (char buffer[], char *digits, const char *end, uint16_t width, const char fillChar) const {
+            const uint16_t length = static_cast<uint16_t>(end - digits);
+            if (width > length) {
+                width -= length;
+                for (; width && digits > buffer; --width)
+                    *--digits = fillChar;
+                while (width--)
+                    this->put_char(fillChar);
+            }
+
+            // Digits never include a newline, so there is nothing to translate in cooked mode unless the fill character
+            // happens to be one
+            if (this->m_cooked && '\n' == fillChar)
+                this->puts(digits);
+            else
+                this->m_printCapable->puts(digits);
+        }
+
     protected:
         PrintCapable *m_printCapable;
         bool         m_cooked;
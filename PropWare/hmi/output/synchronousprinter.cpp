@@ -24,6 +24,8 @@
  */
 
 #include <PropWare/hmi/output/synchronousprinter.h>
+
+#ifdef __PROPELLER__
 #include <PropWare/serial/uart/shareduarttx.h>
 
 #ifndef __PROPELLER_COG__
@@ -31,3 +33,10 @@ PropWare::SharedUARTTX             _g_sharedSimplexUart;
 const PropWare::Printer            _g_printer(_g_sharedSimplexUart);
 const PropWare::SynchronousPrinter pwSyncOut(_g_printer);
 #endif
+#else
+#include <PropWare/models/host/console.h>
+
+PropWare::Console                  _g_syncConsole;
+const PropWare::Printer            _g_printer(_g_syncConsole);
+const PropWare::SynchronousPrinter pwSyncOut(_g_printer);
+#endif
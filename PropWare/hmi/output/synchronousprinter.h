@@ -26,6 +26,8 @@
 #pragma once
 
 #include <PropWare/hmi/output/printer.h>
+#include <PropWare/concurrent/hardwarelock.h>
+#include <PropWare/concurrent/lockreference.h>
 
 namespace PropWare {
 
@@ -33,6 +35,11 @@ namespace PropWare {
  * @brief   Print formatted text to a serial terminal, an LCD, or any other device from any cog at any time with no
  *          worries about contention.
  *
+ * By default, each instance allocates one of the eight hardware locks. When they are scarce, pass a software lock
+ * such as PropWare::TicketLock to the constructor instead.
+ *
+ * Instances can not be copied, since the lock they own can not be: share one instance by reference or pointer instead.
+ *
  * @warning SynchronousPrinter is only software - it can not magically introduce a pull-up resistor on the TX line as
  *          is needed for synchronous printing by various Propeller boards, including the Quickstart.
  */
@@ -41,50 +48,54 @@ class SynchronousPrinter {
         /**
          * @brief   Creates a synchronous instance of a Printer that can be used from multiple cogs simultaneously.
          *
+         * A hardware lock is allocated for the instance.
+         *
          * @param   *printer    Address of an instance of a PropWare::Printer device that can be shared across
          * multiple cogs
          */
         SynchronousPrinter (const Printer &printer)
                 : m_printer(&printer),
-                  m_lock(locknew()),
+                  m_lock(this->m_hardwareLock),
                   m_borrowed(false) {
-            lockclr(this->m_lock);
         }
 
         /**
-         * @brief   Ensure that, when a `SynchronousPrinter` is no longer being used, the lock is returned
+         * @brief   Creates a synchronous instance of a Printer which is protected by a lock of the application's
+         *          choosing, such as a PropWare::TicketLock, instead of allocating a hardware lock
+         *
+         * @param   *printer    Address of an instance of a PropWare::Printer device that can be shared across
+         *                      multiple cogs
+         * @param   lock        Lock held while printing; it must outlive this instance
          */
-        ~SynchronousPrinter () {
-            lockclr(this->m_lock);
-            lockret(this->m_lock);
+        SynchronousPrinter (const Printer &printer, const LockReference &lock)
+                : m_printer(&printer),
+                  m_hardwareLock(HardwareLock::NONE),
+                  m_lock(lock),
+                  m_borrowed(false) {
         }
 
         /**
          * @brief   Determine if an instance of a `SynchronousPrinter` successfully retrieved a lock
-         * @return  True when a lock has been retrieved successfully, false otherwise
+         * @return  True when a lock has been retrieved successfully or was provided by the application, false
+         *          otherwise
          */
         bool has_lock () const {
-            return -1 != this->m_lock;
+            return !this->owns_lock() || this->m_hardwareLock.is_valid();
         }
 
         /**
          * @brief   Retrieve a new lock
          *
          * If this instance already has a lock, the call will block until the lock has been cleared. The lock will
-         * then be returned and a new lock will be retrieved.
+         * then be returned and a new lock will be retrieved. Has no effect on a lock provided by the application.
          *
          * @return  True if the instance was able to successfully retrieve a new lock
          */
         bool refreshLock () {
-            if (this->has_lock()) {
-                // Wait for any other cogs using the lock to return
-                while (lockset(this->m_lock));
-                lockclr(this->m_lock);
-                lockret(this->m_lock);
-            }
-
-            this->m_lock = locknew();
-            return this->has_lock();
+            if (this->owns_lock())
+                return this->m_hardwareLock.reallocate();
+            else
+                return true;
         }
 
         /**
@@ -95,7 +106,7 @@ class SynchronousPrinter {
          *          SynchronousPrinter::return_printer() is called
          */
         const Printer *borrow_printer () {
-            while (lockset(this->m_lock));
+            this->m_lock.lock();
             this->m_borrowed = true;
             return this->m_printer;
         }
@@ -105,7 +116,7 @@ class SynchronousPrinter {
          */
         bool return_printer (const Printer *printer) {
             if (printer == this->m_printer) {
-                lockclr(this->m_lock);
+                this->m_lock.unlock();
                 this->m_borrowed = false;
                 return true;
             } else
@@ -117,9 +128,9 @@ class SynchronousPrinter {
          */
         template<typename T>
         void print (const T var) const {
-            while (lockset(this->m_lock));
+            this->m_lock.lock();
             this->m_printer->print(var);
-            lockclr(this->m_lock);
+            this->m_lock.unlock();
         }
 
         /**
@@ -128,18 +139,18 @@ class SynchronousPrinter {
          * @param[in]   string[]    String to be printed
          */
         void println (const char string[]) const {
-            while (lockset(this->m_lock));
+            this->m_lock.lock();
             this->m_printer->println(string);
-            lockclr(this->m_lock);
+            this->m_lock.unlock();
         }
 
         /**
          * @see PropWare::Printer::printf(const char fmt[])
          */
         void printf (const char fmt[]) const {
-            while (lockset(this->m_lock));
+            this->m_lock.lock();
             this->m_printer->puts(fmt);
-            lockclr(this->m_lock);
+            this->m_lock.unlock();
         }
 
         /**
@@ -147,14 +158,25 @@ class SynchronousPrinter {
          */
         template<typename T, typename... Targs>
         void printf (const char fmt[], const T first, const Targs... remaining) const {
-            while (lockset(this->m_lock));
+            this->m_lock.lock();
             this->m_printer->printf(fmt, first, remaining...);
-            lockclr(this->m_lock);
+            this->m_lock.unlock();
+        }
+
+    private:
+        // A copy would either print under a different lock or return the original's hardware lock when destroyed
+        SynchronousPrinter (const SynchronousPrinter &other);
+        SynchronousPrinter &operator= (const SynchronousPrinter &other);
+
+    protected:
+        bool owns_lock () const {
+            return this->m_lock.refers_to(this->m_hardwareLock);
         }
 
     protected:
         const Printer *m_printer;
-        int           m_lock;
+        HardwareLock  m_hardwareLock;
+        LockReference m_lock;
         bool          m_borrowed;
 };
 
@@ -0,0 +1,61 @@
+/**
+ * @file        PropWare/models/host/console.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/hmi/output/printcapable.h>
+#include <PropWare/hmi/input/scancapable.h>
+#include <stdio.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Standard input and output of the PC, which take the place of the UART behind pwOut, pwSyncOut and pwIn in
+ *          the host model
+ */
+class Console : public PrintCapable,
+                public ScanCapable {
+    public:
+        Console () {
+            // Keep output in step with a test's progress, even if it goes on to crash
+            setvbuf(stdout, NULL, _IOLBF, BUFSIZ);
+        }
+
+        virtual void put_char (const char c) {
+            fputc(c, stdout);
+        }
+
+        virtual void puts (const char string[]) {
+            fputs(string, stdout);
+        }
+
+        virtual char get_char () {
+            fflush(stdout);
+            const int c = fgetc(stdin);
+            return EOF == c ? '\0' : (char) c;
+        }
+};
+
+}
@@ -0,0 +1,187 @@
+/**
+ * @file        PropWare/models/host/propeller.h
+ *
+ * @brief       Stand-in for PropGCC's `propeller.h` when PropWare is compiled for a PC (the "host" model)
+ *
+ * Only this directory needs to be on the include path ahead of the system headers; nothing else in PropWare changes.
+ * Registers and built-in functions are mapped onto PropWare::Simulator:
+ *
+ * - `INA`, `OUTA` and `DIRA` are a simulated 32-pin bus shared by all cogs
+ * - `CNT` and `waitcnt` follow a clock which runs either in real time or only when told to
+ * - `cogstart` runs the function on a new thread, numbered like a cog; `cognew` of PASM code fails with -1
+ * - `cogstop` stops a cog the next time it reads `CNT` or `INA`, waits, writes a pin or tries a lock. A cog which does
+ *   none of those within a few milliseconds, such as one spinning on hub memory, is interrupted with `SIGUSR2` instead
+ * - `locknew`, `lockset` and friends are eight atomic flags
+ *
+ * Inline assembly (FCACHE blocks) is compiled only for the Propeller. PropWare::Port, PropWare::UARTTX and
+ * PropWare::SPI carry C++ reference implementations of theirs for the host; drivers that are PASM through and through,
+ * such as PropWare::FullDuplexSerial or PropWare::SD, are not part of the host model.
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#ifdef __PROPELLER__
+#error "PropWare/models/host is for PC builds only; PropGCC provides the real propeller.h"
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace PropWare {
+namespace host {
+
+/**
+ * @brief   OUTA or DIRA of one cog; every write updates the simulated pin bus
+ */
+class PinRegister {
+    public:
+        PinRegister ()
+                : m_value(0) {
+        }
+
+        operator uint32_t () const {
+            return __atomic_load_n(&this->m_value, __ATOMIC_ACQUIRE);
+        }
+
+        PinRegister &operator= (const uint32_t value) {
+            __atomic_store_n(&this->m_value, value, __ATOMIC_RELEASE);
+            this->pins_changed();
+            return *this;
+        }
+
+        PinRegister &operator|= (const uint32_t value) {
+            return *this = (uint32_t) *this | value;
+        }
+
+        PinRegister &operator&= (const uint32_t value) {
+            return *this = (uint32_t) *this & value;
+        }
+
+        PinRegister &operator^= (const uint32_t value) {
+            return *this = (uint32_t) *this ^ value;
+        }
+
+    protected:
+        void pins_changed () const;
+
+    private:
+        PinRegister (const PinRegister &other);
+        PinRegister &operator= (const PinRegister &other);
+
+    protected:
+        uint32_t m_value;
+};
+
+/**
+ * @brief   Registers which each cog has a copy of
+ */
+struct CogRegisters {
+    PinRegister outa;
+    PinRegister dira;
+    uint32_t    outb;
+    uint32_t    dirb;
+    uint32_t    inb;
+    uint32_t    ctra;
+    uint32_t    ctrb;
+    uint32_t    frqa;
+    uint32_t    frqb;
+    uint32_t    phsa;
+    uint32_t    phsb;
+    uint32_t    par;
+};
+
+CogRegisters &cog_registers ();
+uint32_t cnt ();
+uint32_t ina ();
+void clkset (const uint32_t mode);
+void waitcnt (const uint32_t target);
+void waitpeq (const uint32_t state, const uint32_t mask);
+void waitpne (const uint32_t state, const uint32_t mask);
+int cogid ();
+int cogstart (void (*function) (void *), void *parameter, void *stack, const size_t stackSize);
+int cognew (const void *code, const void *parameter);
+void cogstop (const int id);
+int locknew ();
+void lockret (const int lock);
+int lockset (const int lock);
+int lockclr (const int lock);
+
+/**
+ * @brief   Reference implementation of the `rev` instruction: reverse the low `32 - bits` bits and clear the others
+ */
+inline uint32_t rev (uint32_t x, const uint32_t bits) {
+    uint32_t reversed = 0;
+    for (unsigned int i = 0; i < 32; ++i, x >>= 1)
+        reversed = (reversed << 1) | (x & 1);
+    return (bits & 31) ? reversed >> (bits & 31) : reversed;
+}
+
+}
+}
+
+extern volatile uint32_t _clkfreq;
+extern volatile uint8_t  _clkmode;
+
+#define _CLKFREQ    _clkfreq
+#define _CLKMODE    _clkmode
+#define CLKFREQ     _CLKFREQ
+#define CLKMODE     _CLKMODE
+
+#define CNT         (PropWare::host::cnt())
+#define INA         (PropWare::host::ina())
+#define OUTA        (PropWare::host::cog_registers().outa)
+#define DIRA        (PropWare::host::cog_registers().dira)
+#define INB         (PropWare::host::cog_registers().inb)
+#define OUTB        (PropWare::host::cog_registers().outb)
+#define DIRB        (PropWare::host::cog_registers().dirb)
+#define CTRA        (PropWare::host::cog_registers().ctra)
+#define CTRB        (PropWare::host::cog_registers().ctrb)
+#define FRQA        (PropWare::host::cog_registers().frqa)
+#define FRQB        (PropWare::host::cog_registers().frqb)
+#define PHSA        (PropWare::host::cog_registers().phsa)
+#define PHSB        (PropWare::host::cog_registers().phsb)
+#define PAR         (PropWare::host::cog_registers().par)
+
+#define __builtin_propeller_rev(x, bits)    PropWare::host::rev(x, bits)
+#define __builtin_propeller_clkset(mode)    PropWare::host::clkset(mode)
+
+using PropWare::host::waitcnt;
+using PropWare::host::waitpeq;
+using PropWare::host::waitpne;
+using PropWare::host::cogid;
+using PropWare::host::cogstart;
+using PropWare::host::cognew;
+using PropWare::host::cogstop;
+using PropWare::host::locknew;
+using PropWare::host::lockret;
+using PropWare::host::lockset;
+using PropWare::host::lockclr;
+
+/**
+ * @brief   Wait until `target`, then return the next target `delay` cycles later
+ */
+inline uint32_t waitcnt2 (const uint32_t target, const uint32_t delay) {
+    waitcnt(target);
+    return target + delay;
+}
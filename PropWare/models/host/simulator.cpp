@@ -0,0 +1,412 @@
+/**
+ * @file        PropWare/models/host/simulator.cpp
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/models/host/simulator.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+volatile uint32_t _clkfreq = 80000000;
+volatile uint8_t  _clkmode = 0x6F;
+
+namespace PropWare {
+namespace host {
+
+static const int      COGS        = 8;
+static const int      LOCKS       = 8;
+/** Waits longer than this sleep for most of the time and spin only for the rest, to stay accurate */
+static const uint32_t SPIN_US     = 100;
+/** Time a stopped cog has to reach a cancellation point before it is interrupted (see cogstop) */
+static const long     STOP_MS     = 10;
+/** Interrupts a cog which does not reach a cancellation point in time */
+static const int      STOP_SIGNAL = SIGUSR2;
+
+enum class CogState {
+    STOPPED,
+    RUNNING,
+    STOPPING
+};
+
+struct Cog {
+    CogRegisters registers;
+    CogState     state;
+    bool         finished;
+    pthread_t    thread;
+    void         (*function) (void *);
+    void         *parameter;
+};
+
+static Cog             g_cogs[COGS];
+static pthread_mutex_t g_cogMutex    = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  g_cogFinished = PTHREAD_COND_INITIALIZER;
+static bool            g_stopSignalInstalled;
+static __thread int    t_cogId       = 0;
+
+static int             g_locks[LOCKS];
+static bool            g_lockAllocated[LOCKS];
+
+static Simulator::ClockMode initial_clock_mode () {
+    const char *clock = getenv("PROPWARE_CLOCK");
+    return (clock && 0 == strcmp("virtual", clock)) ? Simulator::ClockMode::VIRTUAL : Simulator::ClockMode::REAL_TIME;
+}
+
+static Simulator::ClockMode g_clockMode = initial_clock_mode();
+static uint32_t             g_virtualTime;
+
+static uint32_t                  g_driven;
+static pthread_mutex_t           g_busMutex        = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t                  g_lastPins;
+static Simulator::PinListener    g_pinListener;
+static void                      *g_pinListenerContext;
+
+/**
+ * A cog is only stopped at a cancellation point; none of those may be reached while it holds one of the simulator's
+ * mutexes, not even from a pin listener
+ */
+static int lock_simulator (pthread_mutex_t &mutex) {
+    int cancelState;
+    pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &cancelState);
+    pthread_mutex_lock(&mutex);
+    return cancelState;
+}
+
+static void unlock_simulator (pthread_mutex_t &mutex, const int cancelState) {
+    pthread_mutex_unlock(&mutex);
+    pthread_setcancelstate(cancelState, NULL);
+}
+
+static uint32_t outputs () {
+    uint32_t pins = 0;
+    for (int i = 0; i < COGS; ++i)
+        pins |= (uint32_t) g_cogs[i].registers.outa & (uint32_t) g_cogs[i].registers.dira;
+    return pins;
+}
+
+static uint32_t directions () {
+    uint32_t dirs = 0;
+    for (int i = 0; i < COGS; ++i)
+        dirs |= (uint32_t) g_cogs[i].registers.dira;
+    return dirs;
+}
+
+static uint32_t pins () {
+    const uint32_t dirs = directions();
+    return outputs() | (__atomic_load_n(&g_driven, __ATOMIC_ACQUIRE) & ~dirs);
+}
+
+static uint32_t real_time () {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const unsigned __int128 ns = (unsigned __int128) now.tv_sec * 1000000000 + now.tv_nsec;
+    return (uint32_t) (ns * _clkfreq / 1000000000);
+}
+
+static void release_registers (Cog &cog) {
+    cog.registers.dira = 0;
+    cog.registers.outa = 0;
+}
+
+/**
+ * Runs when a cog's thread ends for any reason: returning, cogstop from itself, or cancellation by another cog
+ */
+static void cog_finished (void *argument) {
+    Cog &cog = *static_cast<Cog *>(argument);
+    pthread_mutex_lock(&g_cogMutex);
+    // A cog stopped by another one is joined (and released) by that cog instead
+    if (CogState::RUNNING == cog.state) {
+        pthread_detach(cog.thread);
+        cog.state = CogState::STOPPED;
+        release_registers(cog);
+    }
+    cog.finished = true;
+    pthread_cond_broadcast(&g_cogFinished);
+    pthread_mutex_unlock(&g_cogMutex);
+}
+
+/**
+ * Signal handler which stops a cog that never reached a cancellation point. While the cog holds one of the simulator's
+ * mutexes its cancellation is disabled, and it ends as soon as it lets go instead
+ */
+static void stop_spinning_cog (int signal) {
+    pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, NULL);
+    pthread_testcancel();
+}
+
+/**
+ * Wait for a cancelled cog to finish, until `deadline` if one is given. Called with g_cogMutex held
+ */
+static bool wait_for_cog (Cog &cog, const timespec *deadline) {
+    while (!cog.finished)
+        if (deadline) {
+            if (pthread_cond_timedwait(&g_cogFinished, &g_cogMutex, deadline))
+                return cog.finished;
+        } else
+            pthread_cond_wait(&g_cogFinished, &g_cogMutex);
+    return true;
+}
+
+static void *run_cog (void *argument) {
+    Cog &cog = *static_cast<Cog *>(argument);
+    t_cogId = (int) (&cog - g_cogs);
+
+    // Cancellation stays deferred: stopping a thread asynchronously is only safe in code which is async-cancel-safe,
+    // and a cog may be in the middle of printf, malloc or new. Instead, every simulated instruction which cogs spend
+    // their time waiting on (waitcnt, waitpeq, lockset, reading CNT or INA and writing pins) is a cancellation point.
+    // Only a cog which reaches none of them is stopped asynchronously, by cogstop's STOP_SIGNAL
+    pthread_cleanup_push(cog_finished, &cog);
+    cog.function(cog.parameter);
+    pthread_cleanup_pop(1);
+    return NULL;
+}
+
+void PinRegister::pins_changed () const {
+    pthread_testcancel();
+    const int cancelState = lock_simulator(g_busMutex);
+    const uint32_t current = pins();
+    if (current != g_lastPins) {
+        g_lastPins = current;
+        if (g_pinListener)
+            g_pinListener(cnt(), current, g_pinListenerContext);
+    }
+    unlock_simulator(g_busMutex, cancelState);
+}
+
+CogRegisters &cog_registers () {
+    return g_cogs[t_cogId].registers;
+}
+
+uint32_t cnt () {
+    pthread_testcancel();
+    if (Simulator::ClockMode::VIRTUAL == g_clockMode)
+        return __atomic_add_fetch(&g_virtualTime, Simulator::CNT_READ_CYCLES, __ATOMIC_ACQ_REL);
+    else
+        return real_time();
+}
+
+uint32_t ina () {
+    pthread_testcancel();
+    return pins();
+}
+
+void clkset (const uint32_t mode) {
+    // Bit 7 of CLK is RESET: the chip reboots, which for a PC program means the end
+    if (mode & 0x80)
+        exit(EXIT_SUCCESS);
+    _clkmode = (uint8_t) mode;
+}
+
+void waitcnt (const uint32_t target) {
+    pthread_testcancel();
+    if (Simulator::ClockMode::VIRTUAL == g_clockMode) {
+        uint32_t now = __atomic_load_n(&g_virtualTime, __ATOMIC_ACQUIRE);
+        while (0 < (int32_t) (target - now)
+                && !__atomic_compare_exchange_n(&g_virtualTime, &now, target, false, __ATOMIC_ACQ_REL,
+                                                __ATOMIC_ACQUIRE));
+    } else {
+        // A deadline already in the past would cost a full 53 second roll-over on hardware. That is always a bug, but
+        // a PC is also far more likely to be preempted past a short deadline, so the wait simply ends here
+        int32_t remaining = (int32_t) (target - cnt());
+        const int32_t spinCycles = (int32_t) (_clkfreq / 1000000 * SPIN_US);
+        if (remaining > spinCycles) {
+            const uint64_t ns = (uint64_t) (remaining - spinCycles) * 1000000000 / _clkfreq;
+            const timespec sleep = {(time_t) (ns / 1000000000), (long) (ns % 1000000000)};
+            nanosleep(&sleep, NULL);
+        }
+        while (0 < (int32_t) (target - cnt()))
+            sched_yield();
+    }
+}
+
+void waitpeq (const uint32_t state, const uint32_t mask) {
+    while ((ina() & mask) != state)
+        sched_yield();
+}
+
+void waitpne (const uint32_t state, const uint32_t mask) {
+    while ((ina() & mask) == state)
+        sched_yield();
+}
+
+int cogid () {
+    return t_cogId;
+}
+
+int cogstart (void (*function) (void *), void *parameter, void *stack, const size_t stackSize) {
+    // Threads bring their own stacks; the one given is left untouched. Cog 0 is the main thread
+    int id = -1;
+    const int cancelState = lock_simulator(g_cogMutex);
+    for (int i = 1; i < COGS && -1 == id; ++i)
+        if (CogState::STOPPED == g_cogs[i].state)
+            id = i;
+    if (!g_stopSignalInstalled) {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = stop_spinning_cog;
+        sigemptyset(&action.sa_mask);
+        sigaction(STOP_SIGNAL, &action, NULL);
+        g_stopSignalInstalled = true;
+    }
+    if (-1 != id) {
+        Cog &cog = g_cogs[id];
+        cog.function  = function;
+        cog.parameter = parameter;
+        cog.state     = CogState::RUNNING;
+        cog.finished  = false;
+        if (pthread_create(&cog.thread, NULL, run_cog, &cog)) {
+            cog.state = CogState::STOPPED;
+            id = -1;
+        }
+    }
+    unlock_simulator(g_cogMutex, cancelState);
+    return id;
+}
+
+int cognew (const void *code, const void *parameter) {
+    // PASM images can not run on a PC
+    return -1;
+}
+
+void cogstop (const int id) {
+    if (id == t_cogId)
+        pthread_exit(NULL);
+
+    Cog &cog = g_cogs[id & (COGS - 1)];
+    int cancelState = lock_simulator(g_cogMutex);
+    const bool running = CogState::RUNNING == cog.state;
+    if (running)
+        cog.state = CogState::STOPPING;
+    unlock_simulator(g_cogMutex, cancelState);
+
+    if (running) {
+        // The cog stops at its next cancellation point (see run_cog). One which spins on hub memory alone, without
+        // ever touching CNT, INA, a pin or a lock, is given a moment and then interrupted: by then it is all but
+        // certain not to be inside the C library
+        pthread_cancel(cog.thread);
+
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += STOP_MS * 1000000;
+        deadline.tv_sec += deadline.tv_nsec / 1000000000;
+        deadline.tv_nsec %= 1000000000;
+
+        cancelState = lock_simulator(g_cogMutex);
+        if (!wait_for_cog(cog, &deadline)) {
+            pthread_kill(cog.thread, STOP_SIGNAL);
+            wait_for_cog(cog, NULL);
+        }
+        unlock_simulator(g_cogMutex, cancelState);
+        pthread_join(cog.thread, NULL);
+
+        cancelState = lock_simulator(g_cogMutex);
+        cog.state = CogState::STOPPED;
+        release_registers(cog);
+        unlock_simulator(g_cogMutex, cancelState);
+    }
+}
+
+int locknew () {
+    int lock = -1;
+    const int cancelState = lock_simulator(g_cogMutex);
+    for (int i = 0; i < LOCKS && -1 == lock; ++i)
+        if (!g_lockAllocated[i]) {
+            g_lockAllocated[i] = true;
+            lock = i;
+        }
+    unlock_simulator(g_cogMutex, cancelState);
+    return lock;
+}
+
+void lockret (const int lock) {
+    const int cancelState = lock_simulator(g_cogMutex);
+    g_lockAllocated[lock & (LOCKS - 1)] = false;
+    unlock_simulator(g_cogMutex, cancelState);
+}
+
+int lockset (const int lock) {
+    pthread_testcancel();
+    const int previous = __atomic_exchange_n(&g_locks[lock & (LOCKS - 1)], 1, __ATOMIC_ACQUIRE);
+    // Give the holder a chance to finish when there are fewer cores than cogs
+    if (previous)
+        sched_yield();
+    return previous ? -1 : 0;
+}
+
+int lockclr (const int lock) {
+    return __atomic_exchange_n(&g_locks[lock & (LOCKS - 1)], 0, __ATOMIC_RELEASE) ? -1 : 0;
+}
+
+}
+
+void Simulator::set_clock_mode (const ClockMode mode) {
+    if (ClockMode::VIRTUAL == mode && ClockMode::VIRTUAL != host::g_clockMode)
+        host::g_virtualTime = host::real_time();
+    host::g_clockMode = mode;
+}
+
+Simulator::ClockMode Simulator::get_clock_mode () {
+    return host::g_clockMode;
+}
+
+void Simulator::advance (const uint32_t cycles) {
+    if (ClockMode::VIRTUAL == host::g_clockMode)
+        __atomic_add_fetch(&host::g_virtualTime, cycles, __ATOMIC_ACQ_REL);
+}
+
+void Simulator::drive (const uint32_t mask, const uint32_t value) {
+    uint32_t driven = __atomic_load_n(&host::g_driven, __ATOMIC_ACQUIRE);
+    while (!__atomic_compare_exchange_n(&host::g_driven, &driven, (driven & ~mask) | (value & mask), false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+}
+
+uint32_t Simulator::get_outputs () {
+    return host::outputs();
+}
+
+uint32_t Simulator::get_directions () {
+    return host::directions();
+}
+
+void Simulator::set_pin_listener (const PinListener listener, void *context) {
+    const int cancelState = host::lock_simulator(host::g_busMutex);
+    host::g_pinListener        = listener;
+    host::g_pinListenerContext = context;
+    host::g_lastPins           = host::pins();
+    host::unlock_simulator(host::g_busMutex, cancelState);
+}
+
+unsigned int Simulator::get_running_cogs () {
+    unsigned int running = 1;
+    const int cancelState = host::lock_simulator(host::g_cogMutex);
+    for (int i = 1; i < host::COGS; ++i)
+        if (host::CogState::STOPPED != host::g_cogs[i].state)
+            ++running;
+    host::unlock_simulator(host::g_cogMutex, cancelState);
+    return running;
+}
+
+}
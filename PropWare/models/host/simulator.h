@@ -0,0 +1,117 @@
+/**
+ * @file        PropWare/models/host/simulator.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <propeller.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Controls for the simulated hardware behind the host model's `propeller.h`
+ *
+ * The pin bus behaves like the Propeller's: a pin is high when any cog has it set as an output and high, and input pins
+ * read whatever a test drives onto them with PropWare::Simulator::drive. Each cog (the main thread is cog 0) has its
+ * own OUTA and DIRA, which are released when the cog stops.
+ *
+ * The clock runs in real time by default, so that code which waits on other cogs or measures time behaves as it would
+ * on hardware, and host benchmarks report `CNT` cycles at CLKFREQ. A virtual clock makes single-cog tests
+ * deterministic: time then moves only when `waitcnt` or PropWare::Simulator::advance moves it, plus a few cycles for
+ * each read of `CNT` so that polling loops still finish. Set the environment variable `PROPWARE_CLOCK=virtual` to start
+ * a program with the virtual clock.
+ *
+ * @code
+ * void record (const uint32_t timestamp, const uint32_t pins, void *context) {
+ *     ...
+ * }
+ *
+ * PropWare::Simulator::set_clock_mode(PropWare::Simulator::ClockMode::VIRTUAL);
+ * PropWare::Simulator::set_pin_listener(record);
+ * PropWare::UARTTX(PropWare::Port::P12).put_char('A');
+ * @endcode
+ */
+class Simulator {
+    public:
+        enum class ClockMode {
+            /** `CNT` follows the PC's monotonic clock, scaled to CLKFREQ */
+            REAL_TIME,
+            /** `CNT` moves only when it is read, waited on or advanced */
+            VIRTUAL
+        };
+
+        /**
+         * @brief   Called every time a cog changes the level of an output pin
+         *
+         * @param[in]   timestamp   Value of `CNT` when the change was made
+         * @param[in]   pins        Levels of all 32 pins after the change
+         * @param[in]   context     Pointer given to PropWare::Simulator::set_pin_listener
+         */
+        typedef void (*PinListener) (const uint32_t timestamp, const uint32_t pins, void *context);
+
+        /** Cycles that each read of `CNT` takes with the virtual clock; roughly one LMM instruction */
+        static const uint32_t CNT_READ_CYCLES = 4;
+
+    public:
+        static void set_clock_mode (const ClockMode mode);
+
+        static ClockMode get_clock_mode ();
+
+        /**
+         * @brief       Move the virtual clock forward; ignored in real time
+         */
+        static void advance (const uint32_t cycles);
+
+        /**
+         * @brief       Set the level of input pins, as an external device would
+         *
+         * @param[in]   mask    Pins to be driven
+         * @param[in]   value   Level of each pin in `mask`
+         */
+        static void drive (const uint32_t mask, const uint32_t value);
+
+        /**
+         * @brief   Levels of the pins which any cog has set as an output
+         */
+        static uint32_t get_outputs ();
+
+        /**
+         * @brief   Pins which any cog has set as an output
+         */
+        static uint32_t get_directions ();
+
+        /**
+         * @brief       Watch the output pins; NULL removes the listener
+         *
+         * The listener is called from whichever cog changed the pins, one call at a time.
+         */
+        static void set_pin_listener (const PinListener listener, void *context = NULL);
+
+        /**
+         * @brief   Number of cogs running, including cog 0
+         */
+        static unsigned int get_running_cogs ();
+};
+
+}
@@ -0,0 +1,263 @@
+/**
+ * @file    PropWare/serial/framing/cobs.h
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Only the standard library is used here so that the same decoder can be compiled for a PC receiving the data
+#include <stddef.h>
+#include <stdint.h>
+
+namespace PropWare {
+
+/**
+ * @brief   CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF), computed without a lookup table
+ *
+ * Appending the CRC to the data most significant byte first yields a CRC of zero over the whole, which lets a receiver
+ * check a frame without knowing where the data ends and the CRC begins.
+ */
+class CRC16 {
+    public:
+        static const uint16_t INITIAL_VALUE = 0xFFFF;
+
+    public:
+        /**
+         * @brief       Add one byte to a running CRC
+         */
+        static uint16_t update (const uint16_t crc, const uint8_t data) {
+            uint8_t x = (uint8_t) ((crc >> 8) ^ data);
+            x ^= x >> 4;
+            return (uint16_t) ((crc << 8) ^ ((uint16_t) x << 12) ^ ((uint16_t) x << 5) ^ x);
+        }
+
+        /**
+         * @brief       Compute the CRC of an array of bytes
+         *
+         * @param[in]   data[]  Data to be checked
+         * @param[in]   length  Number of bytes in `data`
+         * @param[in]   crc     Running CRC from a previous call, for data which is not contiguous
+         */
+        static uint16_t compute (const char data[], const size_t length, uint16_t crc = INITIAL_VALUE) {
+            for (size_t i = 0; i < length; ++i)
+                crc = update(crc, (uint8_t) data[i]);
+            return crc;
+        }
+};
+
+/**
+ * @brief   Incremental decoder for frames made of Consistent Overhead Byte Stuffing (COBS) encoded data followed by a
+ *          CRC16, as sent by PropWare::FramedSerial
+ *
+ * On the wire, a frame is `COBS(record, CRC16 high byte, CRC16 low byte)` followed by a single zero byte. Because COBS
+ * never produces a zero, the zero byte marks the end of every frame unambiguously: after a corrupt or truncated frame,
+ * the decoder discards everything up to the next zero and carries on with the frame after it.
+ *
+ * @code
+ * static char frame[64 + PropWare::COBSDecoder::CRC_SIZE];
+ * PropWare::COBSDecoder decoder(frame);
+ *
+ * while (1) {
+ *     if (PropWare::COBSDecoder::NO_ERROR == decoder.feed(read_byte()) && decoder.frame_ready())
+ *         handle_record(decoder.get_frame(), decoder.get_length());
+ * }
+ * @endcode
+ */
+class COBSDecoder {
+    public:
+        /** Number of bytes appended to each record for the CRC */
+        static const size_t  CRC_SIZE      = 2;
+        /** Code byte which introduces the largest possible block: 254 non-zero bytes with no implied zero */
+        static const uint8_t MAX_CODE      = 0xFF;
+        /** Byte which ends every frame */
+        static const char    END_OF_FRAME  = 0;
+
+        /** Number of allocated error codes for frame decoding */
+#define COBS_ERRORS_LIMIT 16
+        /** First frame decoding error code */
+#define COBS_ERRORS_BASE  80
+
+        /**
+         * Error codes - Proceeded by UART
+         */
+        typedef enum {
+            /** No errors; Successful completion of the function */     NO_ERROR      = 0,
+            /** First error code for PropWare::COBSDecoder */           BEG_ERROR     = COBS_ERRORS_BASE,
+            /** The frame's CRC did not match its contents */           CRC_MISMATCH  = BEG_ERROR,
+            /** The frame did not fit in the buffer */                  FRAME_TOO_LONG,
+            /** The frame ended in the middle of a block or was short */MALFORMED_FRAME,
+            /** Last error code used by PropWare::COBSDecoder */        END_ERROR     = MALFORMED_FRAME
+        } ErrorCode;
+
+    public:
+        /**
+         * @brief       Construct a decoder
+         *
+         * @param[in]   buffer  Statically allocated array, NOT a pointer, where frames are decoded. It must be
+         *                      PropWare::COBSDecoder::CRC_SIZE bytes longer than the largest record
+         */
+        template<size_t N>
+        COBSDecoder (char (&buffer)[N])
+                : m_buffer(buffer),
+                  m_capacity(N),
+                  m_errorCount(0) {
+            this->reset();
+        }
+
+        /**
+         * @brief   Discard any partially decoded frame
+         */
+        void reset () {
+            this->m_length         = 0;
+            this->m_crc            = CRC16::INITIAL_VALUE;
+            this->m_blockRemaining = 0;
+            this->m_pendingZero    = false;
+            this->m_started        = false;
+            this->m_discarding     = false;
+            this->m_ready          = false;
+        }
+
+        /**
+         * @brief       Decode one byte from the wire
+         *
+         * Once a frame is complete, it remains available through PropWare::COBSDecoder::get_frame until the next byte
+         * is fed in. Consecutive zero bytes are ignored. When an error is returned, the decoder has already recovered:
+         * the rest of the bad frame (if any) is skipped and the next frame is decoded normally.
+         *
+         * @param[in]   c   Byte received
+         *
+         * @return      Zero if the byte was accepted, error code if it completed (or revealed) a bad frame
+         */
+        ErrorCode feed (const char c) {
+            if (this->m_ready) {
+                this->m_ready  = false;
+                this->m_length = 0;
+                this->m_crc    = CRC16::INITIAL_VALUE;
+            }
+
+            if (END_OF_FRAME == c)
+                return this->end_frame();
+            else if (this->m_discarding)
+                return NO_ERROR;
+            else if (0 == this->m_blockRemaining) {
+                // Code byte: every block except the one before a 0xFF code implies a zero before the next block
+                if (this->m_pendingZero && !this->append(0))
+                    return this->fail(FRAME_TOO_LONG);
+                this->m_blockRemaining = (uint8_t) (c - 1);
+                this->m_pendingZero    = MAX_CODE != (uint8_t) c;
+                this->m_started        = true;
+                return NO_ERROR;
+            } else {
+                --this->m_blockRemaining;
+                return this->append(c) ? NO_ERROR : this->fail(FRAME_TOO_LONG);
+            }
+        }
+
+        /**
+         * @brief   Determine if the most recent byte completed a valid frame
+         */
+        bool frame_ready () const {
+            return this->m_ready;
+        }
+
+        /**
+         * @brief   Decoded record of the most recent frame, without its CRC
+         */
+        const char *get_frame () const {
+            return this->m_buffer;
+        }
+
+        /**
+         * @brief   Number of bytes in the most recent frame's record
+         */
+        size_t get_length () const {
+            return this->m_length;
+        }
+
+        /**
+         * @brief   Number of bad frames seen since construction
+         */
+        uint32_t get_error_count () const {
+            return this->m_errorCount;
+        }
+
+    protected:
+        bool append (const char c) {
+            if (this->m_capacity == this->m_length)
+                return false;
+            else {
+                this->m_buffer[this->m_length++] = c;
+                this->m_crc = CRC16::update(this->m_crc, (uint8_t) c);
+                return true;
+            }
+        }
+
+        ErrorCode end_frame () {
+            ErrorCode err = NO_ERROR;
+
+            if (this->m_discarding)
+                this->m_discarding = false;
+            else if (this->m_started) {
+                if (this->m_blockRemaining || CRC_SIZE > this->m_length)
+                    err = MALFORMED_FRAME;
+                else if (this->m_crc)
+                    err = CRC_MISMATCH;
+                else {
+                    this->m_length -= CRC_SIZE;
+                    this->m_ready = true;
+                }
+
+                if (err)
+                    ++this->m_errorCount;
+            }
+
+            if (!this->m_ready)
+                this->m_length = 0;
+            this->m_crc            = CRC16::INITIAL_VALUE;
+            this->m_blockRemaining = 0;
+            this->m_pendingZero    = false;
+            this->m_started        = false;
+            return err;
+        }
+
+        ErrorCode fail (const ErrorCode err) {
+            ++this->m_errorCount;
+            this->m_discarding = true;
+            this->m_length     = 0;
+            return err;
+        }
+
+    protected:
+        char *const  m_buffer;
+        const size_t m_capacity;
+        size_t       m_length;
+        uint16_t     m_crc;
+        uint8_t      m_blockRemaining;
+        bool         m_pendingZero;
+        bool         m_started;
+        bool         m_discarding;
+        bool         m_ready;
+        uint32_t     m_errorCount;
+};
+
+}
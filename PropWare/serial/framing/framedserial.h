@@ -0,0 +1,203 @@
+/**
+ * @file    PropWare/serial/framing/framedserial.h
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/hmi/output/printcapable.h>
+#include <PropWare/hmi/input/scancapable.h>
+#include <PropWare/serial/framing/cobs.h>
+#include <string.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Send and receive binary records as COBS-encoded, CRC-checked frames over any PrintCapable and ScanCapable
+ *
+ * Each record costs one byte of COBS overhead per 254 bytes (minimum one), two bytes of CRC and a zero byte to end the
+ * frame - far less than printing the same values as text. See PropWare::COBSDecoder for the format. A lost or corrupted
+ * byte costs only the frame it belonged to: the receiver skips to the next zero byte and carries on.
+ *
+ * COBS output never contains a zero byte, so each encoded block is handed to PropWare::PrintCapable::puts in one call,
+ * letting objects such as PropWare::UARTTX and PropWare::FullDuplexSerial use their bulk transmit routines.
+ *
+ * @code
+ * struct Sample {
+ *     uint32_t timestamp;
+ *     int16_t  x, y, z;
+ * };
+ *
+ * static char rxBuffer[sizeof(Sample) + PropWare::COBSDecoder::CRC_SIZE];
+ *
+ * int main () {
+ *     PropWare::FullDuplexSerial serial;
+ *     serial.start();
+ *     PropWare::FramedSerial framed(serial, serial, rxBuffer);
+ *
+ *     Sample sample;
+ *     ...
+ *     framed.send(sample);
+ * }
+ * @endcode
+ *
+ * PropWare/serial/framing/cobs.h depends on nothing but the standard library, so PropWare::COBSDecoder can be compiled
+ * into the PC application which receives the frames.
+ */
+class FramedSerial {
+    public:
+        /** Largest number of data bytes in a single COBS block */
+        static const size_t MAX_BLOCK_SIZE = COBSDecoder::MAX_CODE - 1;
+
+    public:
+        /**
+         * @brief       Construct a framed link over a transmitter and receiver
+         *
+         * @param[in]   printCapable    Destination for outgoing frames
+         * @param[in]   scanCapable     Source of incoming frames
+         * @param[in]   receiveBuffer   Statically allocated array, NOT a pointer, where incoming frames are decoded. It
+         *                              must be PropWare::COBSDecoder::CRC_SIZE bytes longer than the largest record
+         */
+        template<size_t N>
+        FramedSerial (PrintCapable &printCapable, ScanCapable &scanCapable, char (&receiveBuffer)[N])
+                : m_printCapable(&printCapable),
+                  m_scanCapable(&scanCapable),
+                  m_decoder(receiveBuffer) {
+        }
+
+        /**
+         * @brief       Send an array of bytes as a single frame
+         *
+         * @param[in]   array[]     Record to be sent; may contain any byte values
+         * @param[in]   length      Number of bytes in `array`
+         */
+        void send_array (const char array[], const size_t length) const {
+            send_frame(*this->m_printCapable, array, length);
+        }
+
+        /**
+         * @brief       Send an array of bytes as a single frame to any PrintCapable, without a FramedSerial instance
+         *
+         * @param[in]   printCapable    Destination for the frame
+         * @param[in]   array[]         Record to be sent; may contain any byte values
+         * @param[in]   length          Number of bytes in `array`
+         */
+        static void send_frame (PrintCapable &printCapable, const char array[], const size_t length) {
+            const uint16_t crc       = CRC16::compute(array, length);
+            const char     trailer[] = {(char) (crc >> 8), (char) crc};
+            const size_t   total     = length + sizeof(trailer);
+
+            // Room for the code byte, one full block and a null-terminator for puts()
+            char   block[MAX_BLOCK_SIZE + 2];
+            size_t blockLength = 1;
+            for (size_t i = 0; i < total; ++i) {
+                const char c = i < length ? array[i] : trailer[i - length];
+
+                if (COBSDecoder::END_OF_FRAME == c)
+                    send_block(printCapable, block, blockLength);
+                else {
+                    block[blockLength++] = c;
+                    if (COBSDecoder::MAX_CODE == blockLength)
+                        send_block(printCapable, block, blockLength);
+                }
+            }
+            send_block(printCapable, block, blockLength);
+
+            printCapable.put_char(COBSDecoder::END_OF_FRAME);
+        }
+
+        /**
+         * @brief       Send any plain-old-data type as a single frame
+         */
+        template<typename T>
+        void send (const T &record) const {
+            this->send_array(reinterpret_cast<const char *>(&record), sizeof(record));
+        }
+
+        /**
+         * @brief   Wait for the next valid frame
+         *
+         * Bad frames are skipped (and counted, see PropWare::FramedSerial::get_error_count) without returning.
+         *
+         * @return  Number of bytes in the frame's record, which is available through PropWare::FramedSerial::get_frame
+         *          until the next call
+         */
+        size_t receive () {
+            do {
+                this->m_decoder.feed(this->m_scanCapable->get_char());
+            } while (!this->m_decoder.frame_ready());
+            return this->m_decoder.get_length();
+        }
+
+        /**
+         * @brief       Wait for the next valid frame and copy it into a plain-old-data type
+         *
+         * @param[out]  record  Destination for the frame
+         *
+         * @return      True if the frame was exactly `sizeof(record)` bytes long. Otherwise, `record` is unmodified
+         */
+        template<typename T>
+        bool receive (T &record) {
+            if (sizeof(record) == this->receive()) {
+                memcpy(&record, this->m_decoder.get_frame(), sizeof(record));
+                return true;
+            } else
+                return false;
+        }
+
+        /**
+         * @brief   Record of the frame most recently returned by PropWare::FramedSerial::receive
+         */
+        const char *get_frame () const {
+            return this->m_decoder.get_frame();
+        }
+
+        /**
+         * @brief   Decoder for incoming frames, for applications which need to poll without blocking
+         */
+        COBSDecoder &get_decoder () {
+            return this->m_decoder;
+        }
+
+        /**
+         * @brief   Number of bad frames received
+         */
+        uint32_t get_error_count () const {
+            return this->m_decoder.get_error_count();
+        }
+
+    protected:
+        static void send_block (PrintCapable &printCapable, char block[], size_t &blockLength) {
+            block[0]           = (char) blockLength;
+            block[blockLength] = '\0';
+            printCapable.puts(block);
+            blockLength = 1;
+        }
+
+    protected:
+        PrintCapable *m_printCapable;
+        ScanCapable  *m_scanCapable;
+        COBSDecoder  m_decoder;
+};
+
+}
@@ -265,6 +265,15 @@ class SPI : public PrintCapable,
          * @param[in]   numberOfBytes   Number of words to send
          */
         void shift_out_block_msb_first_fast (const uint8_t buffer[], size_t numberOfBytes) const {
+#ifndef __PROPELLER__
+            for (size_t i = 0; i < numberOfBytes; ++i)
+                for (int bit = 7; 0 <= bit; --bit) {
+                    this->m_mosi.write((buffer[i] >> bit) & 1);
+                    this->m_sclk.toggle();
+                    this->m_sclk.toggle();
+                }
+            this->m_mosi.set();
+#else
             __asm__ volatile (
 #define ASMVAR(name) FC_ADDR(#name "%=",  "SpiBlockWriteStart%=")
             FC_START("SpiBlockWriteStart%=", "SpiBlockWriteEnd%=")
@@ -302,6 +311,7 @@ class SPI : public PrintCapable,
             :[_mosi] "r"(this->m_mosi.get_mask()),
             [_sclk] "r"(this->m_sclk.get_mask())
             );
+#endif
         }
 
         /**
@@ -312,6 +322,18 @@ class SPI : public PrintCapable,
          * @param[in]   numberOfBytes   Number of bytes to receive
          */
         void shift_in_block_mode0_msb_first_fast (uint8_t *buffer, size_t numberOfBytes) const {
+#ifndef __PROPELLER__
+            for (size_t i = 0; i < numberOfBytes; ++i) {
+                uint8_t data = 0;
+                for (int bit = 0; bit < 8; ++bit) {
+                    const bool sample = this->m_miso.read();
+                    this->m_sclk.toggle();
+                    data = (uint8_t) (data << 1 | sample);
+                    this->m_sclk.toggle();
+                }
+                buffer[i] = data;
+            }
+#else
             __asm__ volatile (
 #define ASMVAR(name) FC_ADDR(#name "%=", "SpiBlockReadStart%=")
             FC_START("SpiBlockReadStart%=", "SpiBlockReadEnd%=")
@@ -347,6 +369,7 @@ class SPI : public PrintCapable,
             [_sclk] "r"(this->m_sclk.get_mask())
             );
 #undef ASMVAR
+#endif
         }
 
         virtual void put_char (const char c) {
@@ -390,6 +413,17 @@ class SPI : public PrintCapable,
     protected:
 
         void shift_out_msb_first (uint32_t bits, uint32_t data) const {
+#ifndef __PROPELLER__
+            uint32_t clock = this->m_clkDelay + CNT;
+            for (uint32_t i = bits; i--;) {
+                this->m_mosi.write((data >> i) & 1);
+                clock = waitcnt2(clock, this->m_clkDelay);
+                this->m_sclk.toggle();
+                clock = waitcnt2(clock, this->m_clkDelay);
+                this->m_sclk.toggle();
+            }
+            this->m_mosi.set();
+#else
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wuninitialized"
             unsigned int clock;
@@ -418,9 +452,21 @@ class SPI : public PrintCapable,
             [_clkDelay] "r"(this->m_clkDelay)
             );
 #pragma GCC diagnostic pop
+#endif
         }
 
         void shift_out_lsb_first (uint32_t bits, uint32_t data) const {
+#ifndef __PROPELLER__
+            uint32_t clock = this->m_clkDelay + CNT;
+            for (uint32_t i = 0; i < bits; ++i) {
+                this->m_mosi.write((data >> i) & 1);
+                clock = waitcnt2(clock, this->m_clkDelay);
+                this->m_sclk.toggle();
+                clock = waitcnt2(clock, this->m_clkDelay);
+                this->m_sclk.toggle();
+            }
+            this->m_mosi.set();
+#else
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wuninitialized"
             unsigned int clock;
@@ -449,9 +495,23 @@ class SPI : public PrintCapable,
             [_clkDelay] "r"(this->m_clkDelay)
             );
 #pragma GCC diagnostic pop
+#endif
         }
 
         uint32_t shift_in_msb_phs0 (unsigned int bits) const {
+#ifndef __PROPELLER__
+            uint32_t clock = this->m_clkDelay + CNT;
+            uint32_t data  = 0;
+            for (unsigned int i = 0; i < bits; ++i) {
+                const bool sample = this->m_miso.read();
+                clock = waitcnt2(clock, this->m_clkDelay);
+                this->m_sclk.toggle();
+                clock = waitcnt2(clock, this->m_clkDelay);
+                this->m_sclk.toggle();
+                data = data << 1 | sample;
+            }
+            return data;
+#else
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wuninitialized"
             unsigned int clock;
@@ -480,9 +540,23 @@ class SPI : public PrintCapable,
             );
 #pragma GCC diagnostic pop
             return tempData;
+#endif
         }
 
         uint32_t shift_in_lsb_phs0 (const unsigned int bits) const {
+#ifndef __PROPELLER__
+            uint32_t clock = this->m_clkDelay + CNT;
+            uint32_t data  = 0;
+            for (unsigned int i = 0; i < bits; ++i) {
+                const bool sample = this->m_miso.read();
+                clock = waitcnt2(clock, this->m_clkDelay);
+                this->m_sclk.toggle();
+                clock = waitcnt2(clock, this->m_clkDelay);
+                this->m_sclk.toggle();
+                data |= (uint32_t) sample << i;
+            }
+            return data;
+#else
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wuninitialized"
             unsigned int clock;
@@ -512,9 +586,23 @@ class SPI : public PrintCapable,
             );
 #pragma GCC diagnostic pop
             return tempData;
+#endif
         }
 
         uint32_t shift_in_msb_phs1 (unsigned int bits) const {
+#ifndef __PROPELLER__
+            uint32_t clock = this->m_clkDelay + CNT;
+            uint32_t data  = 0;
+            for (unsigned int i = 0; i < bits; ++i) {
+                this->m_sclk.toggle();
+                clock = waitcnt2(clock, this->m_clkDelay);
+                const bool sample = this->m_miso.read();
+                this->m_sclk.toggle();
+                clock = waitcnt2(clock, this->m_clkDelay);
+                data = data << 1 | sample;
+            }
+            return data;
+#else
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wuninitialized"
             unsigned int clock;
@@ -543,9 +631,23 @@ class SPI : public PrintCapable,
             );
 #pragma GCC diagnostic pop
             return tempData;
+#endif
         }
 
         uint32_t shift_in_lsb_phs1 (unsigned int bits) const {
+#ifndef __PROPELLER__
+            uint32_t clock = this->m_clkDelay + CNT;
+            uint32_t data  = 0;
+            for (unsigned int i = 0; i < bits; ++i) {
+                this->m_sclk.toggle();
+                clock = waitcnt2(clock, this->m_clkDelay);
+                const bool sample = this->m_miso.read();
+                this->m_sclk.toggle();
+                clock = waitcnt2(clock, this->m_clkDelay);
+                data |= (uint32_t) sample << i;
+            }
+            return data;
+#else
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wuninitialized"
             unsigned int clock;
@@ -574,6 +676,7 @@ class SPI : public PrintCapable,
             );
 #pragma GCC diagnostic pop
             return tempData;
+#endif
         }
 
     private:
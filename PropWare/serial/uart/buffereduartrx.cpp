@@ -0,0 +1,304 @@
+/**
+ * @file    PropWare/serial/uart/buffereduartrx.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdint.h>
+
+
+extern uint8_t _load_start_BufferedUARTRX_cog[];
+
+namespace PropWare {
+
+void *get_buffered_uartrx_driver () {
+    return _load_start_BufferedUARTRX_cog;
+}
+
+}
+
+// PAR points to PropWare::BufferedUARTRX::m_frameHead. Frame flags: PARITY_ERROR = 1, DATA_OVERFLOW = 2,
+// TRUNCATED = 4. Framing: DELIMITER = 0, LENGTH_PREFIX = 1
+__asm__ (
+"            .section .BufferedUARTRX.cog, \"ax\"                     \n"
+"            .compress off                                            \n"
+"..start                                                              \n"
+"            .org    0                                                \n"
+"                                                                     \n"
+"entry                                                                \n"
+"            mov     t1, PAR                                          \n"
+"            add     t1, #(5 << 2)                                    \n"
+"            rdlong  rxmask, t1                                       \n"
+"            add     t1, #4                                           \n"
+"            rdlong  bitticks, t1                                     \n"
+"            add     t1, #4                                           \n"
+"            rdlong  rxbits, t1                                       \n"
+"            add     t1, #4                                           \n"
+"            rdlong  msbmask, t1                                      \n"
+"            add     t1, #4                                           \n"
+"            rdlong  datamask, t1                                     \n"
+"            add     t1, #4                                           \n"
+"            rdlong  parityxor, t1                                    \n"
+"            add     t1, #4                                           \n"
+"            rdlong  paritycheck, t1                                  \n"
+"            add     t1, #4                                           \n"
+"            rdlong  framing, t1                                      \n"
+"            add     t1, #4                                           \n"
+"            rdlong  delimiter, t1                                    \n"
+"            add     t1, #4                                           \n"
+"            rdlong  maxlen, t1                                       \n"
+"            add     t1, #4                                           \n"
+"            rdlong  buff, t1                                         \n"
+"            add     t1, #4                                           \n"
+"            rdlong  buffmask, t1                                     \n"
+"            add     t1, #4                                           \n"
+"            rdlong  frames, t1                                       \n"
+"            add     t1, #4                                           \n"
+"            rdlong  framemask, t1                                    \n"
+"            mov     ftailaddr, PAR                                   \n"
+"            add     ftailaddr, #(1 << 2)                             \n"
+"            mov     tailaddr, PAR                                    \n"
+"            add     tailaddr, #(2 << 2)                              \n"
+"            mov     ovfaddr, PAR                                     \n"
+"            add     ovfaddr, #(3 << 2)                               \n"
+"            mov     dropaddr, PAR                                    \n"
+"            add     dropaddr, #(4 << 2)                              \n"
+"            mov     startticks, bitticks                             \n"
+"            shr     startticks, #1                                   \n"
+"            add     startticks, bitticks                             \n"
+"            rdlong  fhead, PAR                                       \n"
+"            rdlong  head, tailaddr                                   \n"
+"            andn    DIRA, rxmask                                     \n"
+"            mov     inframe, #0                                      \n"
+"            mov     wordflags, #0                                    \n"
+"                                                                     \n"
+// Shift in one word, timestamping its start bit
+"receive                                                              \n"
+"            mov     bits, rxbits                                     \n"
+"            mov     rxdata, #0                                       \n"
+"            waitpne rxmask, rxmask                                   \n"
+"            mov     stamp, CNT                                       \n"
+"            mov     rxcnt, startticks                                \n"
+"            add     rxcnt, stamp                                     \n"
+"                                                                     \n"
+"Receive_bit                                                          \n"
+"            waitcnt rxcnt, bitticks                                  \n"
+"            shr     rxdata, #1                                       \n"
+"            test    rxmask, INA    wz                                \n"
+"            muxnz   rxdata, msbmask                                  \n"
+"            djnz    bits, #Receive_bit                               \n"
+"            waitpeq rxmask, rxmask                                   \n"
+"                                                                     \n"
+// With odd parity's bit flipped, any word holding an odd number of ones failed
+"            xor     rxdata, parityxor                                \n"
+"            test    rxdata, paritycheck    wc                        \n"
+"            muxc    wordflags, #1                                    \n"
+"            and     rxdata, datamask                                 \n"
+"                                                                     \n"
+"            tjnz    inframe, #Frame_word                             \n"
+"            mov     framestamp, stamp                                \n"
+"            mov     framestart, head                                 \n"
+"            mov     framelen, #0                                     \n"
+"            mov     frameflags, wordflags                            \n"
+"            mov     inframe, #1                                      \n"
+"            cmp     framing, #1    wz                                \n"
+"  if_nz     jmp     #Delimit                                         \n"
+"            mov     remaining, rxdata    wz                          \n"
+"  if_z      jmp     #Publish                                         \n"
+"            jmp     #receive                                         \n"
+"                                                                     \n"
+"Frame_word                                                           \n"
+"            or      frameflags, wordflags                            \n"
+"            cmp     framing, #1    wz                                \n"
+"  if_z      jmp     #Store                                           \n"
+"                                                                     \n"
+"Delimit                                                              \n"
+"            cmp     rxdata, delimiter    wz                          \n"
+"  if_z      jmp     #Publish                                         \n"
+"                                                                     \n"
+"Store                                                                \n"
+"            mov     t1, head                                         \n"
+"            add     t1, #1                                           \n"
+"            and     t1, buffmask                                     \n"
+"            rdlong  t2, tailaddr                                     \n"
+"            cmp     t1, t2    wz                                     \n"
+"  if_z      jmp     #Receive_overflow                                \n"
+"            mov     t2, buff                                         \n"
+"            add     t2, head                                         \n"
+"            wrbyte  rxdata, t2                                       \n"
+"            mov     head, t1                                         \n"
+"            add     framelen, #1                                     \n"
+"                                                                     \n"
+"Stored                                                               \n"
+"            cmp     framing, #1    wz                                \n"
+"  if_nz     jmp     #Check_length                                    \n"
+"            djnz    remaining, #receive                              \n"
+"            jmp     #Publish                                         \n"
+"                                                                     \n"
+"Check_length                                                         \n"
+"            cmp     framelen, maxlen    wz                           \n"
+"  if_nz     jmp     #receive                                         \n"
+"            or      frameflags, #4                                   \n"
+"            jmp     #Publish                                         \n"
+"                                                                     \n"
+"Receive_overflow                                                     \n"
+"            or      frameflags, #2                                   \n"
+"            rdlong  t1, ovfaddr                                      \n"
+"            add     t1, #1                                           \n"
+"            wrlong  t1, ovfaddr                                      \n"
+"            jmp     #Stored                                          \n"
+"                                                                     \n"
+// Append the frame's descriptor to the queue
+"Publish                                                              \n"
+"            mov     inframe, #0                                      \n"
+"            mov     t1, fhead                                        \n"
+"            add     t1, #1                                           \n"
+"            and     t1, framemask                                    \n"
+"            rdlong  t2, ftailaddr                                    \n"
+"            cmp     t1, t2    wz                                     \n"
+"  if_z      jmp     #Drop_frame                                      \n"
+"            mov     t2, fhead                                        \n"
+"            shl     t2, #4                                           \n"
+"            add     t2, frames                                       \n"
+"            wrlong  framestamp, t2                                   \n"
+"            add     t2, #4                                           \n"
+"            wrlong  framestart, t2                                   \n"
+"            add     t2, #4                                           \n"
+"            wrlong  framelen, t2                                     \n"
+"            add     t2, #4                                           \n"
+"            wrlong  frameflags, t2                                   \n"
+"            mov     fhead, t1                                        \n"
+"            wrlong  fhead, PAR                                       \n"
+"            jmp     #receive                                         \n"
+"                                                                     \n"
+// No room in the queue: hand the frame's words back to the data buffer
+"Drop_frame                                                           \n"
+"            mov     head, framestart                                 \n"
+"            rdlong  t1, dropaddr                                     \n"
+"            add     t1, #1                                           \n"
+"            wrlong  t1, dropaddr                                     \n"
+"            jmp     #receive                                         \n"
+"                                                                     \n"
+"t1                                                                   \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"t2                                                                   \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxmask                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"bitticks                                                             \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxbits                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"msbmask                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"datamask                                                             \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"parityxor                                                            \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"paritycheck                                                          \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"framing                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"delimiter                                                            \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"maxlen                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"buff                                                                 \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"buffmask                                                             \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"frames                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"framemask                                                            \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"ftailaddr                                                            \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"tailaddr                                                             \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"ovfaddr                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"dropaddr                                                             \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"startticks                                                           \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"fhead                                                                \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"head                                                                 \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"inframe                                                              \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"bits                                                                 \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxdata                                                               \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"stamp                                                                \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxcnt                                                                \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"wordflags                                                            \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"framestamp                                                           \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"framestart                                                           \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"framelen                                                             \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"frameflags                                                           \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"remaining                                                            \n"
+"            .res    1                                                \n"
+"            .compress default                                        \n"
+"            .text                                                    \n"
+);
@@ -0,0 +1,321 @@
+/**
+ * @file    PropWare/serial/uart/buffereduartrx.h
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/serial/uart/uartrx.h>
+#include <string.h>
+
+namespace PropWare {
+
+void *get_buffered_uartrx_driver ();
+
+/**
+ * @brief   UART receiver whose bits are shifted in by a dedicated cog and delivered as whole frames
+ *
+ * Data width (up to 8 bits), parity, baud rate and RX pin are configured exactly as with PropWare::UARTRX. Once
+ * PropWare::BufferedUARTRX::start is invoked, a PASM cog samples the line continuously, stores each word in a ring
+ * buffer and splits the stream into frames, either at a delimiter or according to a length prefix. Every complete
+ * frame is published to a queue of PropWare::BufferedUARTRX::Frame descriptors, which record the system counter at
+ * the start bit of the frame's first word and whether any word in the frame failed its parity check. The calling cog
+ * is free to do other work and pick up whole messages with PropWare::BufferedUARTRX::receive_frame.
+ *
+ * @code
+ * static char                             rxBuffer[256];
+ * static PropWare::BufferedUARTRX::Frame  frames[8];
+ *
+ * int main () {
+ *     PropWare::BufferedUARTRX receiver(rxBuffer, frames);
+ *     receiver.set_delimiter_framing('\n');
+ *     receiver.start();
+ *
+ *     char line[64];
+ *     PropWare::BufferedUARTRX::Frame frame;
+ *     while (1) {
+ *         poll_sensor();
+ *         if (receiver.frame_ready()) {
+ *             const size_t length = receiver.receive_frame(line, sizeof(line), &frame);
+ *             ...
+ *         }
+ *     }
+ * }
+ * @endcode
+ *
+ * Both the data buffer and the frame queue must be powers of two in length, and one entry of each is left unused to
+ * distinguish full from empty. Words arriving while the data buffer is full are dropped and counted, and the frame
+ * they belong to is flagged with PropWare::BufferedUARTRX::Frame::DATA_OVERFLOW. A complete frame arriving while the
+ * frame queue is full is dropped entirely and counted.
+ *
+ * <b>Maximum baud rate</b>
+ * <p>
+ * After the stop bit begins, the receiver cog must store the word and be waiting for the next start bit within one bit
+ * time. Counting 4 clock cycles per instruction and a worst case of 23 per hub access, an ordinary word takes about 150
+ * clock cycles and the last word of a frame, which also writes the frame's descriptor, takes about 250. At 80 MHz, one
+ * bit lasts 347 clock cycles at 230,400 baud, so the receiver keeps up with continuous traffic at that rate, but not at
+ * 460,800 baud (174 clock cycles per bit). These limits are derived from instruction timing, not measured on hardware;
+ * verify with your own traffic before relying on them.
+ *
+ * @note    The blocking receive routines inherited from PropWare::UARTRX must not be used while the receiver cog is
+ *          running
+ *
+ * @note    Only one cog at a time may consume frames
+ */
+class BufferedUARTRX : public UARTRX {
+    public:
+        /**
+         * @brief   Descriptor for a single frame in the data buffer, written by the receiver cog
+         */
+        struct Frame {
+            /** Flags which may be set in PropWare::BufferedUARTRX::Frame::flags */
+            typedef enum {
+                /** At least one word in the frame failed its parity check */ PARITY_ERROR  = BIT_0,
+                /** Words were dropped because the data buffer was full */     DATA_OVERFLOW = BIT_1,
+                /** The frame was cut short at the maximum frame length */    TRUNCATED     = BIT_2
+            } Flag;
+
+            /** Value of `CNT` when the start bit of the frame's first word was detected */
+            uint32_t timestamp;
+            /** Index of the frame's first word within the data buffer */
+            uint32_t offset;
+            /** Number of words in the frame, not including any delimiter or length prefix */
+            uint32_t length;
+            /** Bitwise OR of PropWare::BufferedUARTRX::Frame::Flag values */
+            uint32_t flags;
+        };
+
+        /**
+         * How the receiver cog splits the incoming stream into frames
+         */
+        enum class Framing {
+            /**
+             * A frame ends at the delimiter word, which is not stored. Frames which reach the maximum frame length
+             * without a delimiter are published early and flagged as truncated
+             */
+            DELIMITER,
+            /** The first word of every frame is the number of words which follow it */
+            LENGTH_PREFIX
+        };
+
+    public:
+        /**
+         * @brief       Construct a receiver on the default RX pin, splitting frames at newline characters
+         *
+         * @param[in]   buffer  Statically allocated array, NOT a pointer, used as the data ring buffer. Length must
+         *                      be a power of two
+         * @param[in]   frames  Statically allocated array, NOT a pointer, used as the frame queue. Length must be a
+         *                      power of two
+         * @param[in]   rx      Pin mask of the RX pin
+         */
+        template<size_t BUFFER_N, size_t FRAMES_N>
+        BufferedUARTRX (char (&buffer)[BUFFER_N], Frame (&frames)[FRAMES_N],
+                        const Port::Mask rx = (Port::Mask) (1 << _cfg_rxpin))
+                : UARTRX(rx),
+                  m_frameHead(0),
+                  m_frameTail(0),
+                  m_dataTail(0),
+                  m_overflows(0),
+                  m_droppedFrames(0),
+                  m_framing(static_cast<uint32_t>(Framing::DELIMITER)),
+                  m_delimiter('\n'),
+                  m_maxFrameLength(BUFFER_N - 1),
+                  m_buffer(buffer),
+                  m_bufferMask(BUFFER_N - 1),
+                  m_frames(frames),
+                  m_frameMask(FRAMES_N - 1),
+                  m_cogID(-1) {
+            static_assert(1 < BUFFER_N && 0 == (BUFFER_N & (BUFFER_N - 1)), "Buffer length must be a power of two");
+            static_assert(1 < FRAMES_N && 0 == (FRAMES_N & (FRAMES_N - 1)), "Frame queue length must be a power of 2");
+        }
+
+        ~BufferedUARTRX () {
+            this->stop();
+        }
+
+        /**
+         * @brief       End each frame at a delimiter word
+         *
+         * Must be invoked before PropWare::BufferedUARTRX::start
+         *
+         * @param[in]   delimiter       Word which ends a frame; it is not stored in the data buffer
+         * @param[in]   maxFrameLength  Frames reaching this many words are published without waiting for the
+         *                              delimiter. Zero, or anything larger than the data buffer can hold, selects the
+         *                              largest possible length
+         */
+        void set_delimiter_framing (const char delimiter = '\n', const size_t maxFrameLength = 0) {
+            this->m_framing   = static_cast<uint32_t>(Framing::DELIMITER);
+            this->m_delimiter = (uint8_t) delimiter;
+            if (0 == maxFrameLength || this->m_bufferMask < maxFrameLength)
+                this->m_maxFrameLength = this->m_bufferMask;
+            else
+                this->m_maxFrameLength = maxFrameLength;
+        }
+
+        /**
+         * @brief   Treat the first word of each frame as the number of words which follow it
+         *
+         * A prefix of zero produces an empty frame. Must be invoked before PropWare::BufferedUARTRX::start
+         */
+        void set_length_prefix_framing () {
+            this->m_framing = static_cast<uint32_t>(Framing::LENGTH_PREFIX);
+        }
+
+        Framing get_framing () const {
+            return static_cast<Framing>(this->m_framing);
+        }
+
+        /**
+         * @brief       Only data widths of 1 through 8 bits are supported
+         *
+         * @see         PropWare::UART::set_data_width
+         */
+        virtual ErrorCode set_data_width (const uint8_t dataWidth) {
+            if (8 < dataWidth)
+                return UART::INVALID_DATA_WIDTH;
+            else
+                return UARTRX::set_data_width(dataWidth);
+        }
+
+        /**
+         * @brief   Discard any buffered data and start the receiver cog with the current configuration
+         *
+         * @return  Cog ID of the receiver cog. -1 for failure
+         */
+        int8_t start () {
+            this->stop();
+
+            this->m_frameHead     = 0;
+            this->m_frameTail     = 0;
+            this->m_dataTail      = 0;
+            this->m_overflows     = 0;
+            this->m_droppedFrames = 0;
+
+            this->m_rxMask         = this->m_pin.get_mask();
+            this->m_bitTicks       = this->m_bitCycles;
+            this->m_rxBits         = this->m_receivableBits;
+            this->m_rxMsbMask      = this->m_msbMask;
+            this->m_wordMask       = this->m_dataMask;
+            // Flipping the parity bit of an odd-parity word lets the driver check every word for even parity
+            this->m_parityXor      = Parity::ODD_PARITY == this->m_parity ? this->m_parityMask : 0;
+            this->m_parityCheck    = Parity::NO_PARITY == this->m_parity ? 0 : this->m_dataMask | this->m_parityMask;
+
+            return this->m_cogID = (int8_t) cognew(get_buffered_uartrx_driver(), (int32_t) (&this->m_frameHead));
+        }
+
+        /**
+         * @brief   Stop the receiver cog; frames already in the queue remain available
+         */
+        void stop () {
+            if (-1 != this->m_cogID) {
+                cogstop(this->m_cogID);
+                this->m_cogID = -1;
+            }
+        }
+
+        /**
+         * @brief   Determine if a complete frame is waiting in the queue
+         */
+        bool frame_ready () const {
+            return this->m_frameHead != this->m_frameTail;
+        }
+
+        /**
+         * @brief       Wait for the next complete frame, copy its words into `buffer` and release it
+         *
+         * @param[out]  buffer      Destination for the frame's words. No null-terminator is added
+         * @param[in]   bufferSize  Capacity of `buffer`. Words beyond this are discarded and the copy of the
+         *                          descriptor is flagged with PropWare::BufferedUARTRX::Frame::TRUNCATED
+         * @param[out]  *frame      If non-null, receives a copy of the frame's descriptor
+         *
+         * @return      Number of words copied into `buffer`
+         */
+        size_t receive_frame (char buffer[], const size_t bufferSize, Frame *frame = NULL) {
+            while (!this->frame_ready());
+
+            const uint32_t        tail   = this->m_frameTail;
+            const volatile Frame &next   = this->m_frames[tail];
+            const uint32_t        offset = next.offset;
+            const uint32_t        length = next.length;
+
+            const size_t copied     = length < bufferSize ? length : bufferSize;
+            const size_t bufferEnd  = this->m_bufferMask + 1 - offset;
+            const size_t firstChunk = copied < bufferEnd ? copied : bufferEnd;
+            memcpy(buffer, &this->m_buffer[offset], firstChunk);
+            memcpy(&buffer[firstChunk], this->m_buffer, copied - firstChunk);
+
+            if (NULL != frame) {
+                frame->timestamp = next.timestamp;
+                frame->offset    = offset;
+                frame->length    = length;
+                frame->flags     = next.flags;
+                if (copied < length)
+                    frame->flags |= Frame::TRUNCATED;
+            }
+
+            this->m_dataTail  = (offset + length) & this->m_bufferMask;
+            this->m_frameTail = (tail + 1) & this->m_frameMask;
+
+            return copied;
+        }
+
+        /**
+         * @brief   Number of words dropped because the data buffer was full
+         */
+        uint32_t get_overflow_count () const {
+            return this->m_overflows;
+        }
+
+        /**
+         * @brief   Number of complete frames dropped because the frame queue was full
+         */
+        uint32_t get_dropped_frame_count () const {
+            return this->m_droppedFrames;
+        }
+
+    protected:
+        // Hub block shared with the receiver cog; the order of these members is relied on by the driver
+        volatile uint32_t     m_frameHead;
+        volatile uint32_t     m_frameTail;
+        volatile uint32_t     m_dataTail;
+        volatile uint32_t     m_overflows;
+        volatile uint32_t     m_droppedFrames;
+        uint32_t              m_rxMask;
+        uint32_t              m_bitTicks;
+        uint32_t              m_rxBits;
+        uint32_t              m_rxMsbMask;
+        uint32_t              m_wordMask;
+        uint32_t              m_parityXor;
+        uint32_t              m_parityCheck;
+        uint32_t              m_framing;
+        uint32_t              m_delimiter;
+        uint32_t              m_maxFrameLength;
+        char *const           m_buffer;
+        const uint32_t        m_bufferMask;
+        volatile Frame *const m_frames;
+        const uint32_t        m_frameMask;
+
+        int8_t m_cogID;
+};
+
+}
@@ -0,0 +1,194 @@
+/**
+ * @file    PropWare/serial/uart/buffereduarttx.h
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/serial/uart/uarttx.h>
+#include <PropWare/concurrent/runnable.h>
+#include <cstring>
+
+namespace PropWare {
+
+/**
+ * @brief   UART transmitter whose bits are shifted out by a helper cog
+ *
+ * Data width (up to 8 bits), parity and stop bits are configured exactly as with PropWare::UARTTX, but
+ * PropWare::BufferedUARTTX::send and PropWare::BufferedUARTTX::send_array only copy the data into a ring buffer and
+ * return immediately (unless the buffer is full). The helper cog drains the ring buffer with
+ * PropWare::UARTTX::send_array, so consecutive words go out with the same minimal gap as a single, long call to
+ * `send_array`.
+ *
+ * Because it is a PrintCapable, a BufferedUARTTX can back any PropWare::Printer, including the global `pwOut`:
+ *
+ * @code
+ * static char     txBuffer[1024];
+ * static uint32_t txStack[64];
+ *
+ * int main () {
+ *     static PropWare::BufferedUARTTX bufferedTx(txBuffer, txStack);
+ *     bufferedTx.start();
+ *     pwOut.set_print_capable(bufferedTx);
+ *
+ *     pwOut << "This line costs the caller little more than a memcpy\n";
+ *     ...
+ * }
+ * @endcode
+ *
+ * @note    Only one cog may write to a BufferedUARTTX at a time
+ *
+ * @note    Once started, the helper cog owns the TX pin. PropWare::BufferedUARTTX::start releases the pin in the
+ *          calling cog, so any other UARTTX instance on the same pin (such as the one originally behind `pwOut`) will
+ *          no longer drive it
+ */
+class BufferedUARTTX : public UARTTX,
+                       public Runnable {
+    public:
+        /**
+         * @brief       Construct a buffered transmitter on the default TX pin
+         *
+         * @param[in]   buffer  Statically allocated array, NOT a pointer, used as the ring buffer. Length must be a
+         *                      power of two
+         * @param[in]   stack   Stack for the helper cog
+         * @param[in]   tx      Pin mask of the TX pin
+         */
+        template<size_t BUFFER_N, size_t STACK_N>
+        BufferedUARTTX (char (&buffer)[BUFFER_N], const uint32_t (&stack)[STACK_N],
+                        const Pin::Mask tx = (Pin::Mask) (1 << _cfg_txpin))
+                : UARTTX(tx),
+                  Runnable(stack),
+                  m_buffer(buffer),
+                  m_bufferMask(BUFFER_N - 1),
+                  m_cogID(-1),
+                  m_head(0),
+                  m_tail(0) {
+            static_assert(1 < BUFFER_N && 0 == (BUFFER_N & (BUFFER_N - 1)), "Buffer length must be a power of two");
+        }
+
+        ~BufferedUARTTX () {
+            this->stop();
+        }
+
+        /**
+         * @brief   Start the helper cog and hand the TX pin over to it
+         *
+         * @return  Cog ID of the helper cog. -1 for failure
+         */
+        int8_t start () {
+            this->m_pin.set_dir_in();
+            return this->m_cogID = Runnable::invoke(*this);
+        }
+
+        /**
+         * @brief   Stop the helper cog immediately, discarding anything left in the buffer
+         */
+        void stop () {
+            if (-1 != this->m_cogID) {
+                cogstop(this->m_cogID);
+                this->m_cogID = -1;
+                this->m_tail  = this->m_head;
+            }
+        }
+
+        /**
+         * @brief   Wait until every word in the buffer has been shifted out
+         */
+        void flush () const {
+            while (this->m_head != this->m_tail);
+        }
+
+        /**
+         * @brief       Only data widths of 1 through 8 bits are supported
+         *
+         * @see         PropWare::UART::set_data_width
+         */
+        virtual ErrorCode set_data_width (const uint8_t dataWidth) {
+            if (8 < dataWidth)
+                return UART::INVALID_DATA_WIDTH;
+            else
+                return UARTTX::set_data_width(dataWidth);
+        }
+
+        /**
+         * @brief       Queue a single word (may wait for room in the buffer)
+         */
+        virtual void send (uint16_t originalData) const {
+            const char word = (char) originalData;
+            this->send_array(&word, 1);
+        }
+
+        /**
+         * @brief       Queue an array of words (may wait for room in the buffer)
+         *
+         * Free space in the ring buffer is filled with at most two `memcpy` calls per pass.
+         */
+        virtual void send_array (const char array[], uint32_t words) const {
+            const size_t bufferSize = this->m_bufferMask + 1;
+
+            while (words) {
+                const uint32_t head  = this->m_head;
+                const size_t   space = (this->m_tail - head - 1) & this->m_bufferMask;
+
+                if (space) {
+                    const size_t chunk      = words < space ? words : space;
+                    const size_t firstChunk = chunk < bufferSize - head ? chunk : bufferSize - head;
+                    memcpy(&this->m_buffer[head], array, firstChunk);
+                    memcpy(this->m_buffer, &array[firstChunk], chunk - firstChunk);
+                    this->m_head = (head + chunk) & this->m_bufferMask;
+
+                    array += chunk;
+                    words -= chunk;
+                }
+            }
+        }
+
+        /**
+         * @brief   Invoked in the helper cog; do not call directly
+         */
+        void run () {
+            this->m_pin.set();
+            this->m_pin.set_dir_out();
+
+            while (1) {
+                const uint32_t head = this->m_head;
+                const uint32_t tail = this->m_tail;
+
+                if (head != tail) {
+                    // Send everything up to the head or the end of the buffer, whichever comes first
+                    const uint32_t words = head > tail ? head - tail : this->m_bufferMask + 1 - tail;
+                    UARTTX::send_array(&this->m_buffer[tail], words);
+                    this->m_tail = (tail + words) & this->m_bufferMask;
+                }
+            }
+        }
+
+    protected:
+        char *const               m_buffer;
+        const uint32_t            m_bufferMask;
+        int8_t                    m_cogID;
+        mutable volatile uint32_t m_head;
+        volatile uint32_t         m_tail;
+};
+
+}
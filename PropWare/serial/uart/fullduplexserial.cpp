@@ -61,8 +61,14 @@ __asm__ (
 "            rdlong  bitticks, t1                                     \n"
 "            add     t1, #4                                           \n"
 "            rdlong  rxbuff, t1                                       \n"
-"            mov     txbuff, rxbuff                                   \n"
-"            add     txbuff, #$10                                     \n"
+"            add     t1, #4                                           \n"
+"            rdlong  txbuff, t1                                       \n"
+"            add     t1, #4                                           \n"
+"            rdlong  rxbuffmask, t1                                   \n"
+"            add     t1, #4                                           \n"
+"            rdlong  txbuffmask, t1                                   \n"
+"            add     t1, #4                                           \n"
+"            mov     rxovfaddr, t1                                    \n"
 "            test    rxtxmode, #4    wz                               \n"
 "            test    rxtxmode, #2    wc                               \n"
 "  if_z_ne_c or      OUTA, txmask                                     \n"
@@ -97,12 +103,23 @@ __asm__ (
 "            test    rxtxmode, #1    wz                               \n"
 "  if_nz     xor     rxdata, #$ff                                     \n"
 "            rdlong  t2, PAR                                          \n"
+"            mov     t3, t2                                           \n"
+"            add     t3, #1                                           \n"
+"            and     t3, rxbuffmask                                   \n"
+"            mov     t1, PAR                                          \n"
+"            add     t1, #4                                           \n"
+"            rdlong  t1, t1                                           \n"
+"            cmp     t3, t1    wz                                     \n"
+"  if_z      jmp     #Receive_overflow                                \n"
 "            add     t2, rxbuff                                       \n"
 "            wrbyte  rxdata, t2                                       \n"
-"            sub     t2, rxbuff                                       \n"
-"            add     t2, #1                                           \n"
-"            and     t2, #$f                                          \n"
-"            wrlong  t2, PAR                                          \n"
+"            wrlong  t3, PAR                                          \n"
+"            jmp     #receive                                         \n"
+"                                                                     \n"
+"Receive_overflow                                                     \n"
+"            rdlong  t1, rxovfaddr                                    \n"
+"            add     t1, #1                                           \n"
+"            wrlong  t1, rxovfaddr                                    \n"
 "            jmp     #receive                                         \n"
 "                                                                     \n"
 "transmit                                                             \n"
@@ -118,7 +135,7 @@ __asm__ (
 "            rdbyte  txdata, t3                                       \n"
 "            sub     t3, txbuff                                       \n"
 "            add     t3, #1                                           \n"
-"            and     t3, #$f                                          \n"
+"            and     t3, txbuffmask                                   \n"
 "            wrlong  t3, t1                                           \n"
 "            or      txdata, #$100                                    \n"
 "            shl     txdata, #2                                       \n"
@@ -168,6 +185,12 @@ __asm__ (
 "rxbuff                                                               \n"
 "            .res    1                                                \n"
 "                                                                     \n"
+"rxbuffmask                                                           \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"rxovfaddr                                                            \n"
+"            .res    1                                                \n"
+"                                                                     \n"
 "rxdata                                                               \n"
 "            .res    1                                                \n"
 "                                                                     \n"
@@ -186,6 +209,9 @@ __asm__ (
 "txbuff                                                               \n"
 "            .res    1                                                \n"
 "                                                                     \n"
+"txbuffmask                                                           \n"
+"            .res    1                                                \n"
+"                                                                     \n"
 "txdata                                                               \n"
 "            .res    1                                                \n"
 "                                                                     \n"
@@ -28,7 +28,10 @@
 #pragma once
 
 #include <PropWare/PropWare.h>
+#include <PropWare/concurrent/hardwarelock.h>
+#include <PropWare/concurrent/lockreference.h>
 #include <PropWare/serial/uart/uartcommondata.h>
+#include <PropWare/serial/uart/uartring.h>
 #include <PropWare/hmi/output/printcapable.h>
 #include <PropWare/hmi/input/scancapable.h>
 
@@ -38,9 +41,31 @@ void *get_full_duplex_serial_driver ();
 
 /**
  * @brief   Converted to C++ using spin2cpp and then modified to become a PrintCapable object in PropWare's arsenal.
+ *
+ * The receive and transmit ring buffers default to PropWare::FullDuplexSerial::BUFFER_SIZE bytes each, which is
+ * enough for interactive use at low baud rates. When the application may stall for longer than a handful of
+ * character times (such as during an SD card write at 115200 baud), provide larger, statically-allocated buffers
+ * instead. Each buffer's size must be a power of two and, as with any ring buffer, one byte of each is left unused
+ * to distinguish a full buffer from an empty one.
+ *
+ * @code
+ * char rxBuffer[1024];
+ * char txBuffer[256];
+ * PropWare::FullDuplexSerial serial(rxBuffer, txBuffer);
+ * serial.start();
+ * @endcode
+ *
+ * Bytes received while the receive buffer is full are dropped by the driver and counted. See
+ * PropWare::FullDuplexSerial::get_overflow_count.
+ *
+ * Any number of cogs may transmit concurrently; each call to PropWare::FullDuplexSerial::put_char,
+ * PropWare::FullDuplexSerial::puts or PropWare::FullDuplexSerial::write is queued atomically. Only one cog at a time
+ * may read from the receive buffer.
  */
 class FullDuplexSerial : public PrintCapable,
                          public ScanCapable {
+    friend class UARTRing;
+
     public:
         typedef enum {
             INVERT_RX            = BIT_0,
@@ -49,6 +74,7 @@ class FullDuplexSerial : public PrintCapable,
             IGNORE_TX_ECHO_ON_RX = BIT_3
         } Mode;
 
+        /** Size of each of the default receive and transmit buffers */
         static const size_t BUFFER_SIZE = 16;
 
     public:
@@ -63,27 +89,67 @@ class FullDuplexSerial : public PrintCapable,
          * @param mode          Combination of some, none, or all of the Mode values which can change the behavior of
          *                      the device
          * @param baudrate      Baudrate to run the transmit and recieve routines
+         * @param transmitLock  Lock which serializes transmitting cogs, such as a PropWare::TicketLock. By default, a
+         *                      hardware lock is allocated
          */
         FullDuplexSerial (const int rxPinNumber = _cfg_rxpin, const int txPinNumber = _cfg_txpin,
-                          const uint32_t mode = 0, const int baudrate = _cfg_baudrate)
-                : m_transmitLock(locknew()),
-                  m_stringLock(locknew()),
+                          const uint32_t mode = 0, const int baudrate = _cfg_baudrate,
+                          const LockReference &transmitLock = LockReference())
+                : m_ownTransmitLock(transmitLock.is_bound() ? HardwareLock::NONE : locknew()),
+                  m_transmitLock(transmitLock.is_bound() ? transmitLock : LockReference(this->m_ownTransmitLock)),
+                  m_cogID(-1),
+                  m_receivePinNumber(rxPinNumber),
+                  m_transmitPinNumber(txPinNumber),
+                  m_mode(mode),
+                  m_bitTicks(CLKFREQ / baudrate),
+                  m_receiveBuffer(this->m_defaultReceiveBuffer),
+                  m_transmitBuffer(this->m_defaultTransmitBuffer),
+                  m_receiveBufferMask(BUFFER_SIZE - 1),
+                  m_transmitBufferMask(BUFFER_SIZE - 1),
+                  m_receiveOverflows(0) {
+        }
+
+        /**
+         * Construct a full-duplex, buffered UART instance with user-provided ring buffers
+         *
+         * @param rxBuffer      Statically allocated array, NOT a pointer, used as the receive ring buffer. Length must
+         *                      be a power of two
+         * @param txBuffer      Statically allocated array, NOT a pointer, used as the transmit ring buffer. Length
+         *                      must be a power of two
+         * @param rxPinNumber   Pin number to receive data
+         * @param txPinNumber   Pin number to transmit data
+         * @param mode          Combination of some, none, or all of the Mode values which can change the behavior of
+         *                      the device
+         * @param baudrate      Baudrate to run the transmit and recieve routines
+         * @param transmitLock  Lock which serializes transmitting cogs, such as a PropWare::TicketLock. By default, a
+         *                      hardware lock is allocated
+         */
+        template<size_t RX_N, size_t TX_N>
+        FullDuplexSerial (char (&rxBuffer)[RX_N], char (&txBuffer)[TX_N], const int rxPinNumber = _cfg_rxpin,
+                          const int txPinNumber = _cfg_txpin, const uint32_t mode = 0,
+                          const int baudrate = _cfg_baudrate, const LockReference &transmitLock = LockReference())
+                : m_ownTransmitLock(transmitLock.is_bound() ? HardwareLock::NONE : locknew()),
+                  m_transmitLock(transmitLock.is_bound() ? transmitLock : LockReference(this->m_ownTransmitLock)),
                   m_cogID(-1),
                   m_receivePinNumber(rxPinNumber),
                   m_transmitPinNumber(txPinNumber),
                   m_mode(mode),
                   m_bitTicks(CLKFREQ / baudrate),
-                  m_bufferPointer((uint32_t) this->m_receiveBuffer) {
+                  m_receiveBuffer(rxBuffer),
+                  m_transmitBuffer(txBuffer),
+                  m_receiveBufferMask(RX_N - 1),
+                  m_transmitBufferMask(TX_N - 1),
+                  m_receiveOverflows(0) {
+            static_assert(1 < RX_N && 0 == (RX_N & (RX_N - 1)), "Receive buffer length must be a power of two");
+            static_assert(1 < TX_N && 0 == (TX_N & (TX_N - 1)), "Transmit buffer length must be a power of two");
         }
 
         /**
-         * @brief   Stop the driver cog and return the locks
+         * @brief   Stop the driver cog and return the lock, if one was allocated
          */
         ~FullDuplexSerial () {
             if (-1 != this->m_cogID)
                 cogstop(this->m_cogID);
-            lockret(this->m_transmitLock);
-            lockret(this->m_stringLock);
         }
 
         /**
@@ -122,7 +188,7 @@ class FullDuplexSerial : public PrintCapable,
         bool get_char_non_blocking (char &c) {
             if (this->receive_ready()) {
                 c = this->m_receiveBuffer[this->m_receiveTail];
-                this->m_receiveTail = (this->m_receiveTail + 1) & 0xf;
+                this->m_receiveTail = (this->m_receiveTail + 1) & this->m_receiveBufferMask;
                 return true;
             } else
                 return false;
@@ -152,29 +218,73 @@ class FullDuplexSerial : public PrintCapable,
 
         void put_char (const char c) {
             // Send byte (may wait for room in buffer)
-            while (lockset(this->m_transmitLock));
-            while (this->m_transmitTail == ((this->m_transmitHead + 1) & 0xf));
+            this->m_transmitLock.lock();
+            while (this->m_transmitTail == ((this->m_transmitHead + 1) & this->m_transmitBufferMask));
             this->m_transmitBuffer[this->m_transmitHead] = c;
-            this->m_transmitHead = (this->m_transmitHead + 1) & 0xf;
-            lockclr(this->m_transmitLock);
+            this->m_transmitHead = (this->m_transmitHead + 1) & this->m_transmitBufferMask;
+            this->m_transmitLock.unlock();
             if (this->m_mode & IGNORE_TX_ECHO_ON_RX)
                 this->get_char();
         }
 
+        /**
+         * @brief   Determine how many received bytes have been lost because the receive buffer was full
+         *
+         * The counter is maintained by the driver cog and starts at zero when the object is constructed. It is never
+         * reset, so compare two readings to detect new losses.
+         *
+         * @return  Number of bytes dropped by the driver since construction
+         */
+        uint32_t get_overflow_count () const {
+            return this->m_receiveOverflows;
+        }
+
         void puts (const char string[]) {
-            const unsigned int length = strlen(string);
-            while (lockset(this->m_stringLock));
-            for (unsigned int i = 0; i < length; i++)
-                this->put_char((string++)[0]);
-            lockclr(this->m_stringLock);
+            this->write(string, strlen(string));
+        }
+
+        /**
+         * @brief       Queue an array of bytes for transmission (may wait for room in the buffer)
+         *
+         * The transmit lock is acquired once for the whole array, so the bytes will not be interleaved with those of
+         * another cog. Whatever space is free in the ring buffer is filled with at most two `memcpy` calls rather
+         * than one byte at a time.
+         *
+         * @param[in]   buffer[]    Bytes to be sent
+         * @param[in]   length      Number of bytes to be sent
+         */
+        void write (const char buffer[], size_t length) {
+            UARTRing::write(*this, buffer, length, this->m_mode & IGNORE_TX_ECHO_ON_RX);
+        }
+
+        /**
+         * @brief       Remove all bytes currently waiting in the receive buffer, up to a maximum (never waits)
+         *
+         * @param[out]  buffer[]    Received bytes will be copied here
+         * @param[in]   maxLength   Maximum number of bytes to copy into `buffer[]`
+         *
+         * @return      Number of bytes copied into `buffer[]`
+         */
+        size_t read (char buffer[], const size_t maxLength) {
+            return UARTRing::read(*this, buffer, maxLength);
+        }
+
+        /**
+         * @brief       Wait for at least one byte, then remove all bytes waiting in the receive buffer, up to a maximum
+         *
+         * @see PropWare::ScanCapable::get_chars
+         */
+        size_t get_chars (char buffer[], const size_t maxLength) {
+            while (!this->receive_ready());
+            return this->read(buffer, maxLength);
         }
 
     protected:
-        const uint8_t m_transmitLock;
-        const uint8_t m_stringLock;
+        HardwareLock  m_ownTransmitLock;
+        LockReference m_transmitLock;
         int32_t       m_cogID;
-        char          m_receiveBuffer[BUFFER_SIZE];
-        char          m_transmitBuffer[BUFFER_SIZE];
+        char          m_defaultReceiveBuffer[BUFFER_SIZE];
+        char          m_defaultTransmitBuffer[BUFFER_SIZE];
 
         // These variables must appear in this order. The assembly code relies on the exact order
         volatile uint32_t m_receiveHead;
@@ -185,7 +295,11 @@ class FullDuplexSerial : public PrintCapable,
         const int         m_transmitPinNumber;
         const uint32_t    m_mode;
         const uint32_t    m_bitTicks;
-        const uint32_t    m_bufferPointer;
+        char *const       m_receiveBuffer;
+        char *const       m_transmitBuffer;
+        const uint32_t    m_receiveBufferMask;
+        const uint32_t    m_transmitBufferMask;
+        volatile uint32_t m_receiveOverflows;
 };
 
 }
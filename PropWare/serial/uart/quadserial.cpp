@@ -0,0 +1,292 @@
+/**
+ * @file    PropWare/serial/uart/quadserial.cpp
+ *
+ * @author  Chip Gracey
+ * @author  Jeff Martin
+ * @author  David Zemon
+ *
+ * Assembly code for PropWare::QuadSerial, derived from the Full-Duplex Serial Driver
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>2006-2009 Parallax, Inc.<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <stdint.h>
+
+
+extern uint8_t _load_start_QuadSerial_cog[];
+
+namespace PropWare {
+
+void *get_quad_serial_driver () {
+    return _load_start_QuadSerial_cog;
+}
+
+}
+
+#ifndef DOXYGEN_IGNORE
+
+// Receive co-routine for port n. Yields to the transmit co-routine of the same port
+#define QUAD_SERIAL_RECEIVER(n) \
+"Rx" #n "\n" \
+"            jmpret  rxcode" #n ", txcode" #n "\n" \
+"            test    mode" #n ", #1    wz\n" \
+"            test    rxmask" #n ", INA    wc\n" \
+"  if_z_eq_c jmp     #Rx" #n "\n" \
+"            tjz     rxmask" #n ", #Rx" #n "\n" \
+"            mov     rxbits" #n ", #9\n" \
+"            mov     rxcnt" #n ", bitticks" #n "\n" \
+"            shr     rxcnt" #n ", #1\n" \
+"            add     rxcnt" #n ", CNT\n" \
+"\n" \
+"Rx" #n "_bit\n" \
+"            add     rxcnt" #n ", bitticks" #n "\n" \
+"\n" \
+"Rx" #n "_wait\n" \
+"            jmpret  rxcode" #n ", txcode" #n "\n" \
+"            mov     t1, rxcnt" #n "\n" \
+"            sub     t1, CNT\n" \
+"            cmps    t1, #0    wc\n" \
+"  if_nc     jmp     #Rx" #n "_wait\n" \
+"            test    rxmask" #n ", INA    wc\n" \
+"            rcr     rxdata" #n ", #1\n" \
+"            djnz    rxbits" #n ", #Rx" #n "_bit\n" \
+"            shr     rxdata" #n ", #($20 - 9)\n" \
+"            and     rxdata" #n ", #$ff\n" \
+"            test    mode" #n ", #1    wz\n" \
+"  if_nz     xor     rxdata" #n ", #$ff\n" \
+"            mov     t1, pbase" #n "\n" \
+"            add     t1, #4\n" \
+"            rdlong  t1, t1\n" \
+"            mov     t2, rxhead" #n "\n" \
+"            add     t2, #1\n" \
+"            and     t2, rxbuffmask" #n "\n" \
+"            cmp     t2, t1    wz\n" \
+"  if_z      jmp     #Rx" #n "_overflow\n" \
+"            mov     t1, rxhead" #n "\n" \
+"            add     t1, rxbuff" #n "\n" \
+"            wrbyte  rxdata" #n ", t1\n" \
+"            mov     rxhead" #n ", t2\n" \
+"            wrlong  rxhead" #n ", pbase" #n "\n" \
+"            jmp     #Rx" #n "\n" \
+"\n" \
+"Rx" #n "_overflow\n" \
+"            mov     t1, pbase" #n "\n" \
+"            add     t1, #(12 << 2)\n" \
+"            rdlong  t2, t1\n" \
+"            add     t2, #1\n" \
+"            wrlong  t2, t1\n" \
+"            jmp     #Rx" #n "\n" \
+"\n"
+
+// Transmit co-routine for port n. Yields to the receive co-routine of port m, the next port in the chain
+#define QUAD_SERIAL_TRANSMITTER(n, m) \
+"Tx" #n "\n" \
+"            jmpret  txcode" #n ", rxcode" #m "\n" \
+"            mov     t1, pbase" #n "\n" \
+"            add     t1, #(2 << 2)\n" \
+"            rdlong  t2, t1\n" \
+"            cmp     t2, txtail" #n "    wz\n" \
+"  if_z      jmp     #Tx" #n "\n" \
+"            mov     t3, txtail" #n "\n" \
+"            add     t3, txbuff" #n "\n" \
+"            rdbyte  txdata" #n ", t3\n" \
+"            add     txtail" #n ", #1\n" \
+"            and     txtail" #n ", txbuffmask" #n "\n" \
+"            add     t1, #4\n" \
+"            wrlong  txtail" #n ", t1\n" \
+"            or      txdata" #n ", #$100\n" \
+"            shl     txdata" #n ", #2\n" \
+"            or      txdata" #n ", #1\n" \
+"            mov     txbits" #n ", #$b\n" \
+"            mov     txcnt" #n ", CNT\n" \
+"\n" \
+"Tx" #n "_bit\n" \
+"            test    mode" #n ", #4    wz\n" \
+"            test    mode" #n ", #2    wc\n" \
+"  if_z_and_c xor     txdata" #n ", #1\n" \
+"            shr     txdata" #n ", #1    wc\n" \
+"  if_z      muxc    OUTA, txmask" #n "\n" \
+"  if_nz     muxnc   DIRA, txmask" #n "\n" \
+"            add     txcnt" #n ", bitticks" #n "\n" \
+"\n" \
+"Tx" #n "_wait\n" \
+"            jmpret  txcode" #n ", rxcode" #m "\n" \
+"            mov     t1, txcnt" #n "\n" \
+"            sub     t1, CNT\n" \
+"            cmps    t1, #0    wc\n" \
+"  if_nc     jmp     #Tx" #n "_wait\n" \
+"            djnz    txbits" #n ", #Tx" #n "_bit\n" \
+"            jmp     #Tx" #n "\n" \
+"\n"
+
+// Initialized per-port registers
+#define QUAD_SERIAL_INITIALIZED_REGISTERS(n) \
+"rxcode" #n "\n" \
+"            .long   (Rx" #n " - ..start) / 4\n" \
+"\n" \
+"txcode" #n "\n" \
+"            .long   (Tx" #n " - ..start) / 4\n" \
+"\n" \
+"rxhead" #n "\n" \
+"            .long   0\n" \
+"\n" \
+"txtail" #n "\n" \
+"            .long   0\n" \
+"\n"
+
+// Per-port configuration, copied from hub RAM by the initialization loop. The order must match both the order of the
+// configuration fields in PropWare::QuadSerial::Port and the order of the ports, since all four blocks are filled
+// by a single loop
+#define QUAD_SERIAL_CONFIGURATION_REGISTERS(n) \
+"pbase" #n "\n" \
+"            .res    1\n" \
+"\n" \
+"rxmask" #n "\n" \
+"            .res    1\n" \
+"\n" \
+"txmask" #n "\n" \
+"            .res    1\n" \
+"\n" \
+"mode" #n "\n" \
+"            .res    1\n" \
+"\n" \
+"bitticks" #n "\n" \
+"            .res    1\n" \
+"\n" \
+"rxbuff" #n "\n" \
+"            .res    1\n" \
+"\n" \
+"txbuff" #n "\n" \
+"            .res    1\n" \
+"\n" \
+"rxbuffmask" #n "\n" \
+"            .res    1\n" \
+"\n" \
+"txbuffmask" #n "\n" \
+"            .res    1\n" \
+"\n"
+
+// Per-port working registers
+#define QUAD_SERIAL_WORKING_REGISTERS(n) \
+"rxdata" #n "\n" \
+"            .res    1\n" \
+"\n" \
+"rxbits" #n "\n" \
+"            .res    1\n" \
+"\n" \
+"rxcnt" #n "\n" \
+"            .res    1\n" \
+"\n" \
+"txdata" #n "\n" \
+"            .res    1\n" \
+"\n" \
+"txbits" #n "\n" \
+"            .res    1\n" \
+"\n" \
+"txcnt" #n "\n" \
+"            .res    1\n" \
+"\n"
+
+__asm__ (
+"            .section .QuadSerial.cog, \"ax\"                         \n"
+"            .compress off                                            \n"
+"..start                                                              \n"
+"            .org    0                                                \n"
+"                                                                     \n"
+"entry                                                                \n"
+"            mov     t1, PAR                                          \n"
+"            mov     t4, #4                                           \n"
+"            mov     dest, #((pbase0 - ..start) / 4)                  \n"
+"                                                                     \n"
+"Init_port                                                            \n"
+"            movd    Init_base, dest                                  \n"
+"            add     dest, #1                                         \n"
+"            rdlong  t2, t1                                           \n"
+"Init_base                                                            \n"
+"            mov     0-0, t2                                          \n"
+"            add     t1, #4                                           \n"
+"            add     t2, #(4 << 2)                                    \n"
+"            mov     t3, t2                                           \n"
+"            add     t3, #4                                           \n"
+"            rdlong  t5, t3                                           \n"
+"            add     t3, #4                                           \n"
+"            rdlong  t6, t3                                           \n"
+"            test    t6, #4    wz                                     \n"
+"            test    t6, #2    wc                                     \n"
+"  if_z_ne_c or      OUTA, t5                                         \n"
+"  if_z      or      DIRA, t5                                         \n"
+"            mov     t3, #8                                           \n"
+"                                                                     \n"
+"Init_field                                                           \n"
+"            movd    Init_read, dest                                  \n"
+"            add     dest, #1                                         \n"
+"Init_read                                                            \n"
+"            rdlong  0-0, t2                                          \n"
+"            add     t2, #4                                           \n"
+"            djnz    t3, #Init_field                                  \n"
+"            djnz    t4, #Init_port                                   \n"
+"            jmp     #Rx0                                             \n"
+"                                                                     \n"
+QUAD_SERIAL_RECEIVER(0)
+QUAD_SERIAL_TRANSMITTER(0, 1)
+QUAD_SERIAL_RECEIVER(1)
+QUAD_SERIAL_TRANSMITTER(1, 2)
+QUAD_SERIAL_RECEIVER(2)
+QUAD_SERIAL_TRANSMITTER(2, 3)
+QUAD_SERIAL_RECEIVER(3)
+QUAD_SERIAL_TRANSMITTER(3, 0)
+QUAD_SERIAL_INITIALIZED_REGISTERS(0)
+QUAD_SERIAL_INITIALIZED_REGISTERS(1)
+QUAD_SERIAL_INITIALIZED_REGISTERS(2)
+QUAD_SERIAL_INITIALIZED_REGISTERS(3)
+"t1                                                                   \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"t2                                                                   \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"t3                                                                   \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"t4                                                                   \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"t5                                                                   \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"t6                                                                   \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+"dest                                                                 \n"
+"            .res    1                                                \n"
+"                                                                     \n"
+QUAD_SERIAL_CONFIGURATION_REGISTERS(0)
+QUAD_SERIAL_CONFIGURATION_REGISTERS(1)
+QUAD_SERIAL_CONFIGURATION_REGISTERS(2)
+QUAD_SERIAL_CONFIGURATION_REGISTERS(3)
+QUAD_SERIAL_WORKING_REGISTERS(0)
+QUAD_SERIAL_WORKING_REGISTERS(1)
+QUAD_SERIAL_WORKING_REGISTERS(2)
+QUAD_SERIAL_WORKING_REGISTERS(3)
+"            .compress default                                        \n"
+"            .text                                                    \n"
+);
+
+#endif
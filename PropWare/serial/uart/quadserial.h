@@ -0,0 +1,323 @@
+/**
+ * @file    PropWare/serial/uart/quadserial.h
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/PropWare.h>
+#include <PropWare/concurrent/lockreference.h>
+#include <PropWare/concurrent/lockservice.h>
+#include <PropWare/serial/uart/uartcommondata.h>
+#include <PropWare/serial/uart/fullduplexserial.h>
+#include <PropWare/serial/uart/uartring.h>
+#include <PropWare/hmi/output/printcapable.h>
+#include <PropWare/hmi/input/scancapable.h>
+
+namespace PropWare {
+
+void *get_quad_serial_driver ();
+
+/**
+ * @brief   Four independent, buffered, full-duplex UARTs serviced by a single cog
+ *
+ * Each port has its own RX and TX pins, baud rate, mode bits (see PropWare::FullDuplexSerial::Mode) and ring buffers.
+ * Ports are configured with PropWare::QuadSerial::set_port before the driver is started, and each port is then used
+ * through its PropWare::QuadSerial::Port facade, which is both PrintCapable and ScanCapable:
+ *
+ * @code
+ * char gpsRx[256], gpsTx[16];
+ * char modemRx[512], modemTx[512];
+ *
+ * PropWare::QuadSerial serial;
+ * PropWare::QuadSerial::Port &gps   = serial.set_port(0, gpsRx, gpsTx, 0, 1, 0, 9600);
+ * PropWare::QuadSerial::Port &modem = serial.set_port(1, modemRx, modemTx, 2, 3, 0, 57600);
+ * serial.start();
+ *
+ * PropWare::Printer modemPrinter(modem);
+ * PropWare::Scanner gpsScanner(gps);
+ * @endcode
+ *
+ * Either pin of a port may be -1 to leave that direction unused. A port that is never configured costs nothing but a
+ * few instructions in the driver loop.
+ *
+ * <b>Maximum baud rate</b>
+ * <p>
+ * The driver interleaves eight co-routines (one receiver and one transmitter per port). Each receiver samples its pin
+ * once per pass through all eight, and a pass takes up to ~250 clock cycles when every port is busy. Reliable
+ * reception requires at least four passes per bit, so at 80 MHz:
+ *
+ *   - All four ports active: up to 57,600 baud per port, or 460,800 bps aggregate across all eight RX and TX channels
+ *   - A single active port: up to 115,200 baud
+ *
+ * Unused ports and idle transmitters shorten each pass, so lightly loaded configurations have more headroom. These
+ * limits are derived from instruction timing, not measured on hardware; verify with your own traffic before relying
+ * on them.
+ */
+class QuadSerial {
+    public:
+        /** Number of ports serviced by the driver */
+        static const uint8_t PORTS = 4;
+
+        /**
+         * @brief   A single port of a PropWare::QuadSerial driver
+         *
+         * Any number of cogs may transmit on a port concurrently; each call to PropWare::QuadSerial::Port::put_char,
+         * PropWare::QuadSerial::Port::puts or PropWare::QuadSerial::Port::write is queued atomically. Each port has its
+         * own transmit lock, so a cog waiting for room on a slow port does not hold up writers on the others. Only one
+         * cog at a time may read from a port.
+         */
+        class Port : public PrintCapable,
+                     public ScanCapable {
+            friend class QuadSerial;
+            friend class UARTRing;
+
+            public:
+                /**
+                 * @brief   Find out if a byte is waiting in the receive buffer
+                 *
+                 * @return  True if a byte is waiting, false otherwise
+                 */
+                bool receive_ready () const {
+                    return this->m_receiveHead != this->m_receiveTail;
+                }
+
+                /**
+                 * @brief       Check if byte received (never waits)
+                 *
+                 * @param[out]  c   Byte received from the buffer
+                 *
+                 * @return      True if `c` is valid, false otherwise
+                 */
+                bool get_char_non_blocking (char &c) {
+                    if (this->receive_ready()) {
+                        c = this->m_receiveBuffer[this->m_receiveTail];
+                        this->m_receiveTail = (this->m_receiveTail + 1) & this->m_receiveBufferMask;
+                        return true;
+                    } else
+                        return false;
+                }
+
+                /**
+                 * @brief       Wait for a byte to be received and return after a timeout
+                 *
+                 * @param[out]  c           Byte received from the buffer
+                 * @param[in]   timeout     Timeout (in clock ticks) before exiting the function
+                 *
+                 * @return      True if `c` is valid, false if no character was available before the timeout
+                 */
+                bool get_char (char &c, const unsigned int timeout) {
+                    const unsigned int startTime = CNT;
+                    bool               success;
+                    while (!(success = this->get_char_non_blocking(c))
+                            && ((CNT - startTime) < timeout));
+                    return success;
+                }
+
+                char get_char () {
+                    char c;
+                    while (!this->get_char_non_blocking(c));
+                    return c;
+                }
+
+                void put_char (const char c) {
+                    this->write(&c, 1);
+                }
+
+                void puts (const char string[]) {
+                    this->write(string, strlen(string));
+                }
+
+                /**
+                 * @brief   Queue an array of bytes for transmission (may wait for room in the buffer)
+                 *
+                 * Bytes written to a port which was never configured with PropWare::QuadSerial::set_port are
+                 * discarded.
+                 *
+                 * @see PropWare::FullDuplexSerial::write
+                 */
+                void write (const char buffer[], size_t length) {
+                    if (NULL != this->m_transmitBuffer)
+                        UARTRing::write(*this, buffer, length, this->m_mode & FullDuplexSerial::IGNORE_TX_ECHO_ON_RX);
+                }
+
+                /**
+                 * @see PropWare::FullDuplexSerial::read
+                 */
+                size_t read (char buffer[], const size_t maxLength) {
+                    return UARTRing::read(*this, buffer, maxLength);
+                }
+
+                /**
+                 * @see PropWare::FullDuplexSerial::get_overflow_count
+                 */
+                uint32_t get_overflow_count () const {
+                    return this->m_receiveOverflows;
+                }
+
+            protected:
+                /**
+                 * @brief   An unconfigured port: both pins unused and no buffers
+                 */
+                Port ()
+                        : m_transmitLock(this->m_ownLock),
+                          m_receiveHead(0),
+                          m_receiveTail(0),
+                          m_transmitHead(0),
+                          m_transmitTail(0),
+                          m_receivePinMask(0),
+                          m_transmitPinMask(0),
+                          m_mode(0),
+                          m_bitTicks(0),
+                          m_receiveBuffer(NULL),
+                          m_transmitBuffer(NULL),
+                          m_receiveBufferMask(0),
+                          m_transmitBufferMask(0),
+                          m_receiveOverflows(0) {
+                }
+
+            protected:
+                TicketLock    m_ownLock;
+                LockReference m_transmitLock;
+
+                // These variables must appear in this order. The assembly code relies on the exact order
+                volatile uint32_t m_receiveHead;
+                volatile uint32_t m_receiveTail;
+                volatile uint32_t m_transmitHead;
+                volatile uint32_t m_transmitTail;
+                uint32_t          m_receivePinMask;
+                uint32_t          m_transmitPinMask;
+                uint32_t          m_mode;
+                uint32_t          m_bitTicks;
+                char              *m_receiveBuffer;
+                char              *m_transmitBuffer;
+                uint32_t          m_receiveBufferMask;
+                uint32_t          m_transmitBufferMask;
+                volatile uint32_t m_receiveOverflows;
+        };
+
+    public:
+        /**
+         * @brief   Construct a driver with all four ports unconfigured
+         */
+        QuadSerial ()
+                : m_cogID(-1) {
+        }
+
+        /**
+         * @brief   Stop the driver cog
+         */
+        ~QuadSerial () {
+            this->stop();
+        }
+
+        /**
+         * @brief       Configure one port
+         *
+         * @pre         The driver must not be running. Configure all ports first, then call
+         *              PropWare::QuadSerial::start
+         *
+         * @param[in]   port            Index of the port, 0 through 3
+         * @param[in]   rxBuffer        Statically allocated array, NOT a pointer, used as the receive ring buffer.
+         *                              Length must be a power of two
+         * @param[in]   txBuffer        Statically allocated array, NOT a pointer, used as the transmit ring buffer.
+         *                              Length must be a power of two
+         * @param[in]   rxPinNumber     Pin number to receive data, or -1 if this port does not receive
+         * @param[in]   txPinNumber     Pin number to transmit data, or -1 if this port does not transmit
+         * @param[in]   mode            Combination of some, none, or all of the PropWare::FullDuplexSerial::Mode values
+         * @param[in]   baudrate        Baudrate to run the transmit and receive routines
+         * @param[in]   transmitLock    Lock which serializes cogs transmitting on this port. By default, the port uses
+         *                              its own PropWare::TicketLock
+         *
+         * @return      The configured port
+         */
+        template<size_t RX_N, size_t TX_N>
+        Port &set_port (const uint8_t port, char (&rxBuffer)[RX_N], char (&txBuffer)[TX_N], const int rxPinNumber,
+                        const int txPinNumber, const uint32_t mode = 0, const int baudrate = _cfg_baudrate,
+                        const LockReference &transmitLock = LockReference()) {
+            static_assert(1 < RX_N && 0 == (RX_N & (RX_N - 1)), "Receive buffer length must be a power of two");
+            static_assert(1 < TX_N && 0 == (TX_N & (TX_N - 1)), "Transmit buffer length must be a power of two");
+
+            Port &p = this->m_ports[port];
+            p.m_transmitLock       = transmitLock.is_bound() ? transmitLock : LockReference(p.m_ownLock);
+            p.m_receiveHead        = 0;
+            p.m_receiveTail        = 0;
+            p.m_transmitHead       = 0;
+            p.m_transmitTail       = 0;
+            p.m_receivePinMask     = 0 > rxPinNumber ? 0 : 1 << rxPinNumber;
+            p.m_transmitPinMask    = 0 > txPinNumber ? 0 : 1 << txPinNumber;
+            p.m_mode               = mode;
+            p.m_bitTicks           = CLKFREQ / baudrate;
+            p.m_receiveBuffer      = rxBuffer;
+            p.m_transmitBuffer     = txBuffer;
+            p.m_receiveBufferMask  = RX_N - 1;
+            p.m_transmitBufferMask = TX_N - 1;
+            p.m_receiveOverflows   = 0;
+            return p;
+        }
+
+        /**
+         * @brief       Retrieve a port
+         *
+         * @param[in]   port    Index of the port, 0 through 3
+         */
+        Port &get_port (const uint8_t port) {
+            return this->m_ports[port];
+        }
+
+        /**
+         * @brief   Start the driver cog
+         *
+         * Any data left in the buffers from a previous run of the driver is discarded.
+         *
+         * @return  Cog ID of the driver cog. -1 for failure
+         */
+        int start () {
+            for (uint8_t i = 0; i < PORTS; ++i) {
+                Port &p = this->m_ports[i];
+                p.m_receiveHead  = 0;
+                p.m_receiveTail  = 0;
+                p.m_transmitHead = 0;
+                p.m_transmitTail = 0;
+                this->m_portAddresses[i] = (uint32_t) &p.m_receiveHead;
+            }
+            return this->m_cogID = cognew(get_quad_serial_driver(), (int32_t) this->m_portAddresses);
+        }
+
+        /**
+         * @brief   Stop the driver cog, if it is running
+         */
+        void stop () {
+            if (-1 != this->m_cogID) {
+                cogstop(this->m_cogID);
+                this->m_cogID = -1;
+            }
+        }
+
+    protected:
+        int32_t  m_cogID;
+        Port     m_ports[PORTS];
+        uint32_t m_portAddresses[PORTS];
+};
+
+}
@@ -0,0 +1,113 @@
+/**
+ * @file    PropWare/serial/uart/uartring.h
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Bulk transfers to and from the ring buffers of a buffered serial driver
+ *
+ * PropWare::FullDuplexSerial and each PropWare::QuadSerial::Port keep their buffers in identically-named fields:
+ * `m_receiveHead`, `m_receiveTail`, `m_receiveBuffer` and `m_receiveBufferMask` and their transmit counterparts,
+ * plus `m_transmitLock`. Both make this class a friend so that the copying is written only once.
+ */
+class UARTRing {
+    public:
+        /**
+         * @brief       Queue an array of bytes for transmission (may wait for room in the buffer)
+         *
+         * The transmit lock is acquired once for the whole array, so the bytes will not be interleaved with those of
+         * another cog. Whatever space is free in the ring buffer is filled with at most two `memcpy` calls rather than
+         * one byte at a time.
+         *
+         * @param[in]   serial      Driver whose transmit buffer is filled
+         * @param[in]   buffer[]    Bytes to be sent
+         * @param[in]   length      Number of bytes to be sent
+         * @param[in]   ignoreEcho  Discard one received byte for each byte sent, as with
+         *                          PropWare::FullDuplexSerial::IGNORE_TX_ECHO_ON_RX
+         */
+        template<typename Serial>
+        static void write (Serial &serial, const char buffer[], size_t length, const bool ignoreEcho) {
+            const size_t bufferSize    = serial.m_transmitBufferMask + 1;
+            size_t       echoesPending = ignoreEcho ? length : 0;
+
+            serial.m_transmitLock.lock();
+            while (length) {
+                const uint32_t head  = serial.m_transmitHead;
+                const size_t   space = (serial.m_transmitTail - head - 1) & serial.m_transmitBufferMask;
+
+                if (space) {
+                    const size_t chunk      = length < space ? length : space;
+                    const size_t firstChunk = chunk < bufferSize - head ? chunk : bufferSize - head;
+                    memcpy(&serial.m_transmitBuffer[head], buffer, firstChunk);
+                    memcpy(serial.m_transmitBuffer, &buffer[firstChunk], chunk - firstChunk);
+                    serial.m_transmitHead = (head + chunk) & serial.m_transmitBufferMask;
+
+                    buffer += chunk;
+                    length -= chunk;
+                } else {
+                    // Don't let the echo overflow the receive buffer while we wait for room to transmit
+                    char c;
+                    while (echoesPending && serial.get_char_non_blocking(c))
+                        --echoesPending;
+                }
+            }
+            serial.m_transmitLock.unlock();
+
+            while (echoesPending--)
+                serial.get_char();
+        }
+
+        /**
+         * @brief       Remove all bytes currently waiting in the receive buffer, up to a maximum (never waits)
+         *
+         * @param[in]   serial      Driver whose receive buffer is emptied
+         * @param[out]  buffer[]    Received bytes will be copied here
+         * @param[in]   maxLength   Maximum number of bytes to copy into `buffer[]`
+         *
+         * @return      Number of bytes copied into `buffer[]`
+         */
+        template<typename Serial>
+        static size_t read (Serial &serial, char buffer[], const size_t maxLength) {
+            const size_t   bufferSize = serial.m_receiveBufferMask + 1;
+            const uint32_t tail       = serial.m_receiveTail;
+            const size_t   available  = (serial.m_receiveHead - tail) & serial.m_receiveBufferMask;
+
+            const size_t length     = available < maxLength ? available : maxLength;
+            const size_t firstChunk = length < bufferSize - tail ? length : bufferSize - tail;
+            memcpy(buffer, &serial.m_receiveBuffer[tail], firstChunk);
+            memcpy(&buffer[firstChunk], serial.m_receiveBuffer, length - firstChunk);
+            serial.m_receiveTail = (tail + length) & serial.m_receiveBufferMask;
+
+            return length;
+        }
+};
+
+}
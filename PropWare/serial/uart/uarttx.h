@@ -28,6 +28,7 @@
 #include <PropWare/hmi/output/printcapable.h>
 #include <PropWare/serial/uart/uart.h>
 #include <PropWare/gpio/pin.h>
+#include <cstring>
 
 namespace PropWare {
 
@@ -69,6 +70,7 @@ class UARTTX : public UART
             uint32_t wideData = originalData;
 
             // Add parity bit
+#ifdef __PROPELLER__
             if (Parity::EVEN_PARITY == this->m_parity) {
                 __asm__ volatile("test %[_data], %[_dataMask] wc \n\t"
                         "muxc %[_data], %[_parityMask]"
@@ -82,6 +84,15 @@ class UARTTX : public UART
                 : [_dataMask] "r"(this->m_dataMask),
                 [_parityMask] "r"(this->m_parityMask));
             }
+#else
+            if (Parity::NO_PARITY != this->m_parity) {
+                const bool oddOnes = __builtin_parity(wideData & this->m_dataMask);
+                if (oddOnes == (Parity::EVEN_PARITY == this->m_parity))
+                    wideData |= this->m_parityMask;
+                else
+                    wideData &= ~this->m_parityMask;
+            }
+#endif
 
             // Add stop bits
             wideData |= this->m_stopBitMask;
@@ -93,6 +104,12 @@ class UARTTX : public UART
         }
 
         virtual void send_array (const char array[], uint32_t words) const {
+#ifndef __PROPELLER__
+            // Reference implementation for the host model: the same waveform, one word at a time. Not a virtual call,
+            // since PropWare::BufferedUARTTX sends its own buffer through here and its send would only queue it again
+            for (uint32_t i = 0; i < words; ++i)
+                this->UARTTX::send((uint8_t) array[i]);
+#else
             char     *arrayPtr = (char *) array;
             uint32_t data      = 0, waitCycles = 0, bits = 0;
 
@@ -211,6 +228,7 @@ class UARTTX : public UART
                     [_parityMask] "r"(this->m_parityMask));
                     break;
             }
+#endif
 #endif
         }
 
@@ -235,7 +253,17 @@ class UARTTX : public UART
          */
         inline void shift_out_data (uint32_t data, uint32_t bits, const uint32_t bitCycles,
                                     const uint32_t txMask) const {
-#ifndef DOXYGEN_IGNORE
+#ifndef __PROPELLER__
+            uint32_t waitCycles = bitCycles + CNT;
+            do {
+                waitCycles = waitcnt2(waitCycles, bitCycles);
+                if (data & 1)
+                    OUTA |= txMask;
+                else
+                    OUTA &= ~txMask;
+                data >>= 1;
+            } while (--bits);
+#elif !defined(DOXYGEN_IGNORE)
             volatile uint32_t waitCycles = bitCycles;
             __asm__ volatile (
             FC_START("ShiftOutDataStart%=", "ShiftOutDataEnd%=")
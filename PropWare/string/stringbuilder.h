@@ -27,7 +27,8 @@
 
 #include <PropWare/PropWare.h>
 #include <PropWare/hmi/output/printcapable.h>
-#include <cstdlib>
+#include <PropWare/utility/allocator/allocator.h>
+#include <cstring>
 
 namespace PropWare {
 
@@ -43,20 +44,27 @@ class StringBuilder : public PrintCapable {
          * @brief       Initialize with a given size to start with. Picking the correct size can increase performance.
          *
          * @param[in]   initialSize     Number of bytes that should be (dynamically) allocated for the string buffer
+         * @param[in]   allocator       Source of the string buffer. If it can not supply a larger buffer once the
+         *                              string fills the current one, further characters are dropped
          */
-        StringBuilder (const size_t initialSize = DEFAULT_SPACE_ALLOCATED)
-                : m_minimumSpace(initialSize),
+        StringBuilder (const size_t initialSize = DEFAULT_SPACE_ALLOCATED,
+                       Allocator &allocator = HeapAllocator::get_instance())
+                : m_allocator(&allocator),
+                  m_minimumSpace(initialSize),
                   m_currentSpace(initialSize),
                   m_size(0) {
-            this->m_string = (char *) malloc(initialSize);
-            this->m_string[0] = '\0';
+            this->m_string = (char *) allocator.allocate(initialSize);
+            if (NULL == this->m_string)
+                this->m_currentSpace = 0;
+            else
+                this->m_string[0] = '\0';
         }
 
         /**
          * @brief   Free all memory allocated for the string buffer
          */
         ~StringBuilder () {
-            free(this->m_string);
+            this->m_allocator->deallocate(this->m_string);
         }
 
         void put_char (const char c) {
@@ -92,15 +100,19 @@ class StringBuilder : public PrintCapable {
 
         /**
          * @brief   Remove all characters from the string and reallocate to the original size (if needed)
+         *
+         * The current buffer is kept, at whatever size it has grown to, if the allocator can not supply one of the
+         * original size or could never reuse the current one (see PropWare::Allocator::reclaims_memory).
          */
         void clear () {
             if (this->m_size) {
-                if (this->m_minimumSpace != this->m_currentSpace) {
-                    if (NULL != this->m_string)
-                        // It shouldn't ever be NULL, but this is an easy way to ensure bugs don't sneak in
-                        free(this->m_string);
-                    this->m_string       = (char *) malloc(this->m_minimumSpace);
-                    this->m_currentSpace = this->m_minimumSpace;
+                if (this->m_minimumSpace != this->m_currentSpace && this->m_allocator->reclaims_memory()) {
+                    char *temp = (char *) this->m_allocator->allocate(this->m_minimumSpace);
+                    if (NULL != temp) {
+                        this->m_allocator->deallocate(this->m_string);
+                        this->m_string       = temp;
+                        this->m_currentSpace = this->m_minimumSpace;
+                    }
                 }
                 this->m_string[0] = '\0';
                 this->m_size = 0;
@@ -109,8 +121,11 @@ class StringBuilder : public PrintCapable {
 
     private:
         void insert_char (const char c) {
-            m_string[m_size++] = c;
-            check_buffer_size();
+            // Only false once the allocator has failed to supply a larger buffer
+            if (m_size + 1 < m_currentSpace) {
+                m_string[m_size++] = c;
+                check_buffer_size();
+            }
         }
 
         void check_buffer_size () {
@@ -119,14 +134,18 @@ class StringBuilder : public PrintCapable {
         }
 
         void expand () {
-            this->m_currentSpace <<= 1;
-            char *temp = (char *) malloc((size_t) this->m_currentSpace);
-            strcpy(temp, this->m_string);
-            free(this->m_string);
-            this->m_string = temp;
+            char *temp = (char *) this->m_allocator->allocate((size_t) this->m_currentSpace << 1);
+            if (NULL != temp) {
+                // Not yet null-terminated: called from insert_char, before the caller adds the terminator
+                memcpy(temp, this->m_string, this->m_size);
+                this->m_allocator->deallocate(this->m_string);
+                this->m_string = temp;
+                this->m_currentSpace <<= 1;
+            }
         }
 
     private:
+        Allocator      *m_allocator;
         const uint16_t m_minimumSpace;
         uint16_t       m_currentSpace;
         uint16_t       m_size;
@@ -0,0 +1,99 @@
+/**
+ * @file        PropWare/utility/allocator/allocator.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+
+// Need to include this since PropWare.h is not imported
+#ifdef __PROPELLER_COG__
+#define PropWare PropWare_cog
+#endif
+
+namespace PropWare {
+
+/**
+ * @brief   Interface for all sources of dynamic memory
+ *
+ * Classes which need memory at run time, such as PropWare::FatFS and PropWare::StringBuilder, accept an Allocator so
+ * that the application decides where that memory comes from. By default they use PropWare::HeapAllocator, which is
+ * plain `malloc`. A long-running application can hand them a PropWare::ObjectPool or a PropWare::Arena instead, and
+ * the heap never fragments to the point where a large `malloc` fails. A PropWare::Heap takes requests of any size like
+ * `malloc`, but can report on its own fragmentation.
+ */
+class Allocator {
+    public:
+        /**
+         * @brief       Allocate a block of memory, aligned for any type
+         *
+         * @param[in]   size    Number of bytes needed
+         *
+         * @return      Address of the block, or NULL if the request can not be satisfied
+         */
+        virtual void *allocate (const size_t size) = 0;
+
+        /**
+         * @brief       Give back a block which came from this allocator's PropWare::Allocator::allocate
+         *
+         * @param[in]   block   Address of the block; NULL is ignored
+         */
+        virtual void deallocate (void *block) = 0;
+
+        /**
+         * @brief   Determine whether PropWare::Allocator::deallocate makes a block available to later requests
+         *
+         * A caller which only wants to trade a large block for a smaller one can check this first, so that it does
+         * not take a second block from an allocator which can never have the first one back.
+         */
+        virtual bool reclaims_memory () const {
+            return true;
+        }
+};
+
+/**
+ * @brief   The heap, through `malloc` and `free`; the default PropWare::Allocator
+ */
+class HeapAllocator : public Allocator {
+    public:
+        /**
+         * @brief   The one instance which every class uses by default
+         */
+        static HeapAllocator &get_instance () {
+            static HeapAllocator instance;
+            return instance;
+        }
+
+    public:
+        void *allocate (const size_t size) {
+            return malloc(size);
+        }
+
+        void deallocate (void *block) {
+            free(block);
+        }
+};
+
+}
@@ -0,0 +1,186 @@
+/**
+ * @file        PropWare/utility/allocator/arena.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/utility/allocator/allocator.h>
+#include <stdint.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Bump allocator over a caller-supplied buffer, freed all at once
+ *
+ * Allocating only moves a pointer forward, so it takes constant time and wastes nothing but alignment padding.
+ * PropWare::Arena::deallocate does nothing: the memory comes back when the arena is reset, either explicitly or at the
+ * end of a PropWare::Arena::Scope. That suits work which allocates as it goes and then throws everything away at once,
+ * such as building and sending a reply:
+ *
+ * @code
+ * static uint32_t scratch[256];
+ * PropWare::Arena arena(scratch);
+ *
+ * while (1) {
+ *     PropWare::Arena::Scope scope(arena);
+ *     PropWare::StringBuilder reply(64, arena);
+ *     PropWare::Printer       printer(reply);
+ *     ...
+ *     send(reply.to_string());
+ * }   // Everything allocated from the arena since `scope` was created is released here
+ * @endcode
+ *
+ * An arena has no lock; use one per cog.
+ */
+class Arena : public Allocator {
+    public:
+        /** Every block starts on a multiple of this many bytes */
+        static const size_t ALIGNMENT = __BIGGEST_ALIGNMENT__;
+
+        /**
+         * @brief   Releases everything allocated from an arena during its lifetime
+         *
+         * Scopes can be nested; each one rewinds the arena to where it was when that scope was created.
+         */
+        class Scope {
+            public:
+                explicit Scope (Arena &arena)
+                        : m_arena(&arena),
+                          m_mark(arena.get_mark()) {
+                }
+
+                ~Scope () {
+                    this->m_arena->rewind(this->m_mark);
+                }
+
+            private:
+                Scope (const Scope &other);
+                Scope &operator= (const Scope &other);
+
+            private:
+                Arena        *m_arena;
+                const size_t m_mark;
+        };
+
+    public:
+        /**
+         * @brief       Construct an arena over a buffer
+         *
+         * @param[in]   buffer  Statically allocated array, NOT a pointer, which the arena hands out
+         */
+        template<typename Word, size_t N>
+        Arena (Word (&buffer)[N])
+                : m_buffer(reinterpret_cast<uint8_t *>(buffer)),
+                  m_capacity(sizeof(buffer)),
+                  m_used(0),
+                  m_highWaterMark(0) {
+        }
+
+        /**
+         * @brief       Take the next `size` bytes of the buffer
+         *
+         * @return      Address of the block, or NULL if the rest of the buffer is too small
+         */
+        void *allocate (const size_t size) {
+            const uintptr_t address = (uintptr_t) (this->m_buffer + this->m_used);
+            const size_t    start   = this->m_used + ((ALIGNMENT - address % ALIGNMENT) % ALIGNMENT);
+
+            if (this->m_capacity < start || this->m_capacity - start < size)
+                return NULL;
+            else {
+                this->m_used = start + size;
+                if (this->m_used > this->m_highWaterMark)
+                    this->m_highWaterMark = this->m_used;
+                return this->m_buffer + start;
+            }
+        }
+
+        /**
+         * @brief   Does nothing; see PropWare::Arena::reset and PropWare::Arena::Scope
+         */
+        void deallocate (void *block) {
+        }
+
+        /**
+         * @brief   Always false: a block only comes back when the arena is reset or rewound
+         */
+        bool reclaims_memory () const {
+            return false;
+        }
+
+        /**
+         * @brief   Release everything allocated so far
+         */
+        void reset () {
+            this->m_used = 0;
+        }
+
+        /**
+         * @brief   Current position in the buffer, for PropWare::Arena::rewind
+         */
+        size_t get_mark () const {
+            return this->m_used;
+        }
+
+        /**
+         * @brief       Release everything allocated since PropWare::Arena::get_mark returned `mark`
+         */
+        void rewind (const size_t mark) {
+            if (mark < this->m_used)
+                this->m_used = mark;
+        }
+
+        /**
+         * @brief   Size of the buffer, in bytes
+         */
+        size_t get_capacity () const {
+            return this->m_capacity;
+        }
+
+        /**
+         * @brief   Bytes currently allocated, including alignment padding
+         */
+        size_t get_used () const {
+            return this->m_used;
+        }
+
+        /**
+         * @brief   Most bytes that have ever been allocated at once, for sizing the buffer
+         */
+        size_t get_high_water_mark () const {
+            return this->m_highWaterMark;
+        }
+
+    private:
+        Arena (const Arena &other);
+        Arena &operator= (const Arena &other);
+
+    protected:
+        uint8_t      *const m_buffer;
+        const size_t m_capacity;
+        size_t       m_used;
+        size_t       m_highWaterMark;
+};
+
+}
@@ -0,0 +1,289 @@
+/**
+ * @file        PropWare/utility/allocator/heap.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/utility/allocator/allocator.h>
+#include <PropWare/concurrent/lockreference.h>
+#include <PropWare/concurrent/memorybarrier.h>
+#include <PropWare/hmi/output/printer.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Snapshot of a PropWare::Heap's free space, taken by PropWare::Heap::inspect
+ *
+ * All sizes are in bytes that could be handed out, so they do not include the header in front of each block.
+ */
+struct HeapStatistics {
+    /** Number of size classes in the histogram: one for each position of a block size's most significant bit */
+    static const unsigned int SIZE_CLASSES = 16;
+
+    /** Sum of every free block */
+    size_t freeBytes;
+    /** Largest request which would succeed right now */
+    size_t largestBlock;
+    /** Number of separate free blocks; one means the free space is not fragmented at all */
+    size_t fragments;
+    /**
+     * Class `n` counts the free blocks of at least 2^n bytes but fewer than 2^(n+1) (class 0 also counts 0); the last
+     * class counts everything larger too
+     */
+    size_t histogram[SIZE_CLASSES];
+
+    /**
+     * @brief       Size class of a free block
+     */
+    static unsigned int get_size_class (const size_t bytes) {
+        const unsigned int msb = bytes ? (unsigned int) (sizeof(unsigned long) * 8 - 1 - __builtin_clzl(bytes)) : 0;
+        return SIZE_CLASSES - 1 < msb ? SIZE_CLASSES - 1 : msb;
+    }
+
+    /**
+     * @brief       Print the totals on one line, followed by one line for each non-empty size class
+     *
+     * @param[in]   printer     Destination for the report
+     */
+    void print (const Printer &printer = pwOut) const {
+        printer.printf("Heap: %u bytes free in %u blocks, largest %u\n", (unsigned int) this->freeBytes,
+                       (unsigned int) this->fragments, (unsigned int) this->largestBlock);
+        for (unsigned int i = 0; i < SIZE_CLASSES; ++i)
+            if (this->histogram[i]) {
+                printer.put_char(' ');
+                printer.put_uint(i ? 1U << i : 0, 10, 6);
+                printer.puts(" bytes and up: ");
+                printer.put_uint((unsigned int) this->histogram[i]);
+                printer.put_char('\n');
+            }
+    }
+};
+
+/**
+ * @brief   General-purpose allocator over a caller-supplied buffer, which can report on its own fragmentation
+ *
+ * Free blocks are kept in a singly-linked list, in address order: allocating takes the first block which is large
+ * enough (splitting off whatever is left over) and deallocating merges the block with any free neighbors. Because the
+ * list belongs to PropWare, PropWare::Heap::inspect can walk it to report the free space, the largest block, the
+ * number of fragments and a histogram of block sizes in a single pass - without allocating anything, which is the
+ * only way to ask the same of `malloc` (see PropWare::Utility::get_largest_free_block_size).
+ *
+ * @code
+ * static uint32_t       heapBuffer[2048];
+ * static PropWare::Heap heap(heapBuffer);
+ *
+ * PropWare::StringBuilder builder(64, heap);
+ * ...
+ * heap.inspect().print();
+ * @endcode
+ *
+ * Each block costs a header of PropWare::Heap::HEADER_SIZE bytes. Pass a lock to the constructor to share the heap
+ * among cogs; the lock is held while a block is found or returned, and for the whole walk of the free list in
+ * PropWare::Heap::inspect.
+ */
+class Heap : public Allocator {
+    public:
+        /** Every block starts on a multiple of this many bytes */
+        static const size_t ALIGNMENT   = __BIGGEST_ALIGNMENT__;
+        /** Bytes in front of every block, holding its size */
+        static const size_t HEADER_SIZE = (sizeof(size_t) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+    public:
+        /**
+         * @brief       Construct a heap, initially one free block, over a buffer
+         *
+         * @param[in]   buffer  Statically allocated array, NOT a pointer, from which blocks are handed out
+         * @param[in]   lock    Lock to take around every change to the heap, for heaps shared among cogs. By default,
+         *                      no lock is taken
+         */
+        template<typename Word, size_t N>
+        Heap (Word (&buffer)[N], const LockReference &lock = LockReference())
+                : m_lock(lock) {
+            const uintptr_t begin = round_up((uintptr_t) buffer);
+            const uintptr_t end   = ((uintptr_t) buffer + sizeof(buffer)) / ALIGNMENT * ALIGNMENT;
+
+            this->m_begin    = reinterpret_cast<uint8_t *>(begin);
+            this->m_capacity = end > begin ? end - begin : 0;
+            if (MIN_CHUNK_SIZE <= this->m_capacity) {
+                this->m_free       = reinterpret_cast<Chunk *>(begin);
+                this->m_free->size = this->m_capacity;
+                this->m_free->next = NULL;
+            } else
+                this->m_free = NULL;
+        }
+
+        /**
+         * @brief       Take the first free block which is large enough
+         *
+         * @return      Address of the block, or NULL if there is no free block of at least `size` bytes
+         */
+        void *allocate (const size_t size) {
+            if (this->m_capacity < size)
+                return NULL;
+
+            size_t needed = round_up(HEADER_SIZE + (size ? size : 1));
+            if (MIN_CHUNK_SIZE > needed)
+                needed = MIN_CHUNK_SIZE;
+
+            this->lock();
+            Chunk **link = &this->m_free;
+            while (NULL != *link && needed > (*link)->size)
+                link = &(*link)->next;
+
+            Chunk *chunk = *link;
+            if (NULL != chunk) {
+                if (MIN_CHUNK_SIZE <= chunk->size - needed) {
+                    // Leave the rest of the block in its place in the list
+                    Chunk *rest = reinterpret_cast<Chunk *>(reinterpret_cast<uint8_t *>(chunk) + needed);
+                    rest->size  = chunk->size - needed;
+                    rest->next  = chunk->next;
+                    *link       = rest;
+                    chunk->size = needed;
+                } else
+                    *link = chunk->next;
+            }
+            this->unlock();
+
+            return NULL == chunk ? NULL : reinterpret_cast<uint8_t *>(chunk) + HEADER_SIZE;
+        }
+
+        /**
+         * @brief       Give back a block, merging it with any free neighbors
+         *
+         * @param[in]   block   Block returned by PropWare::Heap::allocate; NULL is ignored
+         */
+        void deallocate (void *block) {
+            if (NULL == block)
+                return;
+
+            Chunk *chunk = reinterpret_cast<Chunk *>(static_cast<uint8_t *>(block) - HEADER_SIZE);
+
+            this->lock();
+            Chunk *previous = NULL;
+            Chunk *next     = this->m_free;
+            while (NULL != next && next < chunk) {
+                previous = next;
+                next     = next->next;
+            }
+
+            if (NULL != next && end_of(chunk) == reinterpret_cast<uint8_t *>(next)) {
+                chunk->size += next->size;
+                chunk->next = next->next;
+            } else
+                chunk->next = next;
+
+            if (NULL == previous)
+                this->m_free = chunk;
+            else if (end_of(previous) == reinterpret_cast<uint8_t *>(chunk)) {
+                previous->size += chunk->size;
+                previous->next = chunk->next;
+            } else
+                previous->next = chunk;
+            this->unlock();
+        }
+
+        /**
+         * @brief   Walk the free list once and summarize it
+         */
+        HeapStatistics inspect () const {
+            HeapStatistics statistics;
+            memset(&statistics, 0, sizeof(statistics));
+
+            this->lock();
+            for (const Chunk *chunk = this->m_free; NULL != chunk; chunk = chunk->next) {
+                const size_t bytes = chunk->size - HEADER_SIZE;
+                statistics.freeBytes += bytes;
+                if (bytes > statistics.largestBlock)
+                    statistics.largestBlock = bytes;
+                ++statistics.fragments;
+                ++statistics.histogram[HeapStatistics::get_size_class(bytes)];
+            }
+            this->unlock();
+
+            return statistics;
+        }
+
+        /**
+         * @brief   Determine if an address lies within this heap's buffer
+         */
+        bool owns (const void *block) const {
+            const uint8_t *address = static_cast<const uint8_t *>(block);
+            return this->m_begin <= address && address < this->m_begin + this->m_capacity;
+        }
+
+        /**
+         * @brief   Bytes of the buffer that the heap manages, after aligning both of its ends
+         */
+        size_t get_capacity () const {
+            return this->m_capacity;
+        }
+
+    protected:
+        struct Chunk {
+            /** Bytes in the block, including its header */
+            size_t size;
+            /** Next free block, at a higher address; overlaps the data while the block is in use */
+            Chunk  *next;
+        };
+
+        /** Smallest block worth keeping: room for the free list's links, rounded up to the alignment */
+        static const size_t MIN_CHUNK_SIZE = (sizeof(Chunk) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+
+    protected:
+        static size_t round_up (const size_t bytes) {
+            return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        }
+
+        static const uint8_t *end_of (const Chunk *chunk) {
+            return reinterpret_cast<const uint8_t *>(chunk) + chunk->size;
+        }
+
+        void lock () const {
+            if (this->m_lock.is_bound()) {
+                this->m_lock.lock();
+                memory_barrier();
+            }
+        }
+
+        void unlock () const {
+            if (this->m_lock.is_bound()) {
+                memory_barrier();
+                this->m_lock.unlock();
+            }
+        }
+
+    private:
+        Heap (const Heap &other);
+        Heap &operator= (const Heap &other);
+
+    protected:
+        const LockReference m_lock;
+        uint8_t             *m_begin;
+        size_t              m_capacity;
+        Chunk               *m_free;
+};
+
+}
@@ -0,0 +1,149 @@
+/**
+ * @file        PropWare/utility/allocator/heapmonitor.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/concurrent/runnable.h>
+#include <PropWare/utility/allocator/heap.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Periodically inspect a PropWare::Heap and pass the statistics to a telemetry hook
+ *
+ * Started as a PropWare::Runnable, the monitor inspects the heap from a cog of its own, so the only effect on the
+ * application's timing is the heap's lock being held for one walk of the free list each period. Applications without
+ * a spare cog can call PropWare::HeapMonitor::poll from their main loop instead, which does nothing until a period has
+ * passed.
+ *
+ * The hook runs in the monitor's cog. Keep it short, such as sending the statistics as one binary frame:
+ *
+ * @code
+ * void send_heap_statistics (const PropWare::HeapStatistics &statistics, void *context) {
+ *     PropWare::FramedSerial::send_frame(*static_cast<PropWare::PrintCapable *>(context),
+ *                                        reinterpret_cast<const char *>(&statistics), sizeof(statistics));
+ * }
+ *
+ * static uint32_t              monitorStack[64];
+ * static PropWare::HeapMonitor monitor(monitorStack, heap, send_heap_statistics, &telemetryUart, 10 * SECOND);
+ *
+ * PropWare::Runnable::invoke(monitor);
+ * @endcode
+ *
+ * The heap must be shared with a lock (see PropWare::Heap::Heap) when the monitor runs in its own cog.
+ */
+class HeapMonitor : public Runnable {
+    public:
+        /**
+         * @brief       Receives the statistics from each inspection
+         *
+         * @param[in]   statistics  Result of PropWare::Heap::inspect
+         * @param[in]   context     Pointer given to the monitor's constructor
+         */
+        typedef void (*Hook) (const HeapStatistics &statistics, void *context);
+
+    public:
+        /**
+         * @brief       Constructor
+         *
+         * @param[in]   stack[]     Stack for the monitor's own cog
+         * @param[in]   heap        Heap to be inspected; it must outlive the monitor
+         * @param[in]   hook        Function called with the statistics from every inspection
+         * @param[in]   context     Passed to every call of `hook`
+         * @param[in]   period      Clock ticks between inspections
+         */
+        template<size_t N>
+        HeapMonitor (const uint32_t (&stack)[N], const Heap &heap, const Hook hook, void *context = NULL,
+                     const uint32_t period = SECOND)
+                : Runnable(stack),
+                  m_heap(&heap),
+                  m_hook(hook),
+                  m_context(context),
+                  m_period(period),
+                  m_lastInspection(CNT),
+                  m_inspections(0),
+                  m_smallestLargestBlock((size_t) -1) {
+        }
+
+        void run () {
+            uint32_t timer = CNT;
+            while (1) {
+                this->inspect();
+                timer += this->m_period;
+                waitcnt(timer);
+            }
+        }
+
+        /**
+         * @brief   Inspect the heap if at least one period has passed since the last inspection
+         *
+         * @return  True if the heap was inspected (and the hook called)
+         */
+        bool poll () {
+            if (this->m_period <= CNT - this->m_lastInspection) {
+                this->inspect();
+                return true;
+            } else
+                return false;
+        }
+
+        /**
+         * @brief   Inspect the heap and call the hook now, regardless of the period
+         */
+        void inspect () {
+            const HeapStatistics statistics = this->m_heap->inspect();
+            this->m_lastInspection = CNT;
+            ++this->m_inspections;
+            if (statistics.largestBlock < this->m_smallestLargestBlock)
+                this->m_smallestLargestBlock = statistics.largestBlock;
+            this->m_hook(statistics, this->m_context);
+        }
+
+        /**
+         * @brief   Number of inspections so far
+         */
+        uint32_t get_inspection_count () const {
+            return this->m_inspections;
+        }
+
+        /**
+         * @brief   Smallest "largest free block" seen by any inspection: the closest the heap has come to failing a
+         *          request of that size, as far as the monitor could tell
+         */
+        size_t get_smallest_largest_block () const {
+            return this->m_smallestLargestBlock;
+        }
+
+    private:
+        const Heap        *m_heap;
+        const Hook        m_hook;
+        void              *m_context;
+        const uint32_t    m_period;
+        uint32_t          m_lastInspection;
+        volatile uint32_t m_inspections;
+        volatile size_t   m_smallestLargestBlock;
+};
+
+}
@@ -0,0 +1,207 @@
+/**
+ * @file        PropWare/utility/allocator/objectpool.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/utility/allocator/allocator.h>
+#include <PropWare/concurrent/nolock.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace PropWare {
+
+/**
+ * @brief   Fixed number of fixed-size blocks, each big enough for one `T`, handed out in constant time
+ *
+ * The blocks are part of the pool itself, so a pool declared at file scope costs no heap at all. Free blocks are kept
+ * in a singly-linked list threaded through the blocks themselves: allocating pops the head of the list and
+ * deallocating pushes onto it, so both take the same few instructions no matter how full the pool is, and the pool
+ * can not fragment.
+ *
+ * @code
+ * struct Message {
+ *     uint32_t timestamp;
+ *     char     text[28];
+ * };
+ *
+ * // Shared by several cogs, so protected by a lock
+ * PropWare::ObjectPool<Message, 16, PropWare::TicketLock> messages;
+ *
+ * Message *message = messages.create();
+ * if (NULL != message) {
+ *     ...
+ *     messages.destroy(message);
+ * }
+ * @endcode
+ *
+ * The lock policy defaults to PropWare::NoLock, for pools used by a single cog; any lock with `lock()` and `unlock()`
+ * methods, such as PropWare::HardwareLock or PropWare::TicketLock, makes the pool safe to share among cogs. As a
+ * PropWare::Allocator, the pool serves any request of up to `sizeof(T)` bytes.
+ *
+ * @tparam  T       Type of object stored in the pool
+ * @tparam  N       Number of blocks
+ * @tparam  Lock    Lock policy, taken around every change to the free list
+ */
+template<typename T, size_t N, typename Lock = NoLock>
+class ObjectPool : public Allocator {
+    public:
+        /** Bytes available in each block */
+        static const size_t BLOCK_SIZE = sizeof(T);
+
+    public:
+        ObjectPool ()
+                : m_free(NULL),
+                  m_available(N),
+                  m_fewestAvailable(N) {
+            // Threaded from the end so that blocks are handed out in address order
+            for (size_t i = N; i; --i) {
+                this->m_blocks[i - 1].next = this->m_free;
+                this->m_free = &this->m_blocks[i - 1];
+            }
+        }
+
+        /**
+         * @brief       Take a block and construct a `T` in it
+         *
+         * @param[in]   args    Arguments for `T`'s constructor
+         *
+         * @return      The new object, or NULL if every block is in use
+         */
+        template<typename... Targs>
+        T *create (Targs &&... args) {
+            void *block = this->take();
+            return NULL == block ? NULL : new(block) T(std::forward<Targs>(args)...);
+        }
+
+        /**
+         * @brief       Destroy an object made by PropWare::ObjectPool::create and give its block back
+         *
+         * @param[in]   object  Object to destroy; NULL is ignored
+         */
+        void destroy (T *object) {
+            if (NULL != object) {
+                object->~T();
+                this->give(object);
+            }
+        }
+
+        /**
+         * @brief       Take a block without constructing anything in it
+         *
+         * @param[in]   size    Number of bytes needed
+         *
+         * @return      Address of a block, or NULL if `size` is larger than PropWare::ObjectPool::BLOCK_SIZE or every
+         *              block is in use
+         */
+        void *allocate (const size_t size) {
+            return BLOCK_SIZE < size ? NULL : this->take();
+        }
+
+        /**
+         * @brief       Give back a block taken with PropWare::ObjectPool::allocate
+         *
+         * @param[in]   block   Block to return; NULL is ignored
+         */
+        void deallocate (void *block) {
+            if (NULL != block)
+                this->give(block);
+        }
+
+        /**
+         * @brief   Determine if an address belongs to one of this pool's blocks
+         */
+        bool owns (const void *block) const {
+            return this->m_blocks <= block && block < this->m_blocks + N;
+        }
+
+        /**
+         * @brief   Total number of blocks
+         */
+        size_t get_capacity () const {
+            return N;
+        }
+
+        /**
+         * @brief   Number of blocks not in use
+         */
+        size_t get_available () const {
+            return this->m_available;
+        }
+
+        /**
+         * @brief   Largest number of blocks that have ever been in use at once
+         *
+         * Run the application through its heaviest paths, then size `N` to the high-water mark plus a little headroom.
+         */
+        size_t get_high_water_mark () const {
+            return N - this->m_fewestAvailable;
+        }
+
+    protected:
+        union Block {
+            Block *next;
+            typename std::aligned_storage<sizeof(T), __alignof__(T)>::type storage;
+        };
+
+    protected:
+        void *take () {
+            this->m_lock.lock();
+            Block *block = this->m_free;
+            if (NULL != block) {
+                this->m_free = block->next;
+                if (--this->m_available < this->m_fewestAvailable)
+                    this->m_fewestAvailable = this->m_available;
+            }
+            this->m_lock.unlock();
+            return block;
+        }
+
+        void give (void *object) {
+            Block *block = static_cast<Block *>(object);
+            this->m_lock.lock();
+            block->next  = this->m_free;
+            this->m_free = block;
+            ++this->m_available;
+            this->m_lock.unlock();
+        }
+
+    private:
+        // Copying would hand out the same blocks twice
+        ObjectPool (const ObjectPool &other);
+        ObjectPool &operator= (const ObjectPool &other);
+
+    protected:
+        Block           m_blocks[N];
+        Lock            m_lock;
+        Block *volatile m_free;
+        volatile size_t m_available;
+        volatile size_t m_fewestAvailable;
+};
+
+template<typename T, size_t N, typename Lock>
+const size_t ObjectPool<T, N, Lock>::BLOCK_SIZE;
+
+}
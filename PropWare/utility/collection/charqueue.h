@@ -40,8 +40,8 @@ namespace PropWare {
  *
  * Typically used for buffered UART implementations. Note that the put_char and get_char methods are blocking to
  * ensure that put_char does not attempt to write to a full buffer and get_char does not attempt to read from an
- * empty buffer. For this reason, you should be careful about using the enqueue and dequeue methods directly when
- * using a CharQueue object because they will allow you to write to a full queue and read from an empty one.
+ * empty buffer. For this reason, you should be careful about using the enqueue method directly when using a CharQueue
+ * object because it will allow you to write to a full queue.
  */
 class CharQueue : public Queue<char>,
                   public ScanCapable,
@@ -57,21 +57,28 @@ class CharQueue : public Queue<char>,
         }
 
         virtual char get_char () {
-            while (this->is_empty());
             return this->dequeue();
         }
 
+        /**
+         * @brief   Wait for at least one character, then remove as many as are waiting under a single lock hold
+         *
+         * @see PropWare::ScanCapable::get_chars
+         */
+        virtual size_t get_chars (char buffer[], const size_t maxLength) {
+            return this->wait_dequeue_n(buffer, maxLength);
+        }
+
         virtual void put_char (const char c) {
             while (this->is_full());
             this->enqueue(c);
         }
 
+        /**
+         * @brief   Insert the whole string, waiting for room as needed, with one lock hold per run of free space
+         */
         virtual void puts (const char *string) {
-            char *c = const_cast<char *>(string);
-            while (*c) {
-                this->put_char(*c);
-                c++;
-            }
+            this->wait_enqueue_n(string, strlen(string));
         }
 };
 
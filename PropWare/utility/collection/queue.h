@@ -26,7 +26,9 @@
 #pragma once
 
 #include <cstddef>
+#include <string.h>
 #include <propeller.h>
+#include <PropWare/concurrent/hardwarelock.h>
 
 // Need to include this since PropWare.h is not imported
 #ifdef __PROPELLER_COG__
@@ -39,24 +41,63 @@ namespace PropWare {
 /**
  * @brief   A basic first-in, first-out queue implementation. The queue will overwrite itself when the maximum size
  *          is reached
+ *
+ * Inserting and removing values is done while holding a lock, which makes the queue safe to share among any number of
+ * producer and consumer cogs. By default each queue allocates one of the eight hardware locks; applications with many
+ * queues can use a software lock instead, such as `PropWare::Queue<T, PropWare::TicketLock>` (see
+ * PropWare/concurrent/lockservice.h). Because taking the lock is the expensive part, cogs which move more than a few
+ * elements at a time should use the bulk methods, such as PropWare::Queue::enqueue_n and PropWare::Queue::dequeue_n,
+ * which copy as many elements as possible under a single lock hold. The bulk methods copy with `memcpy`, so `T` must be
+ * a plain-old-data type to use them. For exactly one producer and one consumer, PropWare::SPSCRing needs no lock at
+ * all.
+ *
+ * PropWare::Queue::enqueue and PropWare::Queue::dequeue are virtual, except in code compiled for the cog memory model
+ * where `virtual` is defined away. A queue therefore has a vtable pointer in every other memory model, and its layout
+ * differs from that seen by cog-mode code.
  */
-template<typename T>
+template<typename T, typename Lock = HardwareLock>
 class Queue {
+    public:
+        /** Attempts made without delay by the waiting methods before they start backing off */
+        static const unsigned int SPIN_ATTEMPTS = 8;
+        /** First backoff delay in clock cycles; long enough that `waitcnt` can not miss it in any memory model */
+        static const uint32_t     MIN_BACKOFF   = 512;
+        /** Longest backoff delay in clock cycles */
+        static const uint32_t     MAX_BACKOFF   = 16384;
+
     public:
         /**
          * @brief   Construct a queue using the given statically-allocated array
          *
+         * A new `Lock` is constructed for the queue. With the default policy, that allocates a hardware lock.
+         *
          * @param[in]   array   Statically allocated instance of an array, NOT a pointer
          */
         template<size_t N>
-        Queue (T (&array)[N], const int lockNumber = locknew())
+        Queue (T (&array)[N])
+                : m_array(array),
+                  m_arrayLength(N),
+                  m_size(0),
+                  m_head(0),
+                  m_tail(0) {
+        }
+
+        /**
+         * @brief   Construct a queue using the given statically-allocated array and a hardware lock which has already
+         *          been allocated
+         *
+         * @param[in]   array       Statically allocated instance of an array, NOT a pointer
+         * @param[in]   lockNumber  Lock returned by `locknew()`. The queue takes ownership and returns it when
+         *                          destroyed
+         */
+        template<size_t N>
+        Queue (T (&array)[N], const int lockNumber)
                 : m_array(array),
                   m_arrayLength(N),
-                  m_lockNumber(lockNumber),
+                  m_lock(lockNumber),
                   m_size(0),
                   m_head(0),
                   m_tail(0) {
-            lockclr(this->m_lockNumber);
         }
 
         /**
@@ -68,19 +109,30 @@ class Queue {
          * @param[in]   array   Address where the array begins
          * @param[in]   length  Number of elements allocated for the array
          */
-        Queue (T *array, const size_t length, const int lockNumber)
+        Queue (T *array, const size_t length)
                 : m_array(array),
                   m_arrayLength(length),
-                  m_lockNumber(locknew()),
                   m_size(0),
                   m_head(0),
                   m_tail(0) {
-            lockclr(this->m_lockNumber);
         }
 
-        ~Queue () {
-            lockclr(this->m_lockNumber);
-            lockret(this->m_lockNumber);
+        /**
+         * @brief   Construct a queue using the given dynamically allocated array and a hardware lock which has already
+         *          been allocated
+         *
+         * @param[in]   array       Address where the array begins
+         * @param[in]   length      Number of elements allocated for the array
+         * @param[in]   lockNumber  Lock returned by `locknew()`. The queue takes ownership and returns it when
+         *                          destroyed
+         */
+        Queue (T *array, const size_t length, const int lockNumber)
+                : m_array(array),
+                  m_arrayLength(length),
+                  m_lock(lockNumber),
+                  m_size(0),
+                  m_head(0),
+                  m_tail(0) {
         }
 
         /**
@@ -128,7 +180,7 @@ class Queue {
          */
         virtual Queue &enqueue (const T &value) {
             // Lock the state and save off these volatile variables into local memory
-            while (lockset(this->m_lockNumber));
+            this->m_lock.lock();
             unsigned int head = this->m_head;
             unsigned int tail = this->m_tail;
             size_t       size = this->m_size;
@@ -159,7 +211,7 @@ class Queue {
             this->m_head = head;
             this->m_tail = tail;
             this->m_size = size;
-            lockclr(this->m_lockNumber);
+            this->m_lock.unlock();
 
             return *this;
         }
@@ -172,41 +224,170 @@ class Queue {
         }
 
         /**
-         * @brief   Return and remove the oldest value in the buffer
+         * @brief   Return and remove the oldest value in the buffer, waiting for one if the buffer is empty
          *
-         * @pre     Buffer must not be empty - no checks are performed to ensure the buffer contains data
+         * The value is copied out before the lock is released, so a producer can not overwrite it first.
+         *
+         * @see PropWare::Queue::wait_dequeue for the backoff, and PropWare::Queue::try_dequeue to avoid waiting
          *
          * @return  Oldest value in the buffer
          */
         virtual T dequeue () {
-            // Lock the state and save off these volatile variables into local memory
-            while (lockset(this->m_lockNumber));
-            unsigned int head = this->m_head;
-            unsigned int tail = this->m_tail;
-            size_t       size = this->m_size;
+            T value;
+            this->wait_dequeue(value);
+            return value;
+        }
+
+        /**
+         * @brief       Remove the oldest value, unless the queue is empty
+         *
+         * Unlike PropWare::Queue::dequeue, this is safe to call on an empty queue, even when several cogs are
+         * consuming from it. An empty queue is detected without taking the lock.
+         *
+         * @param[out]  value   Oldest value in the queue; unmodified if the queue was empty
+         *
+         * @return      True if a value was removed, false if the queue was empty
+         */
+        bool try_dequeue (T &value) {
+            if (this->is_empty())
+                return false;
 
-            T *retVal;
+            this->m_lock.lock();
+            const size_t size = this->m_size;
             if (size) {
-                retVal = &this->m_array[tail];
+                unsigned int tail = this->m_tail;
+                value = this->m_array[tail];
+                if (1 < size && ++tail == this->m_arrayLength)
+                    tail = 0;
+                this->m_tail = tail;
+                this->m_size = size - 1;
+            }
+            this->m_lock.unlock();
 
-                --size;
+            return 0 != size;
+        }
 
-                if (size) {
-                    // Move the tail forward and roll over if necessary
-                    ++tail;
-                    if (tail == this->m_arrayLength)
-                        tail = 0;
-                }
-            } else
-                retVal = NULL;
+        /**
+         * @brief       Insert as many values as fit, all under a single lock hold
+         *
+         * Unlike PropWare::Queue::enqueue, nothing is ever overwritten: values which do not fit are left for the
+         * caller. They are copied with at most two calls to `memcpy`.
+         *
+         * @param[in]   values[]    Values to be inserted, oldest first
+         * @param[in]   count       Number of values in `values[]`
+         *
+         * @return      Number of values inserted, starting from the first
+         */
+        size_t enqueue_n (const T values[], const size_t count) {
+            if (this->is_full())
+                return 0;
 
-            // Unlock the state and upload these variables back to volatile memory
-            this->m_head = head;
-            this->m_tail = tail;
-            this->m_size = size;
-            lockclr(this->m_lockNumber);
+            this->m_lock.lock();
+            size_t       size = this->m_size;
+            unsigned int tail = size ? this->m_tail : 0;
+
+            const size_t free     = this->m_arrayLength - size;
+            const size_t inserted = count < free ? count : free;
+            if (inserted) {
+                const unsigned int first = this->wrap(tail + size);
+                this->copy_in(first, values, inserted);
+                size += inserted;
+                this->m_head = this->wrap(tail + size - 1);
+                this->m_tail = tail;
+                this->m_size = size;
+            }
+            this->m_lock.unlock();
+
+            return inserted;
+        }
+
+        /**
+         * @brief       Remove as many values as are available, up to a maximum, all under a single lock hold
+         *
+         * Values are copied with at most two calls to `memcpy`. An empty queue is detected without taking the lock.
+         *
+         * @param[out]  values[]    Removed values are stored here, oldest first
+         * @param[in]   maxCount    Largest number of values to remove
+         *
+         * @return      Number of values removed
+         */
+        size_t dequeue_n (T values[], const size_t maxCount) {
+            if (this->is_empty())
+                return 0;
+
+            this->m_lock.lock();
+            const size_t size    = this->m_size;
+            const size_t removed = maxCount < size ? maxCount : size;
+            if (removed) {
+                const unsigned int tail = this->m_tail;
+                this->copy_out(values, tail, removed);
+                if (size == removed)
+                    this->m_head = this->m_tail = 0;
+                else
+                    this->m_tail = this->wrap(tail + removed);
+                this->m_size = size - removed;
+            }
+            this->m_lock.unlock();
+
+            return removed;
+        }
+
+        /**
+         * @brief       Wait for a value and remove it
+         *
+         * The queue is checked right away a few times (see PropWare::Queue::SPIN_ATTEMPTS), after which the delay
+         * between checks doubles from PropWare::Queue::MIN_BACKOFF up to PropWare::Queue::MAX_BACKOFF clock cycles,
+         * so that idle consumers stop competing with the producers for the lock.
+         *
+         * @param[out]  value   Oldest value in the queue
+         */
+        void wait_dequeue (T &value) {
+            unsigned int attempts = 0;
+            uint32_t     delay    = MIN_BACKOFF;
+            while (!this->try_dequeue(value))
+                back_off(attempts, delay);
+        }
+
+        /**
+         * @brief       Wait for at least one value, then remove as many as are available, up to a maximum
+         *
+         * @see PropWare::Queue::wait_dequeue for the backoff
+         *
+         * @param[out]  values[]    Removed values are stored here, oldest first
+         * @param[in]   maxCount    Largest number of values to remove; must be at least 1
+         *
+         * @return      Number of values removed; always at least 1
+         */
+        size_t wait_dequeue_n (T values[], const size_t maxCount) {
+            unsigned int attempts = 0;
+            uint32_t     delay    = MIN_BACKOFF;
+            size_t       removed;
+            while (0 == (removed = this->dequeue_n(values, maxCount)))
+                back_off(attempts, delay);
+            return removed;
+        }
 
-            return *retVal;
+        /**
+         * @brief       Insert all values, waiting for room as needed and never overwriting anything
+         *
+         * @see PropWare::Queue::wait_dequeue for the backoff
+         *
+         * @param[in]   values[]    Values to be inserted, oldest first
+         * @param[in]   count       Number of values in `values[]`
+         */
+        void wait_enqueue_n (const T values[], size_t count) {
+            unsigned int attempts = 0;
+            uint32_t     delay    = MIN_BACKOFF;
+            while (count) {
+                const size_t inserted = this->enqueue_n(values, count);
+                if (inserted) {
+                    values += inserted;
+                    count -= inserted;
+                    attempts = 0;
+                    delay    = MIN_BACKOFF;
+                } else
+                    back_off(attempts, delay);
+            }
         }
 
         /**
@@ -236,10 +417,52 @@ class Queue {
             return valid;
         }
 
+        /**
+         * @brief           Delay between two checks of a queue by a waiting cog, as used by the waiting methods
+         *
+         * The first PropWare::Queue::SPIN_ATTEMPTS calls return immediately, after which each call waits twice as
+         * long as the previous one, from PropWare::Queue::MIN_BACKOFF up to PropWare::Queue::MAX_BACKOFF clock
+         * cycles.
+         *
+         * @param[in, out]  attempts    Number of calls so far; start at 0
+         * @param[in, out]  delay       Delay of the next call; start at PropWare::Queue::MIN_BACKOFF
+         */
+        static void back_off (unsigned int &attempts, uint32_t &delay) {
+            if (SPIN_ATTEMPTS > attempts)
+                ++attempts;
+            else {
+                waitcnt(delay + CNT);
+                if (MAX_BACKOFF > delay)
+                    delay <<= 1;
+            }
+        }
+
+    protected:
+        /**
+         * @brief   Wrap an index which may have run up to one lap past the end of the array
+         */
+        unsigned int wrap (const unsigned int index) const {
+            return index < this->m_arrayLength ? index : index - this->m_arrayLength;
+        }
+
+        void copy_in (const unsigned int first, const T values[], const size_t count) {
+            const size_t beforeEnd = this->m_arrayLength - first;
+            const size_t firstSpan = count < beforeEnd ? count : beforeEnd;
+            memcpy(&this->m_array[first], values, firstSpan * sizeof(T));
+            memcpy(this->m_array, &values[firstSpan], (count - firstSpan) * sizeof(T));
+        }
+
+        void copy_out (T values[], const unsigned int first, const size_t count) const {
+            const size_t beforeEnd = this->m_arrayLength - first;
+            const size_t firstSpan = count < beforeEnd ? count : beforeEnd;
+            memcpy(values, &this->m_array[first], firstSpan * sizeof(T));
+            memcpy(&values[firstSpan], this->m_array, (count - firstSpan) * sizeof(T));
+        }
+
     protected:
         T            *m_array;
         const size_t m_arrayLength;
-        const int    m_lockNumber;
+        Lock         m_lock;
 
         volatile size_t       m_size;
         volatile unsigned int m_head;
@@ -0,0 +1,235 @@
+/**
+ * @file        PropWare/utility/collection/spscring.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// Nothing but the standard library and a memory barrier is used here so that the ring can be stress-tested with
+// threads on a PC
+#include <stddef.h>
+#include <stdint.h>
+#include <PropWare/concurrent/memorybarrier.h>
+
+// Need to include this since PropWare.h is not imported
+#ifdef __PROPELLER_COG__
+#define PropWare PropWare_cog
+#endif
+
+namespace PropWare {
+
+/**
+ * @brief   Lock-free first-in, first-out ring buffer for streaming data from exactly one producer cog to exactly one
+ *          consumer cog
+ *
+ * Unlike PropWare::Queue, no hardware lock is used: the head index is written only by the producer and the tail index
+ * only by the consumer, so each side needs nothing more than a read of the other's index. Both are free-running
+ * counters, masked with `N - 1` to find a slot, which lets all `N` slots be used and makes the size simply
+ * `head - tail`.
+ *
+ * Besides single elements, both sides can work directly in the buffer: PropWare::SPSCRing::push_n and
+ * PropWare::SPSCRing::pop_n return the largest contiguous run of free or filled slots, which is handed back with
+ * PropWare::SPSCRing::commit_push or PropWare::SPSCRing::commit_pop once written or read. This suits drivers which
+ * copy blocks with `memcpy`, DMA-like loops or PASM.
+ *
+ * For PASM, the layout of the object is fixed: the head counter, then the tail counter (both 32-bit longs), then the
+ * `N` elements. A PASM producer writes an element at `buffer[head & (N - 1)]` and then increments `head`; a PASM
+ * consumer does the same with `tail`.
+ *
+ * @code
+ * static PropWare::SPSCRing<uint16_t, 64> samples;
+ *
+ * // Producer cog
+ * while (!samples.try_push(read_adc()));
+ *
+ * // Consumer cog
+ * uint16_t sample;
+ * if (samples.try_pop(sample))
+ *     process(sample);
+ * @endcode
+ *
+ * @tparam  T   Element type; elements are copied with `operator=`
+ * @tparam  N   Capacity; must be a power of two
+ */
+template<typename T, size_t N>
+class SPSCRing {
+    static_assert(0 < N && 0 == (N & (N - 1)), "SPSCRing capacity must be a power of two");
+
+    public:
+        /**
+         * @brief   Contiguous run of slots in the ring
+         */
+        struct Span {
+            /** First slot of the run */
+            T      *data;
+            /** Number of slots in the run; zero if none are available */
+            size_t length;
+        };
+
+        /** Maximum number of elements held at once */
+        static const size_t CAPACITY = N;
+
+    public:
+        SPSCRing ()
+                : m_head(0),
+                  m_tail(0) {
+        }
+
+        /**
+         * @brief   Number of elements waiting to be popped
+         *
+         * Exact when called by either the producer or the consumer, though the other side may change it at any moment
+         */
+        size_t size () const {
+            return this->m_head - this->m_tail;
+        }
+
+        /**
+         * @brief   Determine if no elements are waiting to be popped
+         */
+        bool is_empty () const {
+            return this->m_head == this->m_tail;
+        }
+
+        /**
+         * @brief   Determine if no more elements can be pushed
+         */
+        bool is_full () const {
+            return N == this->size();
+        }
+
+        /**
+         * @brief       Insert an element at the end of the ring (producer only)
+         *
+         * @param[in]   value   Element to be copied into the ring
+         *
+         * @return      True if the element was inserted, false if the ring was full
+         */
+        bool try_push (const T &value) {
+            const uint32_t head = this->m_head;
+            if (N == head - this->m_tail)
+                return false;
+            else {
+                this->m_buffer[head & MASK] = value;
+                // The element must be in the buffer before the consumer can see it
+                memory_barrier();
+                this->m_head = head + 1;
+                return true;
+            }
+        }
+
+        /**
+         * @brief       Remove the oldest element from the ring (consumer only)
+         *
+         * @param[out]  value   Oldest element; unmodified if the ring was empty
+         *
+         * @return      True if an element was removed, false if the ring was empty
+         */
+        bool try_pop (T &value) {
+            const uint32_t tail = this->m_tail;
+            if (this->m_head == tail)
+                return false;
+            else {
+                // The head was read before the element, and the element must be copied before its slot is released
+                memory_barrier();
+                value = this->m_buffer[tail & MASK];
+                memory_barrier();
+                this->m_tail = tail + 1;
+                return true;
+            }
+        }
+
+        /**
+         * @brief       Obtain free slots to be written in place (producer only)
+         *
+         * Nothing is inserted until PropWare::SPSCRing::commit_push is called. The span never wraps around the end of
+         * the buffer, so it may be shorter than the free space; call again after committing for the rest.
+         *
+         * @param[in]   count   Largest number of slots wanted
+         *
+         * @return      Up to `count` contiguous free slots
+         */
+        Span push_n (const size_t count = N) {
+            const uint32_t head = this->m_head;
+            return make_span(head, N - (head - this->m_tail), count);
+        }
+
+        /**
+         * @brief       Insert the first `count` slots of a span returned by PropWare::SPSCRing::push_n (producer only)
+         */
+        void commit_push (const size_t count) {
+            memory_barrier();
+            this->m_head += count;
+        }
+
+        /**
+         * @brief       Obtain waiting elements to be read in place (consumer only)
+         *
+         * Nothing is removed until PropWare::SPSCRing::commit_pop is called. The span never wraps around the end of
+         * the buffer, so it may be shorter than the number of waiting elements; call again after committing for the
+         * rest.
+         *
+         * @param[in]   count   Largest number of elements wanted
+         *
+         * @return      Up to `count` contiguous elements, oldest first
+         */
+        Span pop_n (const size_t count = N) {
+            const uint32_t tail = this->m_tail;
+            const Span     span = make_span(tail, this->m_head - tail, count);
+            memory_barrier();
+            return span;
+        }
+
+        /**
+         * @brief       Remove the first `count` elements of a span returned by PropWare::SPSCRing::pop_n (consumer
+         *              only)
+         */
+        void commit_pop (const size_t count) {
+            memory_barrier();
+            this->m_tail += count;
+        }
+
+    protected:
+        static const uint32_t MASK = N - 1;
+
+    protected:
+        Span make_span (const uint32_t index, const size_t available, const size_t count) {
+            const size_t slot       = index & MASK;
+            const size_t contiguous = N - slot;
+
+            Span span;
+            span.data   = &this->m_buffer[slot];
+            span.length = available < count ? available : count;
+            if (contiguous < span.length)
+                span.length = contiguous;
+            return span;
+        }
+
+    protected:
+        // These variables must appear in this order. PASM producers and consumers rely on the exact order
+        volatile uint32_t m_head;
+        volatile uint32_t m_tail;
+        T                 m_buffer[N];
+};
+
+}
@@ -0,0 +1,148 @@
+/**
+ * @file    PropWare/utility/fixed.h
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace PropWare {
+
+/**
+ * @brief   Signed fixed-point number stored in 32 bits, with `FRACTION_BITS` bits after the binary point
+ *
+ * The Propeller has no floating point hardware (and no multiplier), so sensor readings kept in fixed point are much
+ * cheaper to scale, add and print than `float`s. PropWare::Printer prints them with integer arithmetic only, just like
+ * `float`s: `pwOut << value` honors the Printer's precision.
+ *
+ * @code
+ * const PropWare::Q16 celsius = PropWare::Q16::from_raw(rawReading) * PropWare::Q16(0.0625);
+ * pwOut.put_fixed(celsius, 8, 2); // "   21.44"
+ * @endcode
+ */
+template<uint8_t FRACTION_BITS>
+class Fixed {
+    static_assert(FRACTION_BITS < 32, "A Fixed must have at least one integer bit for its sign");
+
+    public:
+        /** Number of bits after the binary point */
+        static const uint8_t BITS = FRACTION_BITS;
+        /** Raw value of 1.0 */
+        static const int32_t ONE  = (int32_t) (1UL << FRACTION_BITS);
+
+    public:
+        /**
+         * @brief       Create a number directly from its raw, scaled representation
+         *
+         * @param[in]   raw     Value multiplied by 2^`FRACTION_BITS`
+         */
+        static Fixed from_raw (const int32_t raw) {
+            Fixed result;
+            result.m_raw = raw;
+            return result;
+        }
+
+    public:
+        Fixed ()
+                : m_raw(0) {
+        }
+
+        Fixed (const int integer)
+                : m_raw((int32_t) ((uint32_t) integer << FRACTION_BITS)) {
+        }
+
+        /**
+         * @brief       Convert from floating point, rounding to the nearest representable value
+         *
+         * Uses floating point math, so it is best kept to constants which the compiler can fold
+         */
+        explicit Fixed (const double value)
+                : m_raw((int32_t) (value * ONE + (0 > value ? -0.5 : 0.5))) {
+        }
+
+        int32_t get_raw () const {
+            return this->m_raw;
+        }
+
+        /**
+         * @brief   Integer part, rounded toward negative infinity
+         */
+        int32_t get_integer () const {
+            return this->m_raw >> FRACTION_BITS;
+        }
+
+        double to_double () const {
+            return (double) this->m_raw / ONE;
+        }
+
+        Fixed operator+ (const Fixed rhs) const {
+            return from_raw(this->m_raw + rhs.m_raw);
+        }
+
+        Fixed operator- (const Fixed rhs) const {
+            return from_raw(this->m_raw - rhs.m_raw);
+        }
+
+        Fixed operator- () const {
+            return from_raw(-this->m_raw);
+        }
+
+        Fixed operator* (const Fixed rhs) const {
+            return from_raw((int32_t) (((int64_t) this->m_raw * rhs.m_raw) >> FRACTION_BITS));
+        }
+
+        Fixed &operator+= (const Fixed rhs) {
+            this->m_raw += rhs.m_raw;
+            return *this;
+        }
+
+        Fixed &operator-= (const Fixed rhs) {
+            this->m_raw -= rhs.m_raw;
+            return *this;
+        }
+
+        bool operator== (const Fixed rhs) const {
+            return this->m_raw == rhs.m_raw;
+        }
+
+        bool operator!= (const Fixed rhs) const {
+            return this->m_raw != rhs.m_raw;
+        }
+
+        bool operator< (const Fixed rhs) const {
+            return this->m_raw < rhs.m_raw;
+        }
+
+        bool operator> (const Fixed rhs) const {
+            return this->m_raw > rhs.m_raw;
+        }
+
+    protected:
+        int32_t m_raw;
+};
+
+/** 16.16 fixed point: 15 integer bits plus the sign and a resolution of about 0.000015 */
+typedef Fixed<16> Q16;
+
+}
@@ -0,0 +1,331 @@
+/**
+ * @file        PropWare/utility/profiler.h
+ *
+ * @author      David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/concurrent/lockservice.h>
+#include <PropWare/hmi/output/printer.h>
+#include <PropWare/serial/framing/framedserial.h>
+#include <string.h>
+
+/** @cond DOXYGEN_IGNORE */
+#define PW_PROFILE_CONCAT_(a, b) a ## b
+#define PW_PROFILE_CONCAT(a, b) PW_PROFILE_CONCAT_(a, b)
+/** @endcond */
+
+#ifdef PROPWARE_PROFILE
+/**
+ * @brief       Time the rest of the enclosing scope, adding each measurement to a named PropWare::ProfileSite
+ *
+ * Profiling is off unless `PROPWARE_PROFILE` is defined (for instance, with `add_definitions(-DPROPWARE_PROFILE)` in
+ * CMakeLists.txt); otherwise the macro expands to nothing and costs neither code nor hub RAM.
+ *
+ * @code
+ * void read_block (...) {
+ *     PW_PROFILE_SCOPE("sd_read");
+ *     ...
+ * }
+ *
+ * PropWare::Profiler::print();
+ * @endcode
+ *
+ * @param[in]   name    String literal which identifies the site in reports; no more than one use per line
+ */
+#define PW_PROFILE_SCOPE(name) \
+    static PropWare::ProfileSite PW_PROFILE_CONCAT(pwProfileSite, __LINE__) \
+            __attribute__((section("pwprofile_sites"))) = PW_PROFILE_SITE_INITIALIZER(name); \
+    const PropWare::ProfileScope PW_PROFILE_CONCAT(pwProfileScope, __LINE__)(PW_PROFILE_CONCAT(pwProfileSite, __LINE__))
+#else
+#define PW_PROFILE_SCOPE(name)
+#endif
+
+/** @cond DOXYGEN_IGNORE */
+#define PW_PROFILE_SITE_INITIALIZER(name) {name, 0, 0, 0xFFFFFFFF, 0, {0}}
+/** @endcond */
+
+namespace PropWare {
+
+/**
+ * @brief   Statistics for one PW_PROFILE_SCOPE, in clock ticks
+ *
+ * Every site takes 152 bytes of hub RAM.
+ */
+struct ProfileSite {
+    /** Number of buckets in the histogram: one for each possible position of a measurement's most significant bit */
+    static const unsigned int BUCKETS = 32;
+
+    const char *name;
+    uint32_t   count;
+    uint64_t   total;
+    uint32_t   minimum;
+    uint32_t   maximum;
+    /** Bucket `n` counts the measurements of at least 2^n ticks but fewer than 2^(n+1) (bucket 0 also counts 0) */
+    uint32_t   histogram[BUCKETS];
+
+    /**
+     * @brief       Add a measurement; safe to call from any cog
+     *
+     * The shared lock of PropWare::LockService is held only while the statistics are updated, not while the code is
+     * being timed.
+     *
+     * @param[in]   ticks   Duration being recorded
+     */
+    void record (const uint32_t ticks) {
+        const unsigned int bucket = ticks ? BUCKETS - 1 - __builtin_clz(ticks) : 0;
+        const int          lock   = LockService::get_lock();
+
+        while (lockset(lock));
+        ++this->count;
+        this->total += ticks;
+        if (ticks < this->minimum)
+            this->minimum = ticks;
+        if (ticks > this->maximum)
+            this->maximum = ticks;
+        ++this->histogram[bucket];
+        memory_barrier();
+        lockclr(lock);
+    }
+
+    /**
+     * @brief   Discard every measurement
+     */
+    void reset () {
+        const int lock = LockService::get_lock();
+
+        while (lockset(lock));
+        this->count   = 0;
+        this->total   = 0;
+        this->minimum = 0xFFFFFFFF;
+        this->maximum = 0;
+        memset(this->histogram, 0, sizeof(this->histogram));
+        memory_barrier();
+        lockclr(lock);
+    }
+};
+
+#ifdef PROPWARE_PROFILE
+/** @cond DOXYGEN_IGNORE */
+namespace profiler {
+
+/**
+ * Allocates the shared lock of PropWare::LockService during static initialization, before `main` can start another
+ * cog. Otherwise, two cogs entering their first profiled scope at the same time could each allocate a hardware lock.
+ * Only defined when profiling is enabled, so that including this header otherwise costs no lock
+ */
+struct LockAllocator {
+    LockAllocator () {
+        LockService::get_lock();
+    }
+};
+
+static const LockAllocator lockAllocator;
+
+}
+/** @endcond */
+#endif
+
+/**
+ * @brief   Times its own lifetime and records it in a PropWare::ProfileSite; created by PW_PROFILE_SCOPE
+ */
+class ProfileScope {
+    public:
+        ProfileScope (ProfileSite &site)
+                : m_site(&site) {
+            // Keep the timed code from being moved ahead of the first reading
+            memory_barrier();
+            this->m_start = CNT;
+        }
+
+        ~ProfileScope () {
+            const uint32_t end = CNT;
+            memory_barrier();
+            this->m_site->record(end - this->m_start);
+        }
+
+    private:
+        ProfileSite *m_site;
+        uint32_t    m_start;
+};
+
+}
+
+/**
+ * Bounds of the section holding every PW_PROFILE_SCOPE site, defined by the linker because the section's name is a
+ * valid C identifier. Weak, so that an application without any sites still links
+ */
+extern "C" PropWare::ProfileSite __start_pwprofile_sites[] __attribute__((weak));
+extern "C" PropWare::ProfileSite __stop_pwprofile_sites[] __attribute__((weak));
+
+namespace PropWare {
+
+/**
+ * @brief   Reports on every PW_PROFILE_SCOPE in the application
+ *
+ * The sites are gathered by the linker, so no registration is needed and there is no limit on their number. When
+ * profiling is disabled, there are no sites and the reports are empty.
+ */
+class Profiler {
+    public:
+        /** Bytes in each frame sent by PropWare::Profiler::send, before the site's name */
+        static const size_t FRAME_HEADER_SIZE = sizeof(uint32_t) * (5 + ProfileSite::BUCKETS);
+
+    public:
+        static ProfileSite *begin () {
+            return __start_pwprofile_sites;
+        }
+
+        static ProfileSite *end () {
+            return __stop_pwprofile_sites;
+        }
+
+        /**
+         * @brief   Number of PW_PROFILE_SCOPE sites linked into the application
+         */
+        static size_t get_site_count () {
+            return (size_t) (end() - begin());
+        }
+
+        /**
+         * @brief       Find a site by name
+         *
+         * @return      The site, or NULL if there is no site with that name
+         */
+        static ProfileSite *find (const char name[]) {
+            for (ProfileSite *site = begin(); site < end(); ++site)
+                if (0 == strcmp(name, site->name))
+                    return site;
+            return NULL;
+        }
+
+        /**
+         * @brief   Discard the measurements of every site
+         */
+        static void reset () {
+            for (ProfileSite *site = begin(); site < end(); ++site)
+                site->reset();
+        }
+
+        /**
+         * @brief       Print one line for each site which has been reached: its name, the number of measurements and
+         *              the minimum, mean, maximum and total duration in clock ticks
+         *
+         * @param[in]   printer     Destination for the report
+         */
+        static void print (const Printer &printer = pwOut) {
+            printer.puts("Site              Count       Min      Mean       Max         Total\n");
+            for (ProfileSite *site = begin(); site < end(); ++site) {
+                ProfileSite snapshot;
+                take_snapshot(*site, snapshot);
+                if (snapshot.count) {
+                    print_name(printer, snapshot.name);
+                    printer.put_uint(snapshot.count, 10, 6);
+                    printer.put_uint(snapshot.minimum, 10, 10);
+                    printer.put_uint((uint32_t) (snapshot.total / snapshot.count), 10, 10);
+                    printer.put_uint(snapshot.maximum, 10, 10);
+                    printer.put_ull(snapshot.total, 10, 14);
+                    printer.put_char('\n');
+                }
+            }
+        }
+
+        /**
+         * @brief       Print the non-empty buckets of one site's histogram, one per line
+         *
+         * @param[in]   site        Site to be printed
+         * @param[in]   printer     Destination for the report
+         */
+        static void print_histogram (const ProfileSite &site, const Printer &printer = pwOut) {
+            ProfileSite snapshot;
+            take_snapshot(site, snapshot);
+            printer.printf("%s:\n", snapshot.name);
+            for (unsigned int i = 0; i < ProfileSite::BUCKETS; ++i)
+                if (snapshot.histogram[i]) {
+                    printer.put_char(' ');
+                    printer.put_uint(i ? 1U << i : 0, 10, 10);
+                    printer.puts(" ticks and up: ");
+                    printer.put_uint(snapshot.histogram[i]);
+                    printer.put_char('\n');
+                }
+        }
+
+        /**
+         * @brief       Send every site as a binary frame (see PropWare::FramedSerial), for analysis on a PC
+         *
+         * Each frame holds the count, the total (low word, then high word), the minimum, the maximum and the
+         * PropWare::ProfileSite::BUCKETS histogram buckets, each as a little-endian 32-bit word, followed by the name
+         * without a null-terminator.
+         *
+         * @param[in]   printCapable    Destination for the frames
+         */
+        static void send (PrintCapable &printCapable) {
+            for (ProfileSite *site = begin(); site < end(); ++site) {
+                ProfileSite snapshot;
+                take_snapshot(*site, snapshot);
+
+                char   frame[FRAME_HEADER_SIZE + 32];
+                size_t length = 0;
+                put_word(frame, length, snapshot.count);
+                put_word(frame, length, (uint32_t) snapshot.total);
+                put_word(frame, length, (uint32_t) (snapshot.total >> 32));
+                put_word(frame, length, snapshot.minimum);
+                put_word(frame, length, snapshot.maximum);
+                for (unsigned int i = 0; i < ProfileSite::BUCKETS; ++i)
+                    put_word(frame, length, snapshot.histogram[i]);
+                for (const char *c = snapshot.name; *c && sizeof(frame) > length; ++c)
+                    frame[length++] = *c;
+                FramedSerial::send_frame(printCapable, frame, length);
+            }
+        }
+
+    protected:
+        /**
+         * Copy a site under the lock, so that a report never mixes statistics from before and after a measurement
+         */
+        static void take_snapshot (const ProfileSite &site, ProfileSite &snapshot) {
+            const int lock = LockService::get_lock();
+            while (lockset(lock));
+            snapshot = site;
+            memory_barrier();
+            lockclr(lock);
+        }
+
+        static void print_name (const Printer &printer, const char name[]) {
+            static const size_t WIDTH = 16;
+            size_t              length = 0;
+            for (; name[length] && WIDTH > length; ++length)
+                printer.put_char(name[length]);
+            for (; WIDTH > length; ++length)
+                printer.put_char(' ');
+        }
+
+        static void put_word (char frame[], size_t &length, const uint32_t word) {
+            frame[length++] = (char) word;
+            frame[length++] = (char) (word >> 8);
+            frame[length++] = (char) (word >> 16);
+            frame[length++] = (char) (word >> 24);
+        }
+};
+
+}
@@ -26,6 +26,10 @@
 #pragma once
 
 #include <PropWare/PropWare.h>
+#include <string.h>
+#ifndef __PROPELLER__
+#include <math.h>
+#endif
 
 namespace PropWare {
 
@@ -116,6 +120,10 @@ class Utility {
          * `malloc` is used to find free memory. Be aware that the execution time of `malloc` is not predictable and
          * it is called repeatedly - so this method can, potentially, take a long time to execute
          *
+         * The C library keeps its free list to itself, so trial allocations are the only way to ask. They disturb the
+         * heap and race with any other cog that allocates at the same time. Memory which comes from a PropWare::Heap
+         * instead can be inspected in a single pass, with no allocations, by PropWare::Heap::inspect
+         *
          * @param[in]   precision   The precision (in bytes) with which the method will be executed. Result can be
          *                          off by +/- `precision` bytes. Lower values will increase execution time
          *
@@ -196,8 +204,15 @@ class Utility {
 
             for (exp = 31; x > 0; exp--)
                 x <<= 1;
+#ifdef __PROPELLER__
             ptr      = (unsigned short *) ((((unsigned int) x) >> 19) + 0xb000);
             return (exp << 16) | *ptr;
+#else
+            // Same values as the ROM's log table at $C000: log2(1 + i/2048) for the 11 bits after the leading one
+            (void) ptr;
+            const unsigned int index = (((unsigned int) x) >> 20) & 0x7FF;
+            return (exp << 16) | (int) (log2(1 + index / 2048.0) * 65536 + 0.5);
+#endif
         }
 
         /**
@@ -0,0 +1,99 @@
+/**
+ * @file    CapturingPrintCapable.h
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/hmi/output/printcapable.h>
+
+/**
+ * @brief   PrintCapable which records everything sent to it, and how, so that tests can inspect the output
+ *
+ * The output is always null-terminated, but may itself contain null bytes; use `get_length` for binary output. Output
+ * beyond the capacity of the buffer is discarded.
+ */
+class CapturingPrintCapable : public PropWare::PrintCapable {
+    public:
+        CapturingPrintCapable () {
+            this->clear();
+        }
+
+        void clear () {
+            this->m_length    = 0;
+            this->m_putsCalls = 0;
+            this->m_charCalls = 0;
+            this->m_buffer[0] = '\0';
+        }
+
+        virtual void put_char (const char c) {
+            ++this->m_charCalls;
+            this->append(c);
+        }
+
+        virtual void puts (const char string[]) {
+            ++this->m_putsCalls;
+            while (*string)
+                this->append(*string++);
+        }
+
+        const char *get_output () const {
+            return this->m_buffer;
+        }
+
+        size_t get_length () const {
+            return this->m_length;
+        }
+
+        /**
+         * @brief   Number of calls to either `put_char` or `puts`
+         */
+        unsigned int get_calls () const {
+            return this->m_putsCalls + this->m_charCalls;
+        }
+
+        unsigned int get_puts_calls () const {
+            return this->m_putsCalls;
+        }
+
+        unsigned int get_char_calls () const {
+            return this->m_charCalls;
+        }
+
+    protected:
+        void append (const char c) {
+            if (sizeof(this->m_buffer) - 1 > this->m_length) {
+                this->m_buffer[this->m_length]     = c;
+                this->m_buffer[this->m_length + 1] = '\0';
+                // Published last: another cog may be polling the length
+                this->m_length = this->m_length + 1;
+            }
+        }
+
+    protected:
+        char            m_buffer[512];
+        // Written by whichever cog is printing, such as an AsyncPrinter's drain cog
+        volatile size_t m_length;
+        unsigned int    m_putsCalls;
+        unsigned int    m_charCalls;
+};
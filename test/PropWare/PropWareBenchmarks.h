@@ -0,0 +1,234 @@
+/**
+ * @file    PropWareBenchmarks.h
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+#include <PropWare/c++allocate.h>
+#include <PropWare/hmi/output/printer.h>
+
+#define PROPWARE_BENCHMARK
+
+/**
+ * @brief   Timing and reporting for a single benchmark, passed to every BENCHMARK function as `benchmark`
+ *
+ * The code inside MEASURE runs a few times untimed, to warm up anything that is loaded on first use, and is then
+ * timed with `CNT` over a number of runs. The cost of the timing itself is measured once per suite and subtracted.
+ * Each benchmark reports one line, which PC tools such as pwbenchdiff can parse:
+ *
+ *     BENCHMARK <suite>.<name> model=<LMM|CMM|...> runs=<n> cycles/op=<mean> min=<fastest run> max=<slowest run>
+ *     bytes/s=<throughput>
+ *
+ * all on one line. `min` and `max` are per run, not per operation, and `bytes/s` is only present when the benchmark
+ * declares how many bytes each run moves.
+ */
+class PropWareBenchmark {
+    public:
+        static const unsigned int DEFAULT_WARMUP = 2;
+        static const unsigned int DEFAULT_RUNS   = 16;
+
+    public:
+        PropWareBenchmark (const uint32_t overhead = 0)
+                : m_overhead(overhead),
+                  m_warmup(DEFAULT_WARMUP),
+                  m_runs(DEFAULT_RUNS),
+                  m_operations(1),
+                  m_bytes(0),
+                  m_skipped(false),
+                  m_iteration(0),
+                  m_start(0),
+                  m_minimum(0xFFFFFFFF),
+                  m_maximum(0),
+                  m_total(0) {
+        }
+
+        /**
+         * @brief   Number of untimed runs before the timed ones
+         */
+        void set_warmup (const unsigned int warmup) {
+            this->m_warmup = warmup;
+        }
+
+        /**
+         * @brief   Number of timed runs; use fewer for slow operations such as file I/O
+         */
+        void set_runs (const unsigned int runs) {
+            this->m_runs = runs;
+        }
+
+        /**
+         * @brief   Number of operations performed by each run, so that cycles/op is reported per operation
+         */
+        void set_operations (const uint32_t operations) {
+            this->m_operations = operations;
+        }
+
+        /**
+         * @brief   Number of bytes moved by each run, which enables the bytes/s figure
+         */
+        void set_bytes (const uint32_t bytes) {
+            this->m_bytes = bytes;
+        }
+
+        /**
+         * @brief   Report the benchmark as skipped, such as when the hardware it needs is missing
+         */
+        void skip (const char reason[]) {
+            this->m_skipped = true;
+            pwOut << "#\tSKIPPED: " << reason << '\n';
+        }
+
+        /**
+         * @brief   Loop condition behind MEASURE: times the run that just finished and decides whether to start another
+         */
+        bool keep_running () {
+            const uint32_t end = CNT;
+
+            if (this->m_iteration > this->m_warmup) {
+                const uint32_t elapsed = end - this->m_start;
+                const uint32_t cycles  = elapsed > this->m_overhead ? elapsed - this->m_overhead : 0;
+                this->m_total += cycles;
+                if (cycles < this->m_minimum)
+                    this->m_minimum = cycles;
+                if (cycles > this->m_maximum)
+                    this->m_maximum = cycles;
+            }
+
+            if (this->m_skipped || this->m_warmup + this->m_runs == this->m_iteration)
+                return false;
+            ++this->m_iteration;
+            this->m_start = CNT;
+            return true;
+        }
+
+        uint32_t get_minimum () const {
+            return this->m_minimum;
+        }
+
+        /**
+         * @brief   Mean clock cycles per operation
+         */
+        uint32_t get_cycles_per_operation () const {
+            return (uint32_t) (this->m_total / ((uint64_t) this->m_runs * this->m_operations));
+        }
+
+        void report (const char suite[], const char name[]) const {
+            if (this->m_skipped)
+                return;
+
+            pwOut << "BENCHMARK " << suite << '.' << name << " model=" << memory_model() << " runs=" << this->m_runs
+                  << " cycles/op=" << this->get_cycles_per_operation() << " min=" << this->m_minimum << " max="
+                  << this->m_maximum;
+            if (this->m_bytes && this->m_total)
+                pwOut << " bytes/s="
+                      << (uint32_t) ((uint64_t) this->m_bytes * this->m_runs * CLKFREQ / this->m_total);
+            pwOut << '\n';
+        }
+
+        static const char *memory_model () {
+#if !defined(__PROPELLER__)
+            return "host";
+#elif defined(__PROPELLER_CMM__)
+            return "CMM";
+#elif defined(__PROPELLER_XMMC__)
+            return "XMMC";
+#elif defined(__PROPELLER_XMM__)
+            return "XMM";
+#else
+            return "LMM";
+#endif
+        }
+
+        /**
+         * @brief   Cycles taken by an empty MEASURE loop, to be subtracted from every timed run
+         */
+        static uint32_t calibrate () {
+            PropWareBenchmark empty;
+            while (empty.keep_running());
+            return empty.get_minimum();
+        }
+
+    protected:
+        const uint32_t m_overhead;
+        unsigned int   m_warmup;
+        unsigned int   m_runs;
+        uint32_t       m_operations;
+        uint32_t       m_bytes;
+        bool           m_skipped;
+        unsigned int   m_iteration;
+        uint32_t       m_start;
+        uint32_t       m_minimum;
+        uint32_t       m_maximum;
+        uint64_t       m_total;
+};
+
+void _runPropWareBenchmark (void (*benchmarkFunction) (PropWareBenchmark &benchmark), const char suiteName[],
+                            const char benchmarkName[], const uint32_t overhead) {
+    PropWareBenchmark benchmark(overhead);
+    benchmarkFunction(benchmark);
+    benchmark.report(suiteName, benchmarkName);
+}
+
+/**
+ * @brief   Define a benchmark; the body sets up, then times its operation with MEASURE
+ *
+ * @code
+ * BENCHMARK(Queue_enqueueDequeue) {
+ *     PropWare::Queue<int> queue(buffer);
+ *     MEASURE {
+ *         queue.enqueue(1);
+ *         queue.dequeue();
+ *     }
+ * }
+ * @endcode
+ */
+#define BENCHMARK(benchmarkName) \
+    void benchmarkName (PropWareBenchmark &benchmark)
+
+/**
+ * @brief   Run the following statement or block repeatedly, timing each run
+ */
+#define MEASURE \
+    while (benchmark.keep_running())
+
+#define START_BENCHMARKS(benchmarkSuiteName) \
+    const char     suiteName[] = #benchmarkSuiteName; \
+    const uint32_t overhead    = PropWareBenchmark::calibrate(); \
+    pwOut.println( \
+        "####################" \
+        "####################" \
+        "####################" \
+        "####################"); \
+    pwOut << "# Benchmark suite: " << suiteName << '\n'
+
+#define RUN_BENCHMARK(benchmarkName) \
+    _runPropWareBenchmark(benchmarkName, suiteName, #benchmarkName, overhead)
+
+/**
+ * Ends with the same exit sequence as a unit test, so that propeller-load's `-q` returns once the suite is done
+ */
+#define COMPLETE_BENCHMARKS() \
+    pwOut.println("done..."); \
+    pwOut << (char) 0xff << (char) 0x00 << (char) 0; \
+    return 0
@@ -0,0 +1,223 @@
+/**
+ * @file    allocator_benchmark.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareBenchmarks.h"
+#include <PropWare/utility/allocator/objectpool.h>
+#include <PropWare/utility/allocator/arena.h>
+#include <PropWare/utility/allocator/heap.h>
+#include <PropWare/concurrent/hardwarelock.h>
+#include <PropWare/utility/utility.h>
+
+static const size_t BLOCK_SIZE = 32;
+/** Blocks alive at once during the churn benchmarks */
+static const size_t SLOTS      = 16;
+/** Every this many blocks, one outlives the churn, the way a long-lived object pins part of the heap */
+static const size_t PIN_EVERY  = 4;
+
+struct Block {
+    uint8_t bytes[BLOCK_SIZE];
+};
+
+/** Big enough for the largest size that size_for returns */
+struct ChurnBlock {
+    uint8_t bytes[16 + 4 * 48];
+};
+
+static PropWare::ObjectPool<Block, 16>                          pool;
+static PropWare::ObjectPool<Block, 16, PropWare::HardwareLock>  lockedPool;
+static PropWare::ObjectPool<ChurnBlock, SLOTS>                  churnPool;
+static uint32_t                                                 arenaBuffer[64];
+static PropWare::Arena                                          arena(arenaBuffer);
+static uint32_t                                                 heapBuffer[1024];
+static PropWare::Heap                                           heap(heapBuffer);
+
+static void         *slots[SLOTS];
+static unsigned int churnRound;
+
+/**
+ * @brief   A different mix of sizes every round, from 16 to 204 bytes, as produced by strings and messages
+ */
+static size_t size_for (const size_t slot) {
+    return 16 + 4 * ((slot * 7 + churnRound * 13) % 48);
+}
+
+/**
+ * @brief   Free every block except the pinned ones, then report the largest block the heap can still supply
+ */
+static void report_fragmentation (const char name[], PropWare::Allocator &allocator, const size_t largestBefore) {
+    for (size_t i = 0; i < SLOTS; ++i)
+        if (i % PIN_EVERY) {
+            allocator.deallocate(slots[i]);
+            slots[i] = NULL;
+        }
+
+    pwOut << "#\t" << name << ": largest free heap block " << largestBefore << " bytes before churn, "
+          << PropWare::Utility::get_largest_free_block_size(8) << " bytes with " << SLOTS / PIN_EVERY
+          << " blocks pinned\n";
+
+    for (size_t i = 0; i < SLOTS; ++i) {
+        allocator.deallocate(slots[i]);
+        slots[i] = NULL;
+    }
+}
+
+static void churn (PropWare::Allocator &allocator) {
+    for (size_t i = 0; i < SLOTS; ++i) {
+        allocator.deallocate(slots[i]);
+        slots[i] = allocator.allocate(size_for(i));
+    }
+    ++churnRound;
+}
+
+BENCHMARK(Malloc_allocFree) {
+    MEASURE {
+        free(malloc(BLOCK_SIZE));
+    }
+}
+
+BENCHMARK(ObjectPool_allocFree) {
+    MEASURE {
+        pool.deallocate(pool.allocate(BLOCK_SIZE));
+    }
+}
+
+BENCHMARK(ObjectPool_allocFree_hardwareLock) {
+    MEASURE {
+        lockedPool.deallocate(lockedPool.allocate(BLOCK_SIZE));
+    }
+}
+
+BENCHMARK(Arena_allocateAndRewind) {
+    MEASURE {
+        PropWare::Arena::Scope scope(arena);
+        arena.allocate(BLOCK_SIZE);
+    }
+}
+
+BENCHMARK(Heap_allocFree) {
+    MEASURE {
+        heap.deallocate(heap.allocate(BLOCK_SIZE));
+    }
+}
+
+BENCHMARK(Malloc_churn) {
+    PropWare::HeapAllocator &heap         = PropWare::HeapAllocator::get_instance();
+    const size_t            largestBefore = PropWare::Utility::get_largest_free_block_size(8);
+
+    benchmark.set_operations(SLOTS);
+    MEASURE {
+        churn(heap);
+    }
+    report_fragmentation("Malloc_churn", heap, largestBefore);
+}
+
+BENCHMARK(ObjectPool_churn) {
+    const size_t largestBefore = PropWare::Utility::get_largest_free_block_size(8);
+
+    benchmark.set_operations(SLOTS);
+    MEASURE {
+        churn(churnPool);
+    }
+    report_fragmentation("ObjectPool_churn", churnPool, largestBefore);
+}
+
+BENCHMARK(Heap_churn) {
+    benchmark.set_operations(SLOTS);
+    MEASURE {
+        churn(heap);
+    }
+
+    for (size_t i = 0; i < SLOTS; ++i)
+        if (i % PIN_EVERY) {
+            heap.deallocate(slots[i]);
+            slots[i] = NULL;
+        }
+    const PropWare::HeapStatistics statistics = heap.inspect();
+    pwOut << "#\tHeap_churn: " << statistics.freeBytes << " bytes free in " << statistics.fragments
+          << " fragments, largest " << statistics.largestBlock << " bytes, with " << SLOTS / PIN_EVERY
+          << " blocks pinned\n";
+    for (size_t i = 0; i < SLOTS; ++i) {
+        heap.deallocate(slots[i]);
+        slots[i] = NULL;
+    }
+}
+
+/**
+ * The two ways of asking how large an allocation can succeed: trial mallocs against a walk of the free list
+ */
+BENCHMARK(Malloc_largestFreeBlock) {
+    benchmark.set_runs(4);
+    MEASURE {
+        PropWare::Utility::get_largest_free_block_size();
+    }
+}
+
+BENCHMARK(Heap_inspect) {
+    MEASURE {
+        heap.inspect();
+    }
+}
+
+/**
+ * newlib's `malloc` walks its free list, so it slows down as the heap fragments. A pool does not
+ */
+BENCHMARK(Malloc_allocFree_fragmented) {
+    PropWare::HeapAllocator &heap = PropWare::HeapAllocator::get_instance();
+
+    for (unsigned int round = 0; round < 4; ++round)
+        churn(heap);
+    for (size_t i = 0; i < SLOTS; ++i)
+        if (i % PIN_EVERY) {
+            heap.deallocate(slots[i]);
+            slots[i] = NULL;
+        }
+
+    MEASURE {
+        free(malloc(BLOCK_SIZE * 8));
+    }
+
+    for (size_t i = 0; i < SLOTS; ++i) {
+        heap.deallocate(slots[i]);
+        slots[i] = NULL;
+    }
+}
+
+int main () {
+    START_BENCHMARKS(AllocatorBenchmark);
+
+    RUN_BENCHMARK(Malloc_allocFree);
+    RUN_BENCHMARK(ObjectPool_allocFree);
+    RUN_BENCHMARK(ObjectPool_allocFree_hardwareLock);
+    RUN_BENCHMARK(Arena_allocateAndRewind);
+    RUN_BENCHMARK(Heap_allocFree);
+    RUN_BENCHMARK(Malloc_churn);
+    RUN_BENCHMARK(ObjectPool_churn);
+    RUN_BENCHMARK(Heap_churn);
+    RUN_BENCHMARK(Malloc_largestFreeBlock);
+    RUN_BENCHMARK(Heap_inspect);
+    RUN_BENCHMARK(Malloc_allocFree_fragmented);
+
+    COMPLETE_BENCHMARKS();
+}
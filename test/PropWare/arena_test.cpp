@@ -0,0 +1,153 @@
+/**
+ * @file    arena_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/utility/allocator/arena.h>
+
+using PropWare::Arena;
+
+static uint32_t buffer[32];
+static Arena    *testable;
+
+SETUP {
+    testable = new Arena(buffer);
+}
+
+TEARDOWN {
+    delete testable;
+}
+
+static bool is_aligned (const void *block) {
+    return 0 == (uintptr_t) block % Arena::ALIGNMENT;
+}
+
+TEST(Constructor_isEmpty) {
+    setUp();
+
+    ASSERT_EQ_MSG(sizeof(buffer), testable->get_capacity());
+    ASSERT_EQ_MSG(0, testable->get_used());
+    ASSERT_EQ_MSG(0, testable->get_high_water_mark());
+
+    tearDown();
+}
+
+TEST(Allocate_isContiguousAndAligned) {
+    setUp();
+
+    uint8_t *first  = (uint8_t *) testable->allocate(1);
+    uint8_t *second = (uint8_t *) testable->allocate(Arena::ALIGNMENT);
+
+    ASSERT_NEQ_MSG(NULL, (uintptr_t) first);
+    ASSERT_TRUE(is_aligned(first));
+    ASSERT_TRUE(is_aligned(second));
+    ASSERT_EQ_MSG((uintptr_t) (first + Arena::ALIGNMENT), (uintptr_t) second);
+
+    tearDown();
+}
+
+TEST(Allocate_failsWhenFull) {
+    setUp();
+
+    // Whatever part of the buffer is lost to aligning its start, this is more than what remains
+    ASSERT_EQ_MSG(NULL, (uintptr_t) testable->allocate(sizeof(buffer) + 1));
+
+    const size_t half = sizeof(buffer) / 2;
+    ASSERT_NEQ_MSG(NULL, (uintptr_t) testable->allocate(half));
+    ASSERT_EQ_MSG(NULL, (uintptr_t) testable->allocate(sizeof(buffer)));
+    // A failed request leaves the arena as it was
+    ASSERT_TRUE(half + Arena::ALIGNMENT > testable->get_used());
+
+    tearDown();
+}
+
+TEST(Deallocate_doesNothing) {
+    setUp();
+
+    void *block = testable->allocate(8);
+    const size_t used = testable->get_used();
+    testable->deallocate(block);
+    ASSERT_EQ_MSG(used, testable->get_used());
+
+    tearDown();
+}
+
+TEST(Reset_releasesEverything) {
+    setUp();
+
+    void *first = testable->allocate(8);
+    testable->allocate(8);
+    testable->reset();
+
+    ASSERT_EQ_MSG(0, testable->get_used());
+    ASSERT_EQ_MSG((uintptr_t) first, (uintptr_t) testable->allocate(8));
+
+    tearDown();
+}
+
+TEST(Scope_rewindsOnExit) {
+    setUp();
+
+    testable->allocate(8);
+    const size_t outer = testable->get_used();
+    {
+        Arena::Scope scope(*testable);
+        testable->allocate(16);
+        {
+            Arena::Scope inner(*testable);
+            testable->allocate(16);
+        }
+        ASSERT_TRUE(outer < testable->get_used());
+    }
+    ASSERT_EQ_MSG(outer, testable->get_used());
+
+    tearDown();
+}
+
+TEST(HighWaterMark_survivesReset) {
+    setUp();
+
+    testable->allocate(40);
+    const size_t peak = testable->get_used();
+    testable->reset();
+    testable->allocate(4);
+
+    ASSERT_EQ_MSG(peak, testable->get_high_water_mark());
+
+    tearDown();
+}
+
+int main () {
+    START(ArenaTest);
+
+    RUN_TEST(Constructor_isEmpty);
+    RUN_TEST(Allocate_isContiguousAndAligned);
+    RUN_TEST(Allocate_failsWhenFull);
+    RUN_TEST(Deallocate_doesNothing);
+    RUN_TEST(Reset_releasesEverything);
+    RUN_TEST(Scope_rewindsOnExit);
+    RUN_TEST(HighWaterMark_survivesReset);
+
+    COMPLETE();
+}
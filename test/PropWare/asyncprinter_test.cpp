@@ -0,0 +1,126 @@
+/**
+ * @file    asyncprinter_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/hmi/output/asyncprinter.h>
+#include "PropWareTests.h"
+#include "CapturingPrintCapable.h"
+#include <string.h>
+
+using PropWare::AsyncPrinter;
+
+static char                  rings[AsyncPrinter::COGS][64];
+static uint32_t              stack[192];
+static CapturingPrintCapable *device;
+static PropWare::Printer     *printer;
+static AsyncPrinter          *testable;
+
+SETUP {
+    device   = new CapturingPrintCapable();
+    printer  = new PropWare::Printer(*device);
+    testable = new AsyncPrinter(*printer, rings, stack);
+}
+
+TEARDOWN {
+    delete testable;
+    delete printer;
+    delete device;
+    testable = NULL;
+    printer  = NULL;
+    device   = NULL;
+}
+
+TEST(Print_waitsForDrain) {
+    setUp();
+
+    testable->printf("x=%d\n", 5);
+    ASSERT_EQ_MSG(0, device->get_length());
+
+    ASSERT_EQ_MSG(4, testable->drain());
+    // Cooked mode is applied by the destination printer, and only once
+    ASSERT_EQ_MSG(0, strcmp("x=5\r\n", device->get_output()));
+    ASSERT_EQ_MSG(0, testable->drain());
+
+    tearDown();
+}
+
+TEST(Print_keepsOrder) {
+    setUp();
+
+    *testable << "a" << 1 << '\n';
+    testable->puts("b");
+    testable->println("c");
+    testable->print(2u);
+    testable->printf(PW_FMT("%X"), 0xFFu);
+    testable->drain();
+    ASSERT_EQ_MSG(0, strcmp("a1\r\nbc\r\n2FF", device->get_output()));
+
+    tearDown();
+}
+
+TEST(FullRing_dropsWholeCall) {
+    setUp();
+
+    // 64-byte ring: the second call does not fit and must leave nothing behind
+    testable->puts("0123456789012345678901234567890123456789");
+    testable->puts("abcdefghijklmnopqrstuvwxyz");
+    ASSERT_EQ_MSG(1, testable->get_dropped_count());
+
+    testable->drain();
+    ASSERT_EQ_MSG(0, strcmp("0123456789012345678901234567890123456789", device->get_output()));
+
+    // The ring has room again, and text wraps around its end
+    testable->puts("abcdefghijklmnopqrstuvwxyz");
+    testable->drain();
+    ASSERT_EQ_MSG(0, strcmp("0123456789012345678901234567890123456789abcdefghijklmnopqrstuvwxyz",
+                            device->get_output()));
+    ASSERT_EQ_MSG(1, testable->get_dropped_count());
+
+    tearDown();
+}
+
+TEST(PrinterCog_drainsInBackground) {
+    setUp();
+
+    const int8_t cog = PropWare::Runnable::invoke(*testable);
+    ASSERT_NEQ(-1, cog);
+
+    testable->printf("cog %d\n", 7);
+    testable->flush();
+    ASSERT_EQ_MSG(0, strcmp("cog 7\r\n", device->get_output()));
+
+    cogstop(cog);
+    tearDown();
+}
+
+int main () {
+    START(AsyncPrinterTest);
+
+    RUN_TEST(Print_waitsForDrain);
+    RUN_TEST(Print_keepsOrder);
+    RUN_TEST(FullRing_dropsWholeCall);
+    RUN_TEST(PrinterCog_drainsInBackground);
+
+    COMPLETE();
+}
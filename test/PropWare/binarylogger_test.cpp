@@ -0,0 +1,164 @@
+/**
+ * @file    binarylogger_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/hmi/output/binarylogger.h>
+#include <PropWare/utility/collection/charqueue.h>
+#include "PropWareTests.h"
+
+using PropWare::BinaryLogger;
+using PropWare::COBSDecoder;
+
+// Records are drained into the queue and read back out of it by a FramedSerial
+static char                   logBuffer[64];
+static char                   wire[512];
+static char                   receiveBuffer[BinaryLogger::MAX_RECORD_SIZE + COBSDecoder::CRC_SIZE];
+static PropWare::CharQueue    *loopback;
+static PropWare::FramedSerial *receiver;
+static BinaryLogger           *testable;
+
+SETUP {
+    loopback = new PropWare::CharQueue(wire);
+    receiver = new PropWare::FramedSerial(*loopback, *loopback, receiveBuffer);
+    testable = new BinaryLogger(logBuffer);
+}
+
+TEARDOWN {
+    delete testable;
+    delete receiver;
+    delete loopback;
+    testable = NULL;
+    receiver = NULL;
+    loopback = NULL;
+}
+
+uint16_t get_id (const char frame[]) {
+    return (uint16_t) ((uint8_t) frame[0] | (uint8_t) frame[1] << 8);
+}
+
+uint32_t get_word (const char bytes[]) {
+    return (uint32_t) (uint8_t) bytes[0]
+           | (uint32_t) (uint8_t) bytes[1] << 8
+           | (uint32_t) (uint8_t) bytes[2] << 16
+           | (uint32_t) (uint8_t) bytes[3] << 24;
+}
+
+TEST(Constructor_isEmpty) {
+    setUp();
+
+    ASSERT_TRUE(testable->is_empty());
+    ASSERT_EQ_MSG(0, testable->drain(*loopback));
+    ASSERT_TRUE(loopback->is_empty());
+
+    tearDown();
+}
+
+TEST(Log_idFindsFormatString) {
+    setUp();
+
+    PW_LOG(*testable, "No arguments\n");
+    PW_LOG(*testable, "Another %%\n");
+    ASSERT_EQ_MSG(2, testable->drain(*loopback));
+
+    ASSERT_EQ_MSG(BinaryLogger::ID_SIZE, receiver->receive());
+    ASSERT_EQ_MSG(0, strcmp("No arguments\n", __start_pwlog_formats + get_id(receiver->get_frame())));
+    ASSERT_EQ_MSG(BinaryLogger::ID_SIZE, receiver->receive());
+    ASSERT_EQ_MSG(0, strcmp("Another %%\n", __start_pwlog_formats + get_id(receiver->get_frame())));
+
+    tearDown();
+}
+
+TEST(Log_encodesArguments) {
+    setUp();
+
+    const int   x    = -2;
+    const char  c    = 'Q';
+    const float half = 0.5f;
+    PW_LOG(*testable, "%d %c %s %08X %.2f", x, c, "hi", 0xCAFEu, half);
+    testable->drain(*loopback);
+
+    // ID, 4-byte integer, character, "hi" with its null-terminator, 4-byte integer and 4-byte float
+    ASSERT_EQ_MSG(BinaryLogger::ID_SIZE + 4 + 1 + 3 + 4 + 4, receiver->receive());
+    const char *arguments = receiver->get_frame() + BinaryLogger::ID_SIZE;
+    ASSERT_EQ_MSG((uint32_t) -2, get_word(arguments));
+    ASSERT_EQ_MSG('Q', arguments[4]);
+    ASSERT_EQ_MSG(0, strcmp("hi", arguments + 5));
+    ASSERT_EQ_MSG(0xCAFE, get_word(arguments + 8));
+    ASSERT_EQ_MSG(0x3F000000, get_word(arguments + 12));
+
+    tearDown();
+}
+
+TEST(Log_sameCallSiteSameId) {
+    setUp();
+
+    for (unsigned int i = 0; i < 2; ++i)
+        PW_LOG(*testable, "Loop %u\n", i);
+    testable->drain(*loopback);
+
+    receiver->receive();
+    const uint16_t firstId = get_id(receiver->get_frame());
+    ASSERT_EQ_MSG(0, get_word(receiver->get_frame() + BinaryLogger::ID_SIZE));
+    receiver->receive();
+    ASSERT_EQ_MSG(firstId, get_id(receiver->get_frame()));
+    ASSERT_EQ_MSG(1, get_word(receiver->get_frame() + BinaryLogger::ID_SIZE));
+
+    tearDown();
+}
+
+TEST(FullBuffer_dropsWholeRecords) {
+    setUp();
+
+    // Each record takes 7 bytes of the 64-byte buffer: length, ID and one integer
+    unsigned int logged = 0;
+    for (unsigned int i = 0; i < 10; ++i)
+        if (testable->log(PW_FMT("%u"), __start_pwlog_formats, i))
+            ++logged;
+    ASSERT_EQ_MSG(9, logged);
+    ASSERT_EQ_MSG(1, testable->get_dropped_count());
+
+    // Draining makes room again, and wrapping around the end of the buffer must not corrupt a record
+    ASSERT_TRUE(testable->drain_one(*loopback));
+    ASSERT_TRUE(testable->log(PW_FMT("%u"), __start_pwlog_formats, 0xDEADBEEF));
+    ASSERT_EQ_MSG(9, testable->drain(*loopback));
+    // The record sent by drain_one is still on the wire ahead of the others
+    for (unsigned int i = 0; i < 10; ++i)
+        receiver->receive();
+    ASSERT_EQ_MSG(0xDEADBEEF, get_word(receiver->get_frame() + BinaryLogger::ID_SIZE));
+    ASSERT_EQ_MSG(0, receiver->get_error_count());
+
+    tearDown();
+}
+
+int main () {
+    START(BinaryLoggerTest);
+
+    RUN_TEST(Constructor_isEmpty);
+    RUN_TEST(Log_idFindsFormatString);
+    RUN_TEST(Log_encodesArguments);
+    RUN_TEST(Log_sameCallSiteSameId);
+    RUN_TEST(FullBuffer_dropsWholeRecords);
+
+    COMPLETE();
+}
@@ -0,0 +1,152 @@
+/**
+ * @file    bufferedprinter_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/hmi/output/bufferedprinter.h>
+#include "PropWareTests.h"
+#include "CapturingPrintCapable.h"
+#include <string.h>
+
+using PropWare::BufferedPrinter;
+
+static char                  buffer[16];
+static CapturingPrintCapable *device;
+static BufferedPrinter       *testable;
+
+SETUP {
+    device   = new CapturingPrintCapable();
+    testable = new BufferedPrinter(*device, buffer);
+}
+
+TEARDOWN {
+    delete testable;
+    delete device;
+    testable = NULL;
+    device   = NULL;
+}
+
+TEST(Constructor_sendsNothing) {
+    setUp();
+
+    ASSERT_EQ_MSG(0, device->get_length());
+    ASSERT_EQ_MSG(0, testable->get_print_buffer().get_length());
+
+    tearDown();
+}
+
+TEST(Newline_flushesCookedLineInOneCall) {
+    setUp();
+
+    testable->printf("x=%d\n", 42);
+    ASSERT_EQ_MSG(0, strcmp("x=42\r\n", device->get_output()));
+    ASSERT_EQ_MSG(1, device->get_puts_calls());
+    ASSERT_EQ_MSG(0, device->get_char_calls());
+
+    tearDown();
+}
+
+TEST(PartialLine_waitsForFlush) {
+    setUp();
+
+    *testable << "abc" << 12;
+    ASSERT_EQ_MSG(0, device->get_length());
+    ASSERT_EQ_MSG(5, testable->get_print_buffer().get_length());
+
+    testable->flush();
+    ASSERT_EQ_MSG(0, strcmp("abc12", device->get_output()));
+    ASSERT_EQ_MSG(1, device->get_puts_calls());
+
+    // Nothing left to send
+    testable->flush();
+    ASSERT_EQ_MSG(1, device->get_puts_calls());
+
+    tearDown();
+}
+
+TEST(FullBuffer_flushes) {
+    setUp();
+
+    // 15 of the 16 bytes hold characters; the last is for the null-terminator
+    testable->puts("0123456789ABCDEFGHIJ");
+    ASSERT_EQ_MSG(0, strcmp("0123456789ABCDE", device->get_output()));
+    ASSERT_EQ_MSG(1, device->get_puts_calls());
+
+    testable->flush();
+    ASSERT_EQ_MSG(0, strcmp("0123456789ABCDEFGHIJ", device->get_output()));
+    ASSERT_EQ_MSG(2, device->get_puts_calls());
+
+    tearDown();
+}
+
+TEST(NullCharacter_passesThrough) {
+    setUp();
+
+    testable->puts("ab");
+    testable->put_char('\0');
+    ASSERT_EQ_MSG(3, device->get_length());
+    ASSERT_EQ_MSG(0, strcmp("ab", device->get_output()));
+    ASSERT_EQ_MSG(1, device->get_puts_calls());
+    ASSERT_EQ_MSG(1, device->get_char_calls());
+
+    tearDown();
+}
+
+TEST(FlushOnNewlineDisabled) {
+    setUp();
+
+    testable->get_print_buffer().set_flush_on_newline(false);
+    testable->puts("a\nb\n");
+    ASSERT_EQ_MSG(0, device->get_length());
+
+    testable->flush();
+    ASSERT_EQ_MSG(0, strcmp("a\r\nb\r\n", device->get_output()));
+    ASSERT_EQ_MSG(1, device->get_puts_calls());
+
+    tearDown();
+}
+
+TEST(Destructor_flushes) {
+    setUp();
+
+    testable->puts("bye");
+    delete testable;
+    testable = NULL;
+    ASSERT_EQ_MSG(0, strcmp("bye", device->get_output()));
+
+    tearDown();
+}
+
+int main () {
+    START(BufferedPrinterTest);
+
+    RUN_TEST(Constructor_sendsNothing);
+    RUN_TEST(Newline_flushesCookedLineInOneCall);
+    RUN_TEST(PartialLine_waitsForFlush);
+    RUN_TEST(FullBuffer_flushes);
+    RUN_TEST(NullCharacter_passesThrough);
+    RUN_TEST(FlushOnNewlineDisabled);
+    RUN_TEST(Destructor_flushes);
+
+    COMPLETE();
+}
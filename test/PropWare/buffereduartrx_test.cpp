@@ -0,0 +1,302 @@
+/**
+ * @file    buffereduartrx_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/serial/uart/buffereduartrx.h>
+#include "PropWareTests.h"
+
+using PropWare::BufferedUARTRX;
+using PropWare::UART;
+
+// The test cog bit-bangs the RX stream onto this pin and the receiver cog samples it back
+static const PropWare::Port::Mask SIMULATED_RX = PropWare::Port::P12;
+static const int32_t              BAUD         = 19200;
+
+static char                   buffer[32];
+static BufferedUARTRX::Frame  frames[4];
+static char                   received[32];
+static BufferedUARTRX::Frame  frame;
+static BufferedUARTRX         *testable;
+static PropWare::Pin          *simulator;
+
+SETUP {
+    testable = new BufferedUARTRX(buffer, frames, SIMULATED_RX);
+    testable->set_baud_rate(BAUD);
+
+    simulator = new PropWare::Pin(SIMULATED_RX, PropWare::Pin::Dir::OUT);
+    simulator->set();
+}
+
+TEARDOWN {
+    delete testable;
+    delete simulator;
+}
+
+void start_receiver () {
+    testable->start();
+    // Give the new cog time to load before anything is put on the line
+    waitcnt(MILLISECOND + CNT);
+}
+
+/**
+ * @brief   Drive a single word onto the simulated line: start bit, 8 data bits, optional parity bit and one stop bit
+ *
+ * @return  Value of CNT just before the start bit was driven
+ */
+uint32_t simulate_word (const uint8_t word, const bool corruptParity = false) {
+    uint32_t     bits     = (uint32_t) word << 1;
+    uint_fast8_t bitCount = 9;
+
+    const UART::Parity parity = testable->get_parity();
+    if (UART::Parity::NO_PARITY != parity) {
+        bool parityBit = __builtin_popcount(word) & 1;
+        if (UART::Parity::ODD_PARITY == parity)
+            parityBit = !parityBit;
+        if (corruptParity)
+            parityBit = !parityBit;
+        bits |= parityBit << bitCount++;
+    }
+    bits |= 1 << bitCount++;
+
+    const uint32_t bitCycles = CLKFREQ / BAUD;
+    const uint32_t startBit  = CNT;
+    uint32_t       timer     = startBit;
+    while (bitCount--) {
+        simulator->write(bits & 1);
+        bits >>= 1;
+        timer += bitCycles;
+        waitcnt(timer);
+    }
+    return startBit;
+}
+
+void simulate_string (const char string[]) {
+    while (*string)
+        simulate_word((uint8_t) *string++);
+}
+
+TEST(Delimiter_singleFrame) {
+    setUp();
+    start_receiver();
+
+    simulate_string("abc\n");
+
+    ASSERT_EQ_MSG(3, testable->receive_frame(received, sizeof(received), &frame));
+    ASSERT_EQ_MSG(0, strncmp("abc", received, 3));
+    ASSERT_EQ_MSG(0, frame.flags);
+    ASSERT_FALSE(testable->frame_ready());
+
+    tearDown();
+}
+
+TEST(Delimiter_timestampIsStartOfFirstWord) {
+    setUp();
+    start_receiver();
+
+    const uint32_t startBit = simulate_word('x');
+    simulate_string("yz\n");
+
+    testable->receive_frame(received, sizeof(received), &frame);
+    ASSERT_TRUE(frame.timestamp - startBit < CLKFREQ / BAUD);
+
+    tearDown();
+}
+
+TEST(Delimiter_emptyFrame) {
+    setUp();
+    start_receiver();
+
+    simulate_string("\n");
+
+    ASSERT_EQ_MSG(0, testable->receive_frame(received, sizeof(received), &frame));
+    ASSERT_EQ_MSG(0, frame.flags);
+
+    tearDown();
+}
+
+TEST(Delimiter_maxFrameLength) {
+    setUp();
+    testable->set_delimiter_framing('\n', 4);
+    start_receiver();
+
+    simulate_string("abcdefg\n");
+
+    ASSERT_EQ_MSG(4, testable->receive_frame(received, sizeof(received), &frame));
+    ASSERT_EQ_MSG(0, strncmp("abcd", received, 4));
+    ASSERT_EQ_MSG(BufferedUARTRX::Frame::TRUNCATED, frame.flags);
+
+    ASSERT_EQ_MSG(3, testable->receive_frame(received, sizeof(received), &frame));
+    ASSERT_EQ_MSG(0, strncmp("efg", received, 3));
+    ASSERT_EQ_MSG(0, frame.flags);
+
+    tearDown();
+}
+
+TEST(LengthPrefix) {
+    setUp();
+    testable->set_length_prefix_framing();
+    start_receiver();
+
+    // The length prefix must not be confused with a delimiter
+    simulate_word(3);
+    simulate_string("x\ny");
+    simulate_word(0);
+
+    ASSERT_EQ_MSG(3, testable->receive_frame(received, sizeof(received), &frame));
+    ASSERT_EQ_MSG(0, strncmp("x\ny", received, 3));
+    ASSERT_EQ_MSG(0, frame.flags);
+
+    ASSERT_EQ_MSG(0, testable->receive_frame(received, sizeof(received), &frame));
+    ASSERT_EQ_MSG(0, frame.flags);
+
+    tearDown();
+}
+
+TEST(EvenParity_flagsFrameWithBadWord) {
+    setUp();
+    testable->set_parity(UART::Parity::EVEN_PARITY);
+    start_receiver();
+
+    simulate_word('a');
+    simulate_word('b', true);
+    simulate_word('\n');
+    simulate_string("ok\n");
+
+    ASSERT_EQ_MSG(2, testable->receive_frame(received, sizeof(received), &frame));
+    ASSERT_EQ_MSG(0, strncmp("ab", received, 2));
+    ASSERT_EQ_MSG(BufferedUARTRX::Frame::PARITY_ERROR, frame.flags);
+
+    ASSERT_EQ_MSG(2, testable->receive_frame(received, sizeof(received), &frame));
+    ASSERT_EQ_MSG(0, strncmp("ok", received, 2));
+    ASSERT_EQ_MSG(0, frame.flags);
+
+    tearDown();
+}
+
+TEST(OddParity) {
+    setUp();
+    testable->set_parity(UART::Parity::ODD_PARITY);
+    start_receiver();
+
+    simulate_string("hi\n");
+    simulate_word('!', true);
+    simulate_word('\n');
+
+    ASSERT_EQ_MSG(2, testable->receive_frame(received, sizeof(received), &frame));
+    ASSERT_EQ_MSG(0, strncmp("hi", received, 2));
+    ASSERT_EQ_MSG(0, frame.flags);
+
+    ASSERT_EQ_MSG(1, testable->receive_frame(received, sizeof(received), &frame));
+    ASSERT_EQ_MSG('!', received[0]);
+    ASSERT_EQ_MSG(BufferedUARTRX::Frame::PARITY_ERROR, frame.flags);
+
+    tearDown();
+}
+
+TEST(ReceiveFrame_wrapsAroundBuffer) {
+    setUp();
+    start_receiver();
+
+    for (unsigned int i = 0; i < 10; ++i) {
+        simulate_string("012345\n");
+        ASSERT_EQ_MSG(6, testable->receive_frame(received, sizeof(received), &frame));
+        ASSERT_EQ_MSG(0, strncmp("012345", received, 6));
+    }
+
+    tearDown();
+}
+
+TEST(ReceiveFrame_smallBufferTruncatesCopy) {
+    setUp();
+    start_receiver();
+
+    simulate_string("abcdef\n");
+
+    ASSERT_EQ_MSG(2, testable->receive_frame(received, 2, &frame));
+    ASSERT_EQ_MSG(6, frame.length);
+    ASSERT_EQ_MSG(BufferedUARTRX::Frame::TRUNCATED, frame.flags);
+    ASSERT_FALSE(testable->frame_ready());
+
+    tearDown();
+}
+
+TEST(FullFrameQueue_dropsFrames) {
+    setUp();
+    start_receiver();
+
+    // Only three of the four frame descriptors are usable
+    simulate_string("1\n2\n3\n4\n5\n");
+
+    ASSERT_EQ_MSG(2, testable->get_dropped_frame_count());
+    for (char expected = '1'; expected <= '3'; ++expected) {
+        ASSERT_EQ_MSG(1, testable->receive_frame(received, sizeof(received), &frame));
+        ASSERT_EQ_MSG(expected, received[0]);
+    }
+    ASSERT_FALSE(testable->frame_ready());
+
+    // The dropped frames' words must not linger in the buffer
+    simulate_string("6\n");
+    ASSERT_EQ_MSG(1, testable->receive_frame(received, sizeof(received), &frame));
+    ASSERT_EQ_MSG('6', received[0]);
+
+    tearDown();
+}
+
+TEST(FullBuffer_countsOverflow) {
+    setUp();
+    start_receiver();
+
+    // 31 of the 32 bytes are usable: the second frame only fits 11 of its 20 words
+    simulate_string("ABCDEFGHIJKLMNOPQRST\n");
+    simulate_string("abcdefghijklmnopqrst\n");
+
+    ASSERT_EQ_MSG(9, testable->get_overflow_count());
+
+    ASSERT_EQ_MSG(20, testable->receive_frame(received, sizeof(received), &frame));
+    ASSERT_EQ_MSG(0, frame.flags);
+
+    ASSERT_EQ_MSG(11, testable->receive_frame(received, sizeof(received), &frame));
+    ASSERT_EQ_MSG(0, strncmp("abcdefghijk", received, 11));
+    ASSERT_EQ_MSG(BufferedUARTRX::Frame::DATA_OVERFLOW, frame.flags);
+
+    tearDown();
+}
+
+int main () {
+    START(BufferedUARTRXTest);
+
+    RUN_TEST(Delimiter_singleFrame);
+    RUN_TEST(Delimiter_timestampIsStartOfFirstWord);
+    RUN_TEST(Delimiter_emptyFrame);
+    RUN_TEST(Delimiter_maxFrameLength);
+    RUN_TEST(LengthPrefix);
+    RUN_TEST(EvenParity_flagsFrameWithBadWord);
+    RUN_TEST(OddParity);
+    RUN_TEST(ReceiveFrame_wrapsAroundBuffer);
+    RUN_TEST(ReceiveFrame_smallBufferTruncatesCopy);
+    RUN_TEST(FullFrameQueue_dropsFrames);
+    RUN_TEST(FullBuffer_countsOverflow);
+
+    COMPLETE();
+}
@@ -0,0 +1,213 @@
+/**
+ * @file    cogpool_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/concurrent/cogpool.h>
+
+using PropWare::CogPool;
+using PropWare::Latch;
+using PropWare::Task;
+
+static const unsigned int WORKERS = 3;
+
+static uint32_t          stacks[WORKERS][128];
+static Task              tasks[4];
+static CogPool           *testable;
+static volatile uint32_t visits[64];
+
+SETUP {
+    testable = new CogPool(stacks, tasks);
+    for (unsigned int i = 0; i < 64; ++i)
+        visits[i] = 0;
+}
+
+TEARDOWN {
+    delete testable;
+    testable = NULL;
+}
+
+void increment (void *context) {
+    ++*static_cast<volatile uint32_t *>(context);
+}
+
+void visit_range (const uint32_t begin, const uint32_t end, void *context) {
+    volatile uint32_t *counts = static_cast<volatile uint32_t *>(context);
+    for (uint32_t i = begin; i < end; ++i)
+        ++counts[i];
+}
+
+TEST(Latch_releasedByLastCountDown) {
+    Latch latch(2);
+
+    ASSERT_FALSE(latch.is_released());
+    latch.count_down();
+    ASSERT_EQ_MSG(1, latch.get_count());
+    latch.count_down();
+    ASSERT_TRUE(latch.is_released());
+    latch.wait();
+
+    latch.reset(1);
+    ASSERT_FALSE(latch.is_released());
+
+    tearDown();
+}
+
+TEST(Submit_waitRunsTasksBeforeStart) {
+    setUp();
+
+    Latch done(2);
+    testable->submit(increment, (void *) &visits[0], &done);
+    testable->submit(increment, (void *) &visits[1], &done);
+    ASSERT_EQ_MSG(2, testable->get_pending_count());
+
+    testable->wait(done);
+    ASSERT_EQ_MSG(1, visits[0]);
+    ASSERT_EQ_MSG(1, visits[1]);
+    ASSERT_EQ_MSG(0, testable->get_pending_count());
+
+    tearDown();
+}
+
+TEST(Submit_fullQueueRunsTasksOnCaller) {
+    setUp();
+
+    Latch done(10);
+    for (unsigned int i = 0; i < 10; ++i)
+        testable->submit(increment, (void *) &visits[i], &done);
+    testable->wait(done);
+
+    for (unsigned int i = 0; i < 10; ++i)
+        ASSERT_EQ_MSG(1, visits[i]);
+
+    tearDown();
+}
+
+TEST(TrySubmit_fullQueue) {
+    setUp();
+
+    const Task task = {increment, (void *) &visits[0], NULL};
+    for (unsigned int i = 0; i < 4; ++i)
+        ASSERT_TRUE(testable->try_submit(task));
+    ASSERT_FALSE(testable->try_submit(task));
+
+    while (testable->run_pending_task());
+    ASSERT_EQ_MSG(4, visits[0]);
+
+    tearDown();
+}
+
+TEST(ParallelFor_visitsEveryIndexOnce) {
+    setUp();
+
+    testable->parallel_for(3, 60, visit_range, (void *) visits);
+
+    for (unsigned int i = 0; i < 64; ++i) {
+        const uint32_t expected = 3 <= i && 60 > i;
+        ASSERT_EQ_MSG(expected, visits[i]);
+    }
+
+    tearDown();
+}
+
+TEST(ParallelFor_fewerIndicesThanCogs) {
+    setUp();
+
+    testable->parallel_for(0, 2, visit_range, (void *) visits);
+
+    ASSERT_EQ_MSG(1, visits[0]);
+    ASSERT_EQ_MSG(1, visits[1]);
+    ASSERT_EQ_MSG(0, visits[2]);
+
+    tearDown();
+}
+
+TEST(ParallelFor_emptyRange) {
+    setUp();
+
+    testable->parallel_for(5, 5, visit_range, (void *) visits);
+    testable->parallel_for(6, 5, visit_range, (void *) visits);
+
+    for (unsigned int i = 0; i < 64; ++i)
+        ASSERT_EQ_MSG(0, visits[i]);
+
+    tearDown();
+}
+
+TEST(ParallelFor_lambda) {
+    setUp();
+
+    const uint32_t offset = 10;
+    testable->parallel_for(0, 32, [offset] (const uint32_t begin, const uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i)
+            visits[i] = i + offset;
+    });
+
+    for (unsigned int i = 0; i < 32; ++i)
+        ASSERT_EQ_MSG(i + offset, visits[i]);
+
+    tearDown();
+}
+
+TEST(Start_workersRunTasks) {
+    setUp();
+
+    ASSERT_EQ_MSG(WORKERS, testable->start());
+
+    // Wait without helping, so that only the workers can run the tasks
+    Latch done(8);
+    for (unsigned int i = 0; i < 8; ++i)
+        testable->submit(increment, (void *) &visits[i], &done);
+    done.wait();
+    for (unsigned int i = 0; i < 8; ++i)
+        ASSERT_EQ_MSG(1, visits[i]);
+
+    testable->parallel_for(0, 64, visit_range, (void *) visits);
+    for (unsigned int i = 0; i < 64; ++i) {
+        const uint32_t expected = 8 > i ? 2 : 1;
+        ASSERT_EQ_MSG(expected, visits[i]);
+    }
+
+    testable->stop();
+    for (unsigned int i = 0; i < WORKERS; ++i)
+        ASSERT_FALSE(testable->m_workers[i].m_running);
+
+    tearDown();
+}
+
+int main () {
+    START(CogPoolTest);
+
+    RUN_TEST(Latch_releasedByLastCountDown);
+    RUN_TEST(Submit_waitRunsTasksBeforeStart);
+    RUN_TEST(Submit_fullQueueRunsTasksOnCaller);
+    RUN_TEST(TrySubmit_fullQueue);
+    RUN_TEST(ParallelFor_visitsEveryIndexOnce);
+    RUN_TEST(ParallelFor_fewerIndicesThanCogs);
+    RUN_TEST(ParallelFor_emptyRange);
+    RUN_TEST(ParallelFor_lambda);
+    RUN_TEST(Start_workersRunTasks);
+
+    COMPLETE();
+}
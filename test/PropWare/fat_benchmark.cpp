@@ -0,0 +1,121 @@
+/**
+ * @file    fat_benchmark.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareBenchmarks.h"
+#include <PropWare/memory/sd.h>
+#include <PropWare/filesystem/fat/fatfs.h>
+#include <PropWare/filesystem/fat/fatfilewriter.h>
+#include <PropWare/filesystem/fat/fatfilereader.h>
+
+using namespace PropWare;
+
+static const char   FILE_NAME[] = "bench.txt";
+static const size_t FILE_SIZE   = 4096;
+// File I/O is slow enough that a handful of runs gives a stable mean
+static const unsigned int RUNS   = 4;
+static const unsigned int WARMUP = 1;
+
+static SD    g_driver;
+static FatFS g_fs(g_driver);
+static bool  g_mounted;
+static char  chunk[512];
+
+BENCHMARK(FatFileWriter_putChar) {
+    if (!g_mounted) {
+        benchmark.skip("no SD card");
+        return;
+    }
+
+    // Every run appends to the same file, so cluster allocation is part of the measurement
+    FatFileWriter writer(g_fs, FILE_NAME);
+    writer.remove();
+    g_fs.flush_fat();
+
+    benchmark.set_warmup(WARMUP);
+    benchmark.set_runs(RUNS);
+    benchmark.set_bytes(FILE_SIZE);
+    MEASURE {
+        writer.open();
+        for (size_t i = 0; i < FILE_SIZE; ++i)
+            writer.put_char((char) ('A' + i % 26));
+        writer.close();
+    }
+}
+
+BENCHMARK(FatFileReader_getChar) {
+    if (!g_mounted) {
+        benchmark.skip("no SD card");
+        return;
+    }
+
+    FatFileReader reader(g_fs, FILE_NAME);
+
+    benchmark.set_warmup(WARMUP);
+    benchmark.set_runs(RUNS);
+    benchmark.set_bytes(FILE_SIZE);
+    MEASURE {
+        reader.open();
+        for (size_t i = 0; i < FILE_SIZE; ++i)
+            reader.get_char();
+        reader.close();
+    }
+}
+
+BENCHMARK(FatFileReader_getChars) {
+    if (!g_mounted) {
+        benchmark.skip("no SD card");
+        return;
+    }
+
+    FatFileReader reader(g_fs, FILE_NAME);
+
+    benchmark.set_warmup(WARMUP);
+    benchmark.set_runs(RUNS);
+    benchmark.set_bytes(FILE_SIZE);
+    MEASURE {
+        reader.open();
+        for (size_t i = 0; i < FILE_SIZE; i += sizeof(chunk))
+            reader.get_chars(chunk, sizeof(chunk));
+        reader.close();
+    }
+}
+
+int main () {
+    START_BENCHMARKS(FatBenchmark);
+
+    g_mounted = !g_fs.mount();
+
+    RUN_BENCHMARK(FatFileWriter_putChar);
+    RUN_BENCHMARK(FatFileReader_getChar);
+    RUN_BENCHMARK(FatFileReader_getChars);
+
+    if (g_mounted) {
+        FatFileWriter(g_fs, FILE_NAME).remove();
+        g_fs.flush_fat();
+        g_fs.unmount();
+    }
+
+    COMPLETE_BENCHMARKS();
+}
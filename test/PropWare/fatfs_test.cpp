@@ -34,6 +34,7 @@
 #include "PropWareTests.h"
 #include <PropWare/memory/sd.h>
 #include <PropWare/filesystem/fat/fatfs.h>
+#include <PropWare/utility/allocator/arena.h>
 
 using namespace PropWare;
 
@@ -133,6 +134,20 @@ TEST(Mount_withParameter4) {
     tearDown();
 }
 
+TEST(Mount_allocatorExhausted) {
+    // Not even one sector
+    uint32_t arenaBuffer[16];
+    Arena    arena(arenaBuffer);
+    setUp();
+
+    FatFS     filesystem(g_driver, pwOut, arena);
+    ErrorCode err = filesystem.mount();
+    ASSERT_EQ_MSG(FatFS::OUT_OF_MEMORY, err);
+    ASSERT_FALSE(filesystem.m_mounted);
+
+    tearDown();
+}
+
 TEST(ClearChain) {
     // TODO: Write test (and don't forget to invoke it in main)
 
@@ -148,6 +163,7 @@ int main () {
     RUN_TEST(Mount_withParameter0);
     RUN_TEST(Mount_withParameter1);
     RUN_TEST(Mount_withParameter4);
+    RUN_TEST(Mount_allocatorExhausted);
 
     COMPLETE();
 }
@@ -0,0 +1,234 @@
+/**
+ * @file    framedserial_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/serial/framing/framedserial.h>
+#include <PropWare/utility/collection/charqueue.h>
+#include "PropWareTests.h"
+
+using PropWare::COBSDecoder;
+using PropWare::CRC16;
+
+static const size_t MAX_RECORD = 600;
+
+// The queue is both the "wire" and the ScanCapable which FramedSerial reads back from
+static char                   wire[1024];
+static char                   receiveBuffer[MAX_RECORD + COBSDecoder::CRC_SIZE];
+static char                   record[MAX_RECORD];
+static PropWare::CharQueue    *loopback;
+static PropWare::FramedSerial *testable;
+
+SETUP {
+    loopback = new PropWare::CharQueue(wire);
+    testable = new PropWare::FramedSerial(*loopback, *loopback, receiveBuffer);
+}
+
+TEARDOWN {
+    delete testable;
+    delete loopback;
+    testable = NULL;
+    loopback = NULL;
+}
+
+/**
+ * @brief   Fill `record` with a repeatable pattern, including a zero every `zeroInterval` bytes
+ */
+void fill_record (const size_t length, const size_t zeroInterval) {
+    for (size_t i = 0; i < length; ++i)
+        record[i] = (char) ((i + 1) % zeroInterval ? i % 255 + 1 : 0);
+}
+
+bool round_trip (const size_t length) {
+    testable->send_array(record, length);
+    return length == testable->receive() && 0 == memcmp(record, testable->get_frame(), length);
+}
+
+TEST(CRC16_checkValue) {
+    ASSERT_EQ_MSG(0x29B1, CRC16::compute("123456789", 9));
+    return true;
+}
+
+TEST(SendArray_onlyZeroIsEndOfFrame) {
+    setUp();
+
+    fill_record(100, 3);
+    testable->send_array(record, 100);
+
+    const size_t frameLength = loopback->size();
+    for (size_t i = 1; i < frameLength; ++i)
+        ASSERT_NEQ(0, loopback->get_char());
+    ASSERT_EQ_MSG(0, loopback->get_char());
+
+    tearDown();
+}
+
+TEST(RoundTrip_empty) {
+    setUp();
+
+    ASSERT_TRUE(round_trip(0));
+
+    tearDown();
+}
+
+TEST(RoundTrip_noZeros) {
+    setUp();
+
+    fill_record(20, MAX_RECORD + 1);
+    ASSERT_TRUE(round_trip(20));
+
+    tearDown();
+}
+
+TEST(RoundTrip_allZeros) {
+    setUp();
+
+    memset(record, 0, 20);
+    ASSERT_TRUE(round_trip(20));
+
+    tearDown();
+}
+
+TEST(RoundTrip_longerThanOneBlock) {
+    setUp();
+
+    // Exactly one full block, then a zero immediately after one, then a long record with occasional zeros
+    fill_record(PropWare::FramedSerial::MAX_BLOCK_SIZE, MAX_RECORD + 1);
+    ASSERT_TRUE(round_trip(PropWare::FramedSerial::MAX_BLOCK_SIZE));
+    record[PropWare::FramedSerial::MAX_BLOCK_SIZE] = 0;
+    ASSERT_TRUE(round_trip(PropWare::FramedSerial::MAX_BLOCK_SIZE + 1));
+    fill_record(MAX_RECORD, 300);
+    ASSERT_TRUE(round_trip(MAX_RECORD));
+
+    tearDown();
+}
+
+TEST(RoundTrip_struct) {
+    struct {
+        uint32_t timestamp;
+        int16_t  x;
+        int16_t  y;
+    }    sent, received;
+    setUp();
+
+    sent.timestamp = 0x12003400;
+    sent.x         = -1;
+    sent.y         = 0;
+    testable->send(sent);
+    ASSERT_TRUE(testable->receive(received));
+    ASSERT_EQ_MSG(sent.timestamp, received.timestamp);
+    ASSERT_EQ_MSG(sent.x, received.x);
+    ASSERT_EQ_MSG(sent.y, received.y);
+
+    tearDown();
+}
+
+TEST(Receive_skipsCorruptFrame) {
+    setUp();
+
+    fill_record(10, 4);
+    testable->send_array(record, 10);
+    // Flip a bit in the middle of the first frame
+    const size_t frameLength = loopback->size();
+    for (size_t i = 0; i < frameLength; ++i) {
+        const char c = loopback->get_char();
+        loopback->put_char(frameLength / 2 == i ? (char) (c ^ 0x10) : c);
+    }
+    testable->send_array(record, 9);
+
+    ASSERT_EQ_MSG(9, testable->receive());
+    ASSERT_EQ_MSG(1, testable->get_error_count());
+
+    tearDown();
+}
+
+TEST(Receive_skipsFrameWithDroppedByte) {
+    setUp();
+
+    fill_record(10, 4);
+    testable->send_array(record, 10);
+    const size_t frameLength = loopback->size();
+    for (size_t i = 0; i < frameLength; ++i) {
+        const char c = loopback->get_char();
+        if (3 != i)
+            loopback->put_char(c);
+    }
+    testable->send_array(record, 8);
+
+    ASSERT_EQ_MSG(8, testable->receive());
+    ASSERT_EQ_MSG(0, memcmp(record, testable->get_frame(), 8));
+    ASSERT_EQ_MSG(1, testable->get_error_count());
+
+    tearDown();
+}
+
+TEST(Decoder_frameTooLong) {
+    static char   smallBuffer[4 + COBSDecoder::CRC_SIZE];
+    COBSDecoder   decoder(smallBuffer);
+    setUp();
+
+    fill_record(5, MAX_RECORD + 1);
+    testable->send_array(record, 5);
+
+    COBSDecoder::ErrorCode err = COBSDecoder::NO_ERROR;
+    while (!loopback->is_empty() && COBSDecoder::NO_ERROR == err)
+        err = decoder.feed(loopback->get_char());
+    ASSERT_EQ_MSG(COBSDecoder::FRAME_TOO_LONG, err);
+
+    // Rest of the frame is skipped, next one decodes normally
+    testable->send_array(record, 4);
+    while (!decoder.frame_ready())
+        ASSERT_EQ_MSG(COBSDecoder::NO_ERROR, decoder.feed(loopback->get_char()));
+    ASSERT_EQ_MSG(4, decoder.get_length());
+
+    tearDown();
+}
+
+TEST(Decoder_ignoresRepeatedEndOfFrame) {
+    static char buffer[8 + COBSDecoder::CRC_SIZE];
+    COBSDecoder decoder(buffer);
+
+    ASSERT_EQ_MSG(COBSDecoder::NO_ERROR, decoder.feed(0));
+    ASSERT_EQ_MSG(COBSDecoder::NO_ERROR, decoder.feed(0));
+    ASSERT_FALSE(decoder.frame_ready());
+    ASSERT_EQ_MSG(0, decoder.get_error_count());
+    return true;
+}
+
+int main () {
+    START(FramedSerialTest);
+
+    RUN_TEST(CRC16_checkValue);
+    RUN_TEST(SendArray_onlyZeroIsEndOfFrame);
+    RUN_TEST(RoundTrip_empty);
+    RUN_TEST(RoundTrip_noZeros);
+    RUN_TEST(RoundTrip_allZeros);
+    RUN_TEST(RoundTrip_longerThanOneBlock);
+    RUN_TEST(RoundTrip_struct);
+    RUN_TEST(Receive_skipsCorruptFrame);
+    RUN_TEST(Receive_skipsFrameWithDroppedByte);
+    RUN_TEST(Decoder_frameTooLong);
+    RUN_TEST(Decoder_ignoresRepeatedEndOfFrame);
+
+    COMPLETE();
+}
@@ -0,0 +1,281 @@
+/**
+ * @file    heap_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/utility/allocator/heap.h>
+#include <PropWare/utility/allocator/heapmonitor.h>
+#include <PropWare/concurrent/lockservice.h>
+
+using PropWare::Heap;
+using PropWare::HeapStatistics;
+using PropWare::HeapMonitor;
+
+static uint32_t buffer[256];
+static Heap     *testable;
+static size_t   initialFree;
+
+SETUP {
+    testable    = new Heap(buffer);
+    initialFree = testable->get_capacity() - Heap::HEADER_SIZE;
+}
+
+TEARDOWN {
+    delete testable;
+}
+
+/**
+ * @brief   Size of the block that a request of `bytes` actually takes from the heap, header included
+ */
+static size_t block_size (const size_t bytes) {
+    return (Heap::HEADER_SIZE + bytes + Heap::ALIGNMENT - 1) / Heap::ALIGNMENT * Heap::ALIGNMENT;
+}
+
+TEST(Constructor_oneFreeBlock) {
+    setUp();
+
+    const HeapStatistics statistics = testable->inspect();
+    ASSERT_EQ_MSG(initialFree, statistics.freeBytes);
+    ASSERT_EQ_MSG(initialFree, statistics.largestBlock);
+    ASSERT_EQ_MSG(1, statistics.fragments);
+    ASSERT_EQ_MSG(1, statistics.histogram[HeapStatistics::get_size_class(initialFree)]);
+    ASSERT_TRUE(sizeof(buffer) - Heap::ALIGNMENT < testable->get_capacity());
+
+    tearDown();
+}
+
+TEST(Allocate_alignedAndOwned) {
+    setUp();
+
+    void *first  = testable->allocate(1);
+    void *second = testable->allocate(13);
+
+    ASSERT_NEQ_MSG(NULL, (uintptr_t) first);
+    ASSERT_NEQ_MSG(NULL, (uintptr_t) second);
+    ASSERT_EQ_MSG(0, (uintptr_t) first % Heap::ALIGNMENT);
+    ASSERT_EQ_MSG(0, (uintptr_t) second % Heap::ALIGNMENT);
+    ASSERT_TRUE(testable->owns(first));
+    ASSERT_TRUE(testable->owns(second));
+    ASSERT_FALSE(testable->owns(&initialFree));
+
+    // The blocks must not overlap
+    memset(first, 0xAA, 1);
+    memset(second, 0x55, 13);
+    ASSERT_EQ_MSG(0xAA, *(uint8_t *) first);
+
+    tearDown();
+}
+
+TEST(Allocate_largestBlockSucceedsOnce) {
+    setUp();
+
+    ASSERT_EQ_MSG(NULL, (uintptr_t) testable->allocate(initialFree + 1));
+
+    void *everything = testable->allocate(initialFree);
+    ASSERT_NEQ_MSG(NULL, (uintptr_t) everything);
+    ASSERT_EQ_MSG(NULL, (uintptr_t) testable->allocate(1));
+
+    const HeapStatistics statistics = testable->inspect();
+    ASSERT_EQ_MSG(0, statistics.freeBytes);
+    ASSERT_EQ_MSG(0, statistics.largestBlock);
+    ASSERT_EQ_MSG(0, statistics.fragments);
+
+    testable->deallocate(everything);
+    ASSERT_EQ_MSG(initialFree, testable->inspect().largestBlock);
+
+    tearDown();
+}
+
+TEST(Allocate_firstFitReusesHole) {
+    setUp();
+
+    testable->allocate(32);
+    void *hole = testable->allocate(64);
+    testable->allocate(32);
+    testable->deallocate(hole);
+
+    ASSERT_EQ_MSG((uintptr_t) hole, (uintptr_t) testable->allocate(48));
+
+    tearDown();
+}
+
+TEST(Deallocate_mergesWithBothNeighbors) {
+    setUp();
+
+    void *a = testable->allocate(32);
+    void *b = testable->allocate(32);
+    void *c = testable->allocate(32);
+    testable->allocate(32);
+
+    testable->deallocate(a);
+    testable->deallocate(c);
+    ASSERT_EQ_MSG(3, testable->inspect().fragments);
+
+    // Bridges the two holes on either side of it, leaving one hole in front of the last block and the rest of the heap
+    testable->deallocate(b);
+    const HeapStatistics statistics = testable->inspect();
+    ASSERT_EQ_MSG(2, statistics.fragments);
+    ASSERT_EQ_MSG((uintptr_t) a, (uintptr_t) testable->allocate(3 * block_size(32) - Heap::HEADER_SIZE));
+    ASSERT_EQ_MSG(initialFree - block_size(32) - Heap::HEADER_SIZE, statistics.freeBytes);
+
+    tearDown();
+}
+
+TEST(Deallocate_everythingRestoresOneBlock) {
+    void *blocks[8];
+    setUp();
+
+    for (unsigned int i = 0; i < 8; ++i)
+        blocks[i] = testable->allocate(8 + 8 * i);
+    // Out of order, so that every kind of merge happens
+    for (unsigned int i = 0; i < 8; i += 2)
+        testable->deallocate(blocks[i]);
+    for (unsigned int i = 7; i < 8; i -= 2)
+        testable->deallocate(blocks[i]);
+
+    const HeapStatistics statistics = testable->inspect();
+    ASSERT_EQ_MSG(1, statistics.fragments);
+    ASSERT_EQ_MSG(initialFree, statistics.freeBytes);
+
+    tearDown();
+}
+
+TEST(Inspect_histogramCountsEveryFragment) {
+    void *blocks[6];
+    setUp();
+
+    for (unsigned int i = 0; i < 6; ++i)
+        blocks[i] = testable->allocate(100);
+    testable->deallocate(blocks[1]);
+    testable->deallocate(blocks[3]);
+
+    const HeapStatistics statistics = testable->inspect();
+    const size_t         hole       = block_size(100) - Heap::HEADER_SIZE;
+    ASSERT_EQ_MSG(3, statistics.fragments);
+    ASSERT_EQ_MSG(2, statistics.histogram[HeapStatistics::get_size_class(hole)]);
+
+    size_t counted = 0;
+    for (unsigned int i = 0; i < HeapStatistics::SIZE_CLASSES; ++i)
+        counted += statistics.histogram[i];
+    ASSERT_EQ_MSG(statistics.fragments, counted);
+
+    tearDown();
+}
+
+TEST(SizeClass_isPositionOfMostSignificantBit) {
+    setUp();
+
+    ASSERT_EQ_MSG(0, HeapStatistics::get_size_class(0));
+    ASSERT_EQ_MSG(0, HeapStatistics::get_size_class(1));
+    ASSERT_EQ_MSG(1, HeapStatistics::get_size_class(2));
+    ASSERT_EQ_MSG(1, HeapStatistics::get_size_class(3));
+    ASSERT_EQ_MSG(9, HeapStatistics::get_size_class(1023));
+    ASSERT_EQ_MSG(10, HeapStatistics::get_size_class(1024));
+    ASSERT_EQ_MSG(HeapStatistics::SIZE_CLASSES - 1, HeapStatistics::get_size_class(0x7FFFFFFF));
+
+    tearDown();
+}
+
+TEST(Lock_isReleased) {
+    uint32_t             heapBuffer[32];
+    PropWare::TicketLock lock;
+    Heap                 heap(heapBuffer, lock);
+    setUp();
+
+    void *block = heap.allocate(16);
+    ASSERT_FALSE(lock.is_locked());
+    heap.deallocate(block);
+    ASSERT_FALSE(lock.is_locked());
+    heap.inspect();
+    ASSERT_FALSE(lock.is_locked());
+
+    tearDown();
+}
+
+static unsigned int   hookCalls;
+static HeapStatistics lastStatistics;
+
+static void record_statistics (const HeapStatistics &statistics, void *context) {
+    ++hookCalls;
+    lastStatistics = statistics;
+    *static_cast<int *>(context) = 42;
+}
+
+TEST(HeapMonitor_pollWaitsForPeriod) {
+    static const uint32_t stack[32] = {0};
+    int                   context   = 0;
+    setUp();
+    hookCalls = 0;
+
+    HeapMonitor monitor(stack, *testable, record_statistics, &context, SECOND);
+    ASSERT_FALSE(monitor.poll());
+    ASSERT_EQ_MSG(0, hookCalls);
+
+    void *block = testable->allocate(100);
+    monitor.inspect();
+    ASSERT_EQ_MSG(1, hookCalls);
+    ASSERT_EQ_MSG(42, context);
+    ASSERT_EQ_MSG(testable->inspect().largestBlock, lastStatistics.largestBlock);
+    ASSERT_EQ_MSG(lastStatistics.largestBlock, monitor.get_smallest_largest_block());
+
+    testable->deallocate(block);
+    monitor.inspect();
+    ASSERT_EQ_MSG(2, monitor.get_inspection_count());
+    // Still the worst seen, not the latest
+    ASSERT_TRUE(monitor.get_smallest_largest_block() < lastStatistics.largestBlock);
+
+    tearDown();
+}
+
+TEST(HeapMonitor_pollAfterPeriod) {
+    static const uint32_t stack[32] = {0};
+    int                   context   = 0;
+    setUp();
+    hookCalls = 0;
+
+    HeapMonitor monitor(stack, *testable, record_statistics, &context, 0);
+    ASSERT_TRUE(monitor.poll());
+    ASSERT_EQ_MSG(1, hookCalls);
+    ASSERT_EQ_MSG(initialFree, lastStatistics.freeBytes);
+
+    tearDown();
+}
+
+int main () {
+    START(HeapTest);
+
+    RUN_TEST(Constructor_oneFreeBlock);
+    RUN_TEST(Allocate_alignedAndOwned);
+    RUN_TEST(Allocate_largestBlockSucceedsOnce);
+    RUN_TEST(Allocate_firstFitReusesHole);
+    RUN_TEST(Deallocate_mergesWithBothNeighbors);
+    RUN_TEST(Deallocate_everythingRestoresOneBlock);
+    RUN_TEST(Inspect_histogramCountsEveryFragment);
+    RUN_TEST(SizeClass_isPositionOfMostSignificantBit);
+    RUN_TEST(Lock_isReleased);
+    RUN_TEST(HeapMonitor_pollWaitsForPeriod);
+    RUN_TEST(HeapMonitor_pollAfterPeriod);
+
+    COMPLETE();
+}
@@ -0,0 +1,344 @@
+/**
+ * @file    lockservice_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/concurrent/lockservice.h>
+#include <PropWare/concurrent/latch.h>
+#include <PropWare/concurrent/lockreference.h>
+#include <PropWare/concurrent/runnable.h>
+#include <PropWare/utility/collection/queue.h>
+
+using PropWare::HardwareLock;
+using PropWare::LockReference;
+using PropWare::LockService;
+using PropWare::ReadWriteLock;
+using PropWare::TicketLock;
+
+static const unsigned int WORKERS    = 3;
+static const unsigned int INCREMENTS = 2000;
+
+static uint32_t stacks[WORKERS][128];
+
+/**
+ * @brief   Increments a shared counter with a read-modify-write sequence that only the lock keeps correct
+ */
+template<typename Lock>
+class Incrementer : public PropWare::Runnable {
+    public:
+        Incrementer (const uint32_t (&stack)[128], Lock &lock, volatile uint32_t &counter)
+                : Runnable(stack),
+                  m_lock(&lock),
+                  m_counter(&counter),
+                  m_done(false) {
+        }
+
+        void run () {
+            for (unsigned int i = 0; i < INCREMENTS; ++i) {
+                this->m_lock->lock();
+                const uint32_t value = *this->m_counter;
+                // Give the other cogs every chance to interleave if mutual exclusion is broken
+                waitcnt(600 + CNT);
+                *this->m_counter = value + 1;
+                this->m_lock->unlock();
+            }
+            this->m_done = true;
+            cogstop(cogid());
+        }
+
+        bool is_done () const {
+            return this->m_done;
+        }
+
+    private:
+        Lock              *m_lock;
+        volatile uint32_t *m_counter;
+        volatile bool     m_done;
+};
+
+template<typename Lock>
+uint32_t run_incrementers (Lock &lock) {
+    volatile uint32_t counter = 0;
+
+    Incrementer<Lock> worker0(stacks[0], lock, counter);
+    Incrementer<Lock> worker1(stacks[1], lock, counter);
+    Incrementer<Lock> worker2(stacks[2], lock, counter);
+    PropWare::Runnable::invoke(worker0);
+    PropWare::Runnable::invoke(worker1);
+    PropWare::Runnable::invoke(worker2);
+    while (!(worker0.is_done() && worker1.is_done() && worker2.is_done()));
+
+    return counter;
+}
+
+TEARDOWN {
+}
+
+TEST(HardwareLock_tryLock) {
+    HardwareLock testable;
+
+    ASSERT_TRUE(testable.is_valid());
+    ASSERT_TRUE(testable.try_lock());
+    ASSERT_FALSE(testable.try_lock());
+    testable.unlock();
+    ASSERT_TRUE(testable.try_lock());
+    testable.unlock();
+
+    tearDown();
+}
+
+TEST(HardwareLock_returnsLockWhenDestroyed) {
+    int lockNumber;
+    {
+        HardwareLock testable;
+        lockNumber = testable.get_lock_number();
+    }
+
+    // The lock that was just returned is the first free one again
+    HardwareLock testable;
+    ASSERT_EQ_MSG(lockNumber, testable.get_lock_number());
+
+    tearDown();
+}
+
+TEST(HardwareLock_none) {
+    HardwareLock testable(HardwareLock::NONE);
+
+    ASSERT_FALSE(testable.is_valid());
+
+    tearDown();
+}
+
+TEST(LockService_unavailableUntilAHardwareLockIsFree) {
+    {
+        // Take every hardware lock still free, before anything has asked LockService for one
+        HardwareLock hardwareLocks[8];
+
+        TicketLock      ticketLock;
+        ReadWriteLock   readWriteLock;
+        PropWare::Latch latch(1);
+        ASSERT_FALSE(LockService::is_available());
+        ASSERT_FALSE(ticketLock.is_valid());
+        ASSERT_FALSE(readWriteLock.is_valid());
+        ASSERT_FALSE(latch.is_valid());
+    }
+
+    // The failure was not remembered
+    ASSERT_TRUE(LockService::is_available());
+    TicketLock ticketLock;
+    ASSERT_TRUE(ticketLock.is_valid());
+
+    tearDown();
+}
+
+TEST(LockService_manySoftwareLocksShareOneHardwareLock) {
+    // More software locks than there are hardware locks
+    TicketLock    ticketLocks[10];
+    ReadWriteLock readWriteLocks[10];
+
+    const int sharedLock = LockService::get_lock();
+    ASSERT_NEQ_MSG(HardwareLock::NONE, sharedLock);
+    for (unsigned int i = 0; i < 10; ++i) {
+        ASSERT_EQ_MSG(sharedLock, ticketLocks[i].m_serviceLock);
+        ASSERT_EQ_MSG(sharedLock, readWriteLocks[i].m_serviceLock);
+    }
+
+    // Each is still a separate lock
+    for (unsigned int i = 0; i < 10; ++i)
+        ASSERT_TRUE(ticketLocks[i].try_lock());
+    for (unsigned int i = 0; i < 10; ++i)
+        ticketLocks[i].unlock();
+
+    tearDown();
+}
+
+TEST(TicketLock_tryLock) {
+    TicketLock testable;
+
+    ASSERT_TRUE(testable.is_valid());
+    ASSERT_FALSE(testable.is_locked());
+    ASSERT_TRUE(testable.try_lock());
+    ASSERT_TRUE(testable.is_locked());
+    ASSERT_FALSE(testable.try_lock());
+    testable.unlock();
+    ASSERT_FALSE(testable.is_locked());
+    ASSERT_TRUE(testable.try_lock());
+    testable.unlock();
+
+    tearDown();
+}
+
+TEST(TicketLock_lockAfterUnlock) {
+    TicketLock testable;
+
+    for (unsigned int i = 0; i < 5; ++i) {
+        testable.lock();
+        ASSERT_TRUE(testable.is_locked());
+        testable.unlock();
+    }
+    ASSERT_EQ_MSG(5, testable.m_serving);
+    ASSERT_FALSE(testable.is_locked());
+
+    tearDown();
+}
+
+TEST(TicketLock_countersWrapAround) {
+    TicketLock testable;
+    testable.m_next    = 0xFFFFFFFF;
+    testable.m_serving = 0xFFFFFFFF;
+
+    testable.lock();
+    testable.unlock();
+    ASSERT_EQ_MSG(0, testable.m_serving);
+    ASSERT_TRUE(testable.try_lock());
+    testable.unlock();
+
+    tearDown();
+}
+
+TEST(ReadWriteLock_manyReaders) {
+    ReadWriteLock testable;
+
+    ASSERT_TRUE(testable.is_valid());
+    testable.lock_shared();
+    ASSERT_TRUE(testable.try_lock_shared());
+    ASSERT_EQ_MSG(2, testable.get_reader_count());
+    ASSERT_FALSE(testable.try_lock());
+
+    testable.unlock_shared();
+    ASSERT_FALSE(testable.try_lock());
+    testable.unlock_shared();
+    ASSERT_EQ_MSG(0, testable.get_reader_count());
+
+    tearDown();
+}
+
+TEST(ReadWriteLock_writerExcludesEveryone) {
+    ReadWriteLock testable;
+
+    testable.lock();
+    ASSERT_TRUE(testable.is_write_locked());
+    ASSERT_EQ_MSG(0, testable.get_reader_count());
+    ASSERT_FALSE(testable.try_lock());
+    ASSERT_FALSE(testable.try_lock_shared());
+
+    testable.unlock();
+    ASSERT_FALSE(testable.is_write_locked());
+    ASSERT_TRUE(testable.try_lock_shared());
+    testable.unlock_shared();
+
+    tearDown();
+}
+
+TEST(ReadWriteLock_waitingWriterKeepsNewReadersOut) {
+    ReadWriteLock testable;
+
+    testable.lock_shared();
+    // What PropWare::ReadWriteLock::lock does before it waits for the reader to leave
+    testable.m_writersWaiting = 1;
+    ASSERT_FALSE(testable.try_lock_shared());
+
+    testable.m_writersWaiting = 0;
+    testable.unlock_shared();
+
+    tearDown();
+}
+
+TEST(LockReference_wrapsAnyLock) {
+    TicketLock    lock;
+    LockReference testable(lock);
+
+    ASSERT_TRUE(testable.is_bound());
+    ASSERT_TRUE(testable.refers_to(lock));
+    testable.lock();
+    ASSERT_TRUE(lock.is_locked());
+    testable.unlock();
+    ASSERT_FALSE(lock.is_locked());
+
+    ASSERT_FALSE(LockReference().is_bound());
+
+    tearDown();
+}
+
+TEST(Queue_withSoftwareLock) {
+    int                              array[4];
+    PropWare::Queue<int, TicketLock> testable(array);
+
+    testable.enqueue(1).enqueue(2);
+    ASSERT_EQ_MSG(1, testable.dequeue());
+    ASSERT_EQ_MSG(2, testable.dequeue());
+    ASSERT_FALSE(testable.m_lock.is_locked());
+
+    tearDown();
+}
+
+TEST(HardwareLock_mutualExclusionAcrossCogs) {
+    HardwareLock lock;
+
+    ASSERT_EQ_MSG(WORKERS * INCREMENTS, run_incrementers(lock));
+
+    tearDown();
+}
+
+TEST(TicketLock_mutualExclusionAcrossCogs) {
+    TicketLock lock;
+
+    ASSERT_EQ_MSG(WORKERS * INCREMENTS, run_incrementers(lock));
+    ASSERT_FALSE(lock.is_locked());
+
+    tearDown();
+}
+
+TEST(ReadWriteLock_mutualExclusionAcrossCogs) {
+    ReadWriteLock lock;
+
+    ASSERT_EQ_MSG(WORKERS * INCREMENTS, run_incrementers(lock));
+    ASSERT_FALSE(lock.is_write_locked());
+
+    tearDown();
+}
+
+int main () {
+    START(LockServiceTest);
+
+    // Must come first: it needs LockService's hardware lock not to have been allocated yet
+    RUN_TEST(LockService_unavailableUntilAHardwareLockIsFree);
+    RUN_TEST(HardwareLock_tryLock);
+    RUN_TEST(HardwareLock_returnsLockWhenDestroyed);
+    RUN_TEST(HardwareLock_none);
+    RUN_TEST(LockService_manySoftwareLocksShareOneHardwareLock);
+    RUN_TEST(TicketLock_tryLock);
+    RUN_TEST(TicketLock_lockAfterUnlock);
+    RUN_TEST(TicketLock_countersWrapAround);
+    RUN_TEST(ReadWriteLock_manyReaders);
+    RUN_TEST(ReadWriteLock_writerExcludesEveryone);
+    RUN_TEST(ReadWriteLock_waitingWriterKeepsNewReadersOut);
+    RUN_TEST(LockReference_wrapsAnyLock);
+    RUN_TEST(Queue_withSoftwareLock);
+    RUN_TEST(HardwareLock_mutualExclusionAcrossCogs);
+    RUN_TEST(TicketLock_mutualExclusionAcrossCogs);
+    RUN_TEST(ReadWriteLock_mutualExclusionAcrossCogs);
+
+    COMPLETE();
+}
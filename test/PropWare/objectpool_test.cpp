@@ -0,0 +1,211 @@
+/**
+ * @file    objectpool_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/utility/allocator/objectpool.h>
+#include <PropWare/concurrent/lockservice.h>
+
+static const size_t CAPACITY = 4;
+
+/**
+ * @brief   Counts constructions and destructions so the tests can see that the pool runs both
+ */
+class Widget {
+    public:
+        static int instances;
+
+    public:
+        Widget (const int id, const char tag)
+                : m_id(id),
+                  m_tag(tag) {
+            ++instances;
+        }
+
+        ~Widget () {
+            --instances;
+        }
+
+    public:
+        int  m_id;
+        char m_tag;
+};
+
+int Widget::instances = 0;
+
+typedef PropWare::ObjectPool<Widget, CAPACITY> Pool;
+
+static Pool *testable;
+
+SETUP {
+    Widget::instances = 0;
+    testable = new Pool();
+}
+
+TEARDOWN {
+    delete testable;
+}
+
+TEST(Constructor_allBlocksAvailable) {
+    setUp();
+
+    ASSERT_EQ_MSG(CAPACITY, testable->get_capacity());
+    ASSERT_EQ_MSG(CAPACITY, testable->get_available());
+    ASSERT_EQ_MSG(0, testable->get_high_water_mark());
+
+    tearDown();
+}
+
+TEST(Create_constructsInBlock) {
+    setUp();
+
+    Widget *widget = testable->create(7, 'w');
+    ASSERT_NEQ_MSG(NULL, (uintptr_t) widget);
+    ASSERT_TRUE(testable->owns(widget));
+    ASSERT_EQ_MSG(7, widget->m_id);
+    ASSERT_EQ_MSG('w', widget->m_tag);
+    ASSERT_EQ_MSG(1, Widget::instances);
+    ASSERT_EQ_MSG(CAPACITY - 1, testable->get_available());
+
+    testable->destroy(widget);
+    ASSERT_EQ_MSG(0, Widget::instances);
+    ASSERT_EQ_MSG(CAPACITY, testable->get_available());
+
+    tearDown();
+}
+
+TEST(Create_failsWhenEmpty) {
+    Widget *widgets[CAPACITY];
+    setUp();
+
+    for (size_t i = 0; i < CAPACITY; ++i) {
+        widgets[i] = testable->create((int) i, 'x');
+        ASSERT_NEQ_MSG(NULL, (uintptr_t) widgets[i]);
+    }
+    ASSERT_EQ_MSG(0, testable->get_available());
+    ASSERT_EQ_MSG(NULL, (uintptr_t) testable->create(99, 'x'));
+    ASSERT_EQ_MSG((int) CAPACITY, Widget::instances);
+
+    // Every block is distinct
+    for (size_t i = 0; i < CAPACITY; ++i)
+        for (size_t j = i + 1; j < CAPACITY; ++j)
+            ASSERT_NEQ_MSG((uintptr_t) widgets[i], (uintptr_t) widgets[j]);
+
+    for (size_t i = 0; i < CAPACITY; ++i)
+        testable->destroy(widgets[i]);
+
+    tearDown();
+}
+
+TEST(Destroy_blockIsReusedFirst) {
+    setUp();
+
+    Widget *first = testable->create(1, 'a');
+    testable->create(2, 'b');
+    testable->destroy(first);
+
+    ASSERT_EQ_MSG((uintptr_t) first, (uintptr_t) testable->create(3, 'c'));
+
+    tearDown();
+}
+
+TEST(Destroy_null) {
+    setUp();
+
+    testable->destroy(NULL);
+    testable->deallocate(NULL);
+    ASSERT_EQ_MSG(CAPACITY, testable->get_available());
+
+    tearDown();
+}
+
+TEST(HighWaterMark_remembersPeak) {
+    setUp();
+
+    Widget *a = testable->create(1, 'a');
+    Widget *b = testable->create(2, 'b');
+    Widget *c = testable->create(3, 'c');
+    testable->destroy(b);
+    testable->destroy(c);
+    testable->destroy(a);
+
+    ASSERT_EQ_MSG(3, testable->get_high_water_mark());
+    ASSERT_EQ_MSG(CAPACITY, testable->get_available());
+
+    tearDown();
+}
+
+TEST(Allocate_rejectsOversizedRequests) {
+    setUp();
+
+    PropWare::Allocator &allocator = *testable;
+    ASSERT_EQ_MSG(NULL, (uintptr_t) allocator.allocate(Pool::BLOCK_SIZE + 1));
+
+    void *block = allocator.allocate(Pool::BLOCK_SIZE);
+    ASSERT_NEQ_MSG(NULL, (uintptr_t) block);
+    ASSERT_TRUE(testable->owns(block));
+    allocator.deallocate(block);
+    ASSERT_EQ_MSG(CAPACITY, testable->get_available());
+
+    tearDown();
+}
+
+TEST(Owns_rejectsForeignAddresses) {
+    int local;
+    setUp();
+
+    ASSERT_FALSE(testable->owns(&local));
+    ASSERT_FALSE(testable->owns(NULL));
+
+    tearDown();
+}
+
+TEST(Create_withSoftwareLock) {
+    PropWare::ObjectPool<Widget, CAPACITY, PropWare::TicketLock> pool;
+    setUp();
+
+    Widget *widget = pool.create(5, 'l');
+    ASSERT_EQ_MSG(5, widget->m_id);
+    ASSERT_FALSE(pool.m_lock.is_locked());
+    pool.destroy(widget);
+    ASSERT_EQ_MSG(CAPACITY, pool.get_available());
+
+    tearDown();
+}
+
+int main () {
+    START(ObjectPoolTest);
+
+    RUN_TEST(Constructor_allBlocksAvailable);
+    RUN_TEST(Create_constructsInBlock);
+    RUN_TEST(Create_failsWhenEmpty);
+    RUN_TEST(Destroy_blockIsReusedFirst);
+    RUN_TEST(Destroy_null);
+    RUN_TEST(HighWaterMark_remembersPeak);
+    RUN_TEST(Allocate_rejectsOversizedRequests);
+    RUN_TEST(Owns_rejectsForeignAddresses);
+    RUN_TEST(Create_withSoftwareLock);
+
+    COMPLETE();
+}
@@ -0,0 +1,113 @@
+/**
+ * @file    printer_benchmark.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareBenchmarks.h"
+
+/**
+ * @brief   Counts and discards everything printed to it, so that only the cost of formatting is measured
+ */
+class NullPrintCapable : public PropWare::PrintCapable {
+    public:
+        NullPrintCapable ()
+                : m_count(0) {
+        }
+
+        virtual void put_char (const char c) {
+            ++this->m_count;
+        }
+
+        virtual void puts (const char string[]) {
+            while (*string++)
+                ++this->m_count;
+        }
+
+        /**
+         * @brief   Number of characters received since the last call
+         */
+        uint32_t take_count () {
+            const uint32_t count = this->m_count;
+            this->m_count = 0;
+            return count;
+        }
+
+    protected:
+        volatile uint32_t m_count;
+};
+
+static NullPrintCapable  sink;
+static PropWare::Printer printer(sink, false);
+
+// Volatile, so that the compiler can not format anything ahead of time
+static volatile int      integer         = -123456;
+static volatile uint32_t unsignedInteger = 0xBEEF;
+static volatile double   real            = 3.14159;
+
+/*
+ * Each benchmark prints once before MEASURE, untimed, to find out how many bytes one run produces
+ */
+
+BENCHMARK(Printer_putInt) {
+    printer.put_int(integer);
+    benchmark.set_bytes(sink.take_count());
+    MEASURE printer.put_int(integer);
+}
+
+BENCHMARK(Printer_printfThreeIntegers) {
+    printer.printf("x=%d y=%5u z=0x%08X\n", integer, unsignedInteger, unsignedInteger);
+    benchmark.set_bytes(sink.take_count());
+    MEASURE printer.printf("x=%d y=%5u z=0x%08X\n", integer, unsignedInteger, unsignedInteger);
+}
+
+BENCHMARK(Printer_compiledFormatThreeIntegers) {
+    const int      x = integer;
+    const uint32_t y = unsignedInteger;
+    printer.printf(PW_FMT("x=%d y=%5u z=0x%08X\n"), x, y, y);
+    benchmark.set_bytes(sink.take_count());
+    MEASURE printer.printf(PW_FMT("x=%d y=%5u z=0x%08X\n"), x, y, y);
+}
+
+BENCHMARK(Printer_streamString) {
+    printer << "The quick brown fox jumps over the lazy dog\n";
+    benchmark.set_bytes(sink.take_count());
+    MEASURE printer << "The quick brown fox jumps over the lazy dog\n";
+}
+
+BENCHMARK(Printer_putFloat) {
+    printer.put_float(real, 0, 4);
+    benchmark.set_bytes(sink.take_count());
+    MEASURE printer.put_float(real, 0, 4);
+}
+
+int main () {
+    START_BENCHMARKS(PrinterBenchmark);
+
+    RUN_BENCHMARK(Printer_putInt);
+    RUN_BENCHMARK(Printer_printfThreeIntegers);
+    RUN_BENCHMARK(Printer_compiledFormatThreeIntegers);
+    RUN_BENCHMARK(Printer_streamString);
+    RUN_BENCHMARK(Printer_putFloat);
+
+    COMPLETE_BENCHMARKS();
+}
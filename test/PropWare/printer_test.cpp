@@ -0,0 +1,388 @@
+/**
+ * @file    printer_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include "CapturingPrintCapable.h"
+#include <string.h>
+
+static CapturingPrintCapable *expected;
+static CapturingPrintCapable *actual;
+static PropWare::Printer     *runtimePrinter;
+static PropWare::Printer     *testable;
+
+SETUP {
+    expected       = new CapturingPrintCapable();
+    actual         = new CapturingPrintCapable();
+    runtimePrinter = new PropWare::Printer(*expected, false);
+    testable       = new PropWare::Printer(*actual, false);
+}
+
+TEARDOWN {
+    delete testable;
+    delete runtimePrinter;
+    delete actual;
+    delete expected;
+    testable       = NULL;
+    runtimePrinter = NULL;
+    actual         = NULL;
+    expected       = NULL;
+}
+
+TEST(CompiledFormat_countsArguments) {
+    const auto none  = PW_FMT("no conversions, 100%% literal");
+    const auto three = PW_FMT("%d, %05.2f and %s");
+    ASSERT_EQ_MSG(0, none.ARGUMENTS);
+    ASSERT_EQ_MSG(3, three.ARGUMENTS);
+    return true;
+}
+
+TEST(CompiledFormat_literalOnly) {
+    setUp();
+
+    testable->printf(PW_FMT("Hello, world!\n"));
+    ASSERT_EQ_MSG(0, strcmp("Hello, world!\n", actual->get_output()));
+    ASSERT_EQ_MSG(1, actual->get_calls());
+
+    tearDown();
+}
+
+TEST(CompiledFormat_matchesRuntimePrintf) {
+    const int          x    = -42;
+    const unsigned int y    = 0xBEEF;
+    const char         c    = 'G';
+    const char         *s   = "David";
+    setUp();
+
+    runtimePrinter->printf("x=%5d y=%X\n", x, y);
+    testable->printf(PW_FMT("x=%5d y=%X\n"), x, y);
+    ASSERT_EQ_MSG(0, strcmp(expected->get_output(), actual->get_output()));
+
+    expected->clear();
+    actual->clear();
+    runtimePrinter->printf("%s: %c %08b 100%% %u", s, c, 5, 7u);
+    testable->printf(PW_FMT("%s: %c %08b 100%% %u"), s, c, 5, 7u);
+    ASSERT_EQ_MSG(0, strcmp(expected->get_output(), actual->get_output()));
+
+    expected->clear();
+    actual->clear();
+    runtimePrinter->printf("%.3f", 2.5);
+    testable->printf(PW_FMT("%.3f"), 2.5);
+    ASSERT_EQ_MSG(0, strcmp(expected->get_output(), actual->get_output()));
+
+    tearDown();
+}
+
+TEST(CompiledFormat_fewerCallsForLiterals) {
+    setUp();
+
+    runtimePrinter->printf("Value: %d units\n", 3);
+    testable->printf(PW_FMT("Value: %d units\n"), 3);
+    ASSERT_EQ_MSG(0, strcmp(expected->get_output(), actual->get_output()));
+    // "Value: ", the digit and " units\n"
+    ASSERT_EQ_MSG(3, actual->get_calls());
+    ASSERT_TRUE(actual->get_calls() < expected->get_calls());
+
+    tearDown();
+}
+
+TEST(CompiledFormat_cookedLiteralsInOneCall) {
+    setUp();
+
+    runtimePrinter->set_cooked(true);
+    testable->set_cooked(true);
+    runtimePrinter->printf("Value:\n%d units\n", 3);
+    testable->printf(PW_FMT("Value:\n%d units\n"), 3);
+    ASSERT_EQ_MSG(0, strcmp("Value:\r\n3 units\r\n", actual->get_output()));
+    ASSERT_EQ_MSG(0, strcmp(expected->get_output(), actual->get_output()));
+    // "Value:\r\n", the digit and " units\r\n"
+    ASSERT_EQ_MSG(3, actual->get_calls());
+
+    tearDown();
+}
+
+TEST(CompiledFormat_escapedPercentAfterLastConversion) {
+    setUp();
+
+    testable->printf(PW_FMT("%u%%"), 7u);
+    ASSERT_EQ_MSG(0, strcmp("7%", actual->get_output()));
+
+    tearDown();
+}
+
+TEST(CompiledFormat_64BitIntegers) {
+    setUp();
+
+    testable->printf(PW_FMT("%d %u"), -12345678901LL, 0x123456789ULL);
+    ASSERT_EQ_MSG(0, strcmp("-12345678901 4886718345", actual->get_output()));
+
+    tearDown();
+}
+
+TEST(PutUint_radix10) {
+    setUp();
+
+    testable->put_uint(0);
+    testable->put_char(' ');
+    testable->put_uint(7);
+    testable->put_char(' ');
+    testable->put_uint(1234567890);
+    testable->put_char(' ');
+    testable->put_uint(4294967295U);
+    ASSERT_EQ_MSG(0, strcmp("0 7 1234567890 4294967295", actual->get_output()));
+
+    tearDown();
+}
+
+TEST(PutUint_powerOfTwoRadix) {
+    setUp();
+
+    testable->put_uint(0xDEADBEEF, 16);
+    testable->put_char(' ');
+    testable->put_uint(0x80000001, 2);
+    testable->put_char(' ');
+    testable->put_uint(0777, 8);
+    ASSERT_EQ_MSG(0, strcmp("DEADBEEF 10000000000000000000000000000001 777", actual->get_output()));
+
+    tearDown();
+}
+
+TEST(PutUint_otherRadix) {
+    setUp();
+
+    testable->put_uint(35, 36);
+    testable->put_char(' ');
+    testable->put_uint(4294967295U, 3);
+    ASSERT_EQ_MSG(0, strcmp("Z 102002022201221111210", actual->get_output()));
+
+    tearDown();
+}
+
+TEST(PutUint_singleCall) {
+    setUp();
+
+    testable->put_uint(1234567890);
+    ASSERT_EQ_MSG(1, actual->get_calls());
+
+    actual->clear();
+    testable->put_uint(0xBEEF, 16, 8, '0');
+    ASSERT_EQ_MSG(0, strcmp("0000BEEF", actual->get_output()));
+    ASSERT_EQ_MSG(1, actual->get_calls());
+
+    tearDown();
+}
+
+TEST(PutUint_widthLargerThanBuffer) {
+    setUp();
+
+    testable->put_uint(42, 10, 40, '.');
+    ASSERT_EQ_MSG(40, strlen(actual->get_output()));
+    ASSERT_EQ_MSG(0, strcmp("......................................42", actual->get_output()));
+
+    tearDown();
+}
+
+TEST(PutInt_signBeforePadding) {
+    setUp();
+
+    testable->put_int(-42, 10, 5);
+    testable->put_char('|');
+    testable->put_int(-2147483647 - 1);
+    ASSERT_EQ_MSG(0, strcmp("-   42|-2147483648", actual->get_output()));
+
+    tearDown();
+}
+
+TEST(PutUll) {
+    setUp();
+
+    testable->put_ull(18446744073709551615ULL);
+    testable->put_char(' ');
+    testable->put_ull(10000000000000000000ULL);
+    testable->put_char(' ');
+    testable->put_ull(0xFEDCBA9876543210ULL, 16);
+    testable->put_char(' ');
+    testable->put_ll(-9223372036854775807LL, 10, 21, '0');
+    ASSERT_EQ_MSG(0, strcmp("18446744073709551615 10000000000000000000 FEDCBA9876543210 -009223372036854775807",
+                            actual->get_output()));
+
+    tearDown();
+}
+
+TEST(Print_64BitIntegers) {
+    setUp();
+
+    testable->print(4886718345ULL);
+    testable->print(' ');
+    testable->print(-12345678901LL);
+    ASSERT_EQ_MSG(0, strcmp("4886718345 -12345678901", actual->get_output()));
+
+    tearDown();
+}
+
+TEST(PutUint_cookedNewlineFill) {
+    setUp();
+
+    const PropWare::Printer cooked(*actual, true);
+    cooked.put_uint(5, 10, 2, '\n');
+    ASSERT_EQ_MSG(0, strcmp("\r\n5", actual->get_output()));
+
+    tearDown();
+}
+
+TEST(PutFloat_matchesHostPrintf) {
+    // Expected strings were produced by a PC's printf("%.*f", precision, value)
+    const struct {
+        float       value;
+        uint16_t    precision;
+        const char *expected;
+    } cases[] = {
+            {0.0f, 6, "0.000000"},
+            {1.0f, 0, "1"},
+            {-1.5f, 3, "-1.500"},
+            {3.14159265f, 9, "3.141592741"},
+            {0.1f, 9, "0.100000001"},
+            {123456.789f, 3, "123456.789"},
+            {1e-5f, 9, "0.000010000"},
+            {2.5f, 0, "2"},
+            {3.5f, 0, "4"},
+            {0.125f, 2, "0.12"},
+            {0.375f, 2, "0.38"},
+            {9.9999f, 3, "10.000"},
+            {-0.0004f, 3, "-0.000"},
+            {16777216.0f, 1, "16777216.0"},
+            {4294967296.0f, 2, "4294967296.00"},
+            {1e20f, 1, "100000002004087734272.0"},
+            {3.4028235e38f, 0, "340282346638528859811704183484516925440"},
+            {1.4e-45f, 9, "0.000000000"}
+    };
+    setUp();
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        actual->clear();
+        testable->put_float(cases[i].value, 0, cases[i].precision);
+        ASSERT_EQ_MSG(0, strcmp(cases[i].expected, actual->get_output()));
+    }
+
+    tearDown();
+}
+
+TEST(PutFloat_widthAndFill) {
+    setUp();
+
+    testable->put_float(-2.25, 8, 2);
+    testable->put_char('|');
+    testable->put_float(-2.25, 8, 2, '0');
+    testable->put_char('|');
+    testable->put_float(12.5, 3, 1);
+    ASSERT_EQ_MSG(0, strcmp("   -2.25|-0002.25|12.5", actual->get_output()));
+
+    tearDown();
+}
+
+TEST(PutFloat_notANumber) {
+    union {
+        uint32_t bits;
+        float    value;
+    } nan;
+    nan.bits = 0x7FC00000;
+    setUp();
+
+    testable->put_float(nan.value);
+    testable->put_char('|');
+    testable->put_float(-1e30 * 1e30, 5);
+    ASSERT_EQ_MSG(0, strcmp("nan| -inf", actual->get_output()));
+
+    tearDown();
+}
+
+TEST(PutFixed) {
+    setUp();
+
+    testable->put_fixed(PropWare::Q16::from_raw(0x00018000), 0, 3);
+    testable->put_char('|');
+    testable->put_fixed(PropWare::Q16(-21.4375), 8, 2);
+    testable->put_char('|');
+    testable->put_fixed(PropWare::Q16::from_raw((int32_t) 0x80000000), 0, 9);
+    testable->put_char('|');
+    testable->put_fixed(PropWare::Q16::from_raw(1), 0, 9);
+    ASSERT_EQ_MSG(0, strcmp("1.500|  -21.44|-32768.000000000|0.000015259", actual->get_output()));
+
+    tearDown();
+}
+
+TEST(Print_fixedUsesFormat) {
+    setUp();
+
+    testable->print(PropWare::Fixed<8>(3.75), PropWare::Printer::Format(6, '0', 10, 1));
+    testable->put_char('|');
+    *testable << PropWare::Q16(0.5);
+    ASSERT_EQ_MSG(0, strcmp("0003.8|0.500000", actual->get_output()));
+
+    tearDown();
+}
+
+TEST(PutDecimal) {
+    setUp();
+
+    testable->put_decimal(-1205, 3);
+    testable->put_char('|');
+    testable->put_decimal(5, 3);
+    testable->put_char('|');
+    testable->put_decimal(42, 0, 4, '0');
+    testable->put_char('|');
+    testable->put_decimal(-7, 1, 6, '0');
+    ASSERT_EQ_MSG(0, strcmp("-1.205|0.005|0042|-000.7", actual->get_output()));
+
+    tearDown();
+}
+
+int main () {
+    START(PrinterTest);
+
+    RUN_TEST(CompiledFormat_countsArguments);
+    RUN_TEST(CompiledFormat_literalOnly);
+    RUN_TEST(CompiledFormat_matchesRuntimePrintf);
+    RUN_TEST(CompiledFormat_fewerCallsForLiterals);
+    RUN_TEST(CompiledFormat_cookedLiteralsInOneCall);
+    RUN_TEST(CompiledFormat_escapedPercentAfterLastConversion);
+    RUN_TEST(CompiledFormat_64BitIntegers);
+    RUN_TEST(PutUint_radix10);
+    RUN_TEST(PutUint_powerOfTwoRadix);
+    RUN_TEST(PutUint_otherRadix);
+    RUN_TEST(PutUint_singleCall);
+    RUN_TEST(PutUint_widthLargerThanBuffer);
+    RUN_TEST(PutInt_signBeforePadding);
+    RUN_TEST(PutUll);
+    RUN_TEST(Print_64BitIntegers);
+    RUN_TEST(PutUint_cookedNewlineFill);
+    RUN_TEST(PutFloat_matchesHostPrintf);
+    RUN_TEST(PutFloat_widthAndFill);
+    RUN_TEST(PutFloat_notANumber);
+    RUN_TEST(PutFixed);
+    RUN_TEST(Print_fixedUsesFormat);
+    RUN_TEST(PutDecimal);
+
+    COMPLETE();
+}
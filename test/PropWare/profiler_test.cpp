@@ -0,0 +1,205 @@
+/**
+ * @file    profiler_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#define PROPWARE_PROFILE
+
+#include "PropWareTests.h"
+#include "CapturingPrintCapable.h"
+#include <PropWare/utility/profiler.h>
+#include <string.h>
+
+using PropWare::ProfileSite;
+using PropWare::Profiler;
+
+static CapturingPrintCapable *capture;
+static PropWare::Printer     *printer;
+
+SETUP {
+    Profiler::reset();
+    capture = new CapturingPrintCapable();
+    printer = new PropWare::Printer(*capture, false);
+}
+
+TEARDOWN {
+    delete printer;
+    delete capture;
+}
+
+void profiled_function () {
+    PW_PROFILE_SCOPE("profiled");
+    waitcnt(1000 + CNT);
+}
+
+void never_called () {
+    PW_PROFILE_SCOPE("never_called");
+}
+
+TEST(Record_statistics) {
+    setUp();
+
+    ProfileSite site = PW_PROFILE_SITE_INITIALIZER("local");
+
+    site.record(100);
+    site.record(3);
+    site.record(1000);
+
+    ASSERT_EQ_MSG(3, site.count);
+    ASSERT_EQ_MSG(1103, site.total);
+    ASSERT_EQ_MSG(3, site.minimum);
+    ASSERT_EQ_MSG(1000, site.maximum);
+    ASSERT_EQ_MSG(1, site.histogram[1]);
+    ASSERT_EQ_MSG(1, site.histogram[6]);
+    ASSERT_EQ_MSG(1, site.histogram[9]);
+    ASSERT_EQ_MSG(0, site.histogram[7]);
+
+    tearDown();
+}
+
+TEST(Record_extremesFitHistogram) {
+    setUp();
+
+    ProfileSite site = PW_PROFILE_SITE_INITIALIZER("local");
+
+    site.record(0);
+    site.record(1);
+    site.record(0xFFFFFFFF);
+
+    ASSERT_EQ_MSG(2, site.histogram[0]);
+    ASSERT_EQ_MSG(1, site.histogram[ProfileSite::BUCKETS - 1]);
+    ASSERT_EQ_MSG(0xFFFFFFFFULL + 1, site.total);
+
+    tearDown();
+}
+
+TEST(Scope_recordsEachExit) {
+    setUp();
+
+    profiled_function();
+    profiled_function();
+    profiled_function();
+
+    const ProfileSite *site = Profiler::find("profiled");
+    ASSERT_TRUE(NULL != site);
+    ASSERT_EQ_MSG(3, site->count);
+    ASSERT_TRUE(site->minimum <= site->maximum);
+
+    ASSERT_TRUE(NULL != Profiler::find("never_called"));
+    ASSERT_EQ_MSG(0, Profiler::find("never_called")->count);
+    ASSERT_TRUE(NULL == Profiler::find("no_such_site"));
+    ASSERT_EQ_MSG(2, Profiler::get_site_count());
+
+    tearDown();
+}
+
+TEST(Print_skipsUnusedSites) {
+    setUp();
+
+    ProfileSite *site = Profiler::find("profiled");
+    site->record(10);
+    site->record(20);
+    Profiler::print(*printer);
+
+    ASSERT_EQ_MSG(0, strcmp("Site              Count       Min      Mean       Max         Total\n"
+                            "profiled             2        10        15        20            30\n",
+                            capture->get_output()));
+
+    tearDown();
+}
+
+TEST(PrintHistogram) {
+    setUp();
+
+    ProfileSite *site = Profiler::find("profiled");
+    site->record(0);
+    site->record(100);
+    site->record(120);
+    Profiler::print_histogram(*site, *printer);
+
+    ASSERT_EQ_MSG(0, strcmp("profiled:\n"
+                            "          0 ticks and up: 1\n"
+                            "         64 ticks and up: 2\n",
+                            capture->get_output()));
+
+    tearDown();
+}
+
+TEST(Send_framesEverySite) {
+    setUp();
+
+    Profiler::find("profiled")->record(7);
+    Profiler::send(*capture);
+
+    static char           frame[Profiler::FRAME_HEADER_SIZE + 32 + PropWare::COBSDecoder::CRC_SIZE];
+    PropWare::COBSDecoder decoder(frame);
+    unsigned int          frames = 0;
+    bool                  found  = false;
+    for (size_t i = 0; i < capture->get_length(); ++i) {
+        decoder.feed(capture->get_output()[i]);
+        if (decoder.frame_ready()) {
+            ++frames;
+            const size_t nameLength = decoder.get_length() - Profiler::FRAME_HEADER_SIZE;
+            if (8 == nameLength && 0 == strncmp("profiled", frame + Profiler::FRAME_HEADER_SIZE, nameLength)) {
+                found = true;
+                ASSERT_EQ_MSG(1, frame[0]);
+                ASSERT_EQ_MSG(7, frame[4]);
+                ASSERT_EQ_MSG(7, frame[12]);
+                ASSERT_EQ_MSG(1, frame[20 + 4 * 2]);
+            }
+        }
+    }
+    ASSERT_EQ_MSG(2, frames);
+    ASSERT_TRUE(found);
+
+    tearDown();
+}
+
+TEST(Reset) {
+    setUp();
+
+    profiled_function();
+    Profiler::reset();
+
+    const ProfileSite *site = Profiler::find("profiled");
+    ASSERT_EQ_MSG(0, site->count);
+    ASSERT_EQ_MSG(0, site->total);
+    ASSERT_EQ_MSG(0xFFFFFFFF, site->minimum);
+    ASSERT_EQ_MSG(0, site->histogram[0]);
+
+    tearDown();
+}
+
+int main () {
+    START(ProfilerTest);
+
+    RUN_TEST(Record_statistics);
+    RUN_TEST(Record_extremesFitHistogram);
+    RUN_TEST(Scope_recordsEachExit);
+    RUN_TEST(Print_skipsUnusedSites);
+    RUN_TEST(PrintHistogram);
+    RUN_TEST(Send_framesEverySite);
+    RUN_TEST(Reset);
+
+    COMPLETE();
+}
@@ -0,0 +1,80 @@
+/**
+ * @file    queue_benchmark.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareBenchmarks.h"
+#include <PropWare/utility/collection/queue.h>
+#include <PropWare/concurrent/lockservice.h>
+
+static const size_t BATCH = 16;
+
+static int values[BATCH];
+static int buffer[BATCH * 2];
+
+BENCHMARK(Queue_enqueueDequeue) {
+    PropWare::Queue<int> queue(buffer);
+    benchmark.set_bytes(sizeof(int));
+    MEASURE {
+        queue.enqueue(1);
+        queue.dequeue();
+    }
+}
+
+BENCHMARK(Queue_enqueueDequeue_ticketLock) {
+    PropWare::Queue<int, PropWare::TicketLock> queue(buffer);
+    benchmark.set_bytes(sizeof(int));
+    MEASURE {
+        queue.enqueue(1);
+        queue.dequeue();
+    }
+}
+
+BENCHMARK(Queue_tryDequeueEmpty) {
+    PropWare::Queue<int> queue(buffer);
+    int                  value;
+    MEASURE {
+        queue.try_dequeue(value);
+    }
+}
+
+BENCHMARK(Queue_batchOf16) {
+    PropWare::Queue<int> queue(buffer);
+    benchmark.set_operations(BATCH);
+    benchmark.set_bytes(sizeof(values));
+    MEASURE {
+        queue.enqueue_n(values, BATCH);
+        queue.dequeue_n(values, BATCH);
+    }
+}
+
+int main () {
+    START_BENCHMARKS(QueueBenchmark);
+
+    RUN_BENCHMARK(Queue_enqueueDequeue);
+    RUN_BENCHMARK(Queue_enqueueDequeue_ticketLock);
+    RUN_BENCHMARK(Queue_tryDequeueEmpty);
+    RUN_BENCHMARK(Queue_batchOf16);
+
+    COMPLETE_BENCHMARKS();
+}
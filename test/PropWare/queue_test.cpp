@@ -25,11 +25,35 @@
 
 #include "PropWareTests.h"
 #include <PropWare/utility/collection/queue.h>
+#include <PropWare/concurrent/runnable.h>
 
 static const size_t         SIZE = 8;
 static int                  array[SIZE];
+static uint32_t             stack[128];
 static PropWare::Queue<int> *testable;
 
+/**
+ * @brief   Enqueues one value a millisecond after being started
+ */
+class DelayedProducer : public PropWare::Runnable {
+    public:
+        DelayedProducer (const uint32_t (&stack)[128], PropWare::Queue<int> &queue, const int value)
+                : Runnable(stack),
+                  m_queue(&queue),
+                  m_value(value) {
+        }
+
+        void run () {
+            waitcnt(CLKFREQ / 1000 + CNT);
+            this->m_queue->enqueue(this->m_value);
+            cogstop(cogid());
+        }
+
+    private:
+        PropWare::Queue<int> *m_queue;
+        const int            m_value;
+};
+
 SETUP {
     testable = new PropWare::Queue<int>(array);
 };
@@ -197,6 +221,123 @@ TEST(ManyElements) {
     tearDown();
 }
 
+TEST(TryDequeue_whenEmpty) {
+    int value = 42;
+    setUp();
+
+    ASSERT_FALSE(testable->try_dequeue(value));
+    ASSERT_EQ_MSG(42, value);
+
+    tearDown();
+}
+
+TEST(Dequeue_waitsWhenEmpty) {
+    setUp();
+
+    DelayedProducer producer(stack, *testable, 7);
+    ASSERT_NEQ(-1, PropWare::Runnable::invoke(producer));
+    ASSERT_EQ_MSG(7, testable->dequeue());
+    ASSERT_TRUE(testable->is_empty());
+
+    tearDown();
+}
+
+TEST(TryDequeue_keepsOrder) {
+    int value;
+    setUp();
+
+    testable->enqueue(1);
+    testable->enqueue(2);
+    ASSERT_TRUE(testable->try_dequeue(value));
+    ASSERT_EQ_MSG(1, value);
+    testable->enqueue(3);
+    ASSERT_TRUE(testable->try_dequeue(value));
+    ASSERT_EQ_MSG(2, value);
+    ASSERT_TRUE(testable->try_dequeue(value));
+    ASSERT_EQ_MSG(3, value);
+    ASSERT_FALSE(testable->try_dequeue(value));
+
+    tearDown();
+}
+
+TEST(EnqueueN_neverOverwrites) {
+    const int values[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    setUp();
+
+    ASSERT_EQ_MSG(3, testable->enqueue_n(values, 3));
+    ASSERT_EQ_MSG(5, testable->enqueue_n(&values[3], 7));
+    ASSERT_TRUE(testable->is_full());
+    ASSERT_EQ_MSG(0, testable->enqueue_n(&values[8], 2));
+
+    for (int i = 0; i < 8; ++i)
+        ASSERT_EQ_MSG(i, testable->dequeue());
+
+    tearDown();
+}
+
+TEST(EnqueueN_wrapsAround) {
+    const int values[] = {10, 11, 12, 13, 14, 15};
+    int       value;
+    setUp();
+
+    for (int i = 0; i < 6; ++i)
+        testable->enqueue(i);
+    for (int i = 0; i < 5; ++i)
+        testable->try_dequeue(value);
+
+    // One value remains in slot 5, so the new ones go in slots 6, 7 and then 0 through 3
+    ASSERT_EQ_MSG(6, testable->enqueue_n(values, 6));
+    ASSERT_EQ_MSG(7, testable->size());
+    ASSERT_EQ_MSG(5, testable->dequeue());
+    for (int i = 0; i < 6; ++i)
+        ASSERT_EQ_MSG(values[i], testable->dequeue());
+
+    // The single-value methods must agree with where the bulk methods left off
+    testable->enqueue(20);
+    ASSERT_EQ_MSG(20, testable->peek());
+
+    tearDown();
+}
+
+TEST(DequeueN_wrapsAround) {
+    int values[SIZE];
+    setUp();
+
+    for (int i = 0; i < 6; ++i)
+        testable->enqueue(i);
+    ASSERT_EQ_MSG(5, testable->dequeue_n(values, 5));
+    for (int i = 0; i < 5; ++i)
+        ASSERT_EQ_MSG(i, values[i]);
+
+    for (int i = 6; i < 11; ++i)
+        testable->enqueue(i);
+    ASSERT_EQ_MSG(6, testable->dequeue_n(values, SIZE));
+    for (int i = 0; i < 6; ++i)
+        ASSERT_EQ_MSG(5 + i, values[i]);
+    ASSERT_TRUE(testable->is_empty());
+    ASSERT_EQ_MSG(0, testable->dequeue_n(values, SIZE));
+
+    // The single-value methods must agree with where the bulk methods left off
+    testable->enqueue(20);
+    testable->enqueue(21);
+    ASSERT_EQ_MSG(20, testable->dequeue());
+    ASSERT_EQ_MSG(21, testable->dequeue());
+
+    tearDown();
+}
+
+TEST(WaitDequeueN_returnsWhatIsAvailable) {
+    const int input[] = {7, 8, 9};
+    int       values[SIZE];
+    setUp();
+
+    testable->wait_enqueue_n(input, 3);
+    ASSERT_EQ_MSG(3, testable->wait_dequeue_n(values, SIZE));
+    ASSERT_EQ_MSG(9, values[2]);
+
+    tearDown();
+}
+
 int main () {
     START(CircularBuffer);
 
@@ -212,6 +353,13 @@ int main () {
     RUN_TEST(Deque_twoElements);
     RUN_TEST(Deque_multipleElements);
     RUN_TEST(ManyElements);
+    RUN_TEST(TryDequeue_whenEmpty);
+    RUN_TEST(Dequeue_waitsWhenEmpty);
+    RUN_TEST(TryDequeue_keepsOrder);
+    RUN_TEST(EnqueueN_neverOverwrites);
+    RUN_TEST(EnqueueN_wrapsAround);
+    RUN_TEST(DequeueN_wrapsAround);
+    RUN_TEST(WaitDequeueN_returnsWhatIsAvailable);
 
     COMPLETE();
 }
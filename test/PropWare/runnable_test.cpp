@@ -0,0 +1,244 @@
+/**
+ * @file    runnable_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include "CapturingPrintCapable.h"
+#include <PropWare/concurrent/stackmonitor.h>
+#include <string.h>
+
+using PropWare::Runnable;
+using PropWare::StackMonitor;
+
+static const size_t STACK_LENGTH = 64;
+
+/**
+ * @brief   Sets a flag from its new cog, then idles until it is stopped
+ */
+class FlagRunnable : public Runnable {
+    public:
+        template<size_t N>
+        FlagRunnable (const uint32_t (&stack)[N])
+                : Runnable(stack),
+                  m_started(false) {
+        }
+
+        void run () {
+            this->m_started = true;
+            while (1)
+                waitcnt(SECOND + CNT);
+        }
+
+        volatile bool m_started;
+};
+
+static uint32_t              stacks[2][STACK_LENGTH];
+static uint32_t              monitorStack[32];
+static FlagRunnable          *first;
+static FlagRunnable          *second;
+static CapturingPrintCapable *capture;
+static PropWare::Printer     *printer;
+static PropWare::SynchronousPrinter *syncPrinter;
+
+SETUP {
+    memset(stacks, 0, sizeof(stacks));
+    first       = new FlagRunnable(stacks[0]);
+    second      = new FlagRunnable(stacks[1]);
+    capture     = new CapturingPrintCapable();
+    printer     = new PropWare::Printer(*capture, false);
+    syncPrinter = new PropWare::SynchronousPrinter(*printer);
+}
+
+TEARDOWN {
+    delete first;
+    delete second;
+    delete syncPrinter;
+    delete printer;
+    delete capture;
+}
+
+/**
+ * @brief   Pretend that the cog has used the top `used` words and that PropGCC's thread state occupies the bottom
+ *          `threadState` words
+ */
+void simulate_use (Runnable &runnable, const size_t used, const size_t threadState = 0) {
+    runnable.paint_stack();
+    uint32_t *stack = const_cast<uint32_t *>(runnable.m_stackPointer);
+    for (size_t i = 0; i < used; ++i)
+        stack[STACK_LENGTH - 1 - i] = i;
+    for (size_t i = 0; i < threadState; ++i)
+        stack[i] = 0;
+}
+
+TEST(Invoke_paintsStack) {
+    setUp();
+
+    const int8_t cog = Runnable::invoke(*first);
+    ASSERT_TRUE(0 <= cog);
+    const uint32_t timeout = CNT + 100 * MILLISECOND;
+    while (!first->m_started && 0 < (int32_t) (timeout - CNT));
+    cogstop(cog);
+
+    const size_t margin = first->get_stack_margin();
+    ASSERT_TRUE(0 < margin);
+    ASSERT_TRUE(STACK_LENGTH * sizeof(uint32_t) > margin);
+    ASSERT_EQ_MSG(STACK_LENGTH * sizeof(uint32_t), margin + first->get_stack_high_water_mark());
+    ASSERT_FALSE(first->has_stack_overflowed());
+
+    tearDown();
+}
+
+TEST(Margin_countsUntouchedWords) {
+    setUp();
+
+    simulate_use(*first, 10);
+
+    ASSERT_EQ_MSG(STACK_LENGTH * sizeof(uint32_t), first->get_stack_size());
+    ASSERT_EQ_MSG((STACK_LENGTH - 10) * sizeof(uint32_t), first->get_stack_margin());
+    ASSERT_EQ_MSG(10 * sizeof(uint32_t), first->get_stack_high_water_mark());
+
+    tearDown();
+}
+
+TEST(Margin_skipsThreadState) {
+    setUp();
+
+    simulate_use(*first, 5, 4);
+
+    ASSERT_EQ_MSG((STACK_LENGTH - 9) * sizeof(uint32_t), first->get_stack_margin());
+    ASSERT_EQ_MSG(9 * sizeof(uint32_t), first->get_stack_high_water_mark());
+
+    tearDown();
+}
+
+TEST(Margin_zeroWhenStackIsFull) {
+    setUp();
+
+    simulate_use(*first, STACK_LENGTH - 4, 4);
+
+    ASSERT_EQ_MSG(0, first->get_stack_margin());
+    ASSERT_TRUE(first->has_stack_overflowed());
+
+    tearDown();
+}
+
+TEST(Unpainted_reportsNoOverflow) {
+    setUp();
+
+    ASSERT_FALSE(first->is_stack_painted());
+    ASSERT_EQ_MSG(STACK_LENGTH * sizeof(uint32_t), first->get_stack_margin());
+    ASSERT_EQ_MSG(0, first->get_stack_high_water_mark());
+    ASSERT_FALSE(first->has_stack_overflowed());
+
+    first->paint_stack();
+    ASSERT_TRUE(first->is_stack_painted());
+
+    tearDown();
+}
+
+TEST(StackMonitor_reportsLowStackOnce) {
+    setUp();
+
+    const Runnable *watched[] = {first, second};
+    StackMonitor   monitor(monitorStack, watched, 8 * sizeof(uint32_t), *syncPrinter);
+
+    simulate_use(*first, 10);
+    simulate_use(*second, STACK_LENGTH - 6);
+    ASSERT_EQ_MSG(1, monitor.check());
+    ASSERT_FALSE(monitor.is_reported(0));
+    ASSERT_TRUE(monitor.is_reported(1));
+    ASSERT_EQ_MSG(0, strncmp("WARNING: stack of Runnable 1", capture->get_output(), 28));
+
+    ASSERT_EQ_MSG(0, monitor.check());
+
+    tearDown();
+}
+
+TEST(StackMonitor_reportsOverflow) {
+    setUp();
+
+    const Runnable *watched[] = {first, second};
+    StackMonitor   monitor(monitorStack, watched, 0, *syncPrinter);
+
+    simulate_use(*first, STACK_LENGTH);
+    simulate_use(*second, STACK_LENGTH - 1);
+    ASSERT_EQ_MSG(1, monitor.check());
+    ASSERT_TRUE(monitor.is_reported(0));
+    ASSERT_EQ_MSG(0, strncmp("OVERFLOW: stack of Runnable 0", capture->get_output(), 29));
+
+    tearDown();
+}
+
+TEST(StackMonitor_skipsUnstartedRunnable) {
+    setUp();
+
+    const Runnable *watched[] = {first, second};
+    StackMonitor   monitor(monitorStack, watched, STACK_LENGTH * sizeof(uint32_t), *syncPrinter);
+
+    simulate_use(*first, 10);
+    ASSERT_EQ_MSG(1, monitor.check());
+    ASSERT_TRUE(monitor.is_reported(0));
+    ASSERT_FALSE(monitor.is_reported(1));
+
+    // Once started, it is watched like any other
+    simulate_use(*second, 10);
+    ASSERT_EQ_MSG(1, monitor.check());
+    ASSERT_TRUE(monitor.is_reported(1));
+
+    tearDown();
+}
+
+TEST(StackMonitor_printReport) {
+    setUp();
+
+    const Runnable *watched[] = {first, second};
+    StackMonitor   monitor(monitorStack, watched, 0, *syncPrinter);
+
+    simulate_use(*first, 16);
+    monitor.print_report();
+    ASSERT_EQ_MSG(0, strcmp("Runnable    Size    Used    Free\n"
+                            "       0     256      64     192\n"
+                            "       1     256       -       -\n", capture->get_output()));
+
+    tearDown();
+}
+
+int main () {
+    START(RunnableTest);
+
+#ifdef __PROPELLER__
+    // A simulated cog runs on a host thread's stack, never the one it was given
+    RUN_TEST(Invoke_paintsStack);
+#endif
+    RUN_TEST(Margin_countsUntouchedWords);
+    RUN_TEST(Margin_skipsThreadState);
+    RUN_TEST(Margin_zeroWhenStackIsFull);
+    RUN_TEST(Unpainted_reportsNoOverflow);
+    RUN_TEST(StackMonitor_reportsLowStackOnce);
+    RUN_TEST(StackMonitor_reportsOverflow);
+    RUN_TEST(StackMonitor_skipsUnstartedRunnable);
+    RUN_TEST(StackMonitor_printReport);
+
+    COMPLETE();
+}
@@ -0,0 +1,68 @@
+/**
+ * @file    spi_benchmark.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareBenchmarks.h"
+#include <PropWare/serial/spi/spi.h>
+
+// Same wiring as spi_test; the block routines run at full speed whether or not a device is attached
+static const PropWare::Pin::Mask MOSI_MASK = PropWare::Port::Mask::P0;
+static const PropWare::Pin::Mask MISO_MASK = PropWare::Port::Mask::P1;
+static const PropWare::Pin::Mask SCLK_MASK = PropWare::Port::Mask::P2;
+static const unsigned int        FREQUENCY = 900000;
+
+/** One SD card sector */
+static uint8_t block[512];
+
+BENCHMARK(SPI_shiftOutBlockFast) {
+    const PropWare::SPI spi(MOSI_MASK, MISO_MASK, SCLK_MASK, FREQUENCY);
+    benchmark.set_bytes(sizeof(block));
+    MEASURE spi.shift_out_block_msb_first_fast(block, sizeof(block));
+}
+
+BENCHMARK(SPI_shiftInBlockFast) {
+    const PropWare::SPI spi(MOSI_MASK, MISO_MASK, SCLK_MASK, FREQUENCY);
+    benchmark.set_bytes(sizeof(block));
+    MEASURE spi.shift_in_block_mode0_msb_first_fast(block, sizeof(block));
+}
+
+BENCHMARK(SPI_shiftOutByteByByte) {
+    const PropWare::SPI spi(MOSI_MASK, MISO_MASK, SCLK_MASK, FREQUENCY);
+    benchmark.set_runs(4);
+    benchmark.set_bytes(sizeof(block));
+    MEASURE {
+        for (size_t i = 0; i < sizeof(block); ++i)
+            spi.shift_out(8, block[i]);
+    }
+}
+
+int main () {
+    START_BENCHMARKS(SPIBenchmark);
+
+    RUN_BENCHMARK(SPI_shiftOutBlockFast);
+    RUN_BENCHMARK(SPI_shiftInBlockFast);
+    RUN_BENCHMARK(SPI_shiftOutByteByByte);
+
+    COMPLETE_BENCHMARKS();
+}
@@ -0,0 +1,182 @@
+/**
+ * @file    spscring_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareTests.h"
+#include <PropWare/utility/collection/spscring.h>
+
+typedef PropWare::SPSCRing<int, 8> Ring;
+
+static Ring *testable;
+
+SETUP {
+    testable = new Ring();
+}
+
+TEARDOWN {
+    delete testable;
+}
+
+TEST(Constructor_isEmpty) {
+    setUp();
+
+    ASSERT_TRUE(testable->is_empty());
+    ASSERT_FALSE(testable->is_full());
+    ASSERT_EQ_MSG(0, testable->size());
+
+    tearDown();
+}
+
+TEST(TryPop_whenEmpty) {
+    int value = 42;
+    setUp();
+
+    ASSERT_FALSE(testable->try_pop(value));
+    ASSERT_EQ_MSG(42, value);
+
+    tearDown();
+}
+
+TEST(TryPush_usesEverySlot) {
+    setUp();
+
+    for (int i = 0; i < 8; ++i)
+        ASSERT_TRUE(testable->try_push(i));
+    ASSERT_TRUE(testable->is_full());
+    ASSERT_FALSE(testable->try_push(8));
+
+    for (int i = 0; i < 8; ++i) {
+        int value;
+        ASSERT_TRUE(testable->try_pop(value));
+        ASSERT_EQ_MSG(i, value);
+    }
+    ASSERT_TRUE(testable->is_empty());
+
+    tearDown();
+}
+
+TEST(TryPush_wrapsAround) {
+    setUp();
+
+    for (int i = 0; i < 100; ++i) {
+        int value;
+        ASSERT_TRUE(testable->try_push(i));
+        ASSERT_TRUE(testable->try_push(-i));
+        ASSERT_TRUE(testable->try_pop(value));
+        ASSERT_EQ_MSG(i, value);
+        ASSERT_TRUE(testable->try_pop(value));
+        ASSERT_EQ_MSG(-i, value);
+    }
+
+    tearDown();
+}
+
+TEST(PushN_stopsAtEndOfBuffer) {
+    int value;
+    setUp();
+
+    for (int i = 0; i < 6; ++i)
+        testable->try_push(i);
+    for (int i = 0; i < 5; ++i)
+        testable->try_pop(value);
+
+    // Slots 6 and 7 are contiguous, then 0 through 4
+    Ring::Span span = testable->push_n();
+    ASSERT_EQ_MSG(2, span.length);
+    span.data[0] = 6;
+    span.data[1] = 7;
+    testable->commit_push(span.length);
+
+    span = testable->push_n(3);
+    ASSERT_EQ_MSG(3, span.length);
+    for (int i = 0; i < 3; ++i)
+        span.data[i] = 8 + i;
+    // Only part of a span needs to be committed
+    testable->commit_push(2);
+    ASSERT_EQ_MSG(5, testable->size());
+
+    for (int i = 5; i < 10; ++i) {
+        ASSERT_TRUE(testable->try_pop(value));
+        ASSERT_EQ_MSG(i, value);
+    }
+    ASSERT_TRUE(testable->is_empty());
+
+    tearDown();
+}
+
+TEST(PushN_whenFull) {
+    setUp();
+
+    for (int i = 0; i < 8; ++i)
+        testable->try_push(i);
+    ASSERT_EQ_MSG(0, testable->push_n().length);
+
+    tearDown();
+}
+
+TEST(PopN_stopsAtEndOfBuffer) {
+    int value;
+    setUp();
+
+    for (int i = 0; i < 6; ++i)
+        testable->try_push(i);
+    for (int i = 0; i < 6; ++i)
+        testable->try_pop(value);
+    for (int i = 0; i < 5; ++i)
+        testable->try_push(10 + i);
+
+    Ring::Span span = testable->pop_n();
+    ASSERT_EQ_MSG(2, span.length);
+    ASSERT_EQ_MSG(10, span.data[0]);
+    ASSERT_EQ_MSG(11, span.data[1]);
+    testable->commit_pop(span.length);
+
+    span = testable->pop_n(2);
+    ASSERT_EQ_MSG(2, span.length);
+    ASSERT_EQ_MSG(12, span.data[0]);
+    testable->commit_pop(1);
+
+    span = testable->pop_n();
+    ASSERT_EQ_MSG(2, span.length);
+    ASSERT_EQ_MSG(13, span.data[0]);
+    ASSERT_EQ_MSG(14, span.data[1]);
+    testable->commit_pop(span.length);
+    ASSERT_EQ_MSG(0, testable->pop_n().length);
+
+    tearDown();
+}
+
+int main () {
+    START(SPSCRingTest);
+
+    RUN_TEST(Constructor_isEmpty);
+    RUN_TEST(TryPop_whenEmpty);
+    RUN_TEST(TryPush_usesEverySlot);
+    RUN_TEST(TryPush_wrapsAround);
+    RUN_TEST(PushN_stopsAtEndOfBuffer);
+    RUN_TEST(PushN_whenFull);
+    RUN_TEST(PopN_stopsAtEndOfBuffer);
+
+    COMPLETE();
+}
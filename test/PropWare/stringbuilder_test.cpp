@@ -28,6 +28,7 @@
 
 #include "PropWareTests.h"
 #include <PropWare/string/stringbuilder.h>
+#include <PropWare/utility/allocator/arena.h>
 
 using namespace PropWare;
 
@@ -44,7 +45,7 @@ TEARDOWN {
 TEST(ConstructorDestructor) {
     testable = new StringBuilder();
 
-    ASSERT_NEQ_MSG(NULL, (unsigned int) testable->m_string);
+    ASSERT_NEQ_MSG(NULL, (uintptr_t) testable->m_string);
     ASSERT_EQ_MSG(StringBuilder::DEFAULT_SPACE_ALLOCATED, testable->m_currentSpace);
     ASSERT_EQ_MSG(0, testable->m_size);
     ASSERT_EQ_MSG(0, strlen(testable->to_string()));
@@ -54,6 +55,7 @@ TEST(ConstructorDestructor) {
 
 TEST(PutChar_one) {
     const char testChar = 'a';
+    setUp();
 
     testable->put_char(testChar);
 
@@ -115,12 +117,12 @@ TEST(PutChar_ExactlyFull_SpaceShouldDouble) {
 TEST(PutChar_FirstNewAlloc) {
     setUp();
 
-    const unsigned int originalStringAddr = (unsigned int) testable->to_string();
+    const uintptr_t     originalStringAddr = (uintptr_t) testable->to_string();
 
     for (int i = 0; i < StringBuilder::DEFAULT_SPACE_ALLOCATED; ++i)
         testable->put_char('a' + i);
 
-    ASSERT_NEQ_MSG(originalStringAddr, (unsigned int) testable->to_string());
+    ASSERT_NEQ_MSG(originalStringAddr, (uintptr_t) testable->to_string());
     ASSERT_EQ_MSG(StringBuilder::DEFAULT_SPACE_ALLOCATED, testable->get_size());
     ASSERT_EQ_MSG(strlen(testable->to_string()), testable->get_size());
     ASSERT_EQ_MSG(StringBuilder::DEFAULT_SPACE_ALLOCATED * 2, testable->m_currentSpace);
@@ -133,13 +135,13 @@ TEST(PutChar_FirstNewAlloc) {
 TEST(PutChar_HugeString) {
     setUp();
 
-    const unsigned int originalStringAddr = (unsigned int) testable->to_string();
+    const uintptr_t     originalStringAddr = (uintptr_t) testable->to_string();
 
     const int STRING_SIZE = 0x1000 - 1;
     for (int  i           = 0; i < STRING_SIZE; ++i)
         testable->put_char('a');
 
-    ASSERT_NEQ_MSG(originalStringAddr, (unsigned int) testable->to_string());
+    ASSERT_NEQ_MSG(originalStringAddr, (uintptr_t) testable->to_string());
     ASSERT_EQ_MSG(STRING_SIZE, testable->get_size());
     ASSERT_EQ_MSG(strlen(testable->to_string()), testable->get_size());
     ASSERT_EQ_MSG((STRING_SIZE + 1) << 1, testable->m_currentSpace);
@@ -154,7 +156,7 @@ TEST(Clear_empty) {
 
     testable->clear();
 
-    ASSERT_NEQ_MSG(NULL, (unsigned int) testable->m_string);
+    ASSERT_NEQ_MSG(NULL, (uintptr_t) testable->m_string);
     ASSERT_EQ_MSG(StringBuilder::DEFAULT_SPACE_ALLOCATED, testable->m_currentSpace);
     ASSERT_EQ_MSG(0, testable->m_size);
     ASSERT_EQ_MSG(0, strlen(testable->to_string()));
@@ -168,7 +170,7 @@ TEST(Clear_OneChar) {
     testable->put_char('a');
     testable->clear();
 
-    ASSERT_NEQ_MSG(NULL, (unsigned int) testable->m_string);
+    ASSERT_NEQ_MSG(NULL, (uintptr_t) testable->m_string);
     ASSERT_EQ_MSG(StringBuilder::DEFAULT_SPACE_ALLOCATED, testable->m_currentSpace);
     ASSERT_EQ_MSG(0, testable->m_size);
     ASSERT_EQ_MSG(0, strlen(testable->to_string()));
@@ -185,7 +187,7 @@ TEST(Clear_HugeString) {
 
     testable->clear();
 
-    ASSERT_NEQ_MSG(NULL, (unsigned int) testable->m_string);
+    ASSERT_NEQ_MSG(NULL, (uintptr_t) testable->m_string);
     ASSERT_EQ_MSG(StringBuilder::DEFAULT_SPACE_ALLOCATED, testable->m_currentSpace);
     ASSERT_EQ_MSG(0, testable->m_size);
     ASSERT_EQ_MSG(0, strlen(testable->to_string()));
@@ -199,13 +201,84 @@ TEST(Puts) {
 
     testable->puts(testString);
 
-    ASSERT_NEQ_MSG(NULL, (unsigned int) testable->to_string());
+    ASSERT_NEQ_MSG(NULL, (uintptr_t) testable->to_string());
     ASSERT_EQ_MSG(sizeof(testString) - 1, testable->get_size());
     ASSERT_EQ_MSG(0, strcmp(testString, testable->to_string()));
 
     tearDown();
 }
 
+TEST(Allocator_bufferGrowsInArena) {
+    uint32_t arenaBuffer[64];
+    Arena    arena(arenaBuffer);
+    setUp();
+
+    StringBuilder builder(16, arena);
+    for (unsigned int i = 0; i < 40; ++i)
+        builder.put_char('x');
+
+    ASSERT_EQ_MSG(40, builder.get_size());
+    ASSERT_EQ_MSG(64, builder.m_currentSpace);
+    ASSERT_TRUE(arena.get_used() >= 16 + 32 + 64);
+
+    tearDown();
+}
+
+TEST(Allocator_exhaustedDropsCharacters) {
+    const uint16_t space = 32;
+    uint32_t       arenaBuffer[16];
+    Arena          arena(arenaBuffer);
+    setUp();
+
+    // The first buffer takes at least half of the arena, so it can never double
+    StringBuilder builder(space, arena);
+    for (unsigned int i = 0; i < 2 * space; ++i)
+        builder.put_char('y');
+
+    ASSERT_EQ_MSG(space - 1, builder.get_size());
+    ASSERT_EQ_MSG(space - 1, strlen(builder.to_string()));
+    ASSERT_EQ_MSG(space, builder.m_currentSpace);
+
+    tearDown();
+}
+
+TEST(Allocator_failedConstructionHasNoSpace) {
+    uint32_t arenaBuffer[4];
+    Arena    arena(arenaBuffer);
+    setUp();
+
+    StringBuilder builder(sizeof(arenaBuffer) + 1, arena);
+    builder.puts("abc");
+    builder.clear();
+
+    ASSERT_EQ_MSG(NULL, (uintptr_t) builder.to_string());
+    ASSERT_EQ_MSG(0, builder.m_currentSpace);
+    ASSERT_EQ_MSG(0, builder.get_size());
+
+    tearDown();
+}
+
+TEST(Allocator_clearKeepsArenaBuffer) {
+    uint32_t arenaBuffer[64];
+    Arena    arena(arenaBuffer);
+    setUp();
+
+    StringBuilder builder(16, arena);
+    for (unsigned int i = 0; i < 40; ++i)
+        builder.put_char('x');
+    const uintptr_t grownAddress = (uintptr_t) builder.to_string();
+    const size_t    used         = arena.get_used();
+
+    builder.clear();
+
+    ASSERT_EQ_MSG(grownAddress, (uintptr_t) builder.to_string());
+    ASSERT_EQ_MSG(64, builder.m_currentSpace);
+    ASSERT_EQ_MSG(used, arena.get_used());
+    ASSERT_EQ_MSG(0, strlen(builder.to_string()));
+
+    tearDown();
+}
+
 int main () {
     START(StringBuilderTest);
 
@@ -220,6 +293,10 @@ int main () {
     RUN_TEST(Clear_OneChar);
     RUN_TEST(Clear_HugeString);
     RUN_TEST(Puts);
+    RUN_TEST(Allocator_bufferGrowsInArena);
+    RUN_TEST(Allocator_exhaustedDropsCharacters);
+    RUN_TEST(Allocator_failedConstructionHasNoSpace);
+    RUN_TEST(Allocator_clearKeepsArenaBuffer);
 
     COMPLETE();
 }
@@ -0,0 +1,327 @@
+/**
+ * @file    tokenizer_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/hmi/input/tokenizer.h>
+#include "PropWareTests.h"
+
+using PropWare::Tokenizer;
+
+/**
+ * @brief   Hands out a string a few characters at a time, like a block device or a UART with a few bytes waiting
+ */
+class ChunkedScanCapable : public PropWare::ScanCapable {
+    public:
+        ChunkedScanCapable (const char string[], const size_t chunkSize)
+                : m_string(string),
+                  m_chunkSize(chunkSize),
+                  m_calls(0) {
+        }
+
+        virtual char get_char () {
+            return *this->m_string++;
+        }
+
+        virtual size_t get_chars (char buffer[], const size_t maxLength) {
+            size_t length = 0;
+            ++this->m_calls;
+            while (*this->m_string && length < maxLength && length < this->m_chunkSize)
+                buffer[length++] = *this->m_string++;
+            return length;
+        }
+
+    public:
+        const char   *m_string;
+        const size_t m_chunkSize;
+        unsigned int m_calls;
+};
+
+static char lookahead[8];
+
+TEARDOWN {
+}
+
+TEST(GetUint_decimalAndHex) {
+    Tokenizer testable(" 42 0x1F 0XfF 0 4294967295");
+    uint32_t  x;
+
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(42, x);
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(0x1F, x);
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(0xFF, x);
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(0, x);
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(0xFFFFFFFF, x);
+    ASSERT_TRUE(testable.at_end());
+
+    tearDown();
+}
+
+TEST(GetUint_zeroFollowedByLetterX) {
+    Tokenizer testable("0xg");
+    uint32_t  x = 1;
+    char      c;
+
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(0, x);
+    ASSERT_TRUE(testable.peek(c));
+    ASSERT_EQ_MSG('x', c);
+
+    tearDown();
+}
+
+TEST(GetUint_overflow) {
+    Tokenizer testable("4294967296");
+    uint32_t  x = 7;
+
+    ASSERT_EQ_MSG(Tokenizer::OUT_OF_RANGE, testable.get(x));
+    ASSERT_EQ_MSG(7, x);
+    // The digit which did not fit is left unread
+    ASSERT_EQ_MSG(10, testable.get_position().column);
+
+    tearDown();
+}
+
+TEST(GetUint_rejectsNegative) {
+    Tokenizer testable("-1");
+    uint32_t  x;
+
+    ASSERT_EQ_MSG(Tokenizer::NOT_A_NUMBER, testable.get(x));
+
+    tearDown();
+}
+
+TEST(GetInt_limits) {
+    Tokenizer testable("-2147483648 2147483647 +5 -0x10 2147483648");
+    int32_t   x;
+
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG((int32_t) 0x80000000, x);
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(2147483647, x);
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(5, x);
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(-16, x);
+    ASSERT_EQ_MSG(Tokenizer::OUT_OF_RANGE, testable.get(x));
+
+    tearDown();
+}
+
+TEST(GetInt_errorPosition) {
+    Tokenizer testable("1,2\n3, x\n");
+    int32_t   x;
+
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.expect(','));
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_TRUE(testable.skip_line());
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.expect(','));
+
+    ASSERT_EQ_MSG(Tokenizer::NOT_A_NUMBER, testable.get(x));
+    ASSERT_EQ_MSG(2, testable.get_token_position().line);
+    ASSERT_EQ_MSG(4, testable.get_token_position().column);
+
+    tearDown();
+}
+
+TEST(GetInt_endOfInput) {
+    Tokenizer testable("  ");
+    int32_t   x;
+
+    ASSERT_EQ_MSG(Tokenizer::END_OF_INPUT, testable.get(x));
+
+    tearDown();
+}
+
+TEST(GetFloat) {
+    const char *inputs[]   = {"3.25", "-12", ".5", "6.02e23", "1e-3", "-0.000125", "123456789012", "1E+2", "2e"};
+    const float expected[] = {3.25f, -12, .5f, 6.02e23f, 1e-3f, -0.000125f, 123456789012.f, 100, 2};
+
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); ++i) {
+        Tokenizer   testable(inputs[i]);
+        float       f;
+        const float tolerance = (0 > expected[i] ? -expected[i] : expected[i]) * 1e-6f;
+
+        ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(f));
+        ASSERT_TRUE(expected[i] - tolerance <= f && f <= expected[i] + tolerance);
+    }
+
+    tearDown();
+}
+
+TEST(GetFloat_exponentLeftForNextToken) {
+    Tokenizer testable("2e,x");
+    float     f;
+    char      c;
+
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(f));
+    ASSERT_TRUE(testable.peek(c));
+    ASSERT_EQ_MSG('e', c);
+
+    tearDown();
+}
+
+TEST(GetFloat_outOfRange) {
+    Tokenizer testable("1e39 .");
+    float     f;
+
+    ASSERT_EQ_MSG(Tokenizer::OUT_OF_RANGE, testable.get(f));
+    ASSERT_TRUE(FLT_MAX < f);
+    ASSERT_EQ_MSG(Tokenizer::NOT_A_NUMBER, testable.get(f));
+
+    tearDown();
+}
+
+TEST(GetFixed) {
+    Tokenizer     testable("3.25 -0.0625 .5 -32768 32767.99999 1.00001 7.");
+    PropWare::Q16 x;
+
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(0x34000, x.get_raw());
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(-0x1000, x.get_raw());
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(0x8000, x.get_raw());
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG((int32_t) 0x80000000, x.get_raw());
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(0x7FFFFFFF, x.get_raw());
+    // 0.00001 * 65536 = 0.655, which rounds up
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(0x10001, x.get_raw());
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(0x70000, x.get_raw());
+
+    tearDown();
+}
+
+TEST(GetFixed_outOfRange) {
+    Tokenizer     testable("32768 32767.999999");
+    PropWare::Q16 x;
+
+    ASSERT_EQ_MSG(Tokenizer::OUT_OF_RANGE, testable.get(x));
+    testable.skip_blanks();
+    testable.skip_line();
+
+    Tokenizer roundsUp("32767.999999");
+    ASSERT_EQ_MSG(Tokenizer::OUT_OF_RANGE, roundsUp.get(x));
+
+    tearDown();
+}
+
+TEST(GetToken_csv) {
+    Tokenizer testable("  pump one ,, 12\r\nabcdefghijklmnopqrst,x");
+    char      field[16];
+    int32_t   x;
+
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get_token(field, sizeof(field)));
+    // Blanks after the field are kept
+    ASSERT_EQ_MSG(0, strcmp("pump one ", field));
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.expect(','));
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get_token(field, sizeof(field)));
+    ASSERT_EQ_MSG(0, strcmp("", field));
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.expect(','));
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+    ASSERT_EQ_MSG(12, x);
+    ASSERT_TRUE(testable.skip_line());
+
+    ASSERT_EQ_MSG(Tokenizer::OUT_OF_RANGE, testable.get_token(field, sizeof(field)));
+    ASSERT_EQ_MSG(0, strcmp("abcdefghijklmno", field));
+    ASSERT_EQ_MSG(Tokenizer::UNEXPECTED_CHARACTER, testable.expect(';'));
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.expect(','));
+
+    tearDown();
+}
+
+TEST(ScanCapable_valuesSpanChunks) {
+    ChunkedScanCapable source("0x1234, -98765, 3.140625\n0x", 3);
+    Tokenizer          testable(source, lookahead);
+    uint32_t           u;
+    int32_t            i;
+    PropWare::Q16      q;
+
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(u));
+    ASSERT_EQ_MSG(0x1234, u);
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.expect(','));
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(i));
+    ASSERT_EQ_MSG(-98765, i);
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.expect(','));
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(q));
+    ASSERT_EQ_MSG(0x32400, q.get_raw());
+    ASSERT_TRUE(testable.skip_line());
+
+    // "0x" with nothing after it is a zero followed by an 'x'
+    ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(u));
+    ASSERT_EQ_MSG(0, u);
+    ASSERT_FALSE(testable.at_end());
+    testable.skip_line();
+    ASSERT_TRUE(testable.at_end());
+
+    tearDown();
+}
+
+TEST(ScanCapable_usesWholeChunks) {
+    ChunkedScanCapable source("1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16", 64);
+    Tokenizer          testable(source, lookahead);
+    int32_t            sum = 0;
+    int32_t            x;
+
+    do {
+        ASSERT_EQ_MSG(Tokenizer::NO_ERROR, testable.get(x));
+        sum += x;
+    } while (Tokenizer::NO_ERROR == testable.expect(','));
+
+    ASSERT_EQ_MSG(136, sum);
+    // 38 characters through an 8-byte buffer: a handful of calls rather than one per character
+    ASSERT_TRUE(source.m_calls < 10);
+
+    tearDown();
+}
+
+int main () {
+    START(TokenizerTest);
+
+    RUN_TEST(GetUint_decimalAndHex);
+    RUN_TEST(GetUint_zeroFollowedByLetterX);
+    RUN_TEST(GetUint_overflow);
+    RUN_TEST(GetUint_rejectsNegative);
+    RUN_TEST(GetInt_limits);
+    RUN_TEST(GetInt_errorPosition);
+    RUN_TEST(GetInt_endOfInput);
+    RUN_TEST(GetFloat);
+    RUN_TEST(GetFloat_exponentLeftForNextToken);
+    RUN_TEST(GetFloat_outOfRange);
+    RUN_TEST(GetFixed);
+    RUN_TEST(GetFixed_outOfRange);
+    RUN_TEST(GetToken_csv);
+    RUN_TEST(ScanCapable_valuesSpanChunks);
+    RUN_TEST(ScanCapable_usesWholeChunks);
+
+    COMPLETE();
+}
@@ -0,0 +1,75 @@
+/**
+ * @file    uart_benchmark.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "PropWareBenchmarks.h"
+#include <PropWare/serial/uart/uarttx.h>
+
+// Nothing needs to be listening: the transmitter's speed does not depend on the receiver
+static const PropWare::Port::Mask TX_PIN = PropWare::Port::P12;
+
+static char data[64];
+
+/**
+ * @brief   Time PropWare::UARTTX::send_array at a given baud rate
+ */
+void send_array (PropWareBenchmark &benchmark, const int32_t baudRate) {
+    PropWare::UARTTX uart(TX_PIN);
+    uart.set_baud_rate(baudRate);
+    for (size_t i = 0; i < sizeof(data); ++i)
+        data[i] = (char) ('A' + i % 26);
+
+    benchmark.set_bytes(sizeof(data));
+    MEASURE uart.send_array(data, sizeof(data));
+}
+
+BENCHMARK(UARTTX_sendArray_115200) {
+    send_array(benchmark, 115200);
+}
+
+BENCHMARK(UARTTX_sendArray_460800) {
+    send_array(benchmark, 460800);
+}
+
+BENCHMARK(UARTTX_sendArray_maxBaud) {
+    send_array(benchmark, 4000000);
+}
+
+BENCHMARK(UARTTX_putChar) {
+    PropWare::UARTTX uart(TX_PIN);
+    uart.set_baud_rate(460800);
+    benchmark.set_bytes(1);
+    MEASURE uart.put_char('A');
+}
+
+int main () {
+    START_BENCHMARKS(UARTBenchmark);
+
+    RUN_BENCHMARK(UARTTX_sendArray_115200);
+    RUN_BENCHMARK(UARTTX_sendArray_460800);
+    RUN_BENCHMARK(UARTTX_sendArray_maxBaud);
+    RUN_BENCHMARK(UARTTX_putChar);
+
+    COMPLETE_BENCHMARKS();
+}
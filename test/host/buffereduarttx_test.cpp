@@ -0,0 +1,170 @@
+/**
+ * @file    buffereduarttx_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/serial/uart/buffereduarttx.h>
+#include <PropWare/models/host/simulator.h>
+#include "../PropWare/PropWareTests.h"
+#include <string.h>
+
+/**
+ * The helper cog's output is checked on the simulated TX pin itself: a pin listener records every edge, and the
+ * waveform is decoded the way a receiver would, by sampling the middle of each bit.
+ */
+
+using PropWare::BufferedUARTTX;
+using PropWare::Simulator;
+
+static const PropWare::Pin::Mask TX_MASK   = PropWare::Pin::P12;
+static const int32_t             BAUD_RATE = 115200;
+
+struct Edge {
+    uint32_t timestamp;
+    bool     level;
+};
+
+static Edge              edges[4096];
+static volatile unsigned edgeCount;
+
+static char           buffer[16];
+static uint32_t       stack[64];
+static BufferedUARTTX *testable;
+
+static void record_edge (const uint32_t timestamp, const uint32_t pins, void *context) {
+    const bool level    = pins & TX_MASK;
+    const bool previous = edgeCount ? edges[edgeCount - 1].level : true;
+    if (level != previous && edgeCount < sizeof(edges) / sizeof(edges[0])) {
+        edges[edgeCount].timestamp = timestamp;
+        edges[edgeCount].level     = level;
+        ++edgeCount;
+    }
+}
+
+static bool level_at (const uint32_t timestamp) {
+    bool level = true;
+    for (unsigned i = 0; i < edgeCount && (int32_t) (timestamp - edges[i].timestamp) >= 0; ++i)
+        level = edges[i].level;
+    return level;
+}
+
+/**
+ * @brief   Decode every 8N1 word on the TX pin, up to `length` of them
+ *
+ * @return  Number of words decoded; -1 if a stop bit was missing
+ */
+static int decode (char received[], const int length) {
+    const uint32_t bitCycles = CLKFREQ / BAUD_RATE;
+    int            words     = 0;
+    unsigned       i         = 0;
+
+    while (words < length) {
+        // Next start bit
+        while (i < edgeCount && edges[i].level)
+            ++i;
+        if (i == edgeCount)
+            break;
+
+        const uint32_t start = edges[i].timestamp;
+        char           word  = 0;
+        for (int bit = 0; bit < 8; ++bit)
+            if (level_at(start + bitCycles * (2 * bit + 3) / 2))
+                word |= (char) (1 << bit);
+        if (!level_at(start + bitCycles * 19 / 2))
+            return -1;
+        received[words++] = word;
+
+        // Skip the edges inside this word
+        while (i < edgeCount && (int32_t) (edges[i].timestamp - (start + bitCycles * 9)) < 0)
+            ++i;
+    }
+    return words;
+}
+
+SETUP {
+    testable = new BufferedUARTTX(buffer, stack, TX_MASK);
+    testable->set_baud_rate(BAUD_RATE);
+    testable->start();
+
+    // Wait for the helper cog to take the (idle high) pin over before listening to it
+    while (!(Simulator::get_outputs() & TX_MASK));
+    edgeCount = 0;
+    Simulator::set_pin_listener(record_edge);
+}
+
+TEARDOWN {
+    Simulator::set_pin_listener(NULL);
+    delete testable;
+    testable = NULL;
+}
+
+TEST(Puts_reachesPin) {
+    const char message[] = "Hello, world!";
+    char       received[sizeof(message)];
+    setUp();
+
+    testable->puts(message);
+    testable->flush();
+
+    ASSERT_EQ_MSG(sizeof(message) - 1, decode(received, sizeof(received)));
+    ASSERT_EQ_MSG(0, memcmp(message, received, sizeof(message) - 1));
+
+    tearDown();
+}
+
+TEST(Puts_longerThanBuffer) {
+    const char message[] = "The helper cog must drain its own ring buffer, many times over, for this to arrive.";
+    char       received[sizeof(message)];
+    setUp();
+
+    testable->puts(message);
+    testable->flush();
+
+    ASSERT_EQ_MSG(sizeof(message) - 1, decode(received, sizeof(received)));
+    ASSERT_EQ_MSG(0, memcmp(message, received, sizeof(message) - 1));
+
+    tearDown();
+}
+
+TEST(Stop_releasesCog) {
+    setUp();
+
+    const unsigned int running = Simulator::get_running_cogs();
+    testable->stop();
+    ASSERT_EQ_MSG(running - 1, Simulator::get_running_cogs());
+
+    tearDown();
+}
+
+int main () {
+    START(BufferedUARTTXTest);
+
+    // Bits are timed with waitcnt, so the virtual clock keeps them exact however the PC schedules the threads
+    Simulator::set_clock_mode(Simulator::ClockMode::VIRTUAL);
+
+    RUN_TEST(Puts_reachesPin);
+    RUN_TEST(Puts_longerThanBuffer);
+    RUN_TEST(Stop_releasesCog);
+
+    COMPLETE();
+}
@@ -0,0 +1,410 @@
+/**
+ * @file    fiber_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/concurrent/fiber.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * The scheduler's logic, run against a simulated clock: time only moves when the scheduler idles or polls the pins, which
+ * makes every interleaving exact and repeatable. Each fiber appends a character to a shared trace whenever it
+ * runs, and the tests compare the trace against the expected order.
+ */
+
+struct SimulatedClock {
+    /** Cycles which pass each time the pins are read, standing in for a cog spinning on `INA` */
+    static const uint32_t POLL_CYCLES = 10;
+
+    static uint32_t time;
+    static uint32_t pins;
+    static unsigned idleCount;
+
+    static uint32_t now () {
+        return time;
+    }
+
+    static uint32_t read_pins () {
+        time += POLL_CYCLES;
+        return pins;
+    }
+
+    static void wait_until (const uint32_t deadline) {
+        ++idleCount;
+        if ((int32_t) (deadline - time) > 0)
+            time = deadline;
+    }
+
+    static void reset (const uint32_t startTime) {
+        time      = startTime;
+        pins      = 0;
+        idleCount = 0;
+    }
+};
+
+uint32_t SimulatedClock::time;
+uint32_t SimulatedClock::pins;
+unsigned SimulatedClock::idleCount;
+
+typedef PropWare::FiberScheduler<SimulatedClock> Scheduler;
+
+static char   trace[256];
+static size_t traceLength;
+
+static void record (const char c) {
+    if (sizeof(trace) - 1 > traceLength)
+        trace[traceLength++] = c;
+    trace[traceLength] = '\0';
+}
+
+static void reset (const uint32_t startTime = 0) {
+    SimulatedClock::reset(startTime);
+    traceLength = 0;
+    trace[0]    = '\0';
+}
+
+static unsigned failures;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures; \
+        } \
+    } while (0)
+
+#define CHECK_TRACE(expected) \
+    do { \
+        if (strcmp(expected, trace)) { \
+            printf("%s:%d: expected trace \"%s\", got \"%s\"\n", __FILE__, __LINE__, expected, trace); \
+            ++failures; \
+        } \
+    } while (0)
+
+/**
+ * Record `name` and yield, `count` times
+ */
+class Yielder : public PropWare::Fiber {
+    public:
+        Yielder (const char name, const unsigned count)
+                : m_name(name),
+                  m_count(count) {
+        }
+
+        void run () {
+            PW_FIBER_BEGIN();
+            for (this->m_i = 0; this->m_i < this->m_count; ++this->m_i) {
+                record(this->m_name);
+                PW_YIELD();
+            }
+            PW_FIBER_END();
+        }
+
+    private:
+        const char     m_name;
+        const unsigned m_count;
+        unsigned       m_i;
+};
+
+/**
+ * Record `name` every `period` cycles, `count` times, starting one period after its first turn
+ */
+class Ticker : public PropWare::Fiber {
+    public:
+        Ticker (const char name, const uint32_t period, const unsigned count)
+                : m_name(name),
+                  m_period(period),
+                  m_count(count) {
+        }
+
+        void run () {
+            PW_FIBER_BEGIN();
+            this->m_next = SimulatedClock::now();
+            for (this->m_i = 0; this->m_i < this->m_count; ++this->m_i) {
+                this->m_next += this->m_period;
+                PW_SLEEP_UNTIL(this->m_next);
+                // Woken late is acceptable; woken early is not
+                CHECK((int32_t) (SimulatedClock::now() - this->m_next) >= 0);
+                record(this->m_name);
+            }
+            PW_FIBER_END();
+        }
+
+    private:
+        const char     m_name;
+        const uint32_t m_period;
+        const unsigned m_count;
+        unsigned       m_i;
+        uint32_t       m_next;
+};
+
+/**
+ * Record `name` once the masked pins match `state`
+ */
+class PinWaiter : public PropWare::Fiber {
+    public:
+        PinWaiter (const char name, const uint32_t mask, const uint32_t state)
+                : m_name(name),
+                  m_mask(mask),
+                  m_state(state) {
+        }
+
+        void run () {
+            PW_FIBER_BEGIN();
+            PW_WAIT_PIN(this->m_mask, this->m_state);
+            record(this->m_name);
+            PW_FIBER_END();
+        }
+
+    private:
+        const char     m_name;
+        const uint32_t m_mask;
+        const uint32_t m_state;
+};
+
+/**
+ * Record `name` once `*flag` is set
+ */
+class FlagWaiter : public PropWare::Fiber {
+    public:
+        FlagWaiter (const char name, const bool *flag)
+                : m_name(name),
+                  m_flag(flag) {
+        }
+
+        void run () {
+            PW_FIBER_BEGIN();
+            PW_WAIT_UNTIL(*this->m_flag);
+            record(this->m_name);
+            PW_FIBER_END();
+        }
+
+    private:
+        const char m_name;
+        const bool *m_flag;
+};
+
+/**
+ * Raise pins and a flag after a fixed delay, recording `name`
+ */
+class Trigger : public PropWare::Fiber {
+    public:
+        Trigger (const char name, const uint32_t delay, const uint32_t pins, bool *flag)
+                : m_name(name),
+                  m_delay(delay),
+                  m_pins(pins),
+                  m_flag(flag) {
+        }
+
+        void run () {
+            PW_FIBER_BEGIN();
+            PW_SLEEP_UNTIL(SimulatedClock::now() + this->m_delay);
+            record(this->m_name);
+            SimulatedClock::pins |= this->m_pins;
+            if (this->m_flag)
+                *this->m_flag = true;
+            PW_FIBER_END();
+        }
+
+    private:
+        const char     m_name;
+        const uint32_t m_delay;
+        const uint32_t m_pins;
+        bool           *m_flag;
+};
+
+static void yield_roundRobin () {
+    reset();
+    Yielder   a('a', 3), b('b', 2), c('c', 1);
+    Scheduler scheduler;
+    scheduler.add(a);
+    scheduler.add(b);
+    scheduler.add(c);
+    CHECK(3 == scheduler.get_fiber_count());
+
+    scheduler.run();
+
+    CHECK_TRACE("abcaba");
+    CHECK(0 == scheduler.get_fiber_count());
+    CHECK(PropWare::Fiber::FINISHED == a.get_state());
+    CHECK(0 == SimulatedClock::idleCount);
+}
+
+static void sleepUntil_ordersByDeadline () {
+    reset();
+    Ticker    slow('s', 300, 2), fast('f', 100, 4), medium('m', 200, 2);
+    Scheduler scheduler;
+    scheduler.add(slow);
+    scheduler.add(fast);
+    scheduler.add(medium);
+
+    scheduler.run();
+
+    // Deadlines tie at 200, 300 and 400: the fiber which went to sleep first wakes first
+    CHECK_TRACE("fmfsfmfs");
+    CHECK(600 == SimulatedClock::time);
+}
+
+static void sleepUntil_idlesOnlyWhenNothingIsReady () {
+    reset();
+    Ticker    ticker('t', 1000, 3);
+    Yielder   yielder('y', 2);
+    Scheduler scheduler;
+    scheduler.add(ticker);
+    scheduler.add(yielder);
+
+    scheduler.run();
+
+    CHECK_TRACE("yyttt");
+    CHECK(3 == SimulatedClock::idleCount);
+    CHECK(3000 == SimulatedClock::time);
+}
+
+static void sleepUntil_handlesCounterRollover () {
+    reset(0xFFFFFF00);
+    Ticker    early('e', 0x80, 1), late('l', 0x200, 1);
+    Scheduler scheduler;
+    scheduler.add(late);
+    scheduler.add(early);
+
+    scheduler.run();
+
+    // The late deadline wraps past zero, so an unsigned comparison would wake it first
+    CHECK_TRACE("el");
+    CHECK(0x100 == SimulatedClock::time);
+}
+
+static void sleepUntil_pastDeadlineIsReadyImmediately () {
+    reset(5000);
+    Trigger   trigger('t', (uint32_t) -100, 0, NULL);
+    Scheduler scheduler;
+    scheduler.add(trigger);
+
+    scheduler.run();
+
+    CHECK_TRACE("t");
+    CHECK(0 == SimulatedClock::idleCount);
+}
+
+static void waitPin_wakesOnMatchingState () {
+    reset();
+    PinWaiter high('h', 0x3, 0x3), low('l', 0x4, 0);
+    Trigger   first('1', 100, 0x1, NULL), second('2', 200, 0x6, NULL);
+    Scheduler scheduler;
+    scheduler.add(high);
+    scheduler.add(low);
+    scheduler.add(first);
+    scheduler.add(second);
+
+    // P2 starts low, so `low` is satisfied on the first pass; `high` needs both P0 and P1
+    scheduler.run();
+
+    CHECK_TRACE("l12h");
+}
+
+static void waitPin_pollsInsteadOfIdling () {
+    reset();
+    PinWaiter waiter('w', 0x1, 0x1);
+    Scheduler scheduler;
+    scheduler.add(waiter);
+
+    // The first turn only starts the wait
+    CHECK(scheduler.run_once());
+    for (unsigned i = 0; i < 10; ++i)
+        CHECK(!scheduler.run_once());
+    CHECK_TRACE("");
+    CHECK(0 == SimulatedClock::idleCount);
+
+    SimulatedClock::pins = 0x1;
+    CHECK(scheduler.run_once());
+    CHECK_TRACE("w");
+    CHECK(0 == scheduler.get_fiber_count());
+}
+
+static void waitUntil_checksConditionEachTurn () {
+    reset();
+    bool       flag = false;
+    FlagWaiter waiter('w', &flag);
+    Trigger    trigger('t', 0, 0, &flag);
+    Scheduler  scheduler;
+    scheduler.add(waiter);
+    scheduler.add(trigger);
+
+    scheduler.run();
+
+    // The condition is polled without the scheduler ever idling, so a simulated clock could not move on its own
+    CHECK_TRACE("tw");
+    CHECK(PropWare::Fiber::FINISHED == waiter.get_state());
+    CHECK(0 == SimulatedClock::idleCount);
+}
+
+static void add_restartsFinishedFiber () {
+    reset();
+    Yielder   a('a', 2);
+    Scheduler scheduler;
+    scheduler.add(a);
+    scheduler.run();
+    scheduler.add(a);
+    scheduler.run();
+
+    CHECK_TRACE("aaaa");
+}
+
+static void manyFibers () {
+    reset();
+    static Ticker tickers[] = {
+            Ticker('0', 7, 50), Ticker('1', 11, 50), Ticker('2', 13, 50), Ticker('3', 17, 50), Ticker('4', 19, 50),
+            Ticker('5', 23, 50), Ticker('6', 29, 50), Ticker('7', 31, 50)
+    };
+    Scheduler scheduler;
+    for (size_t i = 0; i < sizeof(tickers) / sizeof(tickers[0]); ++i)
+        scheduler.add(tickers[i]);
+
+    scheduler.run();
+
+    // Every tick happens at its own deadline; the Ticker itself checks that none was early
+    CHECK(31 * 50 == SimulatedClock::time);
+    CHECK(0 == scheduler.get_fiber_count());
+}
+
+int main () {
+    yield_roundRobin();
+    sleepUntil_ordersByDeadline();
+    sleepUntil_idlesOnlyWhenNothingIsReady();
+    sleepUntil_handlesCounterRollover();
+    sleepUntil_pastDeadlineIsReadyImmediately();
+    waitPin_wakesOnMatchingState();
+    waitPin_pollsInsteadOfIdling();
+    waitUntil_checksConditionEachTurn();
+    add_restartsFinishedFiber();
+    manyFibers();
+
+    if (failures) {
+        printf("%u checks failed\n", failures);
+        return 1;
+    } else {
+        printf("All fiber scheduler checks passed\n");
+        return 0;
+    }
+}
@@ -0,0 +1,237 @@
+/**
+ * @file    mailbox_test.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/concurrent/mailbox.h>
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+
+/**
+ * The first checks run in a single thread against a simulated clock. The last one stands threads in for cogs: several
+ * clients, each with its own slot, hammer one server with requests whose responses can be checked for tearing, which
+ * would reveal any payload read before its sequence number was published (or the other way around).
+ */
+
+struct SimulatedClock {
+    static uint32_t time;
+
+    /** Every reading of the clock moves it on a little, as the cog spends time polling */
+    static uint32_t now () {
+        return time += 10;
+    }
+};
+
+uint32_t SimulatedClock::time;
+
+struct Request {
+    uint32_t client;
+    uint32_t number;
+    uint32_t value[4];
+};
+
+struct Response {
+    uint32_t client;
+    uint32_t number;
+    uint32_t sum;
+    uint32_t check;
+};
+
+typedef PropWare::Mailbox<Request, Response, SimulatedClock> TestMailbox;
+typedef PropWare::Future<Response, SimulatedClock>           TestFuture;
+
+static unsigned failures;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++failures; \
+        } \
+    } while (0)
+
+static Request make_request (const uint32_t client, const uint32_t number) {
+    Request request;
+    request.client = client;
+    request.number = number;
+    for (uint32_t i = 0; i < 4; ++i)
+        request.value[i] = number * 4 + i;
+    return request;
+}
+
+static Response handle (const Request &request) {
+    Response response;
+    response.client = request.client;
+    response.number = request.number;
+    response.sum    = request.value[0] + request.value[1] + request.value[2] + request.value[3];
+    response.check  = ~request.number;
+    return response;
+}
+
+static bool is_response_to (const Response &response, const uint32_t client, const uint32_t number) {
+    return client == response.client && number == response.number && 16 * number + 6 == response.sum
+           && ~number == response.check;
+}
+
+static void future_invalidByDefault () {
+    const TestFuture future;
+    Response         response;
+
+    CHECK(!future.is_valid());
+    CHECK(!future.ready());
+    CHECK(!future.get(response, 1000));
+}
+
+static void post_readyAfterResponse () {
+    TestMailbox::Slot slots[1];
+    TestMailbox       mailbox(slots);
+    size_t            slot;
+
+    CHECK(!mailbox.receive(slot));
+
+    const TestFuture future = mailbox.post(make_request(0, 7));
+    CHECK(future.is_valid());
+    CHECK(!future.ready());
+    CHECK(mailbox.is_busy());
+
+    CHECK(mailbox.serve(handle));
+    CHECK(future.ready());
+    CHECK(!mailbox.is_busy());
+    CHECK(is_response_to(future.get(), 0, 7));
+    CHECK(!mailbox.serve(handle));
+}
+
+static void post_failsWhileSlotIsBusy () {
+    TestMailbox::Slot slots[1];
+    TestMailbox       mailbox(slots);
+
+    const TestFuture first = mailbox.post(make_request(0, 1));
+    CHECK(!mailbox.post(make_request(0, 2)).is_valid());
+
+    mailbox.serve(handle);
+    const TestFuture second = mailbox.post(make_request(0, 3));
+    CHECK(second.is_valid());
+
+    // A Future does not confuse the answer to a later request with its own
+    CHECK(first.ready());
+    CHECK(!second.ready());
+    mailbox.serve(handle);
+    CHECK(!first.ready());
+    CHECK(is_response_to(second.get(), 0, 3));
+}
+
+static void get_timesOut () {
+    TestMailbox::Slot slots[1];
+    TestMailbox       mailbox(slots);
+    Response          response;
+    response.client = 99;
+
+    // Start just before the counter rolls over
+    const uint32_t start = SimulatedClock::time = 0xFFFFFF00;
+    const TestFuture future = mailbox.post(make_request(0, 5));
+    CHECK(!future.get(response, 1000));
+    CHECK(99 == response.client);
+    CHECK(1000 <= SimulatedClock::time - start);
+    CHECK(2000 > SimulatedClock::time - start);
+
+    mailbox.serve(handle);
+    CHECK(future.get(response, 1000));
+    CHECK(is_response_to(response, 0, 5));
+}
+
+static void receive_visitsSlotsInTurn () {
+    TestMailbox::Slot slots[3];
+    TestMailbox       mailbox(slots);
+    size_t            slot;
+
+    mailbox.post(make_request(0, 0), 0);
+    mailbox.post(make_request(2, 0), 2);
+    CHECK(mailbox.receive(slot) && 0 == slot);
+    mailbox.respond(slot, handle(mailbox.get_request(slot)));
+
+    // Slot 0 posts again straight away, but slot 2 has been waiting longer
+    mailbox.post(make_request(0, 1), 0);
+    CHECK(mailbox.receive(slot) && 2 == slot);
+    mailbox.respond(slot, handle(mailbox.get_request(slot)));
+    CHECK(mailbox.receive(slot) && 0 == slot);
+}
+
+static void threads_noTornMessages () {
+    static const uint32_t CLIENTS  = 3;
+    static const uint32_t REQUESTS = 200000;
+
+    typedef PropWare::Mailbox<Request, Response, SimulatedClock> Shared;
+    static Shared::Slot slots[CLIENTS];
+    static Shared       mailbox(slots);
+    std::atomic<bool>   stop(false);
+    std::atomic<int>    errors(0);
+
+    std::thread server([&] () {
+        while (!stop)
+            if (!mailbox.serve(handle))
+                std::this_thread::yield();
+    });
+
+    std::thread *clients[CLIENTS];
+    for (uint32_t c = 0; c < CLIENTS; ++c)
+        clients[c] = new std::thread([&, c] () {
+            for (uint32_t n = 0; n < REQUESTS; ++n) {
+                const PropWare::Future<Response, SimulatedClock> future = mailbox.post(make_request(c, n), c);
+                if (!future.is_valid())
+                    ++errors;
+                else {
+                    while (!future.ready())
+                        std::this_thread::yield();
+                    if (!is_response_to(future.get(), c, n))
+                        ++errors;
+                }
+            }
+        });
+
+    for (uint32_t c = 0; c < CLIENTS; ++c) {
+        clients[c]->join();
+        delete clients[c];
+    }
+    stop = true;
+    server.join();
+
+    CHECK(0 == errors);
+}
+
+int main () {
+    future_invalidByDefault();
+    post_readyAfterResponse();
+    post_failsWhileSlotIsBusy();
+    get_timesOut();
+    receive_visitsSlotsInTurn();
+    threads_noTornMessages();
+
+    if (failures) {
+        printf("%u checks failed\n", failures);
+        return 1;
+    } else {
+        printf("All mailbox checks passed\n");
+        return 0;
+    }
+}
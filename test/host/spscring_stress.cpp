@@ -0,0 +1,97 @@
+/**
+ * @file    spscring_stress.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <PropWare/utility/collection/spscring.h>
+#include <stdio.h>
+#include <thread>
+
+/**
+ * Two threads stand in for two cogs: one pushes a long, known sequence and the other checks that it comes out intact.
+ * Single-element and span-based calls are mixed on both sides, and the ring is kept small so that it is constantly
+ * wrapping, full and empty. A side which finds nothing to do yields, so that the test also finishes on a machine with a
+ * single core.
+ */
+
+static const uint32_t ELEMENTS = 10000000;
+
+static PropWare::SPSCRing<uint32_t, 16> ring;
+
+static void produce () {
+    uint32_t next = 0;
+    while (ELEMENTS > next) {
+        if (next & 0x100) {
+            PropWare::SPSCRing<uint32_t, 16>::Span span = ring.push_n(ELEMENTS - next < 5 ? ELEMENTS - next : 5);
+            for (size_t i = 0; i < span.length; ++i)
+                span.data[i] = next++;
+            ring.commit_push(span.length);
+            if (!span.length)
+                std::this_thread::yield();
+        } else if (ring.try_push(next))
+            ++next;
+        else
+            std::this_thread::yield();
+    }
+}
+
+static bool consume () {
+    uint32_t expected = 0;
+    while (ELEMENTS > expected) {
+        if (expected & 0x80) {
+            PropWare::SPSCRing<uint32_t, 16>::Span span = ring.pop_n(7);
+            for (size_t i = 0; i < span.length; ++i)
+                if (expected++ != span.data[i]) {
+                    printf("FAIL: expected %u, popped %u\n", expected - 1, span.data[i]);
+                    return false;
+                }
+            ring.commit_pop(span.length);
+            if (!span.length)
+                std::this_thread::yield();
+        } else {
+            uint32_t value;
+            if (!ring.try_pop(value))
+                std::this_thread::yield();
+            else if (expected++ != value) {
+                printf("FAIL: expected %u, popped %u\n", expected - 1, value);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main () {
+    bool        passed = false;
+    std::thread consumer([&passed] () {
+        passed = consume();
+    });
+    produce();
+    consumer.join();
+
+    if (passed && ring.is_empty()) {
+        printf("%u elements passed through the ring intact\n", ELEMENTS);
+        return 0;
+    } else
+        return 1;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file    tools/pwbenchdiff/pwbenchdiff.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Compare two runs of a benchmark suite and flag regressions.
+ *
+ *     pwbenchdiff <baseline-output> <current-output> [threshold-percent]
+ *
+ * Both files are the captured terminal output of one or more benchmark suites (see test/PropWare/PropWareBenchmarks.h);
+ * everything but the `BENCHMARK` lines is ignored. Benchmarks are matched by name and memory model, and any whose
+ * cycles/op grew by more than the threshold (5% by default) is reported as a regression. The exit code is 0 when
+ * nothing regressed, 1 when something did and 2 when the files could not be read.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+
+static const double DEFAULT_THRESHOLD = 5;
+
+struct Result {
+    unsigned long cyclesPerOperation;
+};
+
+/**
+ * Value of `key=value` in a BENCHMARK line, or an empty string if the key is missing
+ */
+static std::string find_value (const std::string &line, const std::string &key) {
+    const std::string pattern = ' ' + key + '=';
+    const size_t      start   = line.find(pattern);
+    if (std::string::npos == start)
+        return "";
+    const size_t begin = start + pattern.size();
+    return line.substr(begin, line.find(' ', begin) - begin);
+}
+
+static bool load_results (const char path[], std::map<std::string, Result> &results) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+
+    static const char PREFIX[] = "BENCHMARK ";
+    char              buffer[512];
+    while (fgets(buffer, sizeof(buffer), file)) {
+        std::string line(buffer);
+        line.erase(line.find_last_not_of("\r\n") + 1);
+        if (0 != line.compare(0, sizeof(PREFIX) - 1, PREFIX))
+            continue;
+
+        const size_t      nameEnd = line.find(' ', sizeof(PREFIX) - 1);
+        const std::string name    = line.substr(sizeof(PREFIX) - 1, nameEnd - (sizeof(PREFIX) - 1));
+        const std::string cycles  = find_value(line, "cycles/op");
+        if (cycles.empty()) {
+            fprintf(stderr, "%s: no cycles/op for %s\n", path, name.c_str());
+            continue;
+        }
+
+        Result result;
+        result.cyclesPerOperation = strtoul(cycles.c_str(), NULL, 10);
+        results[name + " (" + find_value(line, "model") + ')'] = result;
+    }
+
+    fclose(file);
+    return true;
+}
+
+int main (int argc, char *argv[]) {
+    if (3 > argc || 4 < argc) {
+        fprintf(stderr, "Usage: %s <baseline-output> <current-output> [threshold-percent]\n", argv[0]);
+        return 2;
+    }
+
+    const double threshold = 4 == argc ? atof(argv[3]) : DEFAULT_THRESHOLD;
+
+    std::map<std::string, Result> baseline;
+    std::map<std::string, Result> current;
+    if (!load_results(argv[1], baseline) || !load_results(argv[2], current))
+        return 2;
+
+    unsigned int regressions = 0;
+    for (std::map<std::string, Result>::const_iterator i = current.begin(); i != current.end(); ++i) {
+        const std::map<std::string, Result>::const_iterator before = baseline.find(i->first);
+        if (baseline.end() == before) {
+            printf("NEW        %-48s %10lu cycles/op\n", i->first.c_str(), i->second.cyclesPerOperation);
+            continue;
+        }
+
+        const unsigned long was = before->second.cyclesPerOperation;
+        const unsigned long now = i->second.cyclesPerOperation;
+        // A benchmark which used to take no time at all regresses the moment it takes any
+        const double change = was ? 100.0 * ((double) now - (double) was) / was : (now ? 100.0 : 0.0);
+
+        const char *verdict;
+        if (change > threshold) {
+            verdict = "REGRESSION";
+            ++regressions;
+        } else if (change < -threshold)
+            verdict = "IMPROVED  ";
+        else
+            verdict = "same      ";
+        printf("%s %-48s %10lu -> %10lu cycles/op (%+.1f%%)\n", verdict, i->first.c_str(), was, now, change);
+    }
+
+    for (std::map<std::string, Result>::const_iterator i = baseline.begin(); i != baseline.end(); ++i)
+        if (current.end() == current.find(i->first))
+            printf("MISSING    %s\n", i->first.c_str());
+
+    if (regressions)
+        printf("\n%u regression%s beyond %.1f%%\n", regressions, 1 == regressions ? "" : "s", threshold);
+    return regressions ? 1 : 0;
+}
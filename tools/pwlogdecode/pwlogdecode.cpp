@@ -0,0 +1,242 @@
+/**
+ * @file    tools/pwlogdecode/pwlogdecode.cpp
+ *
+ * @author  David Zemon
+ *
+ * @copyright
+ * The MIT License (MIT)<br>
+ * <br>Copyright (c) 2013 David Zemon<br>
+ * <br>Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"), to
+ * deal in the Software without restriction, including without limitation the
+ * rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:<br>
+ * <br>The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.<br>
+ * <br>THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Turn the frames written by PropWare::BinaryLogger back into text.
+ *
+ *     pwlogdecode <application.elf> [captured-log]
+ *
+ * The format strings are read from the application's `pwlog_formats` section. Frames are read from the captured log
+ * file (or a serial device) if given, otherwise from standard input, and each record is printed to standard output as
+ * PropWare::Printer::printf would have printed it.
+ */
+
+#include <PropWare/serial/framing/cobs.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const char   SECTION_NAME[]  = "pwlog_formats";
+static const size_t ID_SIZE         = 2;
+static const size_t MAX_RECORD_SIZE = 255;
+static const int    MAX_PRECISION   = 9;
+
+static uint32_t read_le (const std::vector<char> &bytes, const size_t offset, const size_t size) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < size; ++i)
+        value |= (uint32_t) (uint8_t) bytes[offset + i] << (8 * i);
+    return value;
+}
+
+/**
+ * Read the contents of the `pwlog_formats` section out of a 32-bit little-endian ELF file
+ */
+static bool load_formats (const char path[], std::vector<char> &formats) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    std::vector<char> elf;
+    char              chunk[4096];
+    size_t            count;
+    while ((count = fread(chunk, 1, sizeof(chunk), file)))
+        elf.insert(elf.end(), chunk, chunk + count);
+    fclose(file);
+
+    if (52 > elf.size() || 0 != memcmp(elf.data(), "\x7F" "ELF", 4) || 1 != elf[4] || 1 != elf[5]) {
+        fprintf(stderr, "%s: not a 32-bit little-endian ELF file\n", path);
+        return false;
+    }
+
+    const uint32_t sectionTable = read_le(elf, 0x20, 4);
+    const uint32_t entrySize    = read_le(elf, 0x2E, 2);
+    const uint32_t sections     = read_le(elf, 0x30, 2);
+    const uint32_t namesIndex   = read_le(elf, 0x32, 2);
+    if (sectionTable + (uint64_t) sections * entrySize > elf.size() || namesIndex >= sections) {
+        fprintf(stderr, "%s: bad section header table\n", path);
+        return false;
+    }
+    const uint32_t names = read_le(elf, sectionTable + namesIndex * entrySize + 16, 4);
+
+    for (uint32_t i = 0; i < sections; ++i) {
+        const uint32_t header = sectionTable + i * entrySize;
+        const uint32_t name   = names + read_le(elf, header, 4);
+        const uint32_t offset = read_le(elf, header + 16, 4);
+        const uint32_t size   = read_le(elf, header + 20, 4);
+        if (name < elf.size() && 0 == strncmp(&elf[name], SECTION_NAME, elf.size() - name)
+                && (uint64_t) offset + size <= elf.size()) {
+            formats.assign(elf.begin() + offset, elf.begin() + offset + size);
+            formats.push_back('\0');
+            return true;
+        }
+    }
+    fprintf(stderr, "%s: no %s section; was anything logged with PW_LOG?\n", path, SECTION_NAME);
+    return false;
+}
+
+/**
+ * Pad `digits` to `width` the way PropWare::Printer does: zeros go between the sign and the digits, anything else in
+ * front of the sign
+ */
+static std::string pad (const std::string &sign, const std::string &digits, const size_t width, const char fillChar) {
+    const size_t length = sign.size() + digits.size();
+    const std::string padding(width > length ? width - length : 0, fillChar);
+    return '0' == fillChar ? sign + padding + digits : padding + sign + digits;
+}
+
+static std::string to_radix (uint32_t value, const uint32_t radix) {
+    std::string digits;
+    do {
+        digits.insert(digits.begin(), "0123456789ABCDEF"[value % radix]);
+        value /= radix;
+    } while (value);
+    return digits;
+}
+
+/**
+ * Format one record. Returns false if the record does not match its format string
+ */
+static bool format_record (const char format[], const std::vector<char> &arguments, std::string &text) {
+    size_t position = 0;
+    for (const char *s = format; *s; ++s) {
+        if ('%' != *s) {
+            text += *s;
+            continue;
+        } else if ('%' == s[1]) {
+            text += '%';
+            ++s;
+            continue;
+        }
+
+        ++s;
+        const char fillChar  = '0' == *s ? '0' : ' ';
+        size_t     width     = 0;
+        int        precision = 6;
+        for (; '0' <= *s && *s <= '9'; ++s)
+            width = 10 * width + *s - '0';
+        if ('.' == *s) {
+            precision = 0;
+            for (++s; '0' <= *s && *s <= '9'; ++s)
+                precision = 10 * precision + *s - '0';
+        }
+
+        switch (*s) {
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'X':
+            case 'b':
+            case 'f': {
+                if (position + 4 > arguments.size())
+                    return false;
+                const uint32_t word = read_le(arguments, position, 4);
+                position += 4;
+
+                if ('f' == *s) {
+                    float value;
+                    memcpy(&value, &word, sizeof(value));
+                    char buffer[64];
+                    snprintf(buffer, sizeof(buffer), '0' == fillChar ? "%0*.*f" : "%*.*f", (int) width,
+                             precision > MAX_PRECISION ? MAX_PRECISION : precision, (double) value);
+                    text += buffer;
+                } else if ('d' == *s || 'i' == *s) {
+                    // The sign does not count toward the width of an integer
+                    const bool negative = (int32_t) word < 0;
+                    text += negative ? "-" : "";
+                    text += pad("", to_radix(negative ? -word : word, 10), width, fillChar);
+                } else
+                    text += pad("", to_radix(word, 'X' == *s ? 16 : ('b' == *s ? 2 : 10)), width, fillChar);
+                break;
+            }
+            case 'c':
+                if (position >= arguments.size())
+                    return false;
+                text += arguments[position++];
+                break;
+            case 's': {
+                const size_t end = std::find(arguments.begin() + position, arguments.end(), '\0') - arguments.begin();
+                if (end == arguments.size())
+                    return false;
+                text.append(&arguments[position], end - position);
+                position = end + 1;
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return position == arguments.size();
+}
+
+int main (int argc, char *argv[]) {
+    if (2 > argc || 3 < argc) {
+        fprintf(stderr, "Usage: %s <application.elf> [captured-log]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<char> formats;
+    if (!load_formats(argv[1], formats))
+        return 1;
+
+    FILE *input = 3 == argc ? fopen(argv[2], "rb") : stdin;
+    if (!input) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    static char           frame[MAX_RECORD_SIZE + PropWare::COBSDecoder::CRC_SIZE];
+    PropWare::COBSDecoder decoder(frame);
+    int                   c;
+    while (EOF != (c = fgetc(input))) {
+        if (PropWare::COBSDecoder::NO_ERROR != decoder.feed((char) c))
+            fprintf(stderr, "[corrupt frame skipped]\n");
+        else if (decoder.frame_ready()) {
+            const size_t length = decoder.get_length();
+            if (ID_SIZE > length) {
+                fprintf(stderr, "[short frame skipped]\n");
+                continue;
+            }
+
+            const uint16_t          id = (uint16_t) ((uint8_t) frame[0] | (uint8_t) frame[1] << 8);
+            const std::vector<char> arguments(frame + ID_SIZE, frame + length);
+            std::string             text;
+            if (id >= formats.size() - 1)
+                fprintf(stderr, "[unknown format ID %u]\n", id);
+            else if (!format_record(&formats[id], arguments, text))
+                fprintf(stderr, "[record does not match format \"%s\"]\n", &formats[id]);
+            else {
+                fputs(text.c_str(), stdout);
+                fflush(stdout);
+            }
+        }
+    }
+
+    if (stdin != input)
+        fclose(input);
+    return 0;
+}